@@ -19,6 +19,9 @@ import 'showcase_painters.dart';
 // - Configurable binary payload sizes
 // - sessionId displayed during benchmarks
 // - Multiple concurrent publishers (stress test)
+// - Transport profiles: delivered rate and one-way latency over a loopback
+//   peer link per ZenohTransportProfile, with the applied transport keys
+// - ZenohSerializer round trips of float64 arrays and records
 // ============================================================================
 
 class BenchmarkPage extends StatefulWidget {
@@ -73,10 +76,26 @@ class _BenchmarkPageState extends State<BenchmarkPage>
   final List<_BenchmarkResultEntry> _allResults = [];
   bool _showComparison = false;
 
+  // ---- Profiles tab state ----
+  bool _profilesRunning = false;
+  String? _profilesStatus;
+  final List<_ProfileResult> _profileResults = [];
+
+  static const int _profileMessageCount = 2000;
+  static const int _profileLatencyCount = 200;
+  static const int _profilePayloadSize = 1024;
+  static const int _profileBasePort = 7460;
+
+  // ---- Serializer state ----
+  List<_SerializerResult> _serializerResults = [];
+
+  static const int _serializerValues = 100000;
+  static const int _serializerRounds = 20;
+
   @override
   void initState() {
     super.initState();
-    _tabController = TabController(length: 3, vsync: this);
+    _tabController = TabController(length: 4, vsync: this);
     _barChartAnim = AnimationController(
       vsync: this,
       duration: const Duration(milliseconds: 800),
@@ -334,6 +353,230 @@ class _BenchmarkPageState extends State<BenchmarkPage>
     }
   }
 
+  // =========================================================================
+  // Transport Profile Benchmark
+  // =========================================================================
+
+  /// Opens a listening and a connecting peer over loopback with the same
+  /// tuning for every profile, publishes a fixed burst from one to the other
+  /// and measures how many samples arrive and how fast. Then sends single
+  /// messages on a second key, each after the previous one arrived, to time
+  /// put-to-delivery latency without queueing behind the burst.
+  ///
+  /// Puts go through the options path and the subscribers are extended
+  /// ones, neither of which logs per message.
+  Future<void> _runProfileBenchmark() async {
+    if (_profilesRunning) return;
+
+    setState(() {
+      _profilesRunning = true;
+      _profileResults.clear();
+    });
+
+    final payload = Uint8List(_profilePayloadSize);
+    for (int i = 0; i < payload.length; i++) {
+      payload[i] = i % 256;
+    }
+
+    try {
+      for (final profile in ZenohTransportProfile.values) {
+        if (!mounted || _isDisposed) return;
+        setState(() => _profilesStatus = 'Running ${profile.name}...');
+
+        final tuning = ZenohTransportTuning(profile: profile);
+        final endpoint =
+            'tcp/127.0.0.1:${_profileBasePort + profile.index}';
+        final listenerConfig = ZenohConfigBuilder()
+            .mode('peer')
+            .listen([endpoint])
+            .multicastScouting(false)
+            .transport(tuning);
+        final connectorConfig = ZenohConfigBuilder()
+            .mode('peer')
+            .connect([endpoint])
+            .multicastScouting(false)
+            .transport(tuning);
+
+        final receiver = await ZenohSession.openWithConfig(listenerConfig);
+        ZenohSession? sender;
+        ZenohSubscriber? sub;
+        ZenohSubscriber? pingSub;
+        try {
+          sender = await ZenohSession.openWithConfig(connectorConfig);
+          sub = await receiver.declareSubscriber('bench/profile/test',
+              extended: true);
+          pingSub = await receiver.declareSubscriber('bench/profile/ping',
+              extended: true);
+
+          var received = 0;
+          final done = Completer<void>();
+          final listener = sub.stream.listen((_) {
+            received++;
+            if (received == _profileMessageCount && !done.isCompleted) {
+              done.complete();
+            }
+          });
+
+          Completer<void>? pong;
+          final pingListener = pingSub.stream.listen((_) {
+            if (pong != null && !pong!.isCompleted) pong!.complete();
+          });
+
+          // Give the peers time to exchange declarations
+          await Future<void>.delayed(const Duration(milliseconds: 500));
+
+          const putOptions = ZenohPutOptions();
+          final pub = await sender.declarePublisher('bench/profile/test');
+          final sw = Stopwatch()..start();
+          for (int i = 0; i < _profileMessageCount; i++) {
+            await pub.put(payload, options: putOptions);
+          }
+          await done.future
+              .timeout(const Duration(seconds: 3), onTimeout: () {});
+          sw.stop();
+          await listener.cancel();
+
+          final senderStats = sender.stats;
+          final receiverStats = receiver.stats;
+          await pub.undeclare();
+
+          final pingPub = await sender.declarePublisher('bench/profile/ping');
+          final latencies = <double>[];
+          for (int i = 0; i < _profileLatencyCount; i++) {
+            pong = Completer<void>();
+            final lsw = Stopwatch()..start();
+            await pingPub.put(payload, options: putOptions);
+            final arrived = await pong!.future
+                .then((_) => true)
+                .timeout(const Duration(seconds: 1), onTimeout: () => false);
+            if (arrived) latencies.add(lsw.elapsedMicroseconds / 1000.0);
+          }
+          await pingListener.cancel();
+          await pingPub.undeclare();
+          latencies.sort();
+
+          final elapsedMs = max(sw.elapsedMilliseconds, 1);
+          _profileResults.add(_ProfileResult(
+            profile: profile,
+            sent: senderStats.puts,
+            received: received,
+            putErrors: senderStats.putErrors,
+            droppedSamples: receiverStats.droppedSamples,
+            msgsPerSec: received / (elapsedMs / 1000),
+            elapsedMs: elapsedMs,
+            avgLatencyMs: latencies.isEmpty
+                ? null
+                : latencies.reduce((a, b) => a + b) / latencies.length,
+            p99LatencyMs: latencies.isEmpty
+                ? null
+                : latencies[((latencies.length - 1) * 0.99).round()],
+            transportKeys: listenerConfig.transportKeys,
+          ));
+        } finally {
+          await pingSub?.undeclare();
+          await sub?.undeclare();
+          await sender?.close();
+          await receiver.close();
+        }
+
+        if (mounted && !_isDisposed) setState(() {});
+      }
+
+      if (mounted && !_isDisposed) {
+        setState(() {
+          _profilesRunning = false;
+          _profilesStatus = null;
+          for (final r in _profileResults) {
+            _allResults.add(_BenchmarkResultEntry(
+              type: 'Profile ${r.profile.name}',
+              priority: ZenohPriority.data,
+              congestion: ZenohCongestionControl.drop,
+              express: false,
+              payloadSize: _profilePayloadSize,
+              msgsPerSec: r.msgsPerSec,
+              avgLatencyMs: r.avgLatencyMs,
+              timestamp: DateTime.now(),
+            ));
+          }
+        });
+      }
+    } catch (e) {
+      if (mounted && !_isDisposed) {
+        setState(() {
+          _profilesRunning = false;
+          _profilesStatus = null;
+        });
+        ScaffoldMessenger.of(context).showSnackBar(
+          SnackBar(content: Text('Profile benchmark error: $e')),
+        );
+      }
+    }
+  }
+
+  // =========================================================================
+  // Serializer Benchmark
+  // =========================================================================
+
+  /// Times ZenohSerializer round trips of a float64 array and of 16-byte
+  /// records (int32 id, padding, float64 value) that need per-field copies.
+  /// Runs on the UI isolate and needs no session.
+  void _runSerializerBenchmark() {
+    final values = Float64List(_serializerValues);
+    for (int i = 0; i < values.length; i++) {
+      values[i] = i * 0.5;
+    }
+    final records = ByteData(_serializerValues * 16);
+    for (int i = 0; i < _serializerValues; i++) {
+      records.setInt32(i * 16, i, Endian.host);
+      records.setFloat64(i * 16 + 8, i * 0.5, Endian.host);
+    }
+    const fields = [
+      ZenohSerialField(ZenohSerialType.int32, 0),
+      ZenohSerialField(ZenohSerialType.float64, 8),
+    ];
+
+    _SerializerResult time(String name, int bytes, Uint8List Function() encode,
+        void Function(Uint8List) decode) {
+      var payload = encode(); // Warm up
+      decode(payload);
+      final encodeSw = Stopwatch();
+      final decodeSw = Stopwatch();
+      for (int i = 0; i < _serializerRounds; i++) {
+        encodeSw.start();
+        payload = encode();
+        encodeSw.stop();
+        decodeSw.start();
+        decode(payload);
+        decodeSw.stop();
+      }
+      double mbPerSec(Stopwatch sw) =>
+          bytes * _serializerRounds / max(sw.elapsedMicroseconds, 1);
+      return _SerializerResult(
+        name: name,
+        payloadBytes: payload.length,
+        encodeMBps: mbPerSec(encodeSw),
+        decodeMBps: mbPerSec(decodeSw),
+      );
+    }
+
+    setState(() {
+      _serializerResults = [
+        time(
+          'float64 x $_serializerValues',
+          values.lengthInBytes,
+          () => ZenohSerializer.float64List(values),
+          ZenohSerializer.toFloat64List,
+        ),
+        time(
+          'record x $_serializerValues',
+          records.lengthInBytes,
+          () => ZenohSerializer.records(fields, records, 16),
+          (payload) => ZenohSerializer.toRecords(fields, payload, 16),
+        ),
+      ];
+    });
+  }
+
   // =========================================================================
   // UI
   // =========================================================================
@@ -356,6 +599,7 @@ class _BenchmarkPageState extends State<BenchmarkPage>
                   Tab(icon: Icon(Icons.speed), text: 'Throughput'),
                   Tab(icon: Icon(Icons.timer), text: 'Latency'),
                   Tab(icon: Icon(Icons.assessment), text: 'Results'),
+                  Tab(icon: Icon(Icons.tune), text: 'Profiles'),
                 ],
               ),
       ),
@@ -382,6 +626,7 @@ class _BenchmarkPageState extends State<BenchmarkPage>
                     _buildThroughputTab(),
                     _buildLatencyTab(),
                     _buildResultsTab(),
+                    _buildProfilesTab(),
                   ],
                 ),
     );
@@ -1155,6 +1400,151 @@ class _BenchmarkPageState extends State<BenchmarkPage>
     );
   }
 
+  // =========================================================================
+  // Profiles Tab
+  // =========================================================================
+
+  Widget _buildProfilesTab() {
+    final best = _profileResults.isEmpty
+        ? 0.0
+        : _profileResults.map((r) => r.msgsPerSec).reduce(max);
+
+    return ListView(
+      padding: const EdgeInsets.all(12),
+      children: [
+        _buildDarkCard(
+          title: 'Transport Profiles',
+          icon: Icons.tune,
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.start,
+            children: [
+              const Text(
+                'Opens two peers over loopback for each profile and '
+                'publishes $_profileMessageCount x $_profilePayloadSize B '
+                'from one to the other, then times $_profileLatencyCount '
+                'single messages. Does not need a router.',
+                style: TextStyle(color: Colors.white54, fontSize: 12),
+              ),
+              const SizedBox(height: 12),
+              if (_profilesStatus != null)
+                Padding(
+                  padding: const EdgeInsets.only(bottom: 8),
+                  child: Text(
+                    _profilesStatus!,
+                    style: const TextStyle(
+                        color: Colors.cyanAccent, fontSize: 12),
+                  ),
+                ),
+              SizedBox(
+                width: double.infinity,
+                child: ElevatedButton.icon(
+                  onPressed: _profilesRunning ? null : _runProfileBenchmark,
+                  icon: _profilesRunning
+                      ? const SizedBox(
+                          width: 16,
+                          height: 16,
+                          child: CircularProgressIndicator(
+                            strokeWidth: 2,
+                            color: Colors.black,
+                          ),
+                        )
+                      : const Icon(Icons.play_arrow),
+                  label: Text(
+                      _profilesRunning ? 'Running...' : 'Compare Profiles'),
+                  style: ElevatedButton.styleFrom(
+                    backgroundColor: Colors.cyanAccent,
+                    foregroundColor: Colors.black,
+                  ),
+                ),
+              ),
+            ],
+          ),
+        ),
+        _buildDarkCard(
+          title: 'Serializer',
+          icon: Icons.data_array,
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.start,
+            children: [
+              const Text(
+                'Serializes and deserializes $_serializerValues values '
+                '$_serializerRounds times with ZenohSerializer.',
+                style: TextStyle(color: Colors.white54, fontSize: 12),
+              ),
+              const SizedBox(height: 12),
+              SizedBox(
+                width: double.infinity,
+                child: ElevatedButton.icon(
+                  onPressed: _runSerializerBenchmark,
+                  icon: const Icon(Icons.play_arrow),
+                  label: const Text('Time Serializer'),
+                  style: ElevatedButton.styleFrom(
+                    backgroundColor: Colors.cyanAccent,
+                    foregroundColor: Colors.black,
+                  ),
+                ),
+              ),
+              for (final r in _serializerResults) ...[
+                const SizedBox(height: 8),
+                Text(
+                  '${r.name}: ${r.encodeMBps.toStringAsFixed(0)} MB/s encode  '
+                  '${r.decodeMBps.toStringAsFixed(0)} MB/s decode  '
+                  '(${r.payloadBytes} B payload)',
+                  style: const TextStyle(color: Colors.white, fontSize: 13),
+                ),
+              ],
+            ],
+          ),
+        ),
+        for (final r in _profileResults)
+          _buildDarkCard(
+            title: r.profile.name,
+            icon: r.msgsPerSec == best ? Icons.emoji_events : Icons.tune,
+            child: Column(
+              crossAxisAlignment: CrossAxisAlignment.start,
+              children: [
+                LinearProgressIndicator(
+                  value: best > 0 ? r.msgsPerSec / best : 0,
+                  backgroundColor: Colors.white10,
+                  color: Colors.cyanAccent,
+                ),
+                const SizedBox(height: 8),
+                Text(
+                  '${r.msgsPerSec.toStringAsFixed(0)} msgs/s delivered  '
+                  '(${r.received}/${r.sent} in ${r.elapsedMs} ms)',
+                  style: const TextStyle(color: Colors.white, fontSize: 13),
+                ),
+                Text(
+                  r.avgLatencyMs != null
+                      ? 'latency: ${r.avgLatencyMs!.toStringAsFixed(3)} ms avg  '
+                          '${r.p99LatencyMs!.toStringAsFixed(3)} ms p99'
+                      : 'latency: no message arrived',
+                  style: const TextStyle(color: Colors.white, fontSize: 13),
+                ),
+                Text(
+                  'put errors: ${r.putErrors}  '
+                  'dropped: ${r.droppedSamples}',
+                  style: const TextStyle(color: Colors.white54, fontSize: 12),
+                ),
+                if (r.transportKeys.isNotEmpty) ...[
+                  const SizedBox(height: 6),
+                  for (final e in r.transportKeys.entries)
+                    Text(
+                      '${e.key} = ${e.value}',
+                      style: const TextStyle(
+                        color: Colors.white38,
+                        fontSize: 10,
+                        fontFamily: 'monospace',
+                      ),
+                    ),
+                ],
+              ],
+            ),
+          ),
+      ],
+    );
+  }
+
   // =========================================================================
   // Helper widgets and methods
   // =========================================================================
@@ -1465,6 +1855,49 @@ class _BenchmarkResultEntry {
   });
 }
 
+class _ProfileResult {
+  final ZenohTransportProfile profile;
+  final int sent;
+  final int received;
+  final int putErrors;
+  final int droppedSamples;
+  final double msgsPerSec;
+  final int elapsedMs;
+
+  /// One-way put-to-delivery latency of single messages, null when none
+  /// arrived
+  final double? avgLatencyMs;
+  final double? p99LatencyMs;
+  final Map<String, dynamic> transportKeys;
+
+  const _ProfileResult({
+    required this.profile,
+    required this.sent,
+    required this.received,
+    required this.putErrors,
+    required this.droppedSamples,
+    required this.msgsPerSec,
+    required this.elapsedMs,
+    this.avgLatencyMs,
+    this.p99LatencyMs,
+    required this.transportKeys,
+  });
+}
+
+class _SerializerResult {
+  final String name;
+  final int payloadBytes;
+  final double encodeMBps;
+  final double decodeMBps;
+
+  const _SerializerResult({
+    required this.name,
+    required this.payloadBytes,
+    required this.encodeMBps,
+    required this.decodeMBps,
+  });
+}
+
 class _HistogramData {
   final List<double> buckets;
   final List<Color> colors;
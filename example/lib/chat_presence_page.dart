@@ -12,7 +12,7 @@ import 'showcase_painters.dart';
 ///
 /// Demonstrates:
 /// - Liveliness + pub/sub + queryable combined in one page
-/// - declareLivelinessSubscriber(history: true) for presence
+/// - trackLiveliness() for presence: one coalesced delta per interval
 /// - livelinessGet() for on-demand refresh of online users
 /// - Queryable serving message history via replyJson()
 /// - Attachment metadata on messages (username, emoji)
@@ -54,7 +54,7 @@ class _ChatPresencePageState extends State<ChatPresencePage>
 
   // Presence
   ZenohLivelinessToken? _presenceToken;
-  ZenohLivelinessSubscriber? _presenceSub;
+  ZenohLivelinessTracker? _presenceTracker;
   final Map<String, _UserInfo> _onlineUsers = {};
 
   // Zenoh resources
@@ -97,7 +97,7 @@ class _ChatPresencePageState extends State<ChatPresencePage>
 
   void _disposeZenoh() {
     _presenceToken?.undeclare();
-    _presenceSub?.undeclare();
+    _presenceTracker?.close();
     _messageSub?.undeclare();
     _historyQueryable?.undeclare();
     _session?.close();
@@ -126,24 +126,22 @@ class _ChatPresencePageState extends State<ChatPresencePage>
         'chat/presence/$_username',
       );
 
-      // 2. Subscribe to presence with history
-      _presenceSub = await _session!.declareLivelinessSubscriber(
-        'chat/presence/**',
-        history: true,
-      );
-      _presenceSub!.stream.listen((event) {
+      // 2. Track presence natively; the first delta holds everyone online
+      _presenceTracker = await _session!.trackLiveliness('chat/presence/**');
+      _presenceTracker!.changes.listen((delta) {
         if (!mounted || _isDisposed) return;
-        final user = event.key.replaceFirst('chat/presence/', '');
         setState(() {
-          if (event.isAlive) {
+          for (final key in delta.joined) {
+            final user = key.replaceFirst('chat/presence/', '');
             _onlineUsers[user] = _UserInfo(
               name: user,
               emoji: _emojis[user.hashCode.abs() % _emojis.length],
               color: _colors[user.hashCode.abs() % _colors.length],
               joinedAt: DateTime.now(),
             );
-          } else {
-            _onlineUsers.remove(user);
+          }
+          for (final key in delta.left) {
+            _onlineUsers.remove(key.replaceFirst('chat/presence/', ''));
           }
         });
       });
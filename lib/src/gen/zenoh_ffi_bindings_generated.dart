@@ -39,6 +39,63 @@ class ZenohDartBindings {
   late final _zenoh_init_logger =
       _zenoh_init_loggerPtr.asFunction<int Function()>();
 
+  /// Size zenoh's runtime pools. The runtime reads its configuration once, so
+  /// this must run before the first session is opened; it fails with -2 after.
+  int zenoh_runtime_configure(
+    ffi.Pointer<ZenohRuntimeConfig> config,
+  ) {
+    return _zenoh_runtime_configure(
+      config,
+    );
+  }
+
+  late final _zenoh_runtime_configurePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohRuntimeConfig>)>>('zenoh_runtime_configure');
+  late final _zenoh_runtime_configure = _zenoh_runtime_configurePtr
+      .asFunction<int Function(ffi.Pointer<ZenohRuntimeConfig>)>();
+
+  /// Affinity and niceness for threads of kind. Delivery threads apply it before
+  /// their next callback and library threads when they start; threads that
+  /// also call put or get themselves are left alone. NULL stops applying a
+  /// policy, though threads keep what they already applied.
+  int zenoh_set_thread_policy(
+    int kind,
+    ffi.Pointer<ZenohThreadPolicy> policy,
+  ) {
+    return _zenoh_set_thread_policy(
+      kind,
+      policy,
+    );
+  }
+
+  late final _zenoh_set_thread_policyPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Int32,
+              ffi.Pointer<ZenohThreadPolicy>)>>('zenoh_set_thread_policy');
+  late final _zenoh_set_thread_policy = _zenoh_set_thread_policyPtr
+      .asFunction<int Function(int, ffi.Pointer<ZenohThreadPolicy>)>();
+
+  /// Fill one entry per live tracked thread plus one for exited workers, up to
+  /// max. Returns the number written.
+  int zenoh_thread_stats(
+    ffi.Pointer<ZenohThreadStats> stats,
+    int max,
+  ) {
+    return _zenoh_thread_stats(
+      stats,
+      max,
+    );
+  }
+
+  late final _zenoh_thread_statsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Size Function(
+              ffi.Pointer<ZenohThreadStats>, ffi.Size)>>('zenoh_thread_stats');
+  late final _zenoh_thread_stats = _zenoh_thread_statsPtr
+      .asFunction<int Function(ffi.Pointer<ZenohThreadStats>, int)>();
+
   /// ============================================================================
   /// Session Management
   /// ============================================================================
@@ -105,6 +162,439 @@ class ZenohDartBindings {
   late final _zenoh_session_info = _zenoh_session_infoPtr
       .asFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ZenohSession>)>();
 
+  void zenoh_transport_tuning_default(
+    ffi.Pointer<ZenohTransportTuning> tuning,
+  ) {
+    return _zenoh_transport_tuning_default(
+      tuning,
+    );
+  }
+
+  late final _zenoh_transport_tuning_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohTransportTuning>)>>(
+      'zenoh_transport_tuning_default');
+  late final _zenoh_transport_tuning_default =
+      _zenoh_transport_tuning_defaultPtr
+          .asFunction<void Function(ffi.Pointer<ZenohTransportTuning>)>();
+
+  /// Apply tuning to config_json (NULL for the default config) through
+  /// zc_config_insert_json5. Returns the complete resulting config as JSON for
+  /// zenoh_open_session_with_config, or NULL when a value is rejected. When
+  /// applied is not NULL it receives a JSON object of every key written and the
+  /// value zenoh stored, or on rejection the rejected key (NULL when the config
+  /// itself failed to parse). Free both with zenoh_free_string.
+  ffi.Pointer<ffi.Char> zenoh_config_tune(
+    ffi.Pointer<ffi.Char> config_json,
+    ffi.Pointer<ZenohTransportTuning> tuning,
+    ffi.Pointer<ffi.Pointer<ffi.Char>> applied,
+  ) {
+    return _zenoh_config_tune(
+      config_json,
+      tuning,
+      applied,
+    );
+  }
+
+  late final _zenoh_config_tunePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohTransportTuning>,
+              ffi.Pointer<ffi.Pointer<ffi.Char>>)>>('zenoh_config_tune');
+  late final _zenoh_config_tune = _zenoh_config_tunePtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ZenohTransportTuning>,
+          ffi.Pointer<ffi.Pointer<ffi.Char>>)>();
+
+  /// Copy the session's counters. Counters are updated lock-free on the hot
+  /// path; a snapshot costs one pass over the session's live entities.
+  int zenoh_session_stats_snapshot(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ZenohSessionStats> stats,
+  ) {
+    return _zenoh_session_stats_snapshot(
+      session,
+      stats,
+    );
+  }
+
+  late final _zenoh_session_stats_snapshotPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ZenohSessionStats>)>>('zenoh_session_stats_snapshot');
+  late final _zenoh_session_stats_snapshot =
+      _zenoh_session_stats_snapshotPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohSession>, ffi.Pointer<ZenohSessionStats>)>();
+
+  /// Counters of a single entity. Fails for entities that are not tracked.
+  int zenoh_publisher_stats_snapshot(
+    ffi.Pointer<ZenohPublisher> publisher,
+    ffi.Pointer<ZenohSessionStats> stats,
+  ) {
+    return _zenoh_publisher_stats_snapshot(
+      publisher,
+      stats,
+    );
+  }
+
+  late final _zenoh_publisher_stats_snapshotPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int Function(ffi.Pointer<ZenohPublisher>,
+                  ffi.Pointer<ZenohSessionStats>)>>(
+      'zenoh_publisher_stats_snapshot');
+  late final _zenoh_publisher_stats_snapshot =
+      _zenoh_publisher_stats_snapshotPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohPublisher>, ffi.Pointer<ZenohSessionStats>)>();
+
+  int zenoh_subscriber_stats_snapshot(
+    ffi.Pointer<ZenohSubscriber> subscriber,
+    ffi.Pointer<ZenohSessionStats> stats,
+  ) {
+    return _zenoh_subscriber_stats_snapshot(
+      subscriber,
+      stats,
+    );
+  }
+
+  late final _zenoh_subscriber_stats_snapshotPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int Function(ffi.Pointer<ZenohSubscriber>,
+                  ffi.Pointer<ZenohSessionStats>)>>(
+      'zenoh_subscriber_stats_snapshot');
+  late final _zenoh_subscriber_stats_snapshot =
+      _zenoh_subscriber_stats_snapshotPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohSubscriber>, ffi.Pointer<ZenohSessionStats>)>();
+
+  int zenoh_queryable_stats_snapshot(
+    ffi.Pointer<ZenohQueryable> queryable,
+    ffi.Pointer<ZenohSessionStats> stats,
+  ) {
+    return _zenoh_queryable_stats_snapshot(
+      queryable,
+      stats,
+    );
+  }
+
+  late final _zenoh_queryable_stats_snapshotPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int Function(ffi.Pointer<ZenohQueryable>,
+                  ffi.Pointer<ZenohSessionStats>)>>(
+      'zenoh_queryable_stats_snapshot');
+  late final _zenoh_queryable_stats_snapshot =
+      _zenoh_queryable_stats_snapshotPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohQueryable>, ffi.Pointer<ZenohSessionStats>)>();
+
+  /// Open a session on a native worker thread. config_json may be NULL for the
+  /// default config. Returns 0 once the open is started; callback reports the
+  /// outcome exactly once.
+  int zenoh_open_session_async(
+    ffi.Pointer<ffi.Char> config_json,
+    ZenohSessionOpenCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_open_session_async(
+      config_json,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_open_session_asyncPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ffi.Char>, ZenohSessionOpenCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_open_session_async');
+  late final _zenoh_open_session_async =
+      _zenoh_open_session_asyncPtr.asFunction<
+          int Function(ffi.Pointer<ffi.Char>, ZenohSessionOpenCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Close a session without blocking the caller. The session must not be used
+  /// after this returns 0.
+  int zenoh_close_session_async(
+    ffi.Pointer<ZenohSession> session,
+    ZenohSessionCloseCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_close_session_async(
+      session,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_close_session_asyncPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSession>, ZenohSessionCloseCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_close_session_async');
+  late final _zenoh_close_session_async =
+      _zenoh_close_session_asyncPtr.asFunction<
+          int Function(ffi.Pointer<ZenohSession>, ZenohSessionCloseCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Open count sessions from the same config (NULL for the default), in
+  /// parallel. Fails unless every session opens. The members share zenoh's
+  /// process-wide runtime, so a group adds sessions (transports, links and
+  /// entity tables), not threads; size the runtime pools with
+  /// zenoh_runtime_configure. Blocks until every open has finished.
+  ffi.Pointer<ZenohSessionGroup> zenoh_session_group_open(
+    int count,
+    ffi.Pointer<ffi.Char> config_json,
+  ) {
+    return _zenoh_session_group_open(
+      count,
+      config_json,
+    );
+  }
+
+  late final _zenoh_session_group_openPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohSessionGroup> Function(
+              ffi.Size, ffi.Pointer<ffi.Char>)>>('zenoh_session_group_open');
+  late final _zenoh_session_group_open =
+      _zenoh_session_group_openPtr.asFunction<
+          ffi.Pointer<ZenohSessionGroup> Function(
+              int, ffi.Pointer<ffi.Char>)>();
+
+  /// zenoh_session_group_open on a native worker thread. Returns 0 once the
+  /// open is started; callback reports the outcome exactly once.
+  int zenoh_session_group_open_async(
+    int count,
+    ffi.Pointer<ffi.Char> config_json,
+    ZenohSessionGroupOpenCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_session_group_open_async(
+      count,
+      config_json,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_session_group_open_asyncPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Size, ffi.Pointer<ffi.Char>,
+              ZenohSessionGroupOpenCallback, ffi.Pointer<ffi.Void>)>>(
+      'zenoh_session_group_open_async');
+  late final _zenoh_session_group_open_async =
+      _zenoh_session_group_open_asyncPtr.asFunction<
+          int Function(int, ffi.Pointer<ffi.Char>,
+              ZenohSessionGroupOpenCallback, ffi.Pointer<ffi.Void>)>();
+
+  int zenoh_session_group_size(
+    ffi.Pointer<ZenohSessionGroup> group,
+  ) {
+    return _zenoh_session_group_size(
+      group,
+    );
+  }
+
+  late final _zenoh_session_group_sizePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Size Function(
+              ffi.Pointer<ZenohSessionGroup>)>>('zenoh_session_group_size');
+  late final _zenoh_session_group_size = _zenoh_session_group_sizePtr
+      .asFunction<int Function(ffi.Pointer<ZenohSessionGroup>)>();
+
+  /// Borrow a member session. It is closed with the group, never on its own.
+  ffi.Pointer<ZenohSession> zenoh_session_group_session(
+    ffi.Pointer<ZenohSessionGroup> group,
+    int index,
+  ) {
+    return _zenoh_session_group_session(
+      group,
+      index,
+    );
+  }
+
+  late final _zenoh_session_group_sessionPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohSession> Function(ffi.Pointer<ZenohSessionGroup>,
+              ffi.Size)>>('zenoh_session_group_session');
+  late final _zenoh_session_group_session =
+      _zenoh_session_group_sessionPtr.asFunction<
+          ffi.Pointer<ZenohSession> Function(
+              ffi.Pointer<ZenohSessionGroup>, int)>();
+
+  /// Index of the session key hashes to
+  int zenoh_session_group_route(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ffi.Pointer<ffi.Char> key,
+  ) {
+    return _zenoh_session_group_route(
+      group,
+      key,
+    );
+  }
+
+  late final _zenoh_session_group_routePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSessionGroup>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_session_group_route');
+  late final _zenoh_session_group_route =
+      _zenoh_session_group_routePtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohSessionGroup>, ffi.Pointer<ffi.Char>)>();
+
+  /// Declare on the session picked by affinity (taken modulo the group size),
+  /// or by key hash when affinity is negative. opts may be NULL.
+  ffi.Pointer<ZenohPublisher> zenoh_session_group_declare_publisher(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ffi.Pointer<ffi.Char> key,
+    int affinity,
+    ffi.Pointer<ZenohPublisherOptions> opts,
+  ) {
+    return _zenoh_session_group_declare_publisher(
+      group,
+      key,
+      affinity,
+      opts,
+    );
+  }
+
+  late final _zenoh_session_group_declare_publisherPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Pointer<ZenohPublisher> Function(
+                  ffi.Pointer<ZenohSessionGroup>,
+                  ffi.Pointer<ffi.Char>,
+                  ffi.Int,
+                  ffi.Pointer<ZenohPublisherOptions>)>>(
+      'zenoh_session_group_declare_publisher');
+  late final _zenoh_session_group_declare_publisher =
+      _zenoh_session_group_declare_publisherPtr.asFunction<
+          ffi.Pointer<ZenohPublisher> Function(
+              ffi.Pointer<ZenohSessionGroup>,
+              ffi.Pointer<ffi.Char>,
+              int,
+              ffi.Pointer<ZenohPublisherOptions>)>();
+
+  ffi.Pointer<ZenohSubscriber> zenoh_session_group_declare_subscriber(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ffi.Pointer<ffi.Char> key,
+    int affinity,
+    ZenohSubscriberCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_session_group_declare_subscriber(
+      group,
+      key,
+      affinity,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_session_group_declare_subscriberPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Pointer<ZenohSubscriber> Function(
+                  ffi.Pointer<ZenohSessionGroup>,
+                  ffi.Pointer<ffi.Char>,
+                  ffi.Int,
+                  ZenohSubscriberCallback,
+                  ffi.Pointer<ffi.Void>)>>(
+      'zenoh_session_group_declare_subscriber');
+  late final _zenoh_session_group_declare_subscriber =
+      _zenoh_session_group_declare_subscriberPtr.asFunction<
+          ffi.Pointer<ZenohSubscriber> Function(
+              ffi.Pointer<ZenohSessionGroup>,
+              ffi.Pointer<ffi.Char>,
+              int,
+              ZenohSubscriberCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Fill one entry per session, up to max, with its live publishers and
+  /// subscribers however they were declared. Returns the number written.
+  int zenoh_session_group_stats(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ffi.Pointer<ZenohSessionGroupStats> stats,
+    int max,
+  ) {
+    return _zenoh_session_group_stats(
+      group,
+      stats,
+      max,
+    );
+  }
+
+  late final _zenoh_session_group_statsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Size Function(
+              ffi.Pointer<ZenohSessionGroup>,
+              ffi.Pointer<ZenohSessionGroupStats>,
+              ffi.Size)>>('zenoh_session_group_stats');
+  late final _zenoh_session_group_stats =
+      _zenoh_session_group_statsPtr.asFunction<
+          int Function(ffi.Pointer<ZenohSessionGroup>,
+              ffi.Pointer<ZenohSessionGroupStats>, int)>();
+
+  /// Sum of the member sessions' statistics
+  int zenoh_session_group_stats_snapshot(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ffi.Pointer<ZenohSessionStats> stats,
+  ) {
+    return _zenoh_session_group_stats_snapshot(
+      group,
+      stats,
+    );
+  }
+
+  late final _zenoh_session_group_stats_snapshotPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int Function(ffi.Pointer<ZenohSessionGroup>,
+                  ffi.Pointer<ZenohSessionStats>)>>(
+      'zenoh_session_group_stats_snapshot');
+  late final _zenoh_session_group_stats_snapshot =
+      _zenoh_session_group_stats_snapshotPtr.asFunction<
+          int Function(ffi.Pointer<ZenohSessionGroup>,
+              ffi.Pointer<ZenohSessionStats>)>();
+
+  /// Close every session in parallel, returning once all are closed. Entities
+  /// declared through the group must be undeclared first.
+  void zenoh_session_group_close(
+    ffi.Pointer<ZenohSessionGroup> group,
+  ) {
+    return _zenoh_session_group_close(
+      group,
+    );
+  }
+
+  late final _zenoh_session_group_closePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<ZenohSessionGroup>)>>('zenoh_session_group_close');
+  late final _zenoh_session_group_close = _zenoh_session_group_closePtr
+      .asFunction<void Function(ffi.Pointer<ZenohSessionGroup>)>();
+
+  /// zenoh_session_group_close on a native worker thread. The group must not be
+  /// used after this returns 0.
+  int zenoh_session_group_close_async(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ZenohSessionCloseCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_session_group_close_async(
+      group,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_session_group_close_asyncPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSessionGroup>,
+              ZenohSessionCloseCallback, ffi.Pointer<ffi.Void>)>>(
+      'zenoh_session_group_close_async');
+  late final _zenoh_session_group_close_async =
+      _zenoh_session_group_close_asyncPtr.asFunction<
+          int Function(ffi.Pointer<ZenohSessionGroup>,
+              ZenohSessionCloseCallback, ffi.Pointer<ffi.Void>)>();
+
   /// ============================================================================
   /// Publisher
   /// ============================================================================
@@ -222,6 +712,68 @@ class ZenohDartBindings {
   late final _zenoh_undeclare_publisher = _zenoh_undeclare_publisherPtr
       .asFunction<void Function(ffi.Pointer<ZenohPublisher>)>();
 
+  /// Declare count publishers in one call. keys holds count NUL-terminated key
+  /// expressions back to back. opts holds opts_count entries: none for the
+  /// defaults, one shared by every key, or one per key. The publishers live in
+  /// one contiguous block freed with the last of them. publishers[i] is NULL
+  /// where key i failed; returns the number declared.
+  int zenoh_declare_publishers_bulk(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> keys,
+    int count,
+    ffi.Pointer<ZenohPublisherOptions> opts,
+    int opts_count,
+    ffi.Pointer<ffi.Pointer<ZenohPublisher>> publishers,
+  ) {
+    return _zenoh_declare_publishers_bulk(
+      session,
+      keys,
+      count,
+      opts,
+      opts_count,
+      publishers,
+    );
+  }
+
+  late final _zenoh_declare_publishers_bulkPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Size Function(
+                  ffi.Pointer<ZenohSession>,
+                  ffi.Pointer<ffi.Char>,
+                  ffi.Size,
+                  ffi.Pointer<ZenohPublisherOptions>,
+                  ffi.Size,
+                  ffi.Pointer<ffi.Pointer<ZenohPublisher>>)>>(
+      'zenoh_declare_publishers_bulk');
+  late final _zenoh_declare_publishers_bulk =
+      _zenoh_declare_publishers_bulkPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              int,
+              ffi.Pointer<ZenohPublisherOptions>,
+              int,
+              ffi.Pointer<ffi.Pointer<ZenohPublisher>>)>();
+
+  /// Undeclare each non-NULL publisher, whether or not declared in bulk
+  void zenoh_undeclare_publishers_bulk(
+    ffi.Pointer<ffi.Pointer<ZenohPublisher>> publishers,
+    int count,
+  ) {
+    return _zenoh_undeclare_publishers_bulk(
+      publishers,
+      count,
+    );
+  }
+
+  late final _zenoh_undeclare_publishers_bulkPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ffi.Pointer<ZenohPublisher>>,
+              ffi.Size)>>('zenoh_undeclare_publishers_bulk');
+  late final _zenoh_undeclare_publishers_bulk =
+      _zenoh_undeclare_publishers_bulkPtr.asFunction<
+          void Function(ffi.Pointer<ffi.Pointer<ZenohPublisher>>, int)>();
+
   /// ============================================================================
   /// Subscriber
   /// ============================================================================
@@ -297,599 +849,3022 @@ class ZenohDartBindings {
   late final _zenoh_undeclare_subscriber = _zenoh_undeclare_subscriberPtr
       .asFunction<void Function(ffi.Pointer<ZenohSubscriber>)>();
 
-  /// ============================================================================
-  /// Queryable
-  /// ============================================================================
-  ffi.Pointer<ZenohQueryable> zenoh_declare_queryable(
+  /// Declare count subscribers sharing callback, with keys packed as for
+  /// zenoh_declare_publishers_bulk. Subscriber i gets contexts[i] (NULL when
+  /// contexts is NULL). Takes no options: like zenoh_declare_subscriber, every
+  /// subscriber uses the zenoh defaults.
+  int zenoh_declare_subscribers_bulk(
     ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key_expr,
-    ZenohQueryCallback callback,
-    ffi.Pointer<ffi.Void> context,
+    ffi.Pointer<ffi.Char> keys,
+    int count,
+    ZenohSubscriberCallback callback,
+    ffi.Pointer<ffi.Pointer<ffi.Void>> contexts,
+    ffi.Pointer<ffi.Pointer<ZenohSubscriber>> subscribers,
   ) {
-    return _zenoh_declare_queryable(
+    return _zenoh_declare_subscribers_bulk(
       session,
-      key_expr,
+      keys,
+      count,
       callback,
-      context,
+      contexts,
+      subscribers,
     );
   }
 
-  late final _zenoh_declare_queryablePtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Pointer<ZenohQueryable> Function(
+  late final _zenoh_declare_subscribers_bulkPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Size Function(
+                  ffi.Pointer<ZenohSession>,
+                  ffi.Pointer<ffi.Char>,
+                  ffi.Size,
+                  ZenohSubscriberCallback,
+                  ffi.Pointer<ffi.Pointer<ffi.Void>>,
+                  ffi.Pointer<ffi.Pointer<ZenohSubscriber>>)>>(
+      'zenoh_declare_subscribers_bulk');
+  late final _zenoh_declare_subscribers_bulk =
+      _zenoh_declare_subscribers_bulkPtr.asFunction<
+          int Function(
               ffi.Pointer<ZenohSession>,
               ffi.Pointer<ffi.Char>,
-              ZenohQueryCallback,
-              ffi.Pointer<ffi.Void>)>>('zenoh_declare_queryable');
-  late final _zenoh_declare_queryable = _zenoh_declare_queryablePtr.asFunction<
-      ffi.Pointer<ZenohQueryable> Function(ffi.Pointer<ZenohSession>,
-          ffi.Pointer<ffi.Char>, ZenohQueryCallback, ffi.Pointer<ffi.Void>)>();
+              int,
+              ZenohSubscriberCallback,
+              ffi.Pointer<ffi.Pointer<ffi.Void>>,
+              ffi.Pointer<ffi.Pointer<ZenohSubscriber>>)>();
 
-  void zenoh_undeclare_queryable(
-    ffi.Pointer<ZenohQueryable> queryable,
+  void zenoh_undeclare_subscribers_bulk(
+    ffi.Pointer<ffi.Pointer<ZenohSubscriber>> subscribers,
+    int count,
   ) {
-    return _zenoh_undeclare_queryable(
-      queryable,
+    return _zenoh_undeclare_subscribers_bulk(
+      subscribers,
+      count,
     );
   }
 
-  late final _zenoh_undeclare_queryablePtr = _lookup<
-          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohQueryable>)>>(
-      'zenoh_undeclare_queryable');
-  late final _zenoh_undeclare_queryable = _zenoh_undeclare_queryablePtr
-      .asFunction<void Function(ffi.Pointer<ZenohQueryable>)>();
+  late final _zenoh_undeclare_subscribers_bulkPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ffi.Pointer<ZenohSubscriber>>,
+              ffi.Size)>>('zenoh_undeclare_subscribers_bulk');
+  late final _zenoh_undeclare_subscribers_bulk =
+      _zenoh_undeclare_subscribers_bulkPtr.asFunction<
+          void Function(ffi.Pointer<ffi.Pointer<ZenohSubscriber>>, int)>();
 
-  void zenoh_query_reply(
-    ffi.Pointer<ffi.Void> reply_context,
-    ffi.Pointer<ffi.Char> key,
-    ffi.Pointer<ffi.Uint8> data,
-    int len,
+  /// Subscribes to key_expr and queries it. Samples are held back until the
+  /// query completes, then replies and held samples are delivered in timestamp
+  /// order without duplicates, on_ready is called, and live delivery resumes.
+  /// Returns NULL when the query cannot be sent. Held samples that do not fit
+  /// in memory count as dropped in the subscriber's stats.
+  ffi.Pointer<ZenohQueryingSubscriber> zenoh_declare_querying_subscriber(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ffi.Pointer<ZenohQueryingSubscriberOptions> options,
+    ZenohSubscriberCallbackEx callback,
+    ZenohGetCompleteCallback on_ready,
+    ffi.Pointer<ffi.Void> context,
   ) {
-    return _zenoh_query_reply(
-      reply_context,
-      key,
-      data,
-      len,
+    return _zenoh_declare_querying_subscriber(
+      session,
+      key_expr,
+      options,
+      callback,
+      on_ready,
+      context,
     );
   }
 
-  late final _zenoh_query_replyPtr = _lookup<
+  late final _zenoh_declare_querying_subscriberPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>,
-              ffi.Pointer<ffi.Uint8>, ffi.Size)>>('zenoh_query_reply');
-  late final _zenoh_query_reply = _zenoh_query_replyPtr.asFunction<
-      void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>,
-          ffi.Pointer<ffi.Uint8>, int)>();
+          ffi.Pointer<ZenohQueryingSubscriber> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohQueryingSubscriberOptions>,
+              ZenohSubscriberCallbackEx,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_querying_subscriber');
+  late final _zenoh_declare_querying_subscriber =
+      _zenoh_declare_querying_subscriberPtr.asFunction<
+          ffi.Pointer<ZenohQueryingSubscriber> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohQueryingSubscriberOptions>,
+              ZenohSubscriberCallbackEx,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>)>();
 
-  void zenoh_query_reply_with_options(
-    ffi.Pointer<ffi.Void> reply_context,
-    ffi.Pointer<ffi.Char> key,
-    ffi.Pointer<ffi.Uint8> data,
-    int len,
-    int encoding,
-    ffi.Pointer<ffi.Uint8> attachment,
-    int attachment_len,
+  void zenoh_undeclare_querying_subscriber(
+    ffi.Pointer<ZenohQueryingSubscriber> subscriber,
   ) {
-    return _zenoh_query_reply_with_options(
-      reply_context,
-      key,
-      data,
-      len,
-      encoding,
-      attachment,
-      attachment_len,
+    return _zenoh_undeclare_querying_subscriber(
+      subscriber,
     );
   }
 
-  late final _zenoh_query_reply_with_optionsPtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Void Function(
-              ffi.Pointer<ffi.Void>,
-              ffi.Pointer<ffi.Char>,
-              ffi.Pointer<ffi.Uint8>,
-              ffi.Size,
-              ffi.Int32,
-              ffi.Pointer<ffi.Uint8>,
-              ffi.Size)>>('zenoh_query_reply_with_options');
-  late final _zenoh_query_reply_with_options =
-      _zenoh_query_reply_with_optionsPtr.asFunction<
-          void Function(ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Char>,
-              ffi.Pointer<ffi.Uint8>, int, int, ffi.Pointer<ffi.Uint8>, int)>();
+  late final _zenoh_undeclare_querying_subscriberPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohQueryingSubscriber>)>>(
+      'zenoh_undeclare_querying_subscriber');
+  late final _zenoh_undeclare_querying_subscriber =
+      _zenoh_undeclare_querying_subscriberPtr
+          .asFunction<void Function(ffi.Pointer<ZenohQueryingSubscriber>)>();
 
-  /// ============================================================================
-  /// Ad-hoc Operations
-  /// ============================================================================
-  int zenoh_put(
-    ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key,
-    ffi.Pointer<ffi.Uint8> data,
-    int len,
+  int zenoh_querying_subscriber_stats_snapshot(
+    ffi.Pointer<ZenohQueryingSubscriber> subscriber,
+    ffi.Pointer<ZenohSessionStats> stats,
   ) {
-    return _zenoh_put(
-      session,
-      key,
-      data,
-      len,
+    return _zenoh_querying_subscriber_stats_snapshot(
+      subscriber,
+      stats,
     );
   }
 
-  late final _zenoh_putPtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
-              ffi.Pointer<ffi.Uint8>, ffi.Size)>>('zenoh_put');
-  late final _zenoh_put = _zenoh_putPtr.asFunction<
-      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
-          ffi.Pointer<ffi.Uint8>, int)>();
+  late final _zenoh_querying_subscriber_stats_snapshotPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int Function(ffi.Pointer<ZenohQueryingSubscriber>,
+                  ffi.Pointer<ZenohSessionStats>)>>(
+      'zenoh_querying_subscriber_stats_snapshot');
+  late final _zenoh_querying_subscriber_stats_snapshot =
+      _zenoh_querying_subscriber_stats_snapshotPtr.asFunction<
+          int Function(ffi.Pointer<ZenohQueryingSubscriber>,
+              ffi.Pointer<ZenohSessionStats>)>();
 
-  int zenoh_put_with_options(
+  /// Advanced subscribers need zenoh-c built with its unstable API
+  bool zenoh_advanced_subscriber_is_available() {
+    return _zenoh_advanced_subscriber_is_available();
+  }
+
+  late final _zenoh_advanced_subscriber_is_availablePtr =
+      _lookup<ffi.NativeFunction<ffi.Bool Function()>>(
+          'zenoh_advanced_subscriber_is_available');
+  late final _zenoh_advanced_subscriber_is_available =
+      _zenoh_advanced_subscriber_is_availablePtr.asFunction<bool Function()>();
+
+  /// Subscriber with history and lost-sample recovery from advanced publishers.
+  /// on_miss may be NULL. Returns NULL when unavailable.
+  ffi.Pointer<ZenohAdvancedSubscriber> zenoh_declare_advanced_subscriber(
     ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key,
-    ffi.Pointer<ffi.Uint8> data,
-    int len,
-    ffi.Pointer<ZenohPutOptions> options,
+    ffi.Pointer<ffi.Char> key_expr,
+    ffi.Pointer<ZenohAdvancedSubscriberOptions> options,
+    ZenohSubscriberCallbackEx callback,
+    ZenohSampleMissCallback on_miss,
+    ffi.Pointer<ffi.Void> context,
   ) {
-    return _zenoh_put_with_options(
+    return _zenoh_declare_advanced_subscriber(
       session,
-      key,
-      data,
-      len,
+      key_expr,
       options,
+      callback,
+      on_miss,
+      context,
     );
   }
 
-  late final _zenoh_put_with_optionsPtr = _lookup<
+  late final _zenoh_declare_advanced_subscriberPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Int Function(
+          ffi.Pointer<ZenohAdvancedSubscriber> Function(
               ffi.Pointer<ZenohSession>,
               ffi.Pointer<ffi.Char>,
-              ffi.Pointer<ffi.Uint8>,
-              ffi.Size,
-              ffi.Pointer<ZenohPutOptions>)>>('zenoh_put_with_options');
-  late final _zenoh_put_with_options = _zenoh_put_with_optionsPtr.asFunction<
-      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
-          ffi.Pointer<ffi.Uint8>, int, ffi.Pointer<ZenohPutOptions>)>();
+              ffi.Pointer<ZenohAdvancedSubscriberOptions>,
+              ZenohSubscriberCallbackEx,
+              ZenohSampleMissCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_advanced_subscriber');
+  late final _zenoh_declare_advanced_subscriber =
+      _zenoh_declare_advanced_subscriberPtr.asFunction<
+          ffi.Pointer<ZenohAdvancedSubscriber> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohAdvancedSubscriberOptions>,
+              ZenohSubscriberCallbackEx,
+              ZenohSampleMissCallback,
+              ffi.Pointer<ffi.Void>)>();
 
-  int zenoh_delete(
-    ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key,
+  void zenoh_undeclare_advanced_subscriber(
+    ffi.Pointer<ZenohAdvancedSubscriber> subscriber,
   ) {
-    return _zenoh_delete(
-      session,
-      key,
+    return _zenoh_undeclare_advanced_subscriber(
+      subscriber,
     );
   }
 
-  late final _zenoh_deletePtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Int Function(ffi.Pointer<ZenohSession>,
-              ffi.Pointer<ffi.Char>)>>('zenoh_delete');
-  late final _zenoh_delete = _zenoh_deletePtr.asFunction<
-      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>)>();
+  late final _zenoh_undeclare_advanced_subscriberPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohAdvancedSubscriber>)>>(
+      'zenoh_undeclare_advanced_subscriber');
+  late final _zenoh_undeclare_advanced_subscriber =
+      _zenoh_undeclare_advanced_subscriberPtr
+          .asFunction<void Function(ffi.Pointer<ZenohAdvancedSubscriber>)>();
 
-  /// ============================================================================
-  /// Query (Get)
-  /// ============================================================================
-  void zenoh_get_async(
-    ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> selector,
-    ZenohGetCallback callback,
-    ffi.Pointer<ffi.Void> context,
+  /// Returns false when zenoh-c was built without shared-memory support; all
+  /// other SHM functions then return NULL / -1.
+  bool zenoh_shm_is_available() {
+    return _zenoh_shm_is_available();
+  }
+
+  late final _zenoh_shm_is_availablePtr =
+      _lookup<ffi.NativeFunction<ffi.Bool Function()>>(
+          'zenoh_shm_is_available');
+  late final _zenoh_shm_is_available =
+      _zenoh_shm_is_availablePtr.asFunction<bool Function()>();
+
+  ffi.Pointer<ZenohShmProvider> zenoh_shm_provider_create(
+    int size,
   ) {
-    return _zenoh_get_async(
-      session,
-      selector,
-      callback,
-      context,
+    return _zenoh_shm_provider_create(
+      size,
     );
   }
 
-  late final _zenoh_get_asyncPtr = _lookup<
-      ffi.NativeFunction<
-          ffi.Void Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
-              ZenohGetCallback, ffi.Pointer<ffi.Void>)>>('zenoh_get_async');
-  late final _zenoh_get_async = _zenoh_get_asyncPtr.asFunction<
-      void Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
-          ZenohGetCallback, ffi.Pointer<ffi.Void>)>();
+  late final _zenoh_shm_provider_createPtr = _lookup<
+          ffi.NativeFunction<ffi.Pointer<ZenohShmProvider> Function(ffi.Size)>>(
+      'zenoh_shm_provider_create');
+  late final _zenoh_shm_provider_create = _zenoh_shm_provider_createPtr
+      .asFunction<ffi.Pointer<ZenohShmProvider> Function(int)>();
 
-  void zenoh_get_async_with_options(
-    ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> selector,
-    ZenohGetCallback callback,
-    ZenohGetCompleteCallback complete_callback,
-    ffi.Pointer<ffi.Void> context,
-    ffi.Pointer<ZenohGetOptions> options,
+  void zenoh_shm_provider_destroy(
+    ffi.Pointer<ZenohShmProvider> provider,
   ) {
-    return _zenoh_get_async_with_options(
-      session,
-      selector,
-      callback,
-      complete_callback,
-      context,
-      options,
+    return _zenoh_shm_provider_destroy(
+      provider,
     );
   }
 
-  late final _zenoh_get_async_with_optionsPtr = _lookup<
+  late final _zenoh_shm_provider_destroyPtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohShmProvider>)>>(
+      'zenoh_shm_provider_destroy');
+  late final _zenoh_shm_provider_destroy = _zenoh_shm_provider_destroyPtr
+      .asFunction<void Function(ffi.Pointer<ZenohShmProvider>)>();
+
+  ffi.Pointer<ZenohShmBuffer> zenoh_shm_alloc(
+    ffi.Pointer<ZenohShmProvider> provider,
+    int len,
+  ) {
+    return _zenoh_shm_alloc(
+      provider,
+      len,
+    );
+  }
+
+  late final _zenoh_shm_allocPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Void Function(
-              ffi.Pointer<ZenohSession>,
-              ffi.Pointer<ffi.Char>,
-              ZenohGetCallback,
-              ZenohGetCompleteCallback,
-              ffi.Pointer<ffi.Void>,
-              ffi.Pointer<ZenohGetOptions>)>>('zenoh_get_async_with_options');
-  late final _zenoh_get_async_with_options =
-      _zenoh_get_async_with_optionsPtr.asFunction<
-          void Function(
-              ffi.Pointer<ZenohSession>,
-              ffi.Pointer<ffi.Char>,
-              ZenohGetCallback,
-              ZenohGetCompleteCallback,
-              ffi.Pointer<ffi.Void>,
-              ffi.Pointer<ZenohGetOptions>)>();
+          ffi.Pointer<ZenohShmBuffer> Function(
+              ffi.Pointer<ZenohShmProvider>, ffi.Size)>>('zenoh_shm_alloc');
+  late final _zenoh_shm_alloc = _zenoh_shm_allocPtr.asFunction<
+      ffi.Pointer<ZenohShmBuffer> Function(
+          ffi.Pointer<ZenohShmProvider>, int)>();
 
-  /// ============================================================================
-  /// Liveliness
-  /// ============================================================================
-  ffi.Pointer<ZenohLivelinessToken> zenoh_declare_liveliness_token(
-    ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key_expr,
+  ffi.Pointer<ffi.Uint8> zenoh_shm_buffer_data(
+    ffi.Pointer<ZenohShmBuffer> buffer,
   ) {
-    return _zenoh_declare_liveliness_token(
-      session,
-      key_expr,
+    return _zenoh_shm_buffer_data(
+      buffer,
     );
   }
 
-  late final _zenoh_declare_liveliness_tokenPtr = _lookup<
+  late final _zenoh_shm_buffer_dataPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Pointer<ZenohLivelinessToken> Function(ffi.Pointer<ZenohSession>,
-              ffi.Pointer<ffi.Char>)>>('zenoh_declare_liveliness_token');
-  late final _zenoh_declare_liveliness_token =
-      _zenoh_declare_liveliness_tokenPtr.asFunction<
-          ffi.Pointer<ZenohLivelinessToken> Function(
-              ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>)>();
+          ffi.Pointer<ffi.Uint8> Function(
+              ffi.Pointer<ZenohShmBuffer>)>>('zenoh_shm_buffer_data');
+  late final _zenoh_shm_buffer_data = _zenoh_shm_buffer_dataPtr.asFunction<
+      ffi.Pointer<ffi.Uint8> Function(ffi.Pointer<ZenohShmBuffer>)>();
 
-  void zenoh_undeclare_liveliness_token(
-    ffi.Pointer<ZenohLivelinessToken> token,
+  int zenoh_shm_buffer_len(
+    ffi.Pointer<ZenohShmBuffer> buffer,
   ) {
-    return _zenoh_undeclare_liveliness_token(
-      token,
+    return _zenoh_shm_buffer_len(
+      buffer,
     );
   }
 
-  late final _zenoh_undeclare_liveliness_tokenPtr = _lookup<
-          ffi.NativeFunction<
-              ffi.Void Function(ffi.Pointer<ZenohLivelinessToken>)>>(
-      'zenoh_undeclare_liveliness_token');
-  late final _zenoh_undeclare_liveliness_token =
-      _zenoh_undeclare_liveliness_tokenPtr
-          .asFunction<void Function(ffi.Pointer<ZenohLivelinessToken>)>();
+  late final _zenoh_shm_buffer_lenPtr = _lookup<
+          ffi.NativeFunction<ffi.Size Function(ffi.Pointer<ZenohShmBuffer>)>>(
+      'zenoh_shm_buffer_len');
+  late final _zenoh_shm_buffer_len = _zenoh_shm_buffer_lenPtr
+      .asFunction<int Function(ffi.Pointer<ZenohShmBuffer>)>();
 
-  ffi.Pointer<ZenohSubscriber> zenoh_declare_liveliness_subscriber(
+  void zenoh_shm_buffer_free(
+    ffi.Pointer<ZenohShmBuffer> buffer,
+  ) {
+    return _zenoh_shm_buffer_free(
+      buffer,
+    );
+  }
+
+  late final _zenoh_shm_buffer_freePtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohShmBuffer>)>>(
+      'zenoh_shm_buffer_free');
+  late final _zenoh_shm_buffer_free = _zenoh_shm_buffer_freePtr
+      .asFunction<void Function(ffi.Pointer<ZenohShmBuffer>)>();
+
+  /// Publishes the buffer without copying. Takes ownership of buffer.
+  int zenoh_publisher_put_shm(
+    ffi.Pointer<ZenohPublisher> publisher,
+    ffi.Pointer<ZenohShmBuffer> buffer,
+  ) {
+    return _zenoh_publisher_put_shm(
+      publisher,
+      buffer,
+    );
+  }
+
+  late final _zenoh_publisher_put_shmPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohPublisher>,
+              ffi.Pointer<ZenohShmBuffer>)>>('zenoh_publisher_put_shm');
+  late final _zenoh_publisher_put_shm = _zenoh_publisher_put_shmPtr.asFunction<
+      int Function(ffi.Pointer<ZenohPublisher>, ffi.Pointer<ZenohShmBuffer>)>();
+
+  ffi.Pointer<ZenohSubscriber> zenoh_declare_subscriber_shm(
     ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key_expr,
-    ZenohLivelinessCallback callback,
+    ffi.Pointer<ffi.Char> key,
+    ZenohSubscriberShmCallback callback,
     ffi.Pointer<ffi.Void> context,
-    bool history,
   ) {
-    return _zenoh_declare_liveliness_subscriber(
+    return _zenoh_declare_subscriber_shm(
       session,
-      key_expr,
+      key,
       callback,
       context,
-      history,
     );
   }
 
-  late final _zenoh_declare_liveliness_subscriberPtr = _lookup<
+  late final _zenoh_declare_subscriber_shmPtr = _lookup<
       ffi.NativeFunction<
           ffi.Pointer<ZenohSubscriber> Function(
               ffi.Pointer<ZenohSession>,
               ffi.Pointer<ffi.Char>,
-              ZenohLivelinessCallback,
-              ffi.Pointer<ffi.Void>,
-              ffi.Bool)>>('zenoh_declare_liveliness_subscriber');
-  late final _zenoh_declare_liveliness_subscriber =
-      _zenoh_declare_liveliness_subscriberPtr.asFunction<
+              ZenohSubscriberShmCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_subscriber_shm');
+  late final _zenoh_declare_subscriber_shm =
+      _zenoh_declare_subscriber_shmPtr.asFunction<
           ffi.Pointer<ZenohSubscriber> Function(
               ffi.Pointer<ZenohSession>,
               ffi.Pointer<ffi.Char>,
-              ZenohLivelinessCallback,
-              ffi.Pointer<ffi.Void>,
-              bool)>();
+              ZenohSubscriberShmCallback,
+              ffi.Pointer<ffi.Void>)>();
 
-  void zenoh_liveliness_get(
-    ffi.Pointer<ZenohSession> session,
-    ffi.Pointer<ffi.Char> key_expr,
-    ZenohLivelinessCallback callback,
+  /// Splits data into chunks of chunk_size bytes (0 = 64 KiB), each prefixed
+  /// with a header carrying the transfer id, index, count and CRC-32, and
+  /// publishes them back to back. Chunks borrow slices of data rather than
+  /// copying it: with release set, ownership of data passes to the call and
+  /// release(data) runs once zenoh has dropped the last chunk (also on
+  /// failure); with release NULL, data is copied once. Returns the number of
+  /// chunks sent or < 0.
+  int zenoh_publisher_put_chunked(
+    ffi.Pointer<ZenohPublisher> publisher,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    int chunk_size,
+    ffi.Pointer<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>>
+        release,
+    ffi.Pointer<ffi.Uint64> transfer_id,
+  ) {
+    return _zenoh_publisher_put_chunked(
+      publisher,
+      data,
+      len,
+      chunk_size,
+      release,
+      transfer_id,
+    );
+  }
+
+  late final _zenoh_publisher_put_chunkedPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohPublisher>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Size,
+              ffi.Pointer<
+                  ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>>,
+              ffi.Pointer<ffi.Uint64>)>>('zenoh_publisher_put_chunked');
+  late final _zenoh_publisher_put_chunked =
+      _zenoh_publisher_put_chunkedPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohPublisher>,
+              ffi.Pointer<ffi.Uint8>,
+              int,
+              int,
+              ffi.Pointer<
+                  ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>>,
+              ffi.Pointer<ffi.Uint64>)>();
+
+  /// Same as zenoh_publisher_put_chunked, but the chunks are published on a
+  /// native worker thread and callback reports the outcome, so the caller is
+  /// free to prepare the next object meanwhile. Returns < 0 if the put could
+  /// not be started; callback is not called then.
+  int zenoh_publisher_put_chunked_async(
+    ffi.Pointer<ZenohPublisher> publisher,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    int chunk_size,
+    ffi.Pointer<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>>
+        release,
+    ZenohChunkedPutCallback callback,
     ffi.Pointer<ffi.Void> context,
-    int timeout_ms,
   ) {
-    return _zenoh_liveliness_get(
-      session,
-      key_expr,
+    return _zenoh_publisher_put_chunked_async(
+      publisher,
+      data,
+      len,
+      chunk_size,
+      release,
       callback,
       context,
-      timeout_ms,
     );
   }
 
-  late final _zenoh_liveliness_getPtr = _lookup<
+  late final _zenoh_publisher_put_chunked_asyncPtr = _lookup<
       ffi.NativeFunction<
-          ffi.Void Function(
+          ffi.Int Function(
+              ffi.Pointer<ZenohPublisher>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Size,
+              ffi.Pointer<
+                  ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>>,
+              ZenohChunkedPutCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_publisher_put_chunked_async');
+  late final _zenoh_publisher_put_chunked_async =
+      _zenoh_publisher_put_chunked_asyncPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohPublisher>,
+              ffi.Pointer<ffi.Uint8>,
+              int,
+              int,
+              ffi.Pointer<
+                  ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Void>)>>,
+              ZenohChunkedPutCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Reassembles chunked transfers into a preallocated buffer and only delivers
+  /// complete objects. Plain (non-chunked) samples are delivered as-is with
+  /// transfer id 0. Objects larger than max_object_size (0 = unlimited) are
+  /// rejected, and transfers idle for timeout_ms (0 = 30 s) are discarded.
+  ffi.Pointer<ZenohSubscriber> zenoh_declare_chunked_subscriber(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key,
+    ZenohChunkedCallback callback,
+    ZenohChunkProgressCallback progress_callback,
+    int max_object_size,
+    int timeout_ms,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_declare_chunked_subscriber(
+      session,
+      key,
+      callback,
+      progress_callback,
+      max_object_size,
+      timeout_ms,
+      context,
+    );
+  }
+
+  late final _zenoh_declare_chunked_subscriberPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohSubscriber> Function(
               ffi.Pointer<ZenohSession>,
               ffi.Pointer<ffi.Char>,
-              ZenohLivelinessCallback,
-              ffi.Pointer<ffi.Void>,
-              ffi.Uint64)>>('zenoh_liveliness_get');
-  late final _zenoh_liveliness_get = _zenoh_liveliness_getPtr.asFunction<
-      void Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
-          ZenohLivelinessCallback, ffi.Pointer<ffi.Void>, int)>();
+              ZenohChunkedCallback,
+              ZenohChunkProgressCallback,
+              ffi.Size,
+              ffi.Uint64,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_chunked_subscriber');
+  late final _zenoh_declare_chunked_subscriber =
+      _zenoh_declare_chunked_subscriberPtr.asFunction<
+          ffi.Pointer<ZenohSubscriber> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohChunkedCallback,
+              ZenohChunkProgressCallback,
+              int,
+              int,
+              ffi.Pointer<ffi.Void>)>();
 
   /// ============================================================================
-  /// Scouting
+  /// Queryable
   /// ============================================================================
-  void zenoh_scout(
-    ffi.Pointer<ffi.Char> what,
-    ffi.Pointer<ffi.Char> config,
-    ffi.Pointer<
-            ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char> info)>>
-        callback,
+  ffi.Pointer<ZenohQueryable> zenoh_declare_queryable(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ZenohQueryCallback callback,
+    ffi.Pointer<ffi.Void> context,
   ) {
-    return _zenoh_scout(
-      what,
-      config,
+    return _zenoh_declare_queryable(
+      session,
+      key_expr,
       callback,
+      context,
     );
   }
 
-  late final _zenoh_scoutPtr = _lookup<
+  late final _zenoh_declare_queryablePtr = _lookup<
       ffi.NativeFunction<
-          ffi.Void Function(
-              ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ZenohQueryable> Function(
+              ffi.Pointer<ZenohSession>,
               ffi.Pointer<ffi.Char>,
-              ffi.Pointer<
-                  ffi.NativeFunction<
-                      ffi.Void Function(
-                          ffi.Pointer<ffi.Char> info)>>)>>('zenoh_scout');
-  late final _zenoh_scout = _zenoh_scoutPtr.asFunction<
-      void Function(
-          ffi.Pointer<ffi.Char>,
-          ffi.Pointer<ffi.Char>,
-          ffi.Pointer<
-              ffi.NativeFunction<
-                  ffi.Void Function(ffi.Pointer<ffi.Char> info)>>)>();
+              ZenohQueryCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_queryable');
+  late final _zenoh_declare_queryable = _zenoh_declare_queryablePtr.asFunction<
+      ffi.Pointer<ZenohQueryable> Function(ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Char>, ZenohQueryCallback, ffi.Pointer<ffi.Void>)>();
 
-  /// ============================================================================
-  /// Helpers
-  /// ============================================================================
-  void zenoh_free_string(
-    ffi.Pointer<ffi.Char> str,
+  void zenoh_undeclare_queryable(
+    ffi.Pointer<ZenohQueryable> queryable,
   ) {
-    return _zenoh_free_string(
-      str,
+    return _zenoh_undeclare_queryable(
+      queryable,
     );
   }
 
-  late final _zenoh_free_stringPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
-          'zenoh_free_string');
-  late final _zenoh_free_string =
-      _zenoh_free_stringPtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+  late final _zenoh_undeclare_queryablePtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohQueryable>)>>(
+      'zenoh_undeclare_queryable');
+  late final _zenoh_undeclare_queryable = _zenoh_undeclare_queryablePtr
+      .asFunction<void Function(ffi.Pointer<ZenohQueryable>)>();
 
-  /// Default options initializers
-  void zenoh_publisher_options_default(
-    ffi.Pointer<ZenohPublisherOptions> options,
+  int zenoh_query_reply(
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
   ) {
-    return _zenoh_publisher_options_default(
-      options,
+    return _zenoh_query_reply(
+      query,
+      key,
+      data,
+      len,
     );
   }
 
-  late final _zenoh_publisher_options_defaultPtr = _lookup<
-          ffi.NativeFunction<
-              ffi.Void Function(ffi.Pointer<ZenohPublisherOptions>)>>(
-      'zenoh_publisher_options_default');
-  late final _zenoh_publisher_options_default =
-      _zenoh_publisher_options_defaultPtr
-          .asFunction<void Function(ffi.Pointer<ZenohPublisherOptions>)>();
+  late final _zenoh_query_replyPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>, ffi.Size)>>('zenoh_query_reply');
+  late final _zenoh_query_reply = _zenoh_query_replyPtr.asFunction<
+      int Function(ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Uint8>, int)>();
 
-  void zenoh_put_options_default(
-    ffi.Pointer<ZenohPutOptions> options,
+  int zenoh_query_reply_with_options(
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    int encoding,
+    ffi.Pointer<ffi.Uint8> attachment,
+    int attachment_len,
   ) {
-    return _zenoh_put_options_default(
-      options,
+    return _zenoh_query_reply_with_options(
+      query,
+      key,
+      data,
+      len,
+      encoding,
+      attachment,
+      attachment_len,
     );
   }
 
-  late final _zenoh_put_options_defaultPtr = _lookup<
-          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohPutOptions>)>>(
-      'zenoh_put_options_default');
-  late final _zenoh_put_options_default = _zenoh_put_options_defaultPtr
-      .asFunction<void Function(ffi.Pointer<ZenohPutOptions>)>();
+  late final _zenoh_query_reply_with_optionsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohQuery>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Int32,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size)>>('zenoh_query_reply_with_options');
+  late final _zenoh_query_reply_with_options =
+      _zenoh_query_reply_with_optionsPtr.asFunction<
+          int Function(ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>, int, int, ffi.Pointer<ffi.Uint8>, int)>();
 
-  void zenoh_get_options_default(
-    ffi.Pointer<ZenohGetOptions> options,
+  /// Sends n replies in one call. Returns the number sent, or the error code of
+  /// the first reply that failed.
+  int zenoh_query_reply_batch(
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ZenohReplyItem> items,
+    int n,
   ) {
-    return _zenoh_get_options_default(
-      options,
+    return _zenoh_query_reply_batch(
+      query,
+      items,
+      n,
     );
   }
 
-  late final _zenoh_get_options_defaultPtr = _lookup<
-          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohGetOptions>)>>(
-      'zenoh_get_options_default');
-  late final _zenoh_get_options_default = _zenoh_get_options_defaultPtr
-      .asFunction<void Function(ffi.Pointer<ZenohGetOptions>)>();
+  late final _zenoh_query_reply_batchPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohQuery>, ffi.Pointer<ZenohReplyItem>,
+              ffi.Size)>>('zenoh_query_reply_batch');
+  late final _zenoh_query_reply_batch = _zenoh_query_reply_batchPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohQuery>, ffi.Pointer<ZenohReplyItem>, int)>();
 
-  /// Encoding helpers
-  ffi.Pointer<ffi.Char> zenoh_encoding_to_string(
+  int zenoh_query_reply_err(
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ffi.Uint8> payload,
+    int len,
     int encoding,
   ) {
-    return _zenoh_encoding_to_string(
+    return _zenoh_query_reply_err(
+      query,
+      payload,
+      len,
       encoding,
     );
   }
 
-  late final _zenoh_encoding_to_stringPtr =
-      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function(ffi.Int32)>>(
-          'zenoh_encoding_to_string');
-  late final _zenoh_encoding_to_string = _zenoh_encoding_to_stringPtr
-      .asFunction<ffi.Pointer<ffi.Char> Function(int)>();
+  late final _zenoh_query_reply_errPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Uint8>,
+              ffi.Size, ffi.Int32)>>('zenoh_query_reply_err');
+  late final _zenoh_query_reply_err = _zenoh_query_reply_errPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Uint8>, int, int)>();
+
+  int zenoh_query_reply_del(
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ffi.Char> key,
+  ) {
+    return _zenoh_query_reply_del(
+      query,
+      key,
+    );
+  }
+
+  late final _zenoh_query_reply_delPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohQuery>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_query_reply_del');
+  late final _zenoh_query_reply_del = _zenoh_query_reply_delPtr.asFunction<
+      int Function(ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Char>)>();
+
+  /// Value of selector parameter name (parameters are separated by ';' or '&'),
+  /// as a heap string to release with zenoh_free_string. Returns "" for a
+  /// parameter without a value and NULL if it is absent.
+  ffi.Pointer<ffi.Char> zenoh_query_param_get(
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ffi.Char> name,
+  ) {
+    return _zenoh_query_param_get(
+      query,
+      name,
+    );
+  }
+
+  late final _zenoh_query_param_getPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ZenohQuery>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_query_param_get');
+  late final _zenoh_query_param_get = _zenoh_query_param_getPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ZenohQuery>, ffi.Pointer<ffi.Char>)>();
+
+  /// Adds a reference, e.g. before handing the query to another thread
+  ffi.Pointer<ZenohQuery> zenoh_query_retain(
+    ffi.Pointer<ZenohQuery> query,
+  ) {
+    return _zenoh_query_retain(
+      query,
+    );
+  }
+
+  late final _zenoh_query_retainPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohQuery> Function(
+              ffi.Pointer<ZenohQuery>)>>('zenoh_query_retain');
+  late final _zenoh_query_retain = _zenoh_query_retainPtr
+      .asFunction<ffi.Pointer<ZenohQuery> Function(ffi.Pointer<ZenohQuery>)>();
+
+  /// Drops a reference; the last one finalizes the reply stream
+  void zenoh_query_finalize(
+    ffi.Pointer<ZenohQuery> query,
+  ) {
+    return _zenoh_query_finalize(
+      query,
+    );
+  }
+
+  late final _zenoh_query_finalizePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohQuery>)>>(
+          'zenoh_query_finalize');
+  late final _zenoh_query_finalize = _zenoh_query_finalizePtr
+      .asFunction<void Function(ffi.Pointer<ZenohQuery>)>();
+
+  /// ============================================================================
+  /// Ad-hoc Operations
+  /// ============================================================================
+  int zenoh_put(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+  ) {
+    return _zenoh_put(
+      session,
+      key,
+      data,
+      len,
+    );
+  }
+
+  late final _zenoh_putPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>, ffi.Size)>>('zenoh_put');
+  late final _zenoh_put = _zenoh_putPtr.asFunction<
+      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Uint8>, int)>();
+
+  int zenoh_put_with_options(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    ffi.Pointer<ZenohPutOptions> options,
+  ) {
+    return _zenoh_put_with_options(
+      session,
+      key,
+      data,
+      len,
+      options,
+    );
+  }
+
+  late final _zenoh_put_with_optionsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Pointer<ZenohPutOptions>)>>('zenoh_put_with_options');
+  late final _zenoh_put_with_options = _zenoh_put_with_optionsPtr.asFunction<
+      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Uint8>, int, ffi.Pointer<ZenohPutOptions>)>();
+
+  int zenoh_delete(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key,
+  ) {
+    return _zenoh_delete(
+      session,
+      key,
+    );
+  }
+
+  late final _zenoh_deletePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_delete');
+  late final _zenoh_delete = _zenoh_deletePtr.asFunction<
+      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>)>();
+
+  /// ============================================================================
+  /// Query (Get)
+  /// ============================================================================
+  /// The zenoh_get_async* calls return < 0 if the query could not be issued
+  /// (bad selector, out of memory); no callback is called then. Otherwise
+  /// completion is always reported, even if zenoh fails to send the query.
+  int zenoh_get_async(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> selector,
+    ZenohGetCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_get_async(
+      session,
+      selector,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_get_asyncPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
+              ZenohGetCallback, ffi.Pointer<ffi.Void>)>>('zenoh_get_async');
+  late final _zenoh_get_async = _zenoh_get_asyncPtr.asFunction<
+      int Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
+          ZenohGetCallback, ffi.Pointer<ffi.Void>)>();
+
+  int zenoh_get_async_with_options(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> selector,
+    ZenohGetCallback callback,
+    ZenohGetCompleteCallback complete_callback,
+    ffi.Pointer<ffi.Void> context,
+    ffi.Pointer<ZenohGetOptions> options,
+  ) {
+    return _zenoh_get_async_with_options(
+      session,
+      selector,
+      callback,
+      complete_callback,
+      context,
+      options,
+    );
+  }
+
+  late final _zenoh_get_async_with_optionsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohGetCallback,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>,
+              ffi.Pointer<ZenohGetOptions>)>>('zenoh_get_async_with_options');
+  late final _zenoh_get_async_with_options =
+      _zenoh_get_async_with_optionsPtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohGetCallback,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>,
+              ffi.Pointer<ZenohGetOptions>)>();
+
+  /// Like zenoh_get_async_with_options, but delivers error replies and the full
+  /// reply metadata
+  int zenoh_get_async_ex(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> selector,
+    ZenohGetCallbackEx callback,
+    ZenohGetCompleteCallback complete_callback,
+    ffi.Pointer<ffi.Void> context,
+    ffi.Pointer<ZenohGetOptions> options,
+  ) {
+    return _zenoh_get_async_ex(
+      session,
+      selector,
+      callback,
+      complete_callback,
+      context,
+      options,
+    );
+  }
+
+  late final _zenoh_get_async_exPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohGetCallbackEx,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>,
+              ffi.Pointer<ZenohGetOptions>)>>('zenoh_get_async_ex');
+  late final _zenoh_get_async_ex = _zenoh_get_async_exPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Char>,
+          ZenohGetCallbackEx,
+          ZenohGetCompleteCallback,
+          ffi.Pointer<ffi.Void>,
+          ffi.Pointer<ZenohGetOptions>)>();
+
+  /// Like zenoh_get_async_ex, reporting the cursor of the next page on
+  /// completion. options->limit and options->cursor are sent to storages as the
+  /// `_limit` and `_cursor` parameters and enforced again on the replies, which
+  /// are dropped before being copied. Cursors are exact when replies arrive in
+  /// key order, as they do from a single storage.
+  int zenoh_get_async_paged(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> selector,
+    ZenohGetCallbackEx callback,
+    ZenohGetPageCallback page_callback,
+    ffi.Pointer<ffi.Void> context,
+    ffi.Pointer<ZenohGetOptions> options,
+  ) {
+    return _zenoh_get_async_paged(
+      session,
+      selector,
+      callback,
+      page_callback,
+      context,
+      options,
+    );
+  }
+
+  late final _zenoh_get_async_pagedPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohGetCallbackEx,
+              ZenohGetPageCallback,
+              ffi.Pointer<ffi.Void>,
+              ffi.Pointer<ZenohGetOptions>)>>('zenoh_get_async_paged');
+  late final _zenoh_get_async_paged = _zenoh_get_async_pagedPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Char>,
+          ZenohGetCallbackEx,
+          ZenohGetPageCallback,
+          ffi.Pointer<ffi.Void>,
+          ffi.Pointer<ZenohGetOptions>)>();
+
+  /// Queries every selector with the same options and one shared deadline
+  /// (options->timeout_ms from the call). Replies carry the index of their
+  /// selector. complete_callback fires exactly once: when all queries are done,
+  /// or as soon as quorum data replies have been delivered (0 = wait for all).
+  /// Later replies are discarded.
+  void zenoh_get_multi(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Pointer<ffi.Char>> selectors,
+    int count,
+    ffi.Pointer<ZenohGetOptions> options,
+    int quorum,
+    ZenohGetMultiCallback callback,
+    ZenohGetCompleteCallback complete_callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_get_multi(
+      session,
+      selectors,
+      count,
+      options,
+      quorum,
+      callback,
+      complete_callback,
+      context,
+    );
+  }
+
+  late final _zenoh_get_multiPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Pointer<ffi.Char>>,
+              ffi.Size,
+              ffi.Pointer<ZenohGetOptions>,
+              ffi.Size,
+              ZenohGetMultiCallback,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_get_multi');
+  late final _zenoh_get_multi = _zenoh_get_multiPtr.asFunction<
+      void Function(
+          ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Pointer<ffi.Char>>,
+          int,
+          ffi.Pointer<ZenohGetOptions>,
+          int,
+          ZenohGetMultiCallback,
+          ZenohGetCompleteCallback,
+          ffi.Pointer<ffi.Void>)>();
+
+  /// Queries selector into a bounded channel of capacity replies (0 = 256) that
+  /// the caller drains at its own pace. A FIFO channel holds back zenoh when
+  /// full, a ring channel drops the oldest reply. Returns NULL on failure.
+  ffi.Pointer<ZenohReplyChannel> zenoh_get_channel(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> selector,
+    ffi.Pointer<ZenohGetOptions> options,
+    int kind,
+    int capacity,
+  ) {
+    return _zenoh_get_channel(
+      session,
+      selector,
+      options,
+      kind,
+      capacity,
+    );
+  }
+
+  late final _zenoh_get_channelPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohReplyChannel> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohGetOptions>,
+              ffi.Int32,
+              ffi.Size)>>('zenoh_get_channel');
+  late final _zenoh_get_channel = _zenoh_get_channelPtr.asFunction<
+      ffi.Pointer<ZenohReplyChannel> Function(ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ZenohGetOptions>, int, int)>();
+
+  /// Moves up to max (at most 64) queued replies into out without blocking.
+  /// Returns the number received, or -1 once all replies have been received.
+  int zenoh_reply_try_recv_batch(
+    ffi.Pointer<ZenohReplyChannel> channel,
+    ffi.Pointer<ZenohReplyRecord> out,
+    int max,
+  ) {
+    return _zenoh_reply_try_recv_batch(
+      channel,
+      out,
+      max,
+    );
+  }
+
+  late final _zenoh_reply_try_recv_batchPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohReplyChannel>,
+              ffi.Pointer<ZenohReplyRecord>,
+              ffi.Size)>>('zenoh_reply_try_recv_batch');
+  late final _zenoh_reply_try_recv_batch =
+      _zenoh_reply_try_recv_batchPtr.asFunction<
+          int Function(ffi.Pointer<ZenohReplyChannel>,
+              ffi.Pointer<ZenohReplyRecord>, int)>();
+
+  void zenoh_reply_channel_close(
+    ffi.Pointer<ZenohReplyChannel> channel,
+  ) {
+    return _zenoh_reply_channel_close(
+      channel,
+    );
+  }
+
+  late final _zenoh_reply_channel_closePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<ZenohReplyChannel>)>>('zenoh_reply_channel_close');
+  late final _zenoh_reply_channel_close = _zenoh_reply_channel_closePtr
+      .asFunction<void Function(ffi.Pointer<ZenohReplyChannel>)>();
+
+  /// Declares the key expression and query options once, so repeated queries on
+  /// the same key skip re-parsing and re-resolution.
+  ffi.Pointer<ZenohQuerier> zenoh_declare_querier(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ZenohQuerierOptions> options,
+  ) {
+    return _zenoh_declare_querier(
+      session,
+      key,
+      options,
+    );
+  }
+
+  late final _zenoh_declare_querierPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohQuerier> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohQuerierOptions>)>>('zenoh_declare_querier');
+  late final _zenoh_declare_querier = _zenoh_declare_querierPtr.asFunction<
+      ffi.Pointer<ZenohQuerier> Function(ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ZenohQuerierOptions>)>();
+
+  int zenoh_querier_get(
+    ffi.Pointer<ZenohQuerier> querier,
+    ffi.Pointer<ffi.Char> parameters,
+    ffi.Pointer<ffi.Uint8> payload,
+    int payload_len,
+    int encoding,
+    ffi.Pointer<ffi.Uint8> attachment,
+    int attachment_len,
+    ZenohGetCallback callback,
+    ZenohGetCompleteCallback complete_callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_querier_get(
+      querier,
+      parameters,
+      payload,
+      payload_len,
+      encoding,
+      attachment,
+      attachment_len,
+      callback,
+      complete_callback,
+      context,
+    );
+  }
+
+  late final _zenoh_querier_getPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohQuerier>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Int32,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ZenohGetCallback,
+              ZenohGetCompleteCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_querier_get');
+  late final _zenoh_querier_get = _zenoh_querier_getPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohQuerier>,
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Uint8>,
+          int,
+          int,
+          ffi.Pointer<ffi.Uint8>,
+          int,
+          ZenohGetCallback,
+          ZenohGetCompleteCallback,
+          ffi.Pointer<ffi.Void>)>();
+
+  /// Returns 1 if queryables currently match the querier, 0 if not, < 0 on error
+  int zenoh_querier_get_matching_status(
+    ffi.Pointer<ZenohQuerier> querier,
+  ) {
+    return _zenoh_querier_get_matching_status(
+      querier,
+    );
+  }
+
+  late final _zenoh_querier_get_matching_statusPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ZenohQuerier>)>>(
+          'zenoh_querier_get_matching_status');
+  late final _zenoh_querier_get_matching_status =
+      _zenoh_querier_get_matching_statusPtr
+          .asFunction<int Function(ffi.Pointer<ZenohQuerier>)>();
+
+  /// Installs (or replaces) the querier's matching-status listener
+  int zenoh_querier_declare_matching_listener(
+    ffi.Pointer<ZenohQuerier> querier,
+    ZenohMatchingCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_querier_declare_matching_listener(
+      querier,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_querier_declare_matching_listenerPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Int Function(ffi.Pointer<ZenohQuerier>, ZenohMatchingCallback,
+                  ffi.Pointer<ffi.Void>)>>(
+      'zenoh_querier_declare_matching_listener');
+  late final _zenoh_querier_declare_matching_listener =
+      _zenoh_querier_declare_matching_listenerPtr.asFunction<
+          int Function(ffi.Pointer<ZenohQuerier>, ZenohMatchingCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  void zenoh_undeclare_querier(
+    ffi.Pointer<ZenohQuerier> querier,
+  ) {
+    return _zenoh_undeclare_querier(
+      querier,
+    );
+  }
+
+  late final _zenoh_undeclare_querierPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohQuerier>)>>(
+          'zenoh_undeclare_querier');
+  late final _zenoh_undeclare_querier = _zenoh_undeclare_querierPtr
+      .asFunction<void Function(ffi.Pointer<ZenohQuerier>)>();
+
+  /// Declares a queryable on service_key that dispatches calls to the registered
+  /// methods. callback receives calls to methods without a native handler.
+  ffi.Pointer<ZenohRpcServer> zenoh_declare_rpc_server(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> service_key,
+    ZenohRpcRequestCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_declare_rpc_server(
+      session,
+      service_key,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_declare_rpc_serverPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohRpcServer> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohRpcRequestCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_rpc_server');
+  late final _zenoh_declare_rpc_server =
+      _zenoh_declare_rpc_serverPtr.asFunction<
+          ffi.Pointer<ZenohRpcServer> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohRpcRequestCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Registers or replaces method. A NULL handler forwards it to the server
+  /// callback.
+  int zenoh_rpc_server_register(
+    ffi.Pointer<ZenohRpcServer> server,
+    ffi.Pointer<ffi.Char> method,
+    ZenohRpcHandler handler,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_rpc_server_register(
+      server,
+      method,
+      handler,
+      context,
+    );
+  }
+
+  late final _zenoh_rpc_server_registerPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohRpcServer>,
+              ffi.Pointer<ffi.Char>,
+              ZenohRpcHandler,
+              ffi.Pointer<ffi.Void>)>>('zenoh_rpc_server_register');
+  late final _zenoh_rpc_server_register =
+      _zenoh_rpc_server_registerPtr.asFunction<
+          int Function(ffi.Pointer<ZenohRpcServer>, ffi.Pointer<ffi.Char>,
+              ZenohRpcHandler, ffi.Pointer<ffi.Void>)>();
+
+  int zenoh_rpc_server_unregister(
+    ffi.Pointer<ZenohRpcServer> server,
+    ffi.Pointer<ffi.Char> method,
+  ) {
+    return _zenoh_rpc_server_unregister(
+      server,
+      method,
+    );
+  }
+
+  late final _zenoh_rpc_server_unregisterPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohRpcServer>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_rpc_server_unregister');
+  late final _zenoh_rpc_server_unregister =
+      _zenoh_rpc_server_unregisterPtr.asFunction<
+          int Function(ffi.Pointer<ZenohRpcServer>, ffi.Pointer<ffi.Char>)>();
+
+  void zenoh_undeclare_rpc_server(
+    ffi.Pointer<ZenohRpcServer> server,
+  ) {
+    return _zenoh_undeclare_rpc_server(
+      server,
+    );
+  }
+
+  late final _zenoh_undeclare_rpc_serverPtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohRpcServer>)>>(
+      'zenoh_undeclare_rpc_server');
+  late final _zenoh_undeclare_rpc_server = _zenoh_undeclare_rpc_serverPtr
+      .asFunction<void Function(ffi.Pointer<ZenohRpcServer>)>();
+
+  /// Appends to a native handler's response
+  int zenoh_rpc_response_write(
+    ffi.Pointer<ZenohRpcResponse> response,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+  ) {
+    return _zenoh_rpc_response_write(
+      response,
+      data,
+      len,
+    );
+  }
+
+  late final _zenoh_rpc_response_writePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohRpcResponse>,
+              ffi.Pointer<ffi.Uint8>, ffi.Size)>>('zenoh_rpc_response_write');
+  late final _zenoh_rpc_response_write =
+      _zenoh_rpc_response_writePtr.asFunction<
+          int Function(
+              ffi.Pointer<ZenohRpcResponse>, ffi.Pointer<ffi.Uint8>, int)>();
+
+  /// Answers a forwarded call and releases query
+  int zenoh_rpc_respond(
+    ffi.Pointer<ZenohQuery> query,
+    int call_id,
+    int status,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+  ) {
+    return _zenoh_rpc_respond(
+      query,
+      call_id,
+      status,
+      data,
+      len,
+    );
+  }
+
+  late final _zenoh_rpc_respondPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohQuery>, ffi.Uint64, ffi.Int,
+              ffi.Pointer<ffi.Uint8>, ffi.Size)>>('zenoh_rpc_respond');
+  late final _zenoh_rpc_respond = _zenoh_rpc_respondPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohQuery>, int, int, ffi.Pointer<ffi.Uint8>, int)>();
+
+  /// Declares a querier on service_key. Calls share it and may be pipelined.
+  ffi.Pointer<ZenohRpcClient> zenoh_rpc_client_new(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> service_key,
+    ffi.Pointer<ZenohRpcClientOptions> options,
+  ) {
+    return _zenoh_rpc_client_new(
+      session,
+      service_key,
+      options,
+    );
+  }
+
+  late final _zenoh_rpc_client_newPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohRpcClient> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohRpcClientOptions>)>>('zenoh_rpc_client_new');
+  late final _zenoh_rpc_client_new = _zenoh_rpc_client_newPtr.asFunction<
+      ffi.Pointer<ZenohRpcClient> Function(ffi.Pointer<ZenohSession>,
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ZenohRpcClientOptions>)>();
+
+  /// Starts a call and returns its id (0 on failure). Attempts that get no reply
+  /// are retried up to retries times while deadline_ms (0 = none) has not
+  /// passed. callback reports the outcome.
+  int zenoh_rpc_call(
+    ffi.Pointer<ZenohRpcClient> client,
+    ffi.Pointer<ffi.Char> method,
+    ffi.Pointer<ffi.Uint8> request,
+    int len,
+    int deadline_ms,
+    int retries,
+    ZenohRpcResponseCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_rpc_call(
+      client,
+      method,
+      request,
+      len,
+      deadline_ms,
+      retries,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_rpc_callPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Uint64 Function(
+              ffi.Pointer<ZenohRpcClient>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Uint64,
+              ffi.Uint32,
+              ZenohRpcResponseCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_rpc_call');
+  late final _zenoh_rpc_call = _zenoh_rpc_callPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohRpcClient>,
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Uint8>,
+          int,
+          int,
+          int,
+          ZenohRpcResponseCallback,
+          ffi.Pointer<ffi.Void>)>();
+
+  /// In-flight calls still complete, without further retries
+  void zenoh_rpc_client_close(
+    ffi.Pointer<ZenohRpcClient> client,
+  ) {
+    return _zenoh_rpc_client_close(
+      client,
+    );
+  }
+
+  late final _zenoh_rpc_client_closePtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohRpcClient>)>>(
+      'zenoh_rpc_client_close');
+  late final _zenoh_rpc_client_close = _zenoh_rpc_client_closePtr
+      .asFunction<void Function(ffi.Pointer<ZenohRpcClient>)>();
+
+  /// Subscribes to key_expr, keeps the latest value of every key (last writer
+  /// wins on sample timestamps) and answers queries on key_expr natively.
+  /// Queries may restrict replies with a `_time=[start..end]` parameter.
+  /// on_change may be NULL.
+  ffi.Pointer<ZenohStorage> zenoh_declare_memory_storage(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ffi.Pointer<ZenohStorageOptions> options,
+    ZenohStorageChangeCallback on_change,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_declare_memory_storage(
+      session,
+      key_expr,
+      options,
+      on_change,
+      context,
+    );
+  }
+
+  late final _zenoh_declare_memory_storagePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohStorage> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohStorageOptions>,
+              ZenohStorageChangeCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_memory_storage');
+  late final _zenoh_declare_memory_storage =
+      _zenoh_declare_memory_storagePtr.asFunction<
+          ffi.Pointer<ZenohStorage> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohStorageOptions>,
+              ZenohStorageChangeCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Same as zenoh_declare_memory_storage, persisting to an open log store. The
+  /// storage holds its own reference to store.
+  ffi.Pointer<ZenohStorage> zenoh_declare_log_storage(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ffi.Pointer<ZenohLogStore> store,
+    ffi.Pointer<ZenohStorageOptions> options,
+    ZenohStorageChangeCallback on_change,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_declare_log_storage(
+      session,
+      key_expr,
+      store,
+      options,
+      on_change,
+      context,
+    );
+  }
+
+  late final _zenoh_declare_log_storagePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohStorage> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohLogStore>,
+              ffi.Pointer<ZenohStorageOptions>,
+              ZenohStorageChangeCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_declare_log_storage');
+  late final _zenoh_declare_log_storage =
+      _zenoh_declare_log_storagePtr.asFunction<
+          ffi.Pointer<ZenohStorage> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohLogStore>,
+              ffi.Pointer<ZenohStorageOptions>,
+              ZenohStorageChangeCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// Copies the value of key into a heap buffer (release it with
+  /// zenoh_free_string). Returns 1 if found, 0 if not, < 0 on error.
+  int zenoh_storage_get(
+    ffi.Pointer<ZenohStorage> storage,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Pointer<ffi.Uint8>> data,
+    ffi.Pointer<ffi.Size> len,
+  ) {
+    return _zenoh_storage_get(
+      storage,
+      key,
+      data,
+      len,
+    );
+  }
+
+  late final _zenoh_storage_getPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohStorage>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Pointer<ffi.Uint8>>,
+              ffi.Pointer<ffi.Size>)>>('zenoh_storage_get');
+  late final _zenoh_storage_get = _zenoh_storage_getPtr.asFunction<
+      int Function(ffi.Pointer<ZenohStorage>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Pointer<ffi.Uint8>>, ffi.Pointer<ffi.Size>)>();
+
+  int zenoh_storage_stats(
+    ffi.Pointer<ZenohStorage> storage,
+    ffi.Pointer<ZenohStorageStats> stats,
+  ) {
+    return _zenoh_storage_stats(
+      storage,
+      stats,
+    );
+  }
+
+  late final _zenoh_storage_statsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohStorage>,
+              ffi.Pointer<ZenohStorageStats>)>>('zenoh_storage_stats');
+  late final _zenoh_storage_stats = _zenoh_storage_statsPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohStorage>, ffi.Pointer<ZenohStorageStats>)>();
+
+  void zenoh_undeclare_storage(
+    ffi.Pointer<ZenohStorage> storage,
+  ) {
+    return _zenoh_undeclare_storage(
+      storage,
+    );
+  }
+
+  late final _zenoh_undeclare_storagePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohStorage>)>>(
+          'zenoh_undeclare_storage');
+  late final _zenoh_undeclare_storage = _zenoh_undeclare_storagePtr
+      .asFunction<void Function(ffi.Pointer<ZenohStorage>)>();
+
+  /// Opens (creating if needed) a log-structured store in directory path.
+  /// Segments are memory-mapped and the key index is rebuilt from the last
+  /// index snapshot plus the records written after it.
+  ffi.Pointer<ZenohLogStore> zenoh_log_store_open(
+    ffi.Pointer<ffi.Char> path,
+    ffi.Pointer<ZenohLogStoreOptions> options,
+  ) {
+    return _zenoh_log_store_open(
+      path,
+      options,
+    );
+  }
+
+  late final _zenoh_log_store_openPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohLogStore> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ZenohLogStoreOptions>)>>('zenoh_log_store_open');
+  late final _zenoh_log_store_open = _zenoh_log_store_openPtr.asFunction<
+      ffi.Pointer<ZenohLogStore> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ZenohLogStoreOptions>)>();
+
+  /// Writes the index snapshot and releases the handle. Storages declared on
+  /// the store keep it open until they are undeclared.
+  void zenoh_log_store_close(
+    ffi.Pointer<ZenohLogStore> store,
+  ) {
+    return _zenoh_log_store_close(
+      store,
+    );
+  }
+
+  late final _zenoh_log_store_closePtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohLogStore>)>>(
+      'zenoh_log_store_close');
+  late final _zenoh_log_store_close = _zenoh_log_store_closePtr
+      .asFunction<void Function(ffi.Pointer<ZenohLogStore>)>();
+
+  int zenoh_log_store_put(
+    ffi.Pointer<ZenohLogStore> store,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    int encoding,
+  ) {
+    return _zenoh_log_store_put(
+      store,
+      key,
+      data,
+      len,
+      encoding,
+    );
+  }
+
+  late final _zenoh_log_store_putPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohLogStore>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Size,
+              ffi.Int32)>>('zenoh_log_store_put');
+  late final _zenoh_log_store_put = _zenoh_log_store_putPtr.asFunction<
+      int Function(ffi.Pointer<ZenohLogStore>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Uint8>, int, int)>();
+
+  int zenoh_log_store_delete(
+    ffi.Pointer<ZenohLogStore> store,
+    ffi.Pointer<ffi.Char> key,
+  ) {
+    return _zenoh_log_store_delete(
+      store,
+      key,
+    );
+  }
+
+  late final _zenoh_log_store_deletePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohLogStore>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_log_store_delete');
+  late final _zenoh_log_store_delete = _zenoh_log_store_deletePtr.asFunction<
+      int Function(ffi.Pointer<ZenohLogStore>, ffi.Pointer<ffi.Char>)>();
+
+  /// Copies the value of key into a heap buffer (release it with
+  /// zenoh_free_string). Returns 1 if found, 0 if not, < 0 on error.
+  int zenoh_log_store_get(
+    ffi.Pointer<ZenohLogStore> store,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Pointer<ffi.Uint8>> data,
+    ffi.Pointer<ffi.Size> len,
+  ) {
+    return _zenoh_log_store_get(
+      store,
+      key,
+      data,
+      len,
+    );
+  }
+
+  late final _zenoh_log_store_getPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohLogStore>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Pointer<ffi.Uint8>>,
+              ffi.Pointer<ffi.Size>)>>('zenoh_log_store_get');
+  late final _zenoh_log_store_get = _zenoh_log_store_getPtr.asFunction<
+      int Function(ffi.Pointer<ZenohLogStore>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Pointer<ffi.Uint8>>, ffi.Pointer<ffi.Size>)>();
+
+  int zenoh_log_store_stats(
+    ffi.Pointer<ZenohLogStore> store,
+    ffi.Pointer<ZenohLogStoreStats> stats,
+  ) {
+    return _zenoh_log_store_stats(
+      store,
+      stats,
+    );
+  }
+
+  late final _zenoh_log_store_statsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohLogStore>,
+              ffi.Pointer<ZenohLogStoreStats>)>>('zenoh_log_store_stats');
+  late final _zenoh_log_store_stats = _zenoh_log_store_statsPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohLogStore>, ffi.Pointer<ZenohLogStoreStats>)>();
+
+  /// Rewrites every sealed segment now. Returns the number reclaimed.
+  int zenoh_log_store_compact(
+    ffi.Pointer<ZenohLogStore> store,
+  ) {
+    return _zenoh_log_store_compact(
+      store,
+    );
+  }
+
+  late final _zenoh_log_store_compactPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ZenohLogStore>)>>(
+          'zenoh_log_store_compact');
+  late final _zenoh_log_store_compact = _zenoh_log_store_compactPtr
+      .asFunction<int Function(ffi.Pointer<ZenohLogStore>)>();
+
+  /// Syncs segments to disk and writes the index snapshot
+  int zenoh_log_store_flush(
+    ffi.Pointer<ZenohLogStore> store,
+  ) {
+    return _zenoh_log_store_flush(
+      store,
+    );
+  }
+
+  late final _zenoh_log_store_flushPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ZenohLogStore>)>>(
+          'zenoh_log_store_flush');
+  late final _zenoh_log_store_flush = _zenoh_log_store_flushPtr
+      .asFunction<int Function(ffi.Pointer<ZenohLogStore>)>();
+
+  /// Subscribes to key_expr and keeps a ring of (time, value) points per key.
+  /// Queries select points with `_time=[start..end]` and may downsample with
+  /// `step=1s&agg=min|max|avg|last`. Each reply carries one key's points as
+  /// packed little-endian (u64 NTP64 time, f64 value) pairs.
+  ffi.Pointer<ZenohTimeSeries> zenoh_declare_timeseries(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ffi.Pointer<ZenohTimeSeriesOptions> options,
+  ) {
+    return _zenoh_declare_timeseries(
+      session,
+      key_expr,
+      options,
+    );
+  }
+
+  late final _zenoh_declare_timeseriesPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Pointer<ZenohTimeSeries> Function(ffi.Pointer<ZenohSession>,
+                  ffi.Pointer<ffi.Char>, ffi.Pointer<ZenohTimeSeriesOptions>)>>(
+      'zenoh_declare_timeseries');
+  late final _zenoh_declare_timeseries =
+      _zenoh_declare_timeseriesPtr.asFunction<
+          ffi.Pointer<ZenohTimeSeries> Function(ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ZenohTimeSeriesOptions>)>();
+
+  /// Packs the points of key selected by parameters (same syntax as queries)
+  /// into a heap buffer (release it with zenoh_free_string). Returns the number
+  /// of points or < 0 on error.
+  int zenoh_timeseries_read(
+    ffi.Pointer<ZenohTimeSeries> ts,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Char> parameters,
+    ffi.Pointer<ffi.Pointer<ffi.Uint8>> data,
+    ffi.Pointer<ffi.Size> len,
+  ) {
+    return _zenoh_timeseries_read(
+      ts,
+      key,
+      parameters,
+      data,
+      len,
+    );
+  }
+
+  late final _zenoh_timeseries_readPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ZenohTimeSeries>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Pointer<ffi.Uint8>>,
+              ffi.Pointer<ffi.Size>)>>('zenoh_timeseries_read');
+  late final _zenoh_timeseries_read = _zenoh_timeseries_readPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohTimeSeries>,
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Pointer<ffi.Uint8>>,
+          ffi.Pointer<ffi.Size>)>();
+
+  int zenoh_timeseries_stats(
+    ffi.Pointer<ZenohTimeSeries> ts,
+    ffi.Pointer<ZenohTimeSeriesStats> stats,
+  ) {
+    return _zenoh_timeseries_stats(
+      ts,
+      stats,
+    );
+  }
+
+  late final _zenoh_timeseries_statsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ZenohTimeSeries>,
+              ffi.Pointer<ZenohTimeSeriesStats>)>>('zenoh_timeseries_stats');
+  late final _zenoh_timeseries_stats = _zenoh_timeseries_statsPtr.asFunction<
+      int Function(
+          ffi.Pointer<ZenohTimeSeries>, ffi.Pointer<ZenohTimeSeriesStats>)>();
+
+  void zenoh_undeclare_timeseries(
+    ffi.Pointer<ZenohTimeSeries> ts,
+  ) {
+    return _zenoh_undeclare_timeseries(
+      ts,
+    );
+  }
+
+  late final _zenoh_undeclare_timeseriesPtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohTimeSeries>)>>(
+      'zenoh_undeclare_timeseries');
+  late final _zenoh_undeclare_timeseries = _zenoh_undeclare_timeseriesPtr
+      .asFunction<void Function(ffi.Pointer<ZenohTimeSeries>)>();
+
+  /// ============================================================================
+  /// Liveliness
+  /// ============================================================================
+  ffi.Pointer<ZenohLivelinessToken> zenoh_declare_liveliness_token(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+  ) {
+    return _zenoh_declare_liveliness_token(
+      session,
+      key_expr,
+    );
+  }
+
+  late final _zenoh_declare_liveliness_tokenPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohLivelinessToken> Function(ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>)>>('zenoh_declare_liveliness_token');
+  late final _zenoh_declare_liveliness_token =
+      _zenoh_declare_liveliness_tokenPtr.asFunction<
+          ffi.Pointer<ZenohLivelinessToken> Function(
+              ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>)>();
+
+  void zenoh_undeclare_liveliness_token(
+    ffi.Pointer<ZenohLivelinessToken> token,
+  ) {
+    return _zenoh_undeclare_liveliness_token(
+      token,
+    );
+  }
+
+  late final _zenoh_undeclare_liveliness_tokenPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohLivelinessToken>)>>(
+      'zenoh_undeclare_liveliness_token');
+  late final _zenoh_undeclare_liveliness_token =
+      _zenoh_undeclare_liveliness_tokenPtr
+          .asFunction<void Function(ffi.Pointer<ZenohLivelinessToken>)>();
+
+  ffi.Pointer<ZenohSubscriber> zenoh_declare_liveliness_subscriber(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ZenohLivelinessCallback callback,
+    ffi.Pointer<ffi.Void> context,
+    bool history,
+  ) {
+    return _zenoh_declare_liveliness_subscriber(
+      session,
+      key_expr,
+      callback,
+      context,
+      history,
+    );
+  }
+
+  late final _zenoh_declare_liveliness_subscriberPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohSubscriber> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohLivelinessCallback,
+              ffi.Pointer<ffi.Void>,
+              ffi.Bool)>>('zenoh_declare_liveliness_subscriber');
+  late final _zenoh_declare_liveliness_subscriber =
+      _zenoh_declare_liveliness_subscriberPtr.asFunction<
+          ffi.Pointer<ZenohSubscriber> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohLivelinessCallback,
+              ffi.Pointer<ffi.Void>,
+              bool)>();
+
+  void zenoh_liveliness_get(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    ZenohLivelinessCallback callback,
+    ffi.Pointer<ffi.Void> context,
+    int timeout_ms,
+  ) {
+    return _zenoh_liveliness_get(
+      session,
+      key_expr,
+      callback,
+      context,
+      timeout_ms,
+    );
+  }
+
+  late final _zenoh_liveliness_getPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ZenohLivelinessCallback,
+              ffi.Pointer<ffi.Void>,
+              ffi.Uint64)>>('zenoh_liveliness_get');
+  late final _zenoh_liveliness_get = _zenoh_liveliness_getPtr.asFunction<
+      void Function(ffi.Pointer<ZenohSession>, ffi.Pointer<ffi.Char>,
+          ZenohLivelinessCallback, ffi.Pointer<ffi.Void>, int)>();
+
+  /// Track the alive tokens under key_expr natively. Changes are coalesced and
+  /// reported through callback at most once per interval_ms (0 = 100 ms), on a
+  /// library thread; the first delta carries the tokens already alive.
+  ffi.Pointer<ZenohLivelinessTracker> zenoh_liveliness_tracker_open(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Pointer<ffi.Char> key_expr,
+    int interval_ms,
+    ZenohLivelinessDeltaCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_liveliness_tracker_open(
+      session,
+      key_expr,
+      interval_ms,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_liveliness_tracker_openPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ZenohLivelinessTracker> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Uint64,
+              ZenohLivelinessDeltaCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_liveliness_tracker_open');
+  late final _zenoh_liveliness_tracker_open =
+      _zenoh_liveliness_tracker_openPtr.asFunction<
+          ffi.Pointer<ZenohLivelinessTracker> Function(
+              ffi.Pointer<ZenohSession>,
+              ffi.Pointer<ffi.Char>,
+              int,
+              ZenohLivelinessDeltaCallback,
+              ffi.Pointer<ffi.Void>)>();
+
+  /// The alive set as of the last delta, packed like the delta keys. version
+  /// is the delta it reflects, so later deltas apply on top of it. Free the
+  /// result with zenoh_free_string.
+  ffi.Pointer<ffi.Char> zenoh_liveliness_snapshot(
+    ffi.Pointer<ZenohLivelinessTracker> tracker,
+    ffi.Pointer<ffi.Uint64> version,
+    ffi.Pointer<ffi.Size> count,
+    ffi.Pointer<ffi.Size> len,
+  ) {
+    return _zenoh_liveliness_snapshot(
+      tracker,
+      version,
+      count,
+      len,
+    );
+  }
+
+  late final _zenoh_liveliness_snapshotPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ZenohLivelinessTracker>,
+              ffi.Pointer<ffi.Uint64>,
+              ffi.Pointer<ffi.Size>,
+              ffi.Pointer<ffi.Size>)>>('zenoh_liveliness_snapshot');
+  late final _zenoh_liveliness_snapshot =
+      _zenoh_liveliness_snapshotPtr.asFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ZenohLivelinessTracker>,
+              ffi.Pointer<ffi.Uint64>,
+              ffi.Pointer<ffi.Size>,
+              ffi.Pointer<ffi.Size>)>();
+
+  int zenoh_liveliness_tracker_count(
+    ffi.Pointer<ZenohLivelinessTracker> tracker,
+  ) {
+    return _zenoh_liveliness_tracker_count(
+      tracker,
+    );
+  }
+
+  late final _zenoh_liveliness_tracker_countPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Size Function(ffi.Pointer<ZenohLivelinessTracker>)>>(
+      'zenoh_liveliness_tracker_count');
+  late final _zenoh_liveliness_tracker_count =
+      _zenoh_liveliness_tracker_countPtr
+          .asFunction<int Function(ffi.Pointer<ZenohLivelinessTracker>)>();
+
+  /// Stop tracking. No delta is delivered after this returns.
+  void zenoh_liveliness_tracker_close(
+    ffi.Pointer<ZenohLivelinessTracker> tracker,
+  ) {
+    return _zenoh_liveliness_tracker_close(
+      tracker,
+    );
+  }
+
+  late final _zenoh_liveliness_tracker_closePtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohLivelinessTracker>)>>(
+      'zenoh_liveliness_tracker_close');
+  late final _zenoh_liveliness_tracker_close =
+      _zenoh_liveliness_tracker_closePtr
+          .asFunction<void Function(ffi.Pointer<ZenohLivelinessTracker>)>();
+
+  /// ============================================================================
+  /// Scouting
+  /// ============================================================================
+  void zenoh_scout(
+    ffi.Pointer<ffi.Char> what,
+    ffi.Pointer<ffi.Char> config,
+    ffi.Pointer<
+            ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char> info)>>
+        callback,
+  ) {
+    return _zenoh_scout(
+      what,
+      config,
+      callback,
+    );
+  }
+
+  late final _zenoh_scoutPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<
+                  ffi.NativeFunction<
+                      ffi.Void Function(
+                          ffi.Pointer<ffi.Char> info)>>)>>('zenoh_scout');
+  late final _zenoh_scout = _zenoh_scoutPtr.asFunction<
+      void Function(
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Char>,
+          ffi.Pointer<
+              ffi.NativeFunction<
+                  ffi.Void Function(ffi.Pointer<ffi.Char> info)>>)>();
+
+  /// Scout on a library thread for timeout_ms (0 = 1000) with config_json (NULL
+  /// for the default config). what is "router", "peer" or "peer|router".
+  /// Returns 0 once started.
+  int zenoh_scout_ex(
+    ffi.Pointer<ffi.Char> what,
+    ffi.Pointer<ffi.Char> config_json,
+    int timeout_ms,
+    ZenohScoutCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_scout_ex(
+      what,
+      config_json,
+      timeout_ms,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_scout_exPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Uint64,
+              ZenohScoutCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_scout_ex');
+  late final _zenoh_scout_ex = _zenoh_scout_exPtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, int,
+          ZenohScoutCallback, ffi.Pointer<ffi.Void>)>();
+
+  /// Scout like zenoh_scout_ex, probing every TCP-based locator as its hello
+  /// arrives, for up to probe_timeout_ms (0 = 1000) each, and open a session
+  /// with config_json connected to the first to answer without waiting out
+  /// the scout. Falls back to the first locator found when none answers.
+  /// Locators containing quotes, backslashes or control characters are
+  /// skipped. Result is -1 if scouting failed, -2 if nothing was found and
+  /// -3 if the open failed.
+  int zenoh_scout_connect(
+    ffi.Pointer<ffi.Char> what,
+    ffi.Pointer<ffi.Char> config_json,
+    int scout_timeout_ms,
+    int probe_timeout_ms,
+    ZenohScoutConnectCallback callback,
+    ffi.Pointer<ffi.Void> context,
+  ) {
+    return _zenoh_scout_connect(
+      what,
+      config_json,
+      scout_timeout_ms,
+      probe_timeout_ms,
+      callback,
+      context,
+    );
+  }
+
+  late final _zenoh_scout_connectPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Uint64,
+              ffi.Uint64,
+              ZenohScoutConnectCallback,
+              ffi.Pointer<ffi.Void>)>>('zenoh_scout_connect');
+  late final _zenoh_scout_connect = _zenoh_scout_connectPtr.asFunction<
+      int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, int, int,
+          ZenohScoutConnectCallback, ffi.Pointer<ffi.Void>)>();
+
+  /// ============================================================================
+  /// Helpers
+  /// ============================================================================
+  void zenoh_free_string(
+    ffi.Pointer<ffi.Char> str,
+  ) {
+    return _zenoh_free_string(
+      str,
+    );
+  }
+
+  late final _zenoh_free_stringPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
+          'zenoh_free_string');
+  late final _zenoh_free_string =
+      _zenoh_free_stringPtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Default options initializers
+  void zenoh_publisher_options_default(
+    ffi.Pointer<ZenohPublisherOptions> options,
+  ) {
+    return _zenoh_publisher_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_publisher_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohPublisherOptions>)>>(
+      'zenoh_publisher_options_default');
+  late final _zenoh_publisher_options_default =
+      _zenoh_publisher_options_defaultPtr
+          .asFunction<void Function(ffi.Pointer<ZenohPublisherOptions>)>();
+
+  void zenoh_put_options_default(
+    ffi.Pointer<ZenohPutOptions> options,
+  ) {
+    return _zenoh_put_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_put_options_defaultPtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohPutOptions>)>>(
+      'zenoh_put_options_default');
+  late final _zenoh_put_options_default = _zenoh_put_options_defaultPtr
+      .asFunction<void Function(ffi.Pointer<ZenohPutOptions>)>();
+
+  void zenoh_get_options_default(
+    ffi.Pointer<ZenohGetOptions> options,
+  ) {
+    return _zenoh_get_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_get_options_defaultPtr = _lookup<
+          ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ZenohGetOptions>)>>(
+      'zenoh_get_options_default');
+  late final _zenoh_get_options_default = _zenoh_get_options_defaultPtr
+      .asFunction<void Function(ffi.Pointer<ZenohGetOptions>)>();
+
+  void zenoh_querier_options_default(
+    ffi.Pointer<ZenohQuerierOptions> options,
+  ) {
+    return _zenoh_querier_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_querier_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohQuerierOptions>)>>(
+      'zenoh_querier_options_default');
+  late final _zenoh_querier_options_default = _zenoh_querier_options_defaultPtr
+      .asFunction<void Function(ffi.Pointer<ZenohQuerierOptions>)>();
+
+  void zenoh_storage_options_default(
+    ffi.Pointer<ZenohStorageOptions> options,
+  ) {
+    return _zenoh_storage_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_storage_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohStorageOptions>)>>(
+      'zenoh_storage_options_default');
+  late final _zenoh_storage_options_default = _zenoh_storage_options_defaultPtr
+      .asFunction<void Function(ffi.Pointer<ZenohStorageOptions>)>();
+
+  void zenoh_log_store_options_default(
+    ffi.Pointer<ZenohLogStoreOptions> options,
+  ) {
+    return _zenoh_log_store_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_log_store_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohLogStoreOptions>)>>(
+      'zenoh_log_store_options_default');
+  late final _zenoh_log_store_options_default =
+      _zenoh_log_store_options_defaultPtr
+          .asFunction<void Function(ffi.Pointer<ZenohLogStoreOptions>)>();
+
+  void zenoh_timeseries_options_default(
+    ffi.Pointer<ZenohTimeSeriesOptions> options,
+  ) {
+    return _zenoh_timeseries_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_timeseries_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohTimeSeriesOptions>)>>(
+      'zenoh_timeseries_options_default');
+  late final _zenoh_timeseries_options_default =
+      _zenoh_timeseries_options_defaultPtr
+          .asFunction<void Function(ffi.Pointer<ZenohTimeSeriesOptions>)>();
+
+  void zenoh_querying_subscriber_options_default(
+    ffi.Pointer<ZenohQueryingSubscriberOptions> options,
+  ) {
+    return _zenoh_querying_subscriber_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_querying_subscriber_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohQueryingSubscriberOptions>)>>(
+      'zenoh_querying_subscriber_options_default');
+  late final _zenoh_querying_subscriber_options_default =
+      _zenoh_querying_subscriber_options_defaultPtr.asFunction<
+          void Function(ffi.Pointer<ZenohQueryingSubscriberOptions>)>();
+
+  void zenoh_rpc_client_options_default(
+    ffi.Pointer<ZenohRpcClientOptions> options,
+  ) {
+    return _zenoh_rpc_client_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_rpc_client_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohRpcClientOptions>)>>(
+      'zenoh_rpc_client_options_default');
+  late final _zenoh_rpc_client_options_default =
+      _zenoh_rpc_client_options_defaultPtr
+          .asFunction<void Function(ffi.Pointer<ZenohRpcClientOptions>)>();
+
+  void zenoh_advanced_subscriber_options_default(
+    ffi.Pointer<ZenohAdvancedSubscriberOptions> options,
+  ) {
+    return _zenoh_advanced_subscriber_options_default(
+      options,
+    );
+  }
+
+  late final _zenoh_advanced_subscriber_options_defaultPtr = _lookup<
+          ffi.NativeFunction<
+              ffi.Void Function(ffi.Pointer<ZenohAdvancedSubscriberOptions>)>>(
+      'zenoh_advanced_subscriber_options_default');
+  late final _zenoh_advanced_subscriber_options_default =
+      _zenoh_advanced_subscriber_options_defaultPtr.asFunction<
+          void Function(ffi.Pointer<ZenohAdvancedSubscriberOptions>)>();
+
+  /// Encoding helpers
+  ffi.Pointer<ffi.Char> zenoh_encoding_to_string(
+    int encoding,
+  ) {
+    return _zenoh_encoding_to_string(
+      encoding,
+    );
+  }
+
+  late final _zenoh_encoding_to_stringPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function(ffi.Int32)>>(
+          'zenoh_encoding_to_string');
+  late final _zenoh_encoding_to_string = _zenoh_encoding_to_stringPtr
+      .asFunction<ffi.Pointer<ffi.Char> Function(int)>();
+
+  int zenoh_encoding_from_string(
+    ffi.Pointer<ffi.Char> str,
+  ) {
+    return _zenoh_encoding_from_string(
+      str,
+    );
+  }
+
+  late final _zenoh_encoding_from_stringPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Pointer<ffi.Char>)>>(
+          'zenoh_encoding_from_string');
+  late final _zenoh_encoding_from_string = _zenoh_encoding_from_stringPtr
+      .asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+}
+
+final class ZenohSession extends ffi.Opaque {}
+
+final class ZenohPublisher extends ffi.Opaque {}
+
+final class ZenohSubscriber extends ffi.Opaque {}
+
+final class ZenohQueryable extends ffi.Opaque {}
+
+final class ZenohLivelinessToken extends ffi.Opaque {}
+
+final class ZenohShmProvider extends ffi.Opaque {}
+
+final class ZenohShmBuffer extends ffi.Opaque {}
+
+final class ZenohQuerier extends ffi.Opaque {}
+
+final class ZenohQuery extends ffi.Opaque {}
+
+final class ZenohStorage extends ffi.Opaque {}
+
+final class ZenohLogStore extends ffi.Opaque {}
+
+final class ZenohTimeSeries extends ffi.Opaque {}
+
+final class ZenohQueryingSubscriber extends ffi.Opaque {}
+
+final class ZenohAdvancedSubscriber extends ffi.Opaque {}
+
+final class ZenohReplyChannel extends ffi.Opaque {}
+
+final class ZenohRpcServer extends ffi.Opaque {}
+
+final class ZenohRpcClient extends ffi.Opaque {}
+
+final class ZenohRpcResponse extends ffi.Opaque {}
+
+final class ZenohSessionGroup extends ffi.Opaque {}
+
+final class ZenohLivelinessTracker extends ffi.Opaque {}
+
+/// ============================================================================
+/// Enums - Priority and Congestion Control
+/// ============================================================================
+abstract class ZenohPriority {
+  static const int ZENOH_PRIORITY_REAL_TIME = 1;
+  static const int ZENOH_PRIORITY_INTERACTIVE_HIGH = 2;
+  static const int ZENOH_PRIORITY_INTERACTIVE_LOW = 3;
+  static const int ZENOH_PRIORITY_DATA_HIGH = 4;
+  static const int ZENOH_PRIORITY_DATA = 5;
+  static const int ZENOH_PRIORITY_DATA_LOW = 6;
+  static const int ZENOH_PRIORITY_BACKGROUND = 7;
+}
+
+abstract class ZenohCongestionControl {
+  static const int ZENOH_CONGESTION_CONTROL_BLOCK = 0;
+  static const int ZENOH_CONGESTION_CONTROL_DROP = 1;
+  static const int ZENOH_CONGESTION_CONTROL_DROP_FIRST = 2;
+}
+
+abstract class ZenohSampleKind {
+  static const int ZENOH_SAMPLE_KIND_PUT = 0;
+  static const int ZENOH_SAMPLE_KIND_DELETE = 1;
+}
+
+abstract class ZenohReplyKind {
+  static const int ZENOH_REPLY_KIND_PUT = 0;
+  static const int ZENOH_REPLY_KIND_DELETE = 1;
+  static const int ZENOH_REPLY_KIND_ERROR = 2;
+}
+
+/// Status of an RPC call. Handlers may return their own codes from 16 up.
+abstract class ZenohRpcStatus {
+  static const int ZENOH_RPC_OK = 0;
+  static const int ZENOH_RPC_ERROR = 1;
+  static const int ZENOH_RPC_NOT_FOUND = 2;
+  static const int ZENOH_RPC_TIMEOUT = 3;
+  static const int ZENOH_RPC_UNAVAILABLE = 4;
+}
+
+/// Buffering of a ZenohReplyChannel
+abstract class ZenohReplyChannelKind {
+  static const int ZENOH_REPLY_CHANNEL_FIFO = 0;
+  static const int ZENOH_REPLY_CHANNEL_RING = 1;
+}
+
+/// ============================================================================
+/// Enums - Query Consolidation, Target and Locality
+/// ============================================================================
+abstract class ZenohConsolidationMode {
+  static const int ZENOH_CONSOLIDATION_AUTO = 0;
+  static const int ZENOH_CONSOLIDATION_NONE = 1;
+  static const int ZENOH_CONSOLIDATION_MONOTONIC = 2;
+  static const int ZENOH_CONSOLIDATION_LATEST = 3;
+}
+
+abstract class ZenohQueryTarget {
+  static const int ZENOH_QUERY_TARGET_BEST_MATCHING = 0;
+  static const int ZENOH_QUERY_TARGET_ALL = 1;
+  static const int ZENOH_QUERY_TARGET_ALL_COMPLETE = 2;
+}
+
+abstract class ZenohLocality {
+  static const int ZENOH_LOCALITY_ANY = 0;
+  static const int ZENOH_LOCALITY_SESSION_LOCAL = 1;
+  static const int ZENOH_LOCALITY_REMOTE = 2;
+}
+
+/// Named starting points for zenoh_config_tune
+abstract class ZenohTransportProfile {
+  static const int ZENOH_TRANSPORT_PROFILE_DEFAULT = 0;
+  static const int ZENOH_TRANSPORT_PROFILE_LOW_LATENCY = 1;
+  static const int ZENOH_TRANSPORT_PROFILE_HIGH_THROUGHPUT = 2;
+  static const int ZENOH_TRANSPORT_PROFILE_CONSTRAINED_DEVICE = 3;
+}
+
+/// ============================================================================
+/// Encoding Types
+/// ============================================================================
+abstract class ZenohEncodingId {
+  static const int ZENOH_ENCODING_EMPTY = 0;
+  static const int ZENOH_ENCODING_BYTES = 1;
+  static const int ZENOH_ENCODING_STRING = 2;
+  static const int ZENOH_ENCODING_JSON = 3;
+  static const int ZENOH_ENCODING_TEXT_PLAIN = 4;
+  static const int ZENOH_ENCODING_TEXT_JSON = 5;
+  static const int ZENOH_ENCODING_TEXT_HTML = 6;
+  static const int ZENOH_ENCODING_TEXT_XML = 7;
+  static const int ZENOH_ENCODING_TEXT_CSS = 8;
+  static const int ZENOH_ENCODING_TEXT_CSV = 9;
+  static const int ZENOH_ENCODING_TEXT_JAVASCRIPT = 10;
+  static const int ZENOH_ENCODING_IMAGE_PNG = 11;
+  static const int ZENOH_ENCODING_IMAGE_JPEG = 12;
+  static const int ZENOH_ENCODING_IMAGE_GIF = 13;
+  static const int ZENOH_ENCODING_IMAGE_BMP = 14;
+  static const int ZENOH_ENCODING_IMAGE_WEBP = 15;
+  static const int ZENOH_ENCODING_APPLICATION_OCTET_STREAM = 16;
+  static const int ZENOH_ENCODING_APPLICATION_JSON = 17;
+  static const int ZENOH_ENCODING_APPLICATION_XML = 18;
+  static const int ZENOH_ENCODING_APPLICATION_CBOR = 19;
+  static const int ZENOH_ENCODING_APPLICATION_YAML = 20;
+  static const int ZENOH_ENCODING_APPLICATION_PROTOBUF = 21;
+  static const int ZENOH_ENCODING_APPLICATION_CDR = 22;
+  static const int ZENOH_ENCODING_CUSTOM = 100;
+}
+
+/// ============================================================================
+/// Publisher Options
+/// ============================================================================
+final class ZenohPublisherOptions extends ffi.Struct {
+  @ffi.Int32()
+  external int priority;
+
+  @ffi.Int32()
+  external int congestion_control;
+
+  @ffi.Int32()
+  external int encoding;
+
+  /// Optional schema for encoding
+  external ffi.Pointer<ffi.Char> encoding_schema;
+
+  /// Express mode for low latency
+  @ffi.Bool()
+  external bool is_express;
+}
+
+/// ============================================================================
+/// Put Options
+/// ============================================================================
+final class ZenohPutOptions extends ffi.Struct {
+  @ffi.Int32()
+  external int priority;
+
+  @ffi.Int32()
+  external int congestion_control;
+
+  @ffi.Int32()
+  external int encoding;
+
+  external ffi.Pointer<ffi.Char> encoding_schema;
+
+  external ffi.Pointer<ffi.Uint8> attachment;
+
+  @ffi.Size()
+  external int attachment_len;
+
+  @ffi.Bool()
+  external bool is_express;
+}
+
+/// ============================================================================
+/// Query Options
+/// ============================================================================
+final class ZenohGetOptions extends ffi.Struct {
+  /// Timeout in milliseconds (0 = default)
+  @ffi.Uint64()
+  external int timeout_ms;
+
+  @ffi.Int32()
+  external int priority;
+
+  @ffi.Int32()
+  external int congestion_control;
+
+  external ffi.Pointer<ffi.Uint8> payload;
+
+  @ffi.Size()
+  external int payload_len;
+
+  @ffi.Int32()
+  external int encoding;
+
+  external ffi.Pointer<ffi.Uint8> attachment;
+
+  @ffi.Size()
+  external int attachment_len;
+
+  @ffi.Int32()
+  external int consolidation;
+
+  @ffi.Int32()
+  external int target;
+
+  @ffi.Int32()
+  external int allowed_destination;
+
+  /// Max data replies delivered (0 = unlimited)
+  @ffi.Uint32()
+  external int limit;
+
+  /// Only deliver keys sorting after this one
+  external ffi.Pointer<ffi.Char> cursor;
+}
+
+final class ZenohQuerierOptions extends ffi.Struct {
+  /// Timeout in milliseconds (0 = zenoh default)
+  @ffi.Uint64()
+  external int timeout_ms;
+
+  @ffi.Int32()
+  external int priority;
+
+  @ffi.Int32()
+  external int congestion_control;
+
+  @ffi.Bool()
+  external bool is_express;
+
+  @ffi.Int32()
+  external int consolidation;
+
+  @ffi.Int32()
+  external int target;
+
+  @ffi.Int32()
+  external int allowed_destination;
+}
+
+/// ============================================================================
+/// Subscriber Options
+/// ============================================================================
+final class ZenohQueryingSubscriberOptions extends ffi.Struct {
+  /// Initial query (NULL = the key expression)
+  external ffi.Pointer<ffi.Char> query_selector;
+
+  @ffi.Int32()
+  external int query_target;
+
+  @ffi.Int32()
+  external int query_consolidation;
+
+  @ffi.Uint64()
+  external int query_timeout_ms;
+
+  @ffi.Int32()
+  external int allowed_origin;
+}
+
+final class ZenohAdvancedSubscriberOptions extends ffi.Struct {
+  /// Fetch the publishers' cached samples
+  @ffi.Bool()
+  external bool history;
+
+  /// Also fetch history of publishers seen later
+  @ffi.Bool()
+  external bool detect_late_publishers;
+
+  /// Per key (0 = unlimited)
+  @ffi.Size()
+  external int history_max_samples;
+
+  /// 0 = unlimited
+  @ffi.Uint64()
+  external int history_max_age_ms;
+
+  /// Retransmit samples detected as missed
+  @ffi.Bool()
+  external bool recovery;
+
+  /// Last-sample queries (0 = use heartbeats)
+  @ffi.Uint64()
+  external int recovery_period_ms;
+
+  /// History and recovery queries (0 = default)
+  @ffi.Uint64()
+  external int query_timeout_ms;
+
+  /// Announce the subscriber through liveliness
+  @ffi.Bool()
+  external bool subscriber_detection;
+
+  @ffi.Int32()
+  external int allowed_origin;
+}
+
+/// ============================================================================
+/// Storage Options
+/// ============================================================================
+final class ZenohStorageOptions extends ffi.Struct {
+  /// Keys kept, including deleted ones (0 = unlimited)
+  @ffi.Size()
+  external int max_entries;
+
+  /// Declare the queryable as complete for its key space
+  @ffi.Bool()
+  external bool complete;
+}
+
+final class ZenohStorageStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int entries;
+
+  /// Deleted keys remembered for last-writer-wins
+  @ffi.Uint64()
+  external int tombstones;
+
+  /// Approximate heap used by keys, values and index
+  @ffi.Uint64()
+  external int memory_bytes;
+
+  @ffi.Uint64()
+  external int queries;
+
+  /// Updates older than the stored value, or over capacity
+  @ffi.Uint64()
+  external int rejected;
+}
+
+final class ZenohLogStoreOptions extends ffi.Struct {
+  /// Bytes per segment file (0 = 64 MiB)
+  @ffi.Size()
+  external int segment_size;
+
+  /// Garbage share that triggers compaction
+  @ffi.Double()
+  external double compaction_ratio;
+
+  /// Background compaction period
+  @ffi.Uint64()
+  external int compaction_interval_ms;
+
+  /// msync every record before returning
+  @ffi.Bool()
+  external bool sync_writes;
+}
+
+final class ZenohLogStoreStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int entries;
+
+  @ffi.Uint64()
+  external int tombstones;
+
+  @ffi.Uint64()
+  external int segments;
+
+  /// Size of all segment files
+  @ffi.Uint64()
+  external int disk_bytes;
+
+  /// Bytes of the records the index points to
+  @ffi.Uint64()
+  external int live_bytes;
+
+  /// Heap used by the in-memory index
+  @ffi.Uint64()
+  external int index_bytes;
+
+  /// Segments reclaimed since open
+  @ffi.Uint64()
+  external int compactions;
+}
+
+/// How a time series turns sample payloads into values
+abstract class ZenohTimeSeriesFormat {
+  static const int ZENOH_TIMESERIES_FORMAT_AUTO = 0;
+  static const int ZENOH_TIMESERIES_FORMAT_TEXT = 1;
+  static const int ZENOH_TIMESERIES_FORMAT_F64_LE = 2;
+  static const int ZENOH_TIMESERIES_FORMAT_F32_LE = 3;
+  static const int ZENOH_TIMESERIES_FORMAT_I64_LE = 4;
+  static const int ZENOH_TIMESERIES_FORMAT_JSON_FIELD = 5;
+}
+
+final class ZenohTimeSeriesOptions extends ffi.Struct {
+  /// Points kept per key (0 = 3600)
+  @ffi.Size()
+  external int capacity;
+
+  /// Keys tracked (0 = unlimited)
+  @ffi.Size()
+  external int max_series;
+
+  @ffi.Int32()
+  external int format;
+
+  /// Copied, read by JSON_FIELD
+  external ffi.Pointer<ffi.Char> json_field;
+
+  /// Overrides format when set
+  external ZenohTimeSeriesExtractor extractor;
+
+  external ffi.Pointer<ffi.Void> extractor_context;
+
+  /// Declare the queryable as complete for its key space
+  @ffi.Bool()
+  external bool complete;
+}
+
+final class ZenohTimeSeriesStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int series;
+
+  @ffi.Uint64()
+  external int points;
+
+  @ffi.Uint64()
+  external int samples;
+
+  /// Unparsable, out-of-order or over max_series
+  @ffi.Uint64()
+  external int rejected;
+
+  @ffi.Uint64()
+  external int queries;
+
+  /// Ring and key allocations
+  @ffi.Uint64()
+  external int memory_bytes;
+}
+
+/// Transport settings applied on top of a profile. Flags are 1 (on), 0 (off)
+/// or -1 (profile value); sizes of 0 and a time limit of -1 keep the profile
+/// value.
+final class ZenohTransportTuning extends ffi.Struct {
+  @ffi.Int32()
+  external int profile;
+
+  /// Requires qos off
+  @ffi.Int()
+  external int lowlatency;
+
+  /// Priority queues
+  @ffi.Int()
+  external int qos;
+
+  @ffi.Int()
+  external int compression;
+
+  /// Only honored by SHM-enabled builds
+  @ffi.Int()
+  external int shared_memory;
+
+  /// Coalesce messages into batches
+  @ffi.Int()
+  external int batching;
+
+  /// Longest a batch waits before it is sent
+  @ffi.Int64()
+  external int batching_time_limit_ms;
+
+  /// Bytes per batch, at most 65535
+  @ffi.Uint32()
+  external int batch_size;
+
+  /// Receive buffer bytes per link
+  @ffi.Uint32()
+  external int rx_buffer_size;
+
+  /// Batches per priority queue, 1 to 16
+  @ffi.Uint32()
+  external int queue_size;
+
+  /// Wait on a full queue before dropping
+  @ffi.Uint64()
+  external int wait_before_drop_us;
+}
+
+/// Counters of a session, or of one publisher, subscriber or queryable. A
+/// session snapshot sums its live entities, the ones already undeclared and
+/// its own ad-hoc puts.
+final class ZenohSessionStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int puts;
+
+  @ffi.Uint64()
+  external int bytes_out;
+
+  @ffi.Uint64()
+  external int put_errors;
+
+  @ffi.Uint64()
+  external int samples_in;
+
+  @ffi.Uint64()
+  external int bytes_in;
+
+  /// Received but not delivered to the callback
+  @ffi.Uint64()
+  external int dropped_samples;
+
+  @ffi.Uint64()
+  external int queries_served;
+
+  /// Time spent copying each sample for Dart, not Dart's own handling.
+  /// Bucket i counts copies that took less than 2^i microseconds and the
+  /// last bucket all slower ones.
+  @ffi.Array.multi([16])
+  external ffi.Array<ffi.Uint64> sample_copy_us;
+
+  /// Live entities (session snapshots only)
+  @ffi.Uint64()
+  external int publishers;
 
-  int zenoh_encoding_from_string(
-    ffi.Pointer<ffi.Char> str,
-  ) {
-    return _zenoh_encoding_from_string(
-      str,
-    );
-  }
+  @ffi.Uint64()
+  external int subscribers;
 
-  late final _zenoh_encoding_from_stringPtr =
-      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Pointer<ffi.Char>)>>(
-          'zenoh_encoding_from_string');
-  late final _zenoh_encoding_from_string = _zenoh_encoding_from_stringPtr
-      .asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+  @ffi.Uint64()
+  external int queryables;
 }
 
-final class ZenohSession extends ffi.Opaque {}
-
-final class ZenohPublisher extends ffi.Opaque {}
+/// Worker counts of zenoh's runtime pools, handed to zenoh through the
+/// ZENOH_RUNTIME variable. 0 keeps zenoh's default.
+final class ZenohRuntimeConfig extends ffi.Struct {
+  /// Application pool: API calls and timers
+  @ffi.Uint32()
+  external int app_workers;
 
-final class ZenohSubscriber extends ffi.Opaque {}
+  /// Acceptor pool: incoming connections
+  @ffi.Uint32()
+  external int acc_workers;
 
-final class ZenohQueryable extends ffi.Opaque {}
+  /// Transmission pool
+  @ffi.Uint32()
+  external int tx_workers;
 
-final class ZenohLivelinessToken extends ffi.Opaque {}
+  /// Reception pool: runs subscriber and query callbacks
+  @ffi.Uint32()
+  external int rx_workers;
 
-/// ============================================================================
-/// Enums - Priority and Congestion Control
-/// ============================================================================
-abstract class ZenohPriority {
-  static const int ZENOH_PRIORITY_REAL_TIME = 1;
-  static const int ZENOH_PRIORITY_INTERACTIVE_HIGH = 2;
-  static const int ZENOH_PRIORITY_INTERACTIVE_LOW = 3;
-  static const int ZENOH_PRIORITY_DATA_HIGH = 4;
-  static const int ZENOH_PRIORITY_DATA = 5;
-  static const int ZENOH_PRIORITY_DATA_LOW = 6;
-  static const int ZENOH_PRIORITY_BACKGROUND = 7;
+  /// Blocking threads of each pool
+  @ffi.Uint32()
+  external int max_blocking_threads;
 }
 
-abstract class ZenohCongestionControl {
-  static const int ZENOH_CONGESTION_CONTROL_BLOCK = 0;
-  static const int ZENOH_CONGESTION_CONTROL_DROP = 1;
-  static const int ZENOH_CONGESTION_CONTROL_DROP_FIRST = 2;
+abstract class ZenohThreadKind {
+  static const int ZENOH_THREAD_DELIVERY = 0;
+  static const int ZENOH_THREAD_WORKER = 1;
 }
 
-abstract class ZenohSampleKind {
-  static const int ZENOH_SAMPLE_KIND_PUT = 0;
-  static const int ZENOH_SAMPLE_KIND_DELETE = 1;
-}
+/// Applied by each thread of one kind to itself
+final class ZenohThreadPolicy extends ffi.Struct {
+  /// Bit i allows CPU i (0 leaves the affinity alone)
+  @ffi.Uint64()
+  external int cpu_mask;
 
-/// ============================================================================
-/// Encoding Types
-/// ============================================================================
-abstract class ZenohEncodingId {
-  static const int ZENOH_ENCODING_EMPTY = 0;
-  static const int ZENOH_ENCODING_BYTES = 1;
-  static const int ZENOH_ENCODING_STRING = 2;
-  static const int ZENOH_ENCODING_JSON = 3;
-  static const int ZENOH_ENCODING_TEXT_PLAIN = 4;
-  static const int ZENOH_ENCODING_TEXT_JSON = 5;
-  static const int ZENOH_ENCODING_TEXT_HTML = 6;
-  static const int ZENOH_ENCODING_TEXT_XML = 7;
-  static const int ZENOH_ENCODING_TEXT_CSS = 8;
-  static const int ZENOH_ENCODING_TEXT_CSV = 9;
-  static const int ZENOH_ENCODING_TEXT_JAVASCRIPT = 10;
-  static const int ZENOH_ENCODING_IMAGE_PNG = 11;
-  static const int ZENOH_ENCODING_IMAGE_JPEG = 12;
-  static const int ZENOH_ENCODING_IMAGE_GIF = 13;
-  static const int ZENOH_ENCODING_IMAGE_BMP = 14;
-  static const int ZENOH_ENCODING_IMAGE_WEBP = 15;
-  static const int ZENOH_ENCODING_APPLICATION_OCTET_STREAM = 16;
-  static const int ZENOH_ENCODING_APPLICATION_JSON = 17;
-  static const int ZENOH_ENCODING_APPLICATION_XML = 18;
-  static const int ZENOH_ENCODING_APPLICATION_CBOR = 19;
-  static const int ZENOH_ENCODING_APPLICATION_YAML = 20;
-  static const int ZENOH_ENCODING_APPLICATION_PROTOBUF = 21;
-  static const int ZENOH_ENCODING_APPLICATION_CDR = 22;
-  static const int ZENOH_ENCODING_CUSTOM = 100;
-}
+  @ffi.Bool()
+  external bool set_nice;
 
-/// ============================================================================
-/// Publisher Options
-/// ============================================================================
-final class ZenohPublisherOptions extends ffi.Struct {
+  /// -20 (highest priority) to 19 (lowest)
   @ffi.Int32()
-  external int priority;
+  external int nice;
+}
+
+final class ZenohThreadStats extends ffi.Struct {
+  /// OS thread id (0 for the sum of exited workers)
+  @ffi.Uint64()
+  external int thread_id;
 
   @ffi.Int32()
-  external int congestion_control;
+  external int kind;
+
+  /// User plus system time
+  @ffi.Uint64()
+  external int cpu_time_us;
+
+  /// Callbacks delivered on this thread
+  @ffi.Uint64()
+  external int callbacks;
 
+  /// 0 or -1 when the OS refused the last policy
   @ffi.Int32()
-  external int encoding;
+  external int policy_result;
+}
 
-  /// Optional schema for encoding
-  external ffi.Pointer<ffi.Char> encoding_schema;
+/// Live entities of one session of a ZenohSessionGroup
+final class ZenohSessionGroupStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int publishers;
 
-  /// Express mode for low latency
-  @ffi.Bool()
-  external bool is_express;
+  @ffi.Uint64()
+  external int subscribers;
 }
 
 /// ============================================================================
-/// Put Options
+/// RPC Options
 /// ============================================================================
-final class ZenohPutOptions extends ffi.Struct {
+final class ZenohRpcClientOptions extends ffi.Struct {
+  /// Timeout of each attempt (0 = zenoh default)
+  @ffi.Uint64()
+  external int attempt_timeout_ms;
+
   @ffi.Int32()
   external int priority;
 
+  /// Send requests without batching
+  @ffi.Bool()
+  external bool is_express;
+
   @ffi.Int32()
-  external int congestion_control;
+  external int target;
 
   @ffi.Int32()
-  external int encoding;
+  external int allowed_destination;
+}
 
-  external ffi.Pointer<ffi.Char> encoding_schema;
+/// One reply of a zenoh_query_reply_batch call
+final class ZenohReplyItem extends ffi.Struct {
+  external ffi.Pointer<ffi.Char> key;
 
-  external ffi.Pointer<ffi.Uint8> attachment;
+  external ffi.Pointer<ffi.Uint8> payload;
 
   @ffi.Size()
-  external int attachment_len;
+  external int payload_len;
 
-  @ffi.Bool()
-  external bool is_express;
-}
+  @ffi.Int32()
+  external int encoding;
 
-/// ============================================================================
-/// Query Options
-/// ============================================================================
-final class ZenohGetOptions extends ffi.Struct {
-  /// Timeout in milliseconds (0 = default)
-  @ffi.Uint64()
-  external int timeout_ms;
+  external ffi.Pointer<ffi.Uint8> attachment;
 
-  @ffi.Int32()
-  external int priority;
+  @ffi.Size()
+  external int attachment_len;
+}
 
-  @ffi.Int32()
-  external int congestion_control;
+/// One reply received from a ZenohReplyChannel. The strings and buffers are
+/// owned by the channel and stay valid until its next receive or close.
+final class ZenohReplyRecord extends ffi.Struct {
+  /// NULL for error replies
+  external ffi.Pointer<ffi.Char> key;
 
   external ffi.Pointer<ffi.Uint8> payload;
 
   @ffi.Size()
   external int payload_len;
 
-  @ffi.Int32()
-  external int encoding;
+  /// ZenohReplyKind
+  @ffi.Int()
+  external int reply_kind;
+
+  external ffi.Pointer<ffi.Char> encoding;
 
   external ffi.Pointer<ffi.Uint8> attachment;
 
   @ffi.Size()
   external int attachment_len;
+
+  /// NTP64 or 0
+  @ffi.Uint64()
+  external int timestamp;
+
+  /// NULL unless built with the unstable API
+  external ffi.Pointer<ffi.Char> replier_id;
 }
 
+/// Native value extractor, called on zenoh threads. Returns false to drop the
+/// sample.
+typedef ZenohTimeSeriesExtractor
+    = ffi.Pointer<ffi.NativeFunction<ZenohTimeSeriesExtractorFunction>>;
+typedef ZenohTimeSeriesExtractorFunction = ffi.Bool Function(
+    ffi.Pointer<ffi.Uint8> data,
+    ffi.Size len,
+    ffi.Pointer<ffi.Double> value,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohTimeSeriesExtractorFunction = bool Function(
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    ffi.Pointer<ffi.Double> value,
+    ffi.Pointer<ffi.Void> context);
+
+/// Asynchronous open result, called on the worker thread. session is NULL
+/// unless result is 0. elapsed_us is the time spent in z_open.
+typedef ZenohSessionOpenCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohSessionOpenCallbackFunction>>;
+typedef ZenohSessionOpenCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Int result,
+    ffi.Uint64 elapsed_us,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohSessionOpenCallbackFunction = void Function(
+    ffi.Pointer<ZenohSession> session,
+    int result,
+    int elapsed_us,
+    ffi.Pointer<ffi.Void> context);
+
+/// Asynchronous close result. The session handle is already freed.
+typedef ZenohSessionCloseCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohSessionCloseCallbackFunction>>;
+typedef ZenohSessionCloseCallbackFunction = ffi.Void Function(
+    ffi.Int result, ffi.Uint64 elapsed_us, ffi.Pointer<ffi.Void> context);
+typedef DartZenohSessionCloseCallbackFunction = void Function(
+    int result, int elapsed_us, ffi.Pointer<ffi.Void> context);
+
+/// Asynchronous session group open result, called on the worker thread. group
+/// is NULL unless result is 0.
+typedef ZenohSessionGroupOpenCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohSessionGroupOpenCallbackFunction>>;
+typedef ZenohSessionGroupOpenCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ZenohSessionGroup> group,
+    ffi.Int result,
+    ffi.Uint64 elapsed_us,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohSessionGroupOpenCallbackFunction = void Function(
+    ffi.Pointer<ZenohSessionGroup> group,
+    int result,
+    int elapsed_us,
+    ffi.Pointer<ffi.Void> context);
+
 /// Subscriber callback with extended info
 typedef ZenohSubscriberCallback
     = ffi.Pointer<ffi.NativeFunction<ZenohSubscriberCallbackFunction>>;
@@ -935,6 +3910,84 @@ typedef DartZenohSubscriberCallbackExFunction = void Function(
     int attachment_len,
     int timestamp,
     ffi.Pointer<ffi.Void> context);
+
+/// Query completion callback
+typedef ZenohGetCompleteCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohGetCompleteCallbackFunction>>;
+typedef ZenohGetCompleteCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohGetCompleteCallbackFunction = void Function(
+    ffi.Pointer<ffi.Void> context);
+
+/// Advanced subscriber miss callback. source_id is the zid of the publisher
+/// whose samples were lost, count how many could not be recovered.
+typedef ZenohSampleMissCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohSampleMissCallbackFunction>>;
+typedef ZenohSampleMissCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> source_id,
+    ffi.Uint32 count,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohSampleMissCallbackFunction = void Function(
+    ffi.Pointer<ffi.Char> source_id, int count, ffi.Pointer<ffi.Void> context);
+
+/// Shared-memory aware subscriber callback. When shm_buffer is non-NULL, value
+/// points into the mapped segment and stays valid until
+/// zenoh_shm_buffer_free(shm_buffer); otherwise value is a heap copy.
+typedef ZenohSubscriberShmCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohSubscriberShmCallbackFunction>>;
+typedef ZenohSubscriberShmCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> value,
+    ffi.Size len,
+    ffi.Pointer<ZenohShmBuffer> shm_buffer,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohSubscriberShmCallbackFunction = void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> value,
+    int len,
+    ffi.Pointer<ZenohShmBuffer> shm_buffer,
+    ffi.Pointer<ffi.Void> context);
+
+/// Chunked transfer completion callback. data holds the whole reassembled
+/// object as a heap buffer; release it with zenoh_free_string.
+typedef ZenohChunkedCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohChunkedCallbackFunction>>;
+typedef ZenohChunkedCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    ffi.Size len,
+    ffi.Uint64 transfer_id,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohChunkedCallbackFunction = void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    int transfer_id,
+    ffi.Pointer<ffi.Void> context);
+
+/// Chunked transfer progress callback, called once per accepted chunk
+typedef ZenohChunkProgressCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohChunkProgressCallbackFunction>>;
+typedef ZenohChunkProgressCallbackFunction = ffi.Void Function(
+    ffi.Uint64 transfer_id,
+    ffi.Uint32 received,
+    ffi.Uint32 total,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohChunkProgressCallbackFunction = void Function(
+    int transfer_id, int received, int total, ffi.Pointer<ffi.Void> context);
+
+/// Completion of zenoh_publisher_put_chunked_async: result is the number of
+/// chunks sent or < 0
+typedef ZenohChunkedPutCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohChunkedPutCallbackFunction>>;
+typedef ZenohChunkedPutCallbackFunction = ffi.Void Function(
+    ffi.Uint64 transfer_id, ffi.Int result, ffi.Pointer<ffi.Void> context);
+typedef DartZenohChunkedPutCallbackFunction = void Function(
+    int transfer_id, int result, ffi.Pointer<ffi.Void> context);
+
+/// Queryable callback. query is an owned, refcounted handle: replies may be
+/// sent from any thread until zenoh_query_finalize drops the last reference,
+/// which tells the querier that no more replies will follow.
 typedef ZenohQueryCallback
     = ffi.Pointer<ffi.NativeFunction<ZenohQueryCallbackFunction>>;
 typedef ZenohQueryCallbackFunction = ffi.Void Function(
@@ -943,7 +3996,7 @@ typedef ZenohQueryCallbackFunction = ffi.Void Function(
     ffi.Pointer<ffi.Uint8> value,
     ffi.Size len,
     ffi.Pointer<ffi.Char> kind,
-    ffi.Pointer<ffi.Void> reply_context,
+    ffi.Pointer<ZenohQuery> query,
     ffi.Pointer<ffi.Void> user_context);
 typedef DartZenohQueryCallbackFunction = void Function(
     ffi.Pointer<ffi.Char> key,
@@ -951,7 +4004,7 @@ typedef DartZenohQueryCallbackFunction = void Function(
     ffi.Pointer<ffi.Uint8> value,
     int len,
     ffi.Pointer<ffi.Char> kind,
-    ffi.Pointer<ffi.Void> reply_context,
+    ffi.Pointer<ZenohQuery> query,
     ffi.Pointer<ffi.Void> user_context);
 
 /// Query callback with extended info
@@ -970,14 +4023,143 @@ typedef DartZenohGetCallbackFunction = void Function(
     ffi.Pointer<ffi.Char> kind,
     ffi.Pointer<ffi.Void> context);
 
-/// Query completion callback
-typedef ZenohGetCompleteCallback
-    = ffi.Pointer<ffi.NativeFunction<ZenohGetCompleteCallbackFunction>>;
-typedef ZenohGetCompleteCallbackFunction = ffi.Void Function(
+/// Extended query callback. reply_kind is a ZenohReplyKind; error replies have
+/// a NULL key and carry the error payload and encoding. timestamp is the raw
+/// NTP64 time (0 if the reply has none). replier_id is the replier's zid in hex,
+/// or NULL when unknown or built without the unstable API.
+typedef ZenohGetCallbackEx
+    = ffi.Pointer<ffi.NativeFunction<ZenohGetCallbackExFunction>>;
+typedef ZenohGetCallbackExFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> value,
+    ffi.Size len,
+    ffi.Int reply_kind,
+    ffi.Pointer<ffi.Char> encoding,
+    ffi.Pointer<ffi.Uint8> attachment,
+    ffi.Size attachment_len,
+    ffi.Uint64 timestamp,
+    ffi.Pointer<ffi.Char> replier_id,
     ffi.Pointer<ffi.Void> context);
-typedef DartZenohGetCompleteCallbackFunction = void Function(
+typedef DartZenohGetCallbackExFunction = void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> value,
+    int len,
+    int reply_kind,
+    ffi.Pointer<ffi.Char> encoding,
+    ffi.Pointer<ffi.Uint8> attachment,
+    int attachment_len,
+    int timestamp,
+    ffi.Pointer<ffi.Char> replier_id,
+    ffi.Pointer<ffi.Void> context);
+
+/// Paged query completion. next_cursor resumes after the last delivered key
+/// (pass it as ZenohGetOptions.cursor), or is NULL when nothing is left.
+typedef ZenohGetPageCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohGetPageCallbackFunction>>;
+typedef ZenohGetPageCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> next_cursor, ffi.Pointer<ffi.Void> context);
+typedef DartZenohGetPageCallbackFunction = void Function(
+    ffi.Pointer<ffi.Char> next_cursor, ffi.Pointer<ffi.Void> context);
+
+/// Multi-selector query callback: a ZenohGetCallbackEx reply tagged with the
+/// index of the selector it answers
+typedef ZenohGetMultiCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohGetMultiCallbackFunction>>;
+typedef ZenohGetMultiCallbackFunction = ffi.Void Function(
+    ffi.Size selector_index,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> value,
+    ffi.Size len,
+    ffi.Int reply_kind,
+    ffi.Pointer<ffi.Char> encoding,
+    ffi.Pointer<ffi.Uint8> attachment,
+    ffi.Size attachment_len,
+    ffi.Uint64 timestamp,
+    ffi.Pointer<ffi.Char> replier_id,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohGetMultiCallbackFunction = void Function(
+    int selector_index,
+    ffi.Pointer<ffi.Char> key,
+    ffi.Pointer<ffi.Uint8> value,
+    int len,
+    int reply_kind,
+    ffi.Pointer<ffi.Char> encoding,
+    ffi.Pointer<ffi.Uint8> attachment,
+    int attachment_len,
+    int timestamp,
+    ffi.Pointer<ffi.Char> replier_id,
+    ffi.Pointer<ffi.Void> context);
+
+/// Matching status callback: matching is true while at least one entity
+/// matches the declaring querier
+typedef ZenohMatchingCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohMatchingCallbackFunction>>;
+typedef ZenohMatchingCallbackFunction = ffi.Void Function(
+    ffi.Bool matching, ffi.Pointer<ffi.Void> context);
+typedef DartZenohMatchingCallbackFunction = void Function(
+    bool matching, ffi.Pointer<ffi.Void> context);
+
+/// RPC request for a method without a native handler. query must be answered
+/// with zenoh_rpc_respond, passing call_id back.
+typedef ZenohRpcRequestCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohRpcRequestCallbackFunction>>;
+typedef ZenohRpcRequestCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> method,
+    ffi.Pointer<ffi.Uint8> request,
+    ffi.Size len,
+    ffi.Uint64 call_id,
+    ffi.Pointer<ZenohQuery> query,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohRpcRequestCallbackFunction = void Function(
+    ffi.Pointer<ffi.Char> method,
+    ffi.Pointer<ffi.Uint8> request,
+    int len,
+    int call_id,
+    ffi.Pointer<ZenohQuery> query,
     ffi.Pointer<ffi.Void> context);
 
+/// Native RPC method handler, run on a zenoh thread. Writes its response with
+/// zenoh_rpc_response_write and returns a ZenohRpcStatus or its own code.
+typedef ZenohRpcHandler
+    = ffi.Pointer<ffi.NativeFunction<ZenohRpcHandlerFunction>>;
+typedef ZenohRpcHandlerFunction = ffi.Int Function(
+    ffi.Pointer<ffi.Uint8> request,
+    ffi.Size len,
+    ffi.Pointer<ZenohRpcResponse> response,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohRpcHandlerFunction = int Function(
+    ffi.Pointer<ffi.Uint8> request,
+    int len,
+    ffi.Pointer<ZenohRpcResponse> response,
+    ffi.Pointer<ffi.Void> context);
+
+/// RPC call outcome, invoked exactly once per call. data is NULL unless a
+/// server replied in time.
+typedef ZenohRpcResponseCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohRpcResponseCallbackFunction>>;
+typedef ZenohRpcResponseCallbackFunction = ffi.Void Function(
+    ffi.Uint64 call_id,
+    ffi.Int status,
+    ffi.Pointer<ffi.Uint8> data,
+    ffi.Size len,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohRpcResponseCallbackFunction = void Function(
+    int call_id,
+    int status,
+    ffi.Pointer<ffi.Uint8> data,
+    int len,
+    ffi.Pointer<ffi.Void> context);
+
+/// Storage change callback, called after an update has been applied
+typedef ZenohStorageChangeCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohStorageChangeCallbackFunction>>;
+typedef ZenohStorageChangeCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Char> key,
+    ffi.Int sample_kind,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohStorageChangeCallbackFunction = void Function(
+    ffi.Pointer<ffi.Char> key, int sample_kind, ffi.Pointer<ffi.Void> context);
+
 /// Liveliness callback
 typedef ZenohLivelinessCallback
     = ffi.Pointer<ffi.NativeFunction<ZenohLivelinessCallbackFunction>>;
@@ -985,3 +4167,61 @@ typedef ZenohLivelinessCallbackFunction = ffi.Void Function(
     ffi.Pointer<ffi.Char> key, ffi.Int is_alive, ffi.Pointer<ffi.Void> context);
 typedef DartZenohLivelinessCallbackFunction = void Function(
     ffi.Pointer<ffi.Char> key, int is_alive, ffi.Pointer<ffi.Void> context);
+
+/// Liveliness tracker delta from version - 1 to version. keys holds
+/// joined_count and then left_count NUL-terminated keys back to back, len
+/// bytes in all; release it with zenoh_free_string.
+typedef ZenohLivelinessDeltaCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohLivelinessDeltaCallbackFunction>>;
+typedef ZenohLivelinessDeltaCallbackFunction = ffi.Void Function(
+    ffi.Uint64 version,
+    ffi.Pointer<ffi.Char> keys,
+    ffi.Size len,
+    ffi.Size joined_count,
+    ffi.Size left_count,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohLivelinessDeltaCallbackFunction = void Function(
+    int version,
+    ffi.Pointer<ffi.Char> keys,
+    int len,
+    int joined_count,
+    int left_count,
+    ffi.Pointer<ffi.Void> context);
+
+/// Scouting result. Each distinct zid is reported as a packed record: whatami
+/// (1 byte) then zid (16 bytes) then the locator count (u32 LE) and the
+/// locators as NUL-terminated strings. A zid is reported again only when it
+/// brings new locators. A final call with record NULL carries the outcome.
+/// Release records with zenoh_free_string.
+typedef ZenohScoutCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohScoutCallbackFunction>>;
+typedef ZenohScoutCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Uint8> record,
+    ffi.Size len,
+    ffi.Int result,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohScoutCallbackFunction = void Function(
+    ffi.Pointer<ffi.Uint8> record,
+    int len,
+    int result,
+    ffi.Pointer<ffi.Void> context);
+
+/// Scout-and-connect result. locator is the endpoint connected to (release
+/// with zenoh_free_string) and rtt_us its probe handshake time or UINT64_MAX
+/// if no probe answered. session is NULL unless result is 0.
+typedef ZenohScoutConnectCallback
+    = ffi.Pointer<ffi.NativeFunction<ZenohScoutConnectCallbackFunction>>;
+typedef ZenohScoutConnectCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ZenohSession> session,
+    ffi.Int result,
+    ffi.Pointer<ffi.Char> locator,
+    ffi.Uint64 rtt_us,
+    ffi.Pointer<ffi.Void> context);
+typedef DartZenohScoutConnectCallbackFunction = void Function(
+    ffi.Pointer<ZenohSession> session,
+    int result,
+    ffi.Pointer<ffi.Char> locator,
+    int rtt_us,
+    ffi.Pointer<ffi.Void> context);
+
+const int ZENOH_STATS_COPY_BUCKETS = 16;
@@ -0,0 +1,31 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+// Key lists cross the native boundary as NUL-terminated UTF-8 strings packed
+// back to back: for bulk declarations and in liveliness tracker deltas.
+
+/// [keys] as NUL-terminated strings back to back
+Uint8List packKeys(List<String> keys) {
+  final encoded = [for (final key in keys) utf8.encode(key)];
+  final total = encoded.fold<int>(0, (n, e) => n + e.length + 1);
+  final bytes = Uint8List(total);
+  var offset = 0;
+  for (final e in encoded) {
+    bytes.setAll(offset, e);
+    offset += e.length + 1; // Uint8List left the terminator in place
+  }
+  return bytes;
+}
+
+/// Split NUL-terminated keys packed back to back
+List<String> unpackKeys(Uint8List bytes) {
+  final result = <String>[];
+  var start = 0;
+  for (var i = 0; i < bytes.length; i++) {
+    if (bytes[i] == 0) {
+      result.add(utf8.decode(Uint8List.sublistView(bytes, start, i)));
+      start = i + 1;
+    }
+  }
+  return result;
+}
@@ -4,10 +4,18 @@
 /// - Session management
 /// - Publishers and Subscribers
 /// - Queryables and Get operations
-/// - Liveliness tokens
+/// - Queriers for repeated queries
+/// - Querying and advanced subscribers with history recovery
+/// - Native request/response RPC
+/// - Liveliness tokens and native membership tracking
 /// - Priority and congestion control
 /// - Encoding support
 /// - Attachment/metadata support
+/// - Shared-memory zero-copy publishing
+/// - Chunked transfer of large payloads
+/// - Native in-memory storages
+/// - Persistent log-structured storages
+/// - Native time-series rings with downsampling queries
 library zenoh_ffi;
 
 import 'dart:async';
@@ -18,6 +26,7 @@ import 'package:ffi/ffi.dart';
 import 'dart:convert';
 
 import 'src/gen/zenoh_ffi_bindings_generated.dart' as bindings;
+import 'src/packed_keys.dart';
 
 // ============================================================================
 // Library Loading
@@ -91,11 +100,32 @@ class ZenohKeyExprException extends ZenohException {
   ZenohKeyExprException(super.message, [super.errorCode]);
 }
 
+/// Exception thrown when storage operations fail
+class ZenohStorageException extends ZenohException {
+  ZenohStorageException(super.message, [super.errorCode]);
+}
+
 /// Exception thrown when liveliness operations fail
 class ZenohLivelinessException extends ZenohException {
   ZenohLivelinessException(super.message, [super.errorCode]);
 }
 
+/// Exception thrown when shared-memory operations fail
+class ZenohShmException extends ZenohException {
+  ZenohShmException(super.message, [super.errorCode]);
+}
+
+/// Exception completing an RPC call that did not succeed
+class ZenohRpcException extends ZenohException {
+  /// [ZenohRpcStatus] value, or a handler-defined code from 16 up
+  final int status;
+
+  ZenohRpcException(String message, this.status) : super(message, status);
+
+  /// The status as a known [ZenohRpcStatus], if it is one
+  ZenohRpcStatus? get rpcStatus => ZenohRpcStatus.fromValue(status);
+}
+
 /// Exception thrown when timeout occurs
 class ZenohTimeoutException extends ZenohException {
   ZenohTimeoutException(String message) : super(message, null);
@@ -156,6 +186,172 @@ enum ZenohSampleKind {
   }
 }
 
+/// How replies to a query are consolidated before delivery
+enum ZenohConsolidationMode {
+  /// Let zenoh pick, based on the selector
+  auto(0),
+
+  /// Deliver every reply as soon as it arrives
+  none(1),
+
+  /// Deliver replies as they arrive, dropping ones older than a reply
+  /// already delivered for the same key
+  monotonic(2),
+
+  /// Hold replies until the query completes and deliver only the latest
+  /// reply per key
+  latest(3);
+
+  final int value;
+  const ZenohConsolidationMode(this.value);
+}
+
+/// Which queryables a query is routed to
+enum ZenohQueryTarget {
+  bestMatching(0),
+  all(1),
+  allComplete(2);
+
+  final int value;
+  const ZenohQueryTarget(this.value);
+}
+
+/// Where an operation is allowed to be delivered
+enum ZenohLocality {
+  any(0),
+  sessionLocal(1),
+  remote(2);
+
+  final int value;
+  const ZenohLocality(this.value);
+}
+
+/// Outcome of an RPC call
+enum ZenohRpcStatus {
+  ok(0),
+  error(1),
+  notFound(2),
+  timeout(3),
+  unavailable(4);
+
+  final int value;
+  const ZenohRpcStatus(this.value);
+
+  static ZenohRpcStatus? fromValue(int value) {
+    for (final s in ZenohRpcStatus.values) {
+      if (s.value == value) return s;
+    }
+    return null;
+  }
+}
+
+/// Buffering of a [ZenohReplyChannel]
+enum ZenohReplyChannelKind {
+  /// Holds back zenoh when full, so replies are never lost. The zenoh thread
+  /// delivering a reply blocks until the channel is drained or closed.
+  fifo(0),
+
+  /// Drops the oldest reply when full
+  ring(1);
+
+  final int value;
+  const ZenohReplyChannelKind(this.value);
+}
+
+/// Named transport settings for [ZenohTransportTuning]
+enum ZenohTransportProfile {
+  /// Zenoh's own defaults
+  defaults(0),
+
+  /// Low-latency transport, no batching and no QoS queues
+  lowLatency(1),
+
+  /// Large batches and deep per-priority queues
+  highThroughput(2),
+
+  /// Small buffers, single-batch queues and compression
+  constrainedDevice(3);
+
+  final int value;
+  const ZenohTransportProfile(this.value);
+}
+
+/// Threads covered by [ZenohSession.setThreadPolicy]
+enum ZenohThreadKind {
+  /// zenoh threads that run any callback of this library: samples, queries,
+  /// replies, matching, liveliness and scouting events
+  delivery(0),
+
+  /// Threads started by this library: session open/close, session groups
+  /// and log store compaction
+  worker(1);
+
+  final int value;
+  const ZenohThreadKind(this.value);
+}
+
+/// Role announced by a scouted zenoh node
+enum ZenohWhatAmI {
+  router(1),
+  peer(2),
+  client(4);
+
+  final int value;
+  const ZenohWhatAmI(this.value);
+
+  static ZenohWhatAmI fromValue(int value) {
+    return ZenohWhatAmI.values.firstWhere(
+      (w) => w.value == value,
+      orElse: () => ZenohWhatAmI.peer,
+    );
+  }
+}
+
+/// Fixed-size types of zenoh serialization
+enum ZenohSerialType {
+  int8(0, 1),
+  uint8(1, 1),
+  int16(2, 2),
+  uint16(3, 2),
+  int32(4, 4),
+  uint32(5, 4),
+  int64(6, 8),
+  uint64(7, 8),
+  float32(8, 4),
+  float64(9, 8),
+
+  /// One byte holding 0 or 1
+  boolean(10, 1);
+
+  final int value;
+
+  /// Bytes on the wire and in memory
+  final int size;
+  const ZenohSerialType(this.value, this.size);
+}
+
+/// How a time series reads values from sample payloads
+enum ZenohTimeSeriesFormat {
+  /// The whole payload is a number in text form. Binary payloads need an
+  /// explicit format such as [float64].
+  auto(0),
+
+  /// A number at the start of the payload, e.g. "21.5 C"
+  text(1),
+  float64(2),
+  float32(3),
+  int64(4),
+
+  /// The number under [ZenohTimeSeriesOptions.jsonField] in a JSON payload
+  jsonField(5);
+
+  final int value;
+  const ZenohTimeSeriesFormat(this.value);
+}
+
+/// Downsampling applied to each step of a time-series query
+enum ZenohTimeSeriesAgg { min, max, avg, last }
+
 /// Encoding types for Zenoh data
 enum ZenohEncoding {
   empty(0, 'empty'),
@@ -241,12 +437,20 @@ class ZenohSample {
 }
 
 /// Represents a reply from a Zenoh query
+///
+/// Error replies (see [isError], only delivered by [ZenohSession.getEx]) have
+/// an empty [key] and carry the error payload sent by the queryable.
 class ZenohReply {
   final String key;
   final Uint8List payload;
   final ZenohSampleKind kind;
   final ZenohEncoding? encoding;
   final Uint8List? attachment;
+  final DateTime? timestamp;
+
+  /// Id of the replying session, when zenoh-c is built with the unstable API
+  final String? replierId;
+  final bool isError;
 
   ZenohReply({
     required this.key,
@@ -254,6 +458,9 @@ class ZenohReply {
     this.kind = ZenohSampleKind.put,
     this.encoding,
     this.attachment,
+    this.timestamp,
+    this.replierId,
+    this.isError = false,
   });
 
   /// Get payload as UTF-8 string
@@ -264,19 +471,66 @@ class ZenohReply {
       attachment != null ? utf8.decode(attachment!, allowMalformed: true) : null;
 
   @override
-  String toString() =>
-      'ZenohReply(key: $key, kind: $kind, size: ${payload.length})';
+  String toString() => isError
+      ? 'ZenohReply(error, size: ${payload.length})'
+      : 'ZenohReply(key: $key, kind: $kind, size: ${payload.length})';
+}
+
+/// A reply to [ZenohSession.getMulti], tagged with its selector
+class ZenohMultiReply {
+  /// Index of the answered selector in the list passed to getMulti
+  final int selectorIndex;
+  final ZenohReply reply;
+
+  ZenohMultiReply(this.selectorIndex, this.reply);
+
+  @override
+  String toString() => 'ZenohMultiReply(#$selectorIndex, $reply)';
+}
+
+/// One page of replies from [ZenohSession.getPage]
+class ZenohPage {
+  final List<ZenohReply> replies;
+
+  /// Cursor of the following page, or null on the last page
+  final String? nextCursor;
+
+  ZenohPage(this.replies, this.nextCursor);
+
+  bool get hasMore => nextCursor != null;
+}
+
+/// Convert a zenoh NTP64 timestamp (32.32 fixed point seconds since the Unix
+/// epoch) to a [DateTime]
+DateTime? _ntp64ToDateTime(int ntp64) {
+  if (ntp64 == 0) return null;
+  final seconds = ntp64 >>> 32;
+  final fraction = ntp64 & 0xFFFFFFFF;
+  return DateTime.fromMicrosecondsSinceEpoch(
+      seconds * 1000000 + ((fraction * 1000000) >>> 32));
 }
 
 /// Represents a query received by a Queryable
-class ZenohQuery {
+///
+/// The query owns a reference to the native query. Replies can be sent at any
+/// time until [finalize] is called, which tells the querier the reply stream
+/// is complete. Queryables finalize automatically once their handler (and
+/// the future it returns, if any) completes; use [retain] to keep replying
+/// from elsewhere, e.g. a worker isolate.
+class ZenohQuery implements Finalizable {
   final String key;
+
+  /// Selector parameters of the query (the part after `?`)
   final String selector;
   final Uint8List? value;
   final ZenohSampleKind kind;
   final ZenohEncoding? encoding;
   final Uint8List? attachment;
-  final Pointer<Void> _replyContext;
+  final Pointer<bindings.ZenohQuery> _handle;
+  bool _isFinalized = false;
+
+  static final NativeFinalizer _finalizer = NativeFinalizer(
+      _dylib.lookup<NativeFinalizerFunction>('zenoh_query_finalize'));
 
   ZenohQuery({
     required this.key,
@@ -286,16 +540,79 @@ class ZenohQuery {
     this.encoding,
     this.attachment,
     required Pointer<Void> replyContext,
-  }) : _replyContext = replyContext;
+  }) : _handle = replyContext.cast() {
+    // Safety net: a query dropped without finalize() must not stall the querier
+    if (_handle != nullptr) {
+      _finalizer.attach(this, _handle.cast(), detach: this);
+    }
+  }
+
+  void _checkFinalized() {
+    if (_isFinalized) throw ZenohQueryableException('Query is finalized');
+  }
+
+  /// Whether [finalize] has been called on this reference
+  bool get isFinalized => _isFinalized;
+
+  /// Address of the native query, for handing a [retain]ed reference to
+  /// another isolate, which rebuilds it with
+  /// `ZenohQuery(..., replyContext: Pointer.fromAddress(address))`
+  int get nativeAddress => _handle.address;
+
+  /// Value of the selector parameter [name], parsed natively. Returns an
+  /// empty string for a parameter without a value and null if it is absent.
+  String? param(String name) {
+    _checkFinalized();
+    final namePtr = name.toNativeUtf8().cast<Char>();
+    final valuePtr = _bindings.zenoh_query_param_get(_handle, namePtr);
+    calloc.free(namePtr);
+
+    if (valuePtr == nullptr) return null;
+    final value = valuePtr.cast<Utf8>().toDartString();
+    _bindings.zenoh_free_string(valuePtr.cast());
+    return value;
+  }
+
+  /// Integer value of the selector parameter [name], if present and valid
+  int? paramInt(String name) {
+    final value = param(name);
+    return value != null ? int.tryParse(value) : null;
+  }
+
+  /// Take an additional reference to the native query. The returned query
+  /// must be finalized independently.
+  ZenohQuery retain() {
+    _checkFinalized();
+    return ZenohQuery(
+      key: key,
+      selector: selector,
+      value: value,
+      kind: kind,
+      encoding: encoding,
+      attachment: attachment,
+      replyContext: _bindings.zenoh_query_retain(_handle).cast(),
+    );
+  }
+
+  /// Release this reference. Once every reference is released, the querier
+  /// is told that no more replies will follow.
+  void finalize() {
+    if (_isFinalized) return;
+    _isFinalized = true;
+    _finalizer.detach(this);
+    _bindings.zenoh_query_finalize(_handle);
+  }
 
   /// Send a reply to this query
   void reply(String key, Uint8List data,
       {ZenohEncoding? encoding, Uint8List? attachment}) {
+    _checkFinalized();
     final keyPtr = key.toNativeUtf8().cast<Char>();
     final dataPtr = calloc<Uint8>(data.length);
     final dataList = dataPtr.asTypedList(data.length);
     dataList.setAll(0, data);
 
+    int result;
     if (encoding != null || attachment != null) {
       Pointer<Uint8> attPtr = nullptr;
       int attLen = 0;
@@ -305,8 +622,8 @@ class ZenohQuery {
         attLen = attachment.length;
       }
 
-      _bindings.zenoh_query_reply_with_options(
-        _replyContext,
+      result = _bindings.zenoh_query_reply_with_options(
+        _handle,
         keyPtr,
         dataPtr,
         data.length,
@@ -317,11 +634,13 @@ class ZenohQuery {
 
       if (attPtr != nullptr) calloc.free(attPtr);
     } else {
-      _bindings.zenoh_query_reply(_replyContext, keyPtr, dataPtr, data.length);
+      result = _bindings.zenoh_query_reply(_handle, keyPtr, dataPtr, data.length);
     }
 
     calloc.free(keyPtr);
     calloc.free(dataPtr);
+
+    if (result < 0) throw ZenohQueryableException('Reply failed', result);
   }
 
   /// Send a string reply
@@ -348,6 +667,116 @@ class ZenohQuery {
           : null,
     );
   }
+
+  /// Send several replies in a single native call. Useful for wildcard
+  /// queries that match many keys.
+  ///
+  /// Returns the number of replies sent.
+  int replyBatch(List<ZenohReplyItem> items) {
+    _checkFinalized();
+    if (items.isEmpty) return 0;
+
+    // Keys, payloads and attachments are packed into one buffer
+    final encodedKeys = [for (final item in items) utf8.encode(item.key)];
+    var total = 0;
+    for (var i = 0; i < items.length; i++) {
+      total += encodedKeys[i].length + 1;
+      total += items[i].payload.length + (items[i].attachment?.length ?? 0);
+    }
+
+    final buf = calloc<Uint8>(total == 0 ? 1 : total);
+    final itemsPtr = calloc<bindings.ZenohReplyItem>(items.length);
+    try {
+      final bytes = buf.asTypedList(total);
+      var offset = 0;
+      for (var i = 0; i < items.length; i++) {
+        final item = items[i];
+        final native = itemsPtr[i];
+
+        native.key = Pointer<Char>.fromAddress(buf.address + offset);
+        bytes.setAll(offset, encodedKeys[i]);
+        offset += encodedKeys[i].length + 1;
+
+        native.payload = Pointer<Uint8>.fromAddress(buf.address + offset);
+        native.payload_len = item.payload.length;
+        bytes.setAll(offset, item.payload);
+        offset += item.payload.length;
+
+        native.encoding = item.encoding.value;
+
+        final attachment = item.attachment;
+        if (attachment != null && attachment.isNotEmpty) {
+          native.attachment = Pointer<Uint8>.fromAddress(buf.address + offset);
+          native.attachment_len = attachment.length;
+          bytes.setAll(offset, attachment);
+          offset += attachment.length;
+        } else {
+          native.attachment = nullptr;
+          native.attachment_len = 0;
+        }
+      }
+
+      final result =
+          _bindings.zenoh_query_reply_batch(_handle, itemsPtr, items.length);
+      if (result < 0) {
+        throw ZenohQueryableException('Batch reply failed', result);
+      }
+      return result;
+    } finally {
+      calloc.free(itemsPtr);
+      calloc.free(buf);
+    }
+  }
+
+  /// Send an error reply to this query
+  void replyErr(Uint8List data, {ZenohEncoding encoding = ZenohEncoding.bytes}) {
+    _checkFinalized();
+    final dataPtr = calloc<Uint8>(data.length);
+    dataPtr.asTypedList(data.length).setAll(0, data);
+
+    final result = _bindings.zenoh_query_reply_err(
+        _handle, dataPtr, data.length, encoding.value);
+    calloc.free(dataPtr);
+
+    if (result < 0) throw ZenohQueryableException('Error reply failed', result);
+  }
+
+  /// Send a string error reply
+  void replyErrString(String message) {
+    replyErr(Uint8List.fromList(utf8.encode(message)),
+        encoding: ZenohEncoding.textPlain);
+  }
+
+  /// Reply with a deletion of [key]
+  void replyDelete(String key) {
+    _checkFinalized();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final result = _bindings.zenoh_query_reply_del(_handle, keyPtr);
+    calloc.free(keyPtr);
+
+    if (result < 0) throw ZenohQueryableException('Delete reply failed', result);
+  }
+}
+
+/// One reply of a [ZenohQuery.replyBatch] call
+class ZenohReplyItem {
+  final String key;
+  final Uint8List payload;
+  final ZenohEncoding encoding;
+  final Uint8List? attachment;
+
+  const ZenohReplyItem(
+    this.key,
+    this.payload, {
+    this.encoding = ZenohEncoding.bytes,
+    this.attachment,
+  });
+
+  /// Create a text reply item
+  factory ZenohReplyItem.string(String key, String data,
+          {ZenohEncoding encoding = ZenohEncoding.textPlain}) =>
+      ZenohReplyItem(key, Uint8List.fromList(utf8.encode(data)),
+          encoding: encoding);
 }
 
 /// Options for publishing data
@@ -394,6 +823,16 @@ class ZenohGetOptions {
   final Uint8List? payload;
   final ZenohEncoding encoding;
   final Uint8List? attachment;
+  final ZenohConsolidationMode consolidation;
+  final ZenohQueryTarget target;
+  final ZenohLocality allowedDestination;
+
+  /// Maximum number of data replies delivered (0 = unlimited). Extra replies
+  /// are dropped natively, and storages stop after the limit.
+  final int limit;
+
+  /// Only deliver keys sorting after this one; see [ZenohSession.getPage]
+  final String? cursor;
 
   const ZenohGetOptions({
     this.timeout = const Duration(seconds: 10),
@@ -402,895 +841,4290 @@ class ZenohGetOptions {
     this.payload,
     this.encoding = ZenohEncoding.bytes,
     this.attachment,
+    this.consolidation = ZenohConsolidationMode.auto,
+    this.target = ZenohQueryTarget.bestMatching,
+    this.allowedDestination = ZenohLocality.any,
+    this.limit = 0,
+    this.cursor,
   });
 
   static const ZenohGetOptions defaultOptions = ZenohGetOptions();
 }
 
-// ============================================================================
-// Configuration Builder
-// ============================================================================
-
-/// Builder for creating Zenoh configuration
-class ZenohConfigBuilder {
-  final Map<String, dynamic> _config = {};
+/// Options for querier declaration
+class ZenohQuerierOptions {
+  final Duration timeout;
+  final ZenohPriority priority;
+  final ZenohCongestionControl congestionControl;
+  final bool express;
+  final ZenohConsolidationMode consolidation;
+  final ZenohQueryTarget target;
+  final ZenohLocality allowedDestination;
 
-  /// Set the session mode (client, peer, or router)
-  ZenohConfigBuilder mode(String mode) {
-    _config['mode'] = mode;
-    return this;
-  }
+  const ZenohQuerierOptions({
+    this.timeout = const Duration(seconds: 10),
+    this.priority = ZenohPriority.data,
+    this.congestionControl = ZenohCongestionControl.drop,
+    this.express = false,
+    this.consolidation = ZenohConsolidationMode.auto,
+    this.target = ZenohQueryTarget.bestMatching,
+    this.allowedDestination = ZenohLocality.any,
+  });
 
-  /// Add connect endpoints
-  ZenohConfigBuilder connect(List<String> endpoints) {
-    _config['connect'] = {'endpoints': endpoints};
-    return this;
-  }
+  static const ZenohQuerierOptions defaultOptions = ZenohQuerierOptions();
+}
 
-  /// Add listen endpoints
-  ZenohConfigBuilder listen(List<String> endpoints) {
-    _config['listen'] = {'endpoints': endpoints};
-    return this;
-  }
+/// Options for [ZenohSession.declareRpcClient]
+class ZenohRpcClientOptions {
+  /// How long each attempt waits for a reply
+  final Duration attemptTimeout;
+  final ZenohPriority priority;
 
-  /// Enable/disable multicast scouting
-  ZenohConfigBuilder multicastScouting(bool enabled) {
-    _config['scouting'] = {
-      'multicast': {'enabled': enabled}
-    };
-    return this;
-  }
+  /// Send requests without batching
+  final bool express;
+  final ZenohQueryTarget target;
+  final ZenohLocality allowedDestination;
+
+  const ZenohRpcClientOptions({
+    this.attemptTimeout = const Duration(seconds: 1),
+    this.priority = ZenohPriority.interactiveHigh,
+    this.express = true,
+    this.target = ZenohQueryTarget.bestMatching,
+    this.allowedDestination = ZenohLocality.any,
+  });
 
-  /// Set gossip scouting
-  ZenohConfigBuilder gossipScouting(bool enabled) {
-    _config['scouting'] ??= {};
-    (_config['scouting'] as Map)['gossip'] = {'enabled': enabled};
-    return this;
-  }
+  static const ZenohRpcClientOptions defaultOptions = ZenohRpcClientOptions();
+}
 
-  /// Add custom configuration
-  ZenohConfigBuilder custom(String key, dynamic value) {
-    _config[key] = value;
-    return this;
-  }
+/// Worker counts of zenoh's runtime pools for
+/// [ZenohSession.configureRuntime]. Null keeps zenoh's default.
+class ZenohRuntimeConfig {
+  /// Application pool: API calls and timers
+  final int? appWorkers;
 
-  /// Build the configuration as JSON string
-  String build() {
-    return jsonEncode(_config);
-  }
-}
+  /// Acceptor pool: incoming connections
+  final int? acceptorWorkers;
 
-// ============================================================================
-// Liveliness Token
-// ============================================================================
+  /// Transmission pool
+  final int? txWorkers;
 
-/// Represents a liveliness token
-class ZenohLivelinessToken {
-  final Pointer<bindings.ZenohLivelinessToken> _handle;
-  bool _isUndeclared = false;
+  /// Reception pool, which runs subscriber and query callbacks
+  final int? rxWorkers;
 
-  ZenohLivelinessToken._(this._handle);
+  /// Blocking threads of each pool
+  final int? maxBlockingThreads;
 
-  /// Undeclare and drop the liveliness token
-  void undeclare() {
-    if (_isUndeclared) return;
-    _bindings.zenoh_undeclare_liveliness_token(_handle);
-    _isUndeclared = true;
-  }
+  const ZenohRuntimeConfig({
+    this.appWorkers,
+    this.acceptorWorkers,
+    this.txWorkers,
+    this.rxWorkers,
+    this.maxBlockingThreads,
+  });
 }
 
-/// Liveliness event received from a subscription
-class ZenohLivelinessEvent {
-  final String key;
-  final bool isAlive;
+/// CPU placement for [ZenohSession.setThreadPolicy]
+class ZenohThreadPolicy {
+  /// CPUs the threads may run on. Empty leaves the affinity alone.
+  final List<int> cpus;
 
-  ZenohLivelinessEvent(this.key, this.isAlive);
+  /// Niceness from -20 (highest priority) to 19 (lowest), or null to leave
+  /// it alone. Lowering it usually needs privileges.
+  final int? nice;
 
-  @override
-  String toString() => 'ZenohLivelinessEvent(key: $key, alive: $isAlive)';
+  const ZenohThreadPolicy({this.cpus = const [], this.nice});
 }
 
-// ============================================================================
-// Session
-// ============================================================================
+/// Transport settings for [ZenohConfigBuilder.transport]: a profile plus
+/// individual overrides. Null fields keep the profile's value.
+class ZenohTransportTuning {
+  final ZenohTransportProfile profile;
+
+  /// Low-latency transport; requires [qos] off
+  final bool? lowLatency;
+  final bool? qos;
+  final bool? compression;
+
+  /// Only honored by builds with shared memory
+  final bool? sharedMemory;
+  final bool? batching;
+
+  /// Longest a batch waits before it is sent
+  final Duration? batchingTimeLimit;
+
+  /// Bytes per batch, at most 65535
+  final int? batchSize;
+
+  /// Receive buffer bytes per link; zenoh accepts more than one batch
+  final int? rxBufferSize;
+
+  /// Batches per priority queue, 1 to 16
+  final int? queueSize;
+
+  /// How long a put waits on a full queue before it is dropped
+  final Duration? waitBeforeDrop;
+
+  const ZenohTransportTuning({
+    this.profile = ZenohTransportProfile.defaults,
+    this.lowLatency,
+    this.qos,
+    this.compression,
+    this.sharedMemory,
+    this.batching,
+    this.batchingTimeLimit,
+    this.batchSize,
+    this.rxBufferSize,
+    this.queueSize,
+    this.waitBeforeDrop,
+  });
 
-/// A Zenoh session providing all communication capabilities
-class ZenohSession {
-  final Pointer<bindings.ZenohSession> _handle;
-  bool _isClosed = false;
+  static const ZenohTransportTuning lowLatencyProfile =
+      ZenohTransportTuning(profile: ZenohTransportProfile.lowLatency);
+  static const ZenohTransportTuning highThroughputProfile =
+      ZenohTransportTuning(profile: ZenohTransportProfile.highThroughput);
+  static const ZenohTransportTuning constrainedDeviceProfile =
+      ZenohTransportTuning(profile: ZenohTransportProfile.constrainedDevice);
+}
 
-  // Static maps to hold callbacks
-  static final Map<int, StreamController<ZenohSample>> _subscribers = {};
-  static final Map<int, StreamController<ZenohReply>> _queries = {};
-  static final Map<int, void Function(ZenohQuery)> _queryables = {};
-  static final Map<int, StreamController<ZenohLivelinessEvent>>
-      _livelinessSubscribers = {};
-  static final Map<int, Completer<void>> _queryCompleters = {};
+/// Options for [ZenohSession.declareQueryingSubscriber]
+class ZenohQueryingSubscriberOptions {
+  /// Selector of the initial query; defaults to the subscribed key expression
+  final String? querySelector;
+  final ZenohQueryTarget queryTarget;
+
+  /// Replies are merged natively, so no consolidation is needed by default
+  final ZenohConsolidationMode queryConsolidation;
+  final Duration queryTimeout;
+  final ZenohLocality allowedOrigin;
+
+  const ZenohQueryingSubscriberOptions({
+    this.querySelector,
+    this.queryTarget = ZenohQueryTarget.bestMatching,
+    this.queryConsolidation = ZenohConsolidationMode.none,
+    this.queryTimeout = const Duration(seconds: 10),
+    this.allowedOrigin = ZenohLocality.any,
+  });
 
-  static int _nextSubscriberId = 0;
-  static int _nextQueryId = 0;
-  static int _nextQueryableId = 0;
-  static int _nextLivelinessId = 0;
+  static const ZenohQueryingSubscriberOptions defaultOptions =
+      ZenohQueryingSubscriberOptions();
+}
 
-  // Native callback pointers
-  static NativeCallable<bindings.ZenohSubscriberCallbackFunction>?
-      _subscriberCallback;
-  static NativeCallable<bindings.ZenohGetCallbackFunction>? _queryCallback;
-  static NativeCallable<bindings.ZenohQueryCallbackFunction>?
-      _queryableCallback;
-  static NativeCallable<bindings.ZenohLivelinessCallbackFunction>?
-      _livelinessCallback;
-  static NativeCallable<bindings.ZenohGetCompleteCallbackFunction>?
-      _queryCompleteCallback;
+/// Options for [ZenohSession.declareAdvancedSubscriber]
+class ZenohAdvancedSubscriberOptions {
+  /// Fetch the samples cached by advanced publishers on declaration
+  final bool history;
 
-  ZenohSession._(this._handle);
+  /// Also fetch the history of publishers that appear later
+  final bool detectLatePublishers;
 
-  /// Open a Zenoh session with mode and endpoints
-  static Future<ZenohSession> open({
-    String mode = 'client',
-    List<String> endpoints = const [],
-  }) async {
-    final modePtr = mode.toNativeUtf8().cast<Char>();
+  /// Samples fetched per key (0 = unlimited)
+  final int historyMaxSamples;
 
-    Pointer<Char> endpointsPtr = nullptr;
-    if (endpoints.isNotEmpty) {
-      final endpointsJson = jsonEncode(endpoints);
-      endpointsPtr = endpointsJson.toNativeUtf8().cast<Char>();
-    }
+  /// Oldest history fetched (null = unlimited)
+  final Duration? historyMaxAge;
 
-    final handle = _bindings.zenoh_open_session(modePtr, endpointsPtr);
+  /// Ask publishers to retransmit samples detected as missed
+  final bool recovery;
 
-    calloc.free(modePtr);
-    if (endpointsPtr != nullptr) calloc.free(endpointsPtr);
+  /// Period of queries for missed last samples (null = use heartbeats)
+  final Duration? recoveryPeriod;
 
-    if (handle == nullptr) {
-      throw ZenohSessionException('Failed to open Zenoh session');
-    }
+  /// Timeout of history and recovery queries (null = zenoh default)
+  final Duration? queryTimeout;
 
-    _ensureCallbacksInitialized();
-    return ZenohSession._(handle);
-  }
+  /// Announce the subscriber through liveliness
+  final bool subscriberDetection;
+  final ZenohLocality allowedOrigin;
 
-  /// Open a Zenoh session with a configuration builder
-  static Future<ZenohSession> openWithConfig(ZenohConfigBuilder config) async {
-    final configJson = config.build();
-    final configPtr = configJson.toNativeUtf8().cast<Char>();
+  const ZenohAdvancedSubscriberOptions({
+    this.history = true,
+    this.detectLatePublishers = true,
+    this.historyMaxSamples = 0,
+    this.historyMaxAge,
+    this.recovery = true,
+    this.recoveryPeriod,
+    this.queryTimeout,
+    this.subscriberDetection = false,
+    this.allowedOrigin = ZenohLocality.any,
+  });
 
-    final handle = _bindings.zenoh_open_session_with_config(configPtr);
-    calloc.free(configPtr);
+  static const ZenohAdvancedSubscriberOptions defaultOptions =
+      ZenohAdvancedSubscriberOptions();
+}
 
-    if (handle == nullptr) {
-      throw ZenohSessionException('Failed to open Zenoh session with config');
-    }
+/// Samples from a publisher that an advanced subscriber could not recover
+class ZenohSampleMiss {
+  /// Zid of the publishing session
+  final String sourceId;
+  final int count;
 
-    _ensureCallbacksInitialized();
-    return ZenohSession._(handle);
-  }
+  ZenohSampleMiss(this.sourceId, this.count);
 
-  static void _ensureCallbacksInitialized() {
-    _subscriberCallback ??=
-        NativeCallable<bindings.ZenohSubscriberCallbackFunction>.listener(
-            _onSubscriberData);
-    _queryCallback ??=
-        NativeCallable<bindings.ZenohGetCallbackFunction>.listener(
-            _onQueryData);
-    _queryableCallback ??=
-        NativeCallable<bindings.ZenohQueryCallbackFunction>.listener(
-            _onQueryRequest);
-    _livelinessCallback ??=
-        NativeCallable<bindings.ZenohLivelinessCallbackFunction>.listener(
-            _onLivelinessEvent);
-    _queryCompleteCallback ??=
-        NativeCallable<bindings.ZenohGetCompleteCallbackFunction>.listener(
-            _onQueryComplete);
-  }
+  @override
+  String toString() => 'ZenohSampleMiss(source: $sourceId, count: $count)';
+}
 
-  void _checkClosed() {
-    if (_isClosed) throw ZenohSessionException('Session is closed');
-  }
+/// Progress of an in-flight chunked transfer
+class ZenohChunkProgress {
+  final int transferId;
+  final int received;
+  final int total;
 
-  /// Get the session's unique identifier
-  String? get sessionId {
-    _checkClosed();
-    final infoPtr = _bindings.zenoh_session_info(_handle);
-    if (infoPtr == nullptr) return null;
-    final info = infoPtr.cast<Utf8>().toDartString();
-    _bindings.zenoh_free_string(infoPtr.cast());
-    return info;
-  }
+  ZenohChunkProgress(this.transferId, this.received, this.total);
 
-  /// Close the session
-  Future<void> close() async {
-    if (_isClosed) return;
-    _bindings.zenoh_close_session(_handle);
-    _isClosed = true;
-  }
+  /// Fraction of chunks received, from 0.0 to 1.0
+  double get fraction => total > 0 ? received / total : 1.0;
 
-  // ============================================================================
-  // Publisher Operations
-  // ============================================================================
+  bool get isComplete => received == total;
 
-  /// Declare a publisher on a key expression
-  Future<ZenohPublisher> declarePublisher(
-    String key, {
-    ZenohPublisherOptions options = ZenohPublisherOptions.defaultOptions,
-  }) async {
-    _checkClosed();
-    final keyPtr = key.toNativeUtf8().cast<Char>();
+  @override
+  String toString() =>
+      'ZenohChunkProgress(id: $transferId, $received/$total chunks)';
+}
 
-    // Create options struct
-    final optsPtr = calloc<bindings.ZenohPublisherOptions>();
-    optsPtr.ref.priority = options.priority.value;
-    optsPtr.ref.congestion_control = options.congestionControl.value;
-    optsPtr.ref.encoding = options.encoding.value;
-    optsPtr.ref.is_express = options.express;
-    optsPtr.ref.encoding_schema = nullptr;
+/// Options for native storages
+class ZenohStorageOptions {
+  /// Maximum number of keys kept, including deleted ones (0 = unlimited)
+  final int maxEntries;
 
-    final pubHandle = _bindings.zenoh_declare_publisher_with_options(
-        _handle, keyPtr, optsPtr);
+  /// Declare the storage's queryable as complete for its key expression
+  final bool complete;
 
-    calloc.free(keyPtr);
-    calloc.free(optsPtr);
+  /// Deliver a [ZenohStorageChange] for every applied update
+  final bool notifyChanges;
 
-    if (pubHandle == nullptr) {
-      throw ZenohPublisherException(
-          'Failed to declare publisher for key: $key');
-    }
+  const ZenohStorageOptions({
+    this.maxEntries = 0,
+    this.complete = true,
+    this.notifyChanges = false,
+  });
 
-    return ZenohPublisher._(pubHandle);
-  }
+  static const ZenohStorageOptions defaultOptions = ZenohStorageOptions();
+}
 
-  /// Put data on a key expression (ad-hoc publish)
-  Future<void> put(
-    String key,
-    Uint8List data, {
-    ZenohPutOptions options = ZenohPutOptions.defaultOptions,
-  }) async {
-    _checkClosed();
-    final keyPtr = key.toNativeUtf8().cast<Char>();
-    final dataPtr = calloc<Uint8>(data.length);
-    final dataList = dataPtr.asTypedList(data.length);
-    dataList.setAll(0, data);
+/// Counters of a native storage
+class ZenohStorageStats {
+  final int entries;
 
-    // Create options struct
-    final optsPtr = calloc<bindings.ZenohPutOptions>();
-    optsPtr.ref.priority = options.priority.value;
-    optsPtr.ref.congestion_control = options.congestionControl.value;
-    optsPtr.ref.encoding = options.encoding.value;
-    optsPtr.ref.is_express = options.express;
-    optsPtr.ref.encoding_schema = nullptr;
+  /// Deleted keys remembered so older updates cannot resurrect them
+  final int tombstones;
 
-    if (options.attachment != null && options.attachment!.isNotEmpty) {
-      final attPtr = calloc<Uint8>(options.attachment!.length);
-      attPtr
-          .asTypedList(options.attachment!.length)
-          .setAll(0, options.attachment!);
-      optsPtr.ref.attachment = attPtr;
-      optsPtr.ref.attachment_len = options.attachment!.length;
-    } else {
-      optsPtr.ref.attachment = nullptr;
-      optsPtr.ref.attachment_len = 0;
-    }
+  /// Approximate heap used by keys, values and the key index
+  final int memoryBytes;
+  final int queries;
 
-    final result = _bindings.zenoh_put_with_options(
-        _handle, keyPtr, dataPtr, data.length, optsPtr);
+  /// Updates dropped as older than the stored value, or over capacity
+  final int rejected;
 
-    if (optsPtr.ref.attachment != nullptr) {
-      calloc.free(optsPtr.ref.attachment);
-    }
-    calloc.free(keyPtr);
-    calloc.free(dataPtr);
-    calloc.free(optsPtr);
+  ZenohStorageStats({
+    required this.entries,
+    required this.tombstones,
+    required this.memoryBytes,
+    required this.queries,
+    required this.rejected,
+  });
 
-    if (result < 0) throw ZenohException('Put failed', result);
-  }
+  @override
+  String toString() => 'ZenohStorageStats(entries: $entries, '
+      'tombstones: $tombstones, memory: $memoryBytes B, queries: $queries, '
+      'rejected: $rejected)';
+}
 
-  /// Put a string on a key expression
-  Future<void> putString(
-    String key,
-    String value, {
-    ZenohPutOptions? options,
-  }) async {
-    await put(
-      key,
-      Uint8List.fromList(utf8.encode(value)),
-      options:
-          options ?? const ZenohPutOptions(encoding: ZenohEncoding.textPlain),
-    );
-  }
+/// Runtime counters of a session or of a single publisher, subscriber or
+/// queryable
+class ZenohStats {
+  final int puts;
+  final int bytesOut;
+  final int putErrors;
+  final int samplesIn;
+  final int bytesIn;
+
+  /// Samples received but not delivered, e.g. when out of memory
+  final int droppedSamples;
+  final int queriesServed;
+
+  /// Histogram of the native time spent copying each sample for Dart; the
+  /// Dart handler itself runs later and is not included. Entry i counts
+  /// copies that took less than 2^i microseconds; the last entry counts all
+  /// slower ones.
+  final List<int> sampleCopyTime;
+
+  /// Live entities; only set on session snapshots
+  final int publishers;
+  final int subscribers;
+  final int queryables;
+
+  ZenohStats({
+    required this.puts,
+    required this.bytesOut,
+    required this.putErrors,
+    required this.samplesIn,
+    required this.bytesIn,
+    required this.droppedSamples,
+    required this.queriesServed,
+    required this.sampleCopyTime,
+    required this.publishers,
+    required this.subscribers,
+    required this.queryables,
+  });
 
-  /// Put JSON data on a key expression
-  Future<void> putJson(
-    String key,
-    Object value, {
-    Uint8List? attachment,
-  }) async {
-    await put(
-      key,
-      Uint8List.fromList(utf8.encode(jsonEncode(value))),
-      options: ZenohPutOptions(
-        encoding: ZenohEncoding.applicationJson,
-        attachment: attachment,
-      ),
-    );
+  /// Read a snapshot filled by [fill], or null when [fill] fails
+  static ZenohStats? _read(
+      int Function(Pointer<bindings.ZenohSessionStats>) fill) {
+    final statsPtr = calloc<bindings.ZenohSessionStats>();
+    try {
+      if (fill(statsPtr) < 0) return null;
+      final s = statsPtr.ref;
+      return ZenohStats(
+        puts: s.puts,
+        bytesOut: s.bytes_out,
+        putErrors: s.put_errors,
+        samplesIn: s.samples_in,
+        bytesIn: s.bytes_in,
+        droppedSamples: s.dropped_samples,
+        queriesServed: s.queries_served,
+        sampleCopyTime: List.generate(bindings.ZENOH_STATS_COPY_BUCKETS,
+            (i) => s.sample_copy_us[i],
+            growable: false),
+        publishers: s.publishers,
+        subscribers: s.subscribers,
+        queryables: s.queryables,
+      );
+    } finally {
+      calloc.free(statsPtr);
+    }
   }
 
-  /// Delete data on a key expression
-  Future<void> delete(String key) async {
-    _checkClosed();
-    final keyPtr = key.toNativeUtf8().cast<Char>();
+  @override
+  String toString() => 'ZenohStats(puts: $puts, out: $bytesOut B, '
+      'putErrors: $putErrors, samples: $samplesIn, in: $bytesIn B, '
+      'dropped: $droppedSamples, queries: $queriesServed)';
+}
 
-    final result = _bindings.zenoh_delete(_handle, keyPtr);
-    calloc.free(keyPtr);
+/// CPU time of one thread tracked by the library
+class ZenohThreadStats {
+  /// OS thread id; 0 for the entry summing workers that already exited
+  final int threadId;
+  final ZenohThreadKind kind;
+  final Duration cpuTime;
+
+  /// Callbacks delivered on this thread
+  final int callbacks;
+
+  /// False when the OS refused the last [ZenohThreadPolicy]
+  final bool policyApplied;
+
+  ZenohThreadStats({
+    required this.threadId,
+    required this.kind,
+    required this.cpuTime,
+    required this.callbacks,
+    required this.policyApplied,
+  });
 
-    if (result < 0) throw ZenohException('Delete failed', result);
-  }
+  @override
+  String toString() => 'ZenohThreadStats(thread: $threadId, ${kind.name}, '
+      'cpu: ${cpuTime.inMicroseconds} us, callbacks: $callbacks)';
+}
 
-  // ============================================================================
-  // Subscriber Operations
-  // ============================================================================
+/// An update applied by a native storage
+class ZenohStorageChange {
+  final String key;
+  final ZenohSampleKind kind;
 
-  /// Declare a subscriber on a key expression
-  Future<ZenohSubscriber> declareSubscriber(String key) async {
-    _checkClosed();
+  ZenohStorageChange(this.key, this.kind);
 
-    final id = _nextSubscriberId++;
-    final controller = StreamController<ZenohSample>();
-    _subscribers[id] = controller;
+  @override
+  String toString() => 'ZenohStorageChange(key: $key, kind: $kind)';
+}
 
-    final context = Pointer<Void>.fromAddress(id);
-    final keyPtr = key.toNativeUtf8().cast<Char>();
+/// Options for [ZenohLogStore.open]
+class ZenohLogStoreOptions {
+  /// Size of each memory-mapped segment file in bytes
+  final int segmentSize;
 
-    final subHandle = _bindings.zenoh_declare_subscriber(
-      _handle,
-      keyPtr,
-      _subscriberCallback!.nativeFunction,
-      context,
-    );
-    calloc.free(keyPtr);
+  /// Share of dead records in a sealed segment that triggers its compaction
+  final double compactionRatio;
 
-    if (subHandle == nullptr) {
-      _subscribers.remove(id);
-      throw ZenohSubscriberException(
-          'Failed to declare subscriber for key: $key');
-    }
+  /// How often the background compactor checks segments
+  final Duration compactionInterval;
 
-    controller.onCancel = () {
-      // Cleanup handled in undeclare
-    };
+  /// Sync every record to disk before the write returns
+  final bool syncWrites;
 
-    return ZenohSubscriber._(subHandle, controller, id);
-  }
+  const ZenohLogStoreOptions({
+    this.segmentSize = 64 * 1024 * 1024,
+    this.compactionRatio = 0.5,
+    this.compactionInterval = const Duration(seconds: 30),
+    this.syncWrites = false,
+  });
 
-  // ============================================================================
-  // Query (Get) Operations
-  // ============================================================================
+  static const ZenohLogStoreOptions defaultOptions = ZenohLogStoreOptions();
+}
 
-  /// Query data from the network
-  Stream<ZenohReply> get(
-    String selector, {
-    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
-  }) {
-    _checkClosed();
-    final id = _nextQueryId++;
-    final controller = StreamController<ZenohReply>();
-    final completer = Completer<void>();
-    _queries[id] = controller;
-    _queryCompleters[id] = completer;
+/// Counters of a [ZenohLogStore]
+class ZenohLogStoreStats {
+  final int entries;
+  final int tombstones;
+  final int segments;
 
-    final context = Pointer<Void>.fromAddress(id);
-    final selectorPtr = selector.toNativeUtf8().cast<Char>();
+  /// Size of all segment files
+  final int diskBytes;
 
-    // Create options struct
-    final optsPtr = calloc<bindings.ZenohGetOptions>();
-    optsPtr.ref.timeout_ms = options.timeout.inMilliseconds;
-    optsPtr.ref.priority = options.priority.value;
-    optsPtr.ref.congestion_control = options.congestionControl.value;
-    optsPtr.ref.encoding = options.encoding.value;
+  /// Bytes of the records the index still points to
+  final int liveBytes;
 
-    if (options.payload != null && options.payload!.isNotEmpty) {
-      final payloadPtr = calloc<Uint8>(options.payload!.length);
-      payloadPtr
-          .asTypedList(options.payload!.length)
-          .setAll(0, options.payload!);
-      optsPtr.ref.payload = payloadPtr;
-      optsPtr.ref.payload_len = options.payload!.length;
-    } else {
-      optsPtr.ref.payload = nullptr;
-      optsPtr.ref.payload_len = 0;
-    }
+  /// Heap used by the in-memory key index
+  final int indexBytes;
 
-    if (options.attachment != null && options.attachment!.isNotEmpty) {
-      final attPtr = calloc<Uint8>(options.attachment!.length);
-      attPtr
-          .asTypedList(options.attachment!.length)
-          .setAll(0, options.attachment!);
-      optsPtr.ref.attachment = attPtr;
-      optsPtr.ref.attachment_len = options.attachment!.length;
-    } else {
-      optsPtr.ref.attachment = nullptr;
-      optsPtr.ref.attachment_len = 0;
-    }
+  /// Segments reclaimed since the store was opened
+  final int compactions;
 
-    _bindings.zenoh_get_async_with_options(
-      _handle,
-      selectorPtr,
-      _queryCallback!.nativeFunction,
-      _queryCompleteCallback!.nativeFunction,
-      context,
-      optsPtr,
-    );
+  ZenohLogStoreStats({
+    required this.entries,
+    required this.tombstones,
+    required this.segments,
+    required this.diskBytes,
+    required this.liveBytes,
+    required this.indexBytes,
+    required this.compactions,
+  });
 
-    // Clean up options
-    if (optsPtr.ref.payload != nullptr) calloc.free(optsPtr.ref.payload);
-    if (optsPtr.ref.attachment != nullptr) calloc.free(optsPtr.ref.attachment);
-    calloc.free(selectorPtr);
-    calloc.free(optsPtr);
+  @override
+  String toString() => 'ZenohLogStoreStats(entries: $entries, '
+      'tombstones: $tombstones, segments: $segments, disk: $diskBytes B, '
+      'live: $liveBytes B, index: $indexBytes B, compactions: $compactions)';
+}
 
-    // The stream will be closed when the query completes (via completion callback)
-    // Add a timeout fallback just in case
-    Future.delayed(options.timeout + const Duration(seconds: 1), () {
-      if (!controller.isClosed) {
-        controller.close();
-        _queries.remove(id);
-        _queryCompleters.remove(id);
-      }
-    });
+/// Options for native time series
+class ZenohTimeSeriesOptions {
+  /// Points kept per key; older ones are overwritten
+  final int capacity;
 
-    return controller.stream;
-  }
+  /// Maximum number of keys tracked (0 = unlimited)
+  final int maxSeries;
+  final ZenohTimeSeriesFormat format;
 
-  /// Query and collect all replies into a list
-  Future<List<ZenohReply>> getCollect(
-    String selector, {
-    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
-  }) async {
-    final replies = <ZenohReply>[];
-    await for (final reply in get(selector, options: options)) {
-      replies.add(reply);
-    }
-    return replies;
-  }
+  /// Field read by [ZenohTimeSeriesFormat.jsonField]
+  final String? jsonField;
 
-  // ============================================================================
-  // Queryable Operations
-  // ============================================================================
+  /// Native extractor overriding [format]. It runs on zenoh threads, so it
+  /// must be a C function rather than a Dart callback.
+  final bindings.ZenohTimeSeriesExtractor? extractor;
 
-  /// Declare a queryable on a key expression
-  Future<ZenohQueryable> declareQueryable(
-    String keyExpr,
-    void Function(ZenohQuery) handler,
-  ) async {
-    _checkClosed();
+  /// Declare the time series' queryable as complete for its key expression
+  final bool complete;
 
-    final id = _nextQueryableId++;
-    _queryables[id] = handler;
+  const ZenohTimeSeriesOptions({
+    this.capacity = 3600,
+    this.maxSeries = 0,
+    this.format = ZenohTimeSeriesFormat.auto,
+    this.jsonField,
+    this.extractor,
+    this.complete = false,
+  });
 
-    final context = Pointer<Void>.fromAddress(id);
-    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+  static const ZenohTimeSeriesOptions defaultOptions =
+      ZenohTimeSeriesOptions();
+}
 
-    final qHandle = _bindings.zenoh_declare_queryable(
-      _handle,
-      keyPtr,
-      _queryableCallback!.nativeFunction,
-      context,
-    );
+/// Counters of a native time series
+class ZenohTimeSeriesStats {
+  final int series;
+  final int points;
+  final int samples;
+
+  /// Samples dropped as unparsable, out of order or over the series limit
+  final int rejected;
+  final int queries;
+  final int memoryBytes;
+
+  ZenohTimeSeriesStats({
+    required this.series,
+    required this.points,
+    required this.samples,
+    required this.rejected,
+    required this.queries,
+    required this.memoryBytes,
+  });
 
-    calloc.free(keyPtr);
+  @override
+  String toString() => 'ZenohTimeSeriesStats(series: $series, '
+      'points: $points, samples: $samples, rejected: $rejected, '
+      'queries: $queries, memory: $memoryBytes B)';
+}
 
-    if (qHandle == nullptr) {
-      _queryables.remove(id);
-      throw ZenohQueryableException(
-          'Failed to declare queryable for key: $keyExpr');
+/// One point of a time series
+class ZenohTimePoint {
+  final DateTime time;
+  final double value;
+
+  ZenohTimePoint(this.time, this.value);
+
+  /// Decode a time-series reply payload of packed little-endian
+  /// (NTP64 time, float64 value) pairs
+  static List<ZenohTimePoint> decode(Uint8List payload) {
+    final data = ByteData.sublistView(payload);
+    final points = <ZenohTimePoint>[];
+    for (var offset = 0; offset + 16 <= payload.length; offset += 16) {
+      final time = _ntp64ToDateTime(data.getUint64(offset, Endian.little));
+      if (time == null) continue;
+      points.add(
+          ZenohTimePoint(time, data.getFloat64(offset + 8, Endian.little)));
     }
+    return points;
+  }
 
-    return ZenohQueryable._(qHandle, id);
+  @override
+  String toString() => 'ZenohTimePoint($time, $value)';
+}
+
+/// A zenoh node found by [ZenohSession.scoutNodes]
+class ZenohHello {
+  final ZenohWhatAmI whatami;
+  final String zid;
+  final List<String> locators;
+
+  ZenohHello(this.whatami, this.zid, this.locators);
+
+  /// Decode a native scout record: whatami, 16-byte zid, u32 LE locator
+  /// count, then NUL-terminated locators
+  static ZenohHello decode(Uint8List record) {
+    final zid = record.sublist(1, 17);
+    final hex = [for (final b in zid) b.toRadixString(16).padLeft(2, '0')];
+    final count = ByteData.sublistView(record).getUint32(17, Endian.little);
+    final locators = <String>[];
+    var start = 21;
+    for (var i = start; i < record.length && locators.length < count; i++) {
+      if (record[i] != 0) continue;
+      locators.add(utf8.decode(record.sublist(start, i)));
+      start = i + 1;
+    }
+    return ZenohHello(
+      ZenohWhatAmI.fromValue(record[0]),
+      '${hex.sublist(0, 4).join()}-${hex.sublist(4, 6).join()}-'
+      '${hex.sublist(6, 8).join()}-${hex.sublist(8, 10).join()}-'
+      '${hex.sublist(10).join()}',
+      locators,
+    );
   }
 
-  // ============================================================================
-  // Liveliness Operations
-  // ============================================================================
+  @override
+  String toString() =>
+      'ZenohHello(${whatami.name}, zid: $zid, locators: $locators)';
+}
 
-  /// Declare a liveliness token
-  Future<ZenohLivelinessToken> declareLivelinessToken(String keyExpr) async {
-    _checkClosed();
-    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+/// One field of a fixed-layout record for [ZenohSerializer]
+class ZenohSerialField {
+  final ZenohSerialType type;
 
-    final tokenHandle =
-        _bindings.zenoh_declare_liveliness_token(_handle, keyPtr);
-    calloc.free(keyPtr);
+  /// Byte offset of the field in the record's memory layout
+  final int offset;
 
-    if (tokenHandle == nullptr) {
-      throw ZenohLivelinessException(
-          'Failed to declare liveliness token for key: $keyExpr');
-    }
+  const ZenohSerialField(this.type, this.offset);
+}
 
-    return ZenohLivelinessToken._(tokenHandle);
-  }
+/// Session opened by [ZenohSession.scoutAndConnect]
+class ZenohScoutConnection {
+  final ZenohSession session;
 
-  /// Subscribe to liveliness changes
-  Future<ZenohLivelinessSubscriber> declareLivelinessSubscriber(
-    String keyExpr, {
-    bool history = false,
-  }) async {
-    _checkClosed();
+  /// The scouted endpoint the session is connected to
+  final String locator;
 
-    final id = _nextLivelinessId++;
-    final controller = StreamController<ZenohLivelinessEvent>();
-    _livelinessSubscribers[id] = controller;
+  /// Handshake time of [locator], or null if no locator answered the probe
+  /// and the first one found was used
+  final Duration? rtt;
 
-    final context = Pointer<Void>.fromAddress(id);
-    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+  ZenohScoutConnection(this.session, this.locator, this.rtt);
+}
 
-    final subHandle = _bindings.zenoh_declare_liveliness_subscriber(
-      _handle,
-      keyPtr,
-      _livelinessCallback!.nativeFunction,
-      context,
-      history,
-    );
-    calloc.free(keyPtr);
+// ============================================================================
+// Configuration Builder
+// ============================================================================
 
-    if (subHandle == nullptr) {
-      _livelinessSubscribers.remove(id);
-      throw ZenohLivelinessException(
-          'Failed to declare liveliness subscriber for key: $keyExpr');
-    }
+/// Builder for creating Zenoh configuration
+class ZenohConfigBuilder {
+  final Map<String, dynamic> _config = {};
+  ZenohTransportTuning? _tuning;
 
-    return ZenohLivelinessSubscriber._(subHandle, controller, id);
+  /// Set the session mode (client, peer, or router)
+  ZenohConfigBuilder mode(String mode) {
+    _config['mode'] = mode;
+    return this;
   }
 
-  /// Query currently alive tokens
-  Stream<ZenohLivelinessEvent> livelinessGet(
-    String keyExpr, {
-    Duration timeout = const Duration(seconds: 10),
-  }) {
-    _checkClosed();
-
-    final id = _nextLivelinessId++;
-    final controller = StreamController<ZenohLivelinessEvent>();
-    _livelinessSubscribers[id] = controller;
+  /// Add connect endpoints
+  ZenohConfigBuilder connect(List<String> endpoints) {
+    _config['connect'] = {'endpoints': endpoints};
+    return this;
+  }
 
-    final context = Pointer<Void>.fromAddress(id);
-    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+  /// Add listen endpoints
+  ZenohConfigBuilder listen(List<String> endpoints) {
+    _config['listen'] = {'endpoints': endpoints};
+    return this;
+  }
 
-    _bindings.zenoh_liveliness_get(
-      _handle,
-      keyPtr,
-      _livelinessCallback!.nativeFunction,
-      context,
-      timeout.inMilliseconds,
-    );
+  /// Enable/disable multicast scouting
+  ZenohConfigBuilder multicastScouting(bool enabled) {
+    _config['scouting'] = {
+      'multicast': {'enabled': enabled}
+    };
+    return this;
+  }
 
-    calloc.free(keyPtr);
+  /// Set gossip scouting
+  ZenohConfigBuilder gossipScouting(bool enabled) {
+    _config['scouting'] ??= {};
+    (_config['scouting'] as Map)['gossip'] = {'enabled': enabled};
+    return this;
+  }
 
-    // Close stream after timeout
-    Future.delayed(timeout + const Duration(milliseconds: 100), () {
-      if (!controller.isClosed) {
-        controller.close();
-        _livelinessSubscribers.remove(id);
-      }
-    });
+  /// Add custom configuration
+  ZenohConfigBuilder custom(String key, dynamic value) {
+    _config[key] = value;
+    return this;
+  }
 
-    return controller.stream;
+  /// Apply a transport profile and overrides when the config is built
+  ZenohConfigBuilder transport(ZenohTransportTuning tuning) {
+    _tuning = tuning;
+    return this;
   }
 
-  // ============================================================================
-  // Scouting
-  // ============================================================================
+  /// Transport keys written by [transport] and the values zenoh stored for
+  /// them
+  Map<String, dynamic> get transportKeys {
+    if (_tuning == null) return const {};
+    return jsonDecode(_tune(jsonEncode(_config), _tuning!).applied)
+        as Map<String, dynamic>;
+  }
 
-  /// Scout for Zenoh peers and routers on the network
-  static Stream<String> scout({String what = 'peer|router', String? config}) {
-    final controller = StreamController<String>();
+  /// Build the configuration as JSON string
+  String build() {
+    final json = jsonEncode(_config);
+    return _tuning != null ? _tune(json, _tuning!).config : json;
+  }
 
-    final whatPtr = what.toNativeUtf8().cast<Char>();
-    final configPtr =
-        config != null ? config.toNativeUtf8().cast<Char>() : nullptr;
+  static ({String config, String applied}) _tune(
+      String json, ZenohTransportTuning tuning) {
+    final batchSize = tuning.batchSize;
+    if (batchSize != null && (batchSize < 0 || batchSize > 65535)) {
+      throw ArgumentError.value(batchSize, 'batchSize', 'must be in 0..65535');
+    }
+    final rxBufferSize = tuning.rxBufferSize;
+    if (rxBufferSize != null &&
+        (rxBufferSize < 0 || rxBufferSize > 0xFFFFFFFF)) {
+      throw ArgumentError.value(
+          rxBufferSize, 'rxBufferSize', 'must fit in 32 bits');
+    }
+    final queueSize = tuning.queueSize;
+    if (queueSize != null && (queueSize < 0 || queueSize > 16)) {
+      throw ArgumentError.value(queueSize, 'queueSize', 'must be in 0..16');
+    }
+    final tuningPtr = calloc<bindings.ZenohTransportTuning>();
+    _bindings.zenoh_transport_tuning_default(tuningPtr);
+    final t = tuningPtr.ref;
+    t.profile = tuning.profile.value;
+    if (tuning.lowLatency != null) t.lowlatency = tuning.lowLatency! ? 1 : 0;
+    if (tuning.qos != null) t.qos = tuning.qos! ? 1 : 0;
+    if (tuning.compression != null) {
+      t.compression = tuning.compression! ? 1 : 0;
+    }
+    if (tuning.sharedMemory != null) {
+      t.shared_memory = tuning.sharedMemory! ? 1 : 0;
+    }
+    if (tuning.batching != null) t.batching = tuning.batching! ? 1 : 0;
+    if (tuning.batchingTimeLimit != null) {
+      t.batching_time_limit_ms = tuning.batchingTimeLimit!.inMilliseconds;
+    }
+    t.batch_size = tuning.batchSize ?? 0;
+    t.rx_buffer_size = tuning.rxBufferSize ?? 0;
+    t.queue_size = tuning.queueSize ?? 0;
+    t.wait_before_drop_us = tuning.waitBeforeDrop?.inMicroseconds ?? 0;
+
+    final jsonPtr = json.toNativeUtf8().cast<Char>();
+    final appliedPtr = calloc<Pointer<Char>>();
+    final configPtr = _bindings.zenoh_config_tune(jsonPtr, tuningPtr, appliedPtr);
+    calloc.free(jsonPtr);
+    calloc.free(tuningPtr);
+
+    if (configPtr == nullptr) {
+      final rejected = appliedPtr.value;
+      calloc.free(appliedPtr);
+      if (rejected == nullptr) {
+        throw ZenohSessionException('Transport tuning rejected by zenoh');
+      }
+      final key = rejected.cast<Utf8>().toDartString();
+      _bindings.zenoh_free_string(rejected);
+      throw ZenohSessionException('Transport tuning rejected by zenoh: $key');
+    }
+    final config = configPtr.cast<Utf8>().toDartString();
+    final applied = appliedPtr.value.cast<Utf8>().toDartString();
+    _bindings.zenoh_free_string(configPtr);
+    _bindings.zenoh_free_string(appliedPtr.value);
+    calloc.free(appliedPtr);
+    return (config: config, applied: applied);
+  }
+}
 
-    final callback = NativeCallable<Void Function(Pointer<Char>)>.listener(
-      (Pointer<Char> info) {
-        final infoStr = info.cast<Utf8>().toDartString();
-        controller.add(infoStr);
-      },
-    );
+// ============================================================================
+// Liveliness Token
+// ============================================================================
 
-    Future(() {
-      _bindings.zenoh_scout(whatPtr, configPtr, callback.nativeFunction);
+/// Represents a liveliness token
+class ZenohLivelinessToken {
+  final Pointer<bindings.ZenohLivelinessToken> _handle;
+  bool _isUndeclared = false;
 
-      calloc.free(whatPtr);
-      if (configPtr != nullptr) calloc.free(configPtr);
-      callback.close();
-      controller.close();
-    });
+  ZenohLivelinessToken._(this._handle);
 
-    return controller.stream;
+  /// Undeclare and drop the liveliness token
+  void undeclare() {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_liveliness_token(_handle);
+    _isUndeclared = true;
   }
+}
 
-  // ============================================================================
-  // Callbacks
-  // ============================================================================
+/// Keys that joined and left between two tracker versions
+class ZenohLivelinessDelta {
+  final int version;
+  final List<String> joined;
+  final List<String> left;
 
-  static void _onSubscriberData(
-    Pointer<Char> key,
-    Pointer<Uint8> value,
-    int len,
-    Pointer<Char> kind,
-    Pointer<Char> attachment,
-    Pointer<Void> context,
-  ) {
-    try {
-      int id = context.address;
-      if (_subscribers.containsKey(id)) {
-        final keyStr = key.cast<Utf8>().toDartString();
-        final kindStr = kind.cast<Utf8>().toDartString();
-        final payload = len > 0 && value.address != 0
-            ? Uint8List.fromList(value.asTypedList(len))
-            : Uint8List(0);
-        final attStr = attachment.address != 0
-            ? attachment.cast<Utf8>().toDartString()
-            : '';
+  ZenohLivelinessDelta(this.version, this.joined, this.left);
 
-        _subscribers[id]?.add(ZenohSample(
-          key: keyStr,
-          payload: payload,
-          kind: kindStr == 'DELETE'
-              ? ZenohSampleKind.delete
-              : ZenohSampleKind.put,
-          attachment: attStr.isNotEmpty
-              ? Uint8List.fromList(utf8.encode(attStr))
-              : null,
-        ));
+  @override
+  String toString() => 'ZenohLivelinessDelta(version: $version, '
+      'joined: ${joined.length}, left: ${left.length})';
+}
+
+/// The alive set of a [ZenohLivelinessTracker] as of [version]. Deltas with
+/// a higher version apply on top of it.
+class ZenohLivelinessSnapshot {
+  final int version;
+  final Set<String> alive;
+
+  ZenohLivelinessSnapshot(this.version, this.alive);
+}
+
+/// Liveliness event received from a subscription
+class ZenohLivelinessEvent {
+  final String key;
+  final bool isAlive;
+
+  ZenohLivelinessEvent(this.key, this.isAlive);
+
+  @override
+  String toString() => 'ZenohLivelinessEvent(key: $key, alive: $isAlive)';
+}
+
+// ============================================================================
+// Session
+// ============================================================================
+
+/// A Zenoh session providing all communication capabilities
+class ZenohSession {
+  final Pointer<bindings.ZenohSession> _handle;
+  bool _isClosed = false;
+
+  /// Time spent opening the session on the native worker thread, or null
+  /// when it was opened synchronously
+  final Duration? openDuration;
+
+  /// Time the native close took, available once [close] completes
+  Duration? get closeDuration => _closeDuration;
+  Duration? _closeDuration;
+
+  // Members of a ZenohSessionGroup are closed by the group
+  final bool _grouped;
+
+  // Static maps to hold callbacks
+  static final Map<int, StreamController<ZenohSample>> _subscribers = {};
+  static final Map<int, StreamController<ZenohReply>> _queries = {};
+  static final Map<int, FutureOr<void> Function(ZenohQuery)> _queryables = {};
+  static final Map<int, StreamController<ZenohLivelinessEvent>>
+      _livelinessSubscribers = {};
+  static final Map<int, Completer<void>> _queryCompleters = {};
+  static final Map<int, Completer<String?>> _pageCompleters = {};
+  static final Map<int, StreamController<ZenohMultiReply>> _multiQueries = {};
+  static final Map<int, ZenohRpcServer> _rpcServers = {};
+  static final Map<int, Completer<Uint8List>> _rpcCalls = {};
+  static final Map<int, void Function(ZenohChunkProgress)>
+      _chunkProgressHandlers = {};
+  static final Map<int, Completer<int>> _chunkedPuts = {};
+  static final Map<int, StreamController<bool>> _matchingListeners = {};
+  static final Map<int, StreamController<ZenohStorageChange>> _storageChanges =
+      {};
+  static final Map<int, Completer<void>> _subscriberReady = {};
+  static final Map<int, void Function(ZenohSampleMiss)> _sampleMissHandlers =
+      {};
+  static final Map<int, Completer<ZenohSession>> _sessionOpens = {};
+  static final Map<int, Completer<Duration>> _sessionCloses = {};
+  static final Map<int, Completer<Pointer<bindings.ZenohSessionGroup>>>
+      _sessionGroupOpens = {};
+  static final Map<int, StreamController<ZenohLivelinessDelta>>
+      _livelinessTrackers = {};
+  static final Map<int, StreamController<ZenohHello>> _scouts = {};
+  static final Map<int, Completer<ZenohScoutConnection>> _scoutConnects = {};
+
+  static int _nextSubscriberId = 0;
+  static int _nextRpcId = 1;
+  static int _nextQueryId = 0;
+  static int _nextQueryableId = 0;
+  static int _nextLivelinessId = 0;
+  static int _nextMatchingId = 0;
+  static int _nextStorageId = 0;
+  static int _nextChunkedPutId = 0;
+  static int _nextSessionOpId = 0;
+  static int _nextScoutId = 0;
+
+  // Native callback pointers
+  static NativeCallable<bindings.ZenohSubscriberCallbackFunction>?
+      _subscriberCallback;
+  static NativeCallable<bindings.ZenohGetCallbackFunction>? _queryCallback;
+  static NativeCallable<bindings.ZenohGetCallbackExFunction>? _queryCallbackEx;
+  static NativeCallable<bindings.ZenohGetMultiCallbackFunction>?
+      _multiQueryCallback;
+  static NativeCallable<bindings.ZenohGetPageCallbackFunction>?
+      _queryPageCallback;
+  static NativeCallable<bindings.ZenohRpcRequestCallbackFunction>?
+      _rpcRequestCallback;
+  static NativeCallable<bindings.ZenohRpcResponseCallbackFunction>?
+      _rpcResponseCallback;
+  static NativeCallable<bindings.ZenohQueryCallbackFunction>?
+      _queryableCallback;
+  static NativeCallable<bindings.ZenohLivelinessCallbackFunction>?
+      _livelinessCallback;
+  static NativeCallable<bindings.ZenohGetCompleteCallbackFunction>?
+      _queryCompleteCallback;
+  static NativeCallable<bindings.ZenohSubscriberShmCallbackFunction>?
+      _shmSubscriberCallback;
+  static NativeCallable<bindings.ZenohChunkedCallbackFunction>?
+      _chunkedCallback;
+  static NativeCallable<bindings.ZenohChunkProgressCallbackFunction>?
+      _chunkProgressCallback;
+  static NativeCallable<bindings.ZenohChunkedPutCallbackFunction>?
+      _chunkedPutCallback;
+  static NativeCallable<bindings.ZenohMatchingCallbackFunction>?
+      _matchingCallback;
+  static NativeCallable<bindings.ZenohStorageChangeCallbackFunction>?
+      _storageChangeCallback;
+  static NativeCallable<bindings.ZenohSubscriberCallbackExFunction>?
+      _subscriberCallbackEx;
+  static NativeCallable<bindings.ZenohGetCompleteCallbackFunction>?
+      _subscriberReadyCallback;
+  static NativeCallable<bindings.ZenohSampleMissCallbackFunction>?
+      _sampleMissCallback;
+  static NativeCallable<bindings.ZenohSessionOpenCallbackFunction>?
+      _sessionOpenCallback;
+  static NativeCallable<bindings.ZenohSessionCloseCallbackFunction>?
+      _sessionCloseCallback;
+  static NativeCallable<bindings.ZenohSessionGroupOpenCallbackFunction>?
+      _sessionGroupOpenCallback;
+  static NativeCallable<bindings.ZenohLivelinessDeltaCallbackFunction>?
+      _livelinessDeltaCallback;
+  static NativeCallable<bindings.ZenohScoutCallbackFunction>? _scoutCallback;
+  static NativeCallable<bindings.ZenohScoutConnectCallbackFunction>?
+      _scoutConnectCallback;
+
+  ZenohSession._(this._handle, [this.openDuration, this._grouped = false]);
+
+  /// Size zenoh's runtime thread pools. zenoh reads this once, so it must
+  /// be called before the first session is opened.
+  static void configureRuntime(ZenohRuntimeConfig config) {
+    final configPtr = calloc<bindings.ZenohRuntimeConfig>();
+    configPtr.ref
+      ..app_workers = config.appWorkers ?? 0
+      ..acc_workers = config.acceptorWorkers ?? 0
+      ..tx_workers = config.txWorkers ?? 0
+      ..rx_workers = config.rxWorkers ?? 0
+      ..max_blocking_threads = config.maxBlockingThreads ?? 0;
+    final result = _bindings.zenoh_runtime_configure(configPtr);
+    calloc.free(configPtr);
+    if (result == -2) {
+      throw ZenohSessionException(
+          'Runtime already started; configure it before opening a session',
+          result);
+    }
+    if (result < 0) {
+      throw ZenohSessionException('Failed to configure runtime', result);
+    }
+  }
+
+  /// Pin and prioritise the native threads of [kind], e.g. to keep zenoh's
+  /// delivery threads off the cores running the UI. Delivery threads apply
+  /// the policy before their next callback, library threads when they
+  /// start. Pass null to stop applying a policy to new threads.
+  static void setThreadPolicy(ZenohThreadKind kind, ZenohThreadPolicy? policy) {
+    Pointer<bindings.ZenohThreadPolicy> policyPtr = nullptr;
+    if (policy != null) {
+      policyPtr = calloc<bindings.ZenohThreadPolicy>();
+      var mask = 0;
+      for (final cpu in policy.cpus) {
+        if (cpu < 0 || cpu >= 64) {
+          calloc.free(policyPtr);
+          throw ArgumentError.value(cpu, 'cpus', 'must be in 0..63');
+        }
+        mask |= 1 << cpu;
       }
-    } catch (e) {
-      print('Error in subscriber callback: $e');
+      policyPtr.ref
+        ..cpu_mask = mask
+        ..set_nice = policy.nice != null
+        ..nice = policy.nice ?? 0;
+    }
+    final result = _bindings.zenoh_set_thread_policy(kind.value, policyPtr);
+    if (policyPtr != nullptr) calloc.free(policyPtr);
+    if (result < 0) {
+      throw ZenohSessionException('Failed to set thread policy', result);
+    }
+  }
+
+  /// CPU time of every live native thread that delivered a callback or was
+  /// started by the library. Threads that have exited drop out; exited
+  /// library threads are summed in one entry with a thread id of 0.
+  static List<ZenohThreadStats> get threadStats {
+    const max = 65; // Every tracked thread plus the exited-worker entry
+    final statsPtr = calloc<bindings.ZenohThreadStats>(max);
+    final n = _bindings.zenoh_thread_stats(statsPtr, max);
+    final result = [
+      for (var i = 0; i < n; i++)
+        ZenohThreadStats(
+          threadId: statsPtr[i].thread_id,
+          kind: ZenohThreadKind.values
+              .firstWhere((k) => k.value == statsPtr[i].kind),
+          cpuTime: Duration(microseconds: statsPtr[i].cpu_time_us),
+          callbacks: statsPtr[i].callbacks,
+          policyApplied: statsPtr[i].policy_result == 0,
+        ),
+    ];
+    calloc.free(statsPtr);
+    return result;
+  }
+
+  /// Open a Zenoh session with mode and endpoints
+  static Future<ZenohSession> open({
+    String mode = 'client',
+    List<String> endpoints = const [],
+  }) async {
+    final modePtr = mode.toNativeUtf8().cast<Char>();
+
+    Pointer<Char> endpointsPtr = nullptr;
+    if (endpoints.isNotEmpty) {
+      final endpointsJson = jsonEncode(endpoints);
+      endpointsPtr = endpointsJson.toNativeUtf8().cast<Char>();
+    }
+
+    final handle = _bindings.zenoh_open_session(modePtr, endpointsPtr);
+
+    calloc.free(modePtr);
+    if (endpointsPtr != nullptr) calloc.free(endpointsPtr);
+
+    if (handle == nullptr) {
+      throw ZenohSessionException('Failed to open Zenoh session');
+    }
+
+    _ensureCallbacksInitialized();
+    return ZenohSession._(handle);
+  }
+
+  /// Open a Zenoh session with a configuration builder.
+  ///
+  /// The open runs on a native worker thread so the isolate is not blocked
+  /// while transports connect; [openDuration] reports how long it took.
+  static Future<ZenohSession> openWithConfig(ZenohConfigBuilder config) async {
+    _ensureCallbacksInitialized();
+    final configJson = config.build();
+    final configPtr = configJson.toNativeUtf8().cast<Char>();
+
+    final id = _nextSessionOpId++;
+    final completer = Completer<ZenohSession>();
+    _sessionOpens[id] = completer;
+
+    final result = _bindings.zenoh_open_session_async(
+      configPtr,
+      _sessionOpenCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(configPtr);
+
+    if (result != 0) {
+      _sessionOpens.remove(id);
+      throw ZenohSessionException(
+          'Failed to open Zenoh session with config', result);
+    }
+    return completer.future;
+  }
+
+  static void _ensureCallbacksInitialized() {
+    _subscriberCallback ??=
+        NativeCallable<bindings.ZenohSubscriberCallbackFunction>.listener(
+            _onSubscriberData);
+    _queryCallback ??=
+        NativeCallable<bindings.ZenohGetCallbackFunction>.listener(
+            _onQueryData);
+    _queryCallbackEx ??=
+        NativeCallable<bindings.ZenohGetCallbackExFunction>.listener(
+            _onQueryDataEx);
+    _multiQueryCallback ??=
+        NativeCallable<bindings.ZenohGetMultiCallbackFunction>.listener(
+            _onMultiQueryData);
+    _queryPageCallback ??=
+        NativeCallable<bindings.ZenohGetPageCallbackFunction>.listener(
+            _onQueryPage);
+    _rpcRequestCallback ??=
+        NativeCallable<bindings.ZenohRpcRequestCallbackFunction>.listener(
+            _onRpcRequest);
+    _rpcResponseCallback ??=
+        NativeCallable<bindings.ZenohRpcResponseCallbackFunction>.listener(
+            _onRpcResponse);
+    _queryableCallback ??=
+        NativeCallable<bindings.ZenohQueryCallbackFunction>.listener(
+            _onQueryRequest);
+    _livelinessCallback ??=
+        NativeCallable<bindings.ZenohLivelinessCallbackFunction>.listener(
+            _onLivelinessEvent);
+    _queryCompleteCallback ??=
+        NativeCallable<bindings.ZenohGetCompleteCallbackFunction>.listener(
+            _onQueryComplete);
+    _shmSubscriberCallback ??=
+        NativeCallable<bindings.ZenohSubscriberShmCallbackFunction>.listener(
+            _onShmSubscriberData);
+    _chunkedCallback ??=
+        NativeCallable<bindings.ZenohChunkedCallbackFunction>.listener(
+            _onChunkedData);
+    _chunkProgressCallback ??=
+        NativeCallable<bindings.ZenohChunkProgressCallbackFunction>.listener(
+            _onChunkProgress);
+    _chunkedPutCallback ??=
+        NativeCallable<bindings.ZenohChunkedPutCallbackFunction>.listener(
+            _onChunkedPut);
+    _matchingCallback ??=
+        NativeCallable<bindings.ZenohMatchingCallbackFunction>.listener(
+            _onMatchingStatus);
+    _storageChangeCallback ??=
+        NativeCallable<bindings.ZenohStorageChangeCallbackFunction>.listener(
+            _onStorageChange);
+    _subscriberCallbackEx ??=
+        NativeCallable<bindings.ZenohSubscriberCallbackExFunction>.listener(
+            _onSubscriberDataEx);
+    _subscriberReadyCallback ??=
+        NativeCallable<bindings.ZenohGetCompleteCallbackFunction>.listener(
+            _onSubscriberReady);
+    _sampleMissCallback ??=
+        NativeCallable<bindings.ZenohSampleMissCallbackFunction>.listener(
+            _onSampleMiss);
+    _sessionOpenCallback ??=
+        NativeCallable<bindings.ZenohSessionOpenCallbackFunction>.listener(
+            _onSessionOpened);
+    _sessionCloseCallback ??=
+        NativeCallable<bindings.ZenohSessionCloseCallbackFunction>.listener(
+            _onSessionClosed);
+    _sessionGroupOpenCallback ??=
+        NativeCallable<bindings.ZenohSessionGroupOpenCallbackFunction>.listener(
+            _onSessionGroupOpened);
+    _livelinessDeltaCallback ??=
+        NativeCallable<bindings.ZenohLivelinessDeltaCallbackFunction>.listener(
+            _onLivelinessDelta);
+    _scoutCallback ??=
+        NativeCallable<bindings.ZenohScoutCallbackFunction>.listener(
+            _onScoutHello);
+    _scoutConnectCallback ??=
+        NativeCallable<bindings.ZenohScoutConnectCallbackFunction>.listener(
+            _onScoutConnected);
+  }
+
+  void _checkClosed() {
+    if (_isClosed) throw ZenohSessionException('Session is closed');
+  }
+
+  /// Get the session's unique identifier
+  String? get sessionId {
+    _checkClosed();
+    final infoPtr = _bindings.zenoh_session_info(_handle);
+    if (infoPtr == nullptr) return null;
+    final info = infoPtr.cast<Utf8>().toDartString();
+    _bindings.zenoh_free_string(infoPtr.cast());
+    return info;
+  }
+
+  /// Counters of this session and every entity declared on it. Cheap enough
+  /// to poll periodically.
+  ZenohStats get stats {
+    _checkClosed();
+    final stats = ZenohStats._read(
+        (out) => _bindings.zenoh_session_stats_snapshot(_handle, out));
+    if (stats == null) {
+      throw ZenohSessionException('Failed to read session stats');
+    }
+    return stats;
+  }
+
+  /// Close the session. The shutdown runs on a native worker thread and the
+  /// returned future completes once it has finished.
+  Future<void> close() async {
+    if (_isClosed) return;
+    if (_grouped) {
+      throw ZenohSessionException(
+          'Session belongs to a group; close the group instead');
+    }
+    _isClosed = true;
+
+    final id = _nextSessionOpId++;
+    final completer = Completer<Duration>();
+    _sessionCloses[id] = completer;
+
+    final result = _bindings.zenoh_close_session_async(
+      _handle,
+      _sessionCloseCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    if (result != 0) {
+      _sessionCloses.remove(id);
+      _bindings.zenoh_close_session(_handle);
+      return;
+    }
+    _closeDuration = await completer.future;
+  }
+
+  // ============================================================================
+  // Publisher Operations
+  // ============================================================================
+
+  /// Declare a publisher on a key expression
+  Future<ZenohPublisher> declarePublisher(
+    String key, {
+    ZenohPublisherOptions options = ZenohPublisherOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+
+    final optsPtr = _publisherOptionsToNative(options);
+    final pubHandle = _bindings.zenoh_declare_publisher_with_options(
+        _handle, keyPtr, optsPtr);
+
+    calloc.free(keyPtr);
+    calloc.free(optsPtr);
+
+    if (pubHandle == nullptr) {
+      throw ZenohPublisherException(
+          'Failed to declare publisher for key: $key');
+    }
+
+    return ZenohPublisher._(pubHandle);
+  }
+
+  static Pointer<bindings.ZenohPublisherOptions> _publisherOptionsToNative(
+      ZenohPublisherOptions options) {
+    final optsPtr = calloc<bindings.ZenohPublisherOptions>();
+    optsPtr.ref.priority = options.priority.value;
+    optsPtr.ref.congestion_control = options.congestionControl.value;
+    optsPtr.ref.encoding = options.encoding.value;
+    optsPtr.ref.is_express = options.express;
+    optsPtr.ref.encoding_schema = nullptr;
+    return optsPtr;
+  }
+
+  /// Declare a publisher for each of [keys] in one native call, stored in
+  /// one native block. Much cheaper than [declarePublisher] in a loop when
+  /// declaring thousands. Fails as a whole: if any key is rejected, the
+  /// others are undeclared again.
+  Future<List<ZenohPublisher>> declarePublishers(
+    List<String> keys, {
+    ZenohPublisherOptions options = ZenohPublisherOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    if (keys.isEmpty) return [];
+
+    final keysPtr = _packKeys(keys);
+    final optsPtr = _publisherOptionsToNative(options);
+    final handlesPtr = calloc<Pointer<bindings.ZenohPublisher>>(keys.length);
+    try {
+      final declared = _bindings.zenoh_declare_publishers_bulk(
+          _handle, keysPtr, keys.length, optsPtr, 1, handlesPtr);
+      if (declared < keys.length) {
+        final failed = [
+          for (var i = 0; i < keys.length; i++)
+            if (handlesPtr[i] == nullptr) keys[i],
+        ];
+        _bindings.zenoh_undeclare_publishers_bulk(handlesPtr, keys.length);
+        throw ZenohPublisherException(
+            'Failed to declare publishers for keys: ${failed.join(', ')}');
+      }
+      return [
+        for (var i = 0; i < keys.length; i++) ZenohPublisher._(handlesPtr[i]),
+      ];
     } finally {
-      // Free native memory allocated by C side
-      malloc.free(key);
-      malloc.free(kind);
-      if (attachment.address != 0) malloc.free(attachment);
-      if (value.address != 0 && len > 0) malloc.free(value);
+      calloc.free(keysPtr);
+      calloc.free(optsPtr);
+      calloc.free(handlesPtr);
+    }
+  }
+
+  /// Keys as NUL-terminated strings back to back, in one allocation
+  static Pointer<Char> _packKeys(List<String> keys) {
+    final packed = packKeys(keys);
+    final ptr = calloc<Uint8>(packed.length);
+    ptr.asTypedList(packed.length).setAll(0, packed);
+    return ptr.cast();
+  }
+
+  /// Put data on a key expression (ad-hoc publish)
+  Future<void> put(
+    String key,
+    Uint8List data, {
+    ZenohPutOptions options = ZenohPutOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final dataPtr = calloc<Uint8>(data.length);
+    final dataList = dataPtr.asTypedList(data.length);
+    dataList.setAll(0, data);
+
+    // Create options struct
+    final optsPtr = calloc<bindings.ZenohPutOptions>();
+    optsPtr.ref.priority = options.priority.value;
+    optsPtr.ref.congestion_control = options.congestionControl.value;
+    optsPtr.ref.encoding = options.encoding.value;
+    optsPtr.ref.is_express = options.express;
+    optsPtr.ref.encoding_schema = nullptr;
+
+    if (options.attachment != null && options.attachment!.isNotEmpty) {
+      final attPtr = calloc<Uint8>(options.attachment!.length);
+      attPtr
+          .asTypedList(options.attachment!.length)
+          .setAll(0, options.attachment!);
+      optsPtr.ref.attachment = attPtr;
+      optsPtr.ref.attachment_len = options.attachment!.length;
+    } else {
+      optsPtr.ref.attachment = nullptr;
+      optsPtr.ref.attachment_len = 0;
+    }
+
+    final result = _bindings.zenoh_put_with_options(
+        _handle, keyPtr, dataPtr, data.length, optsPtr);
+
+    if (optsPtr.ref.attachment != nullptr) {
+      calloc.free(optsPtr.ref.attachment);
+    }
+    calloc.free(keyPtr);
+    calloc.free(dataPtr);
+    calloc.free(optsPtr);
+
+    if (result < 0) throw ZenohException('Put failed', result);
+  }
+
+  /// Put a string on a key expression
+  Future<void> putString(
+    String key,
+    String value, {
+    ZenohPutOptions? options,
+  }) async {
+    await put(
+      key,
+      Uint8List.fromList(utf8.encode(value)),
+      options:
+          options ?? const ZenohPutOptions(encoding: ZenohEncoding.textPlain),
+    );
+  }
+
+  /// Put JSON data on a key expression
+  Future<void> putJson(
+    String key,
+    Object value, {
+    Uint8List? attachment,
+  }) async {
+    await put(
+      key,
+      Uint8List.fromList(utf8.encode(jsonEncode(value))),
+      options: ZenohPutOptions(
+        encoding: ZenohEncoding.applicationJson,
+        attachment: attachment,
+      ),
+    );
+  }
+
+  /// Delete data on a key expression
+  Future<void> delete(String key) async {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+
+    final result = _bindings.zenoh_delete(_handle, keyPtr);
+    calloc.free(keyPtr);
+
+    if (result < 0) throw ZenohException('Delete failed', result);
+  }
+
+  // ============================================================================
+  // Subscriber Operations
+  // ============================================================================
+
+  /// Declare a subscriber on a key expression
+  ///
+  /// With [extended], samples also carry their encoding, priority,
+  /// congestion control, attachment and timestamp, and are not logged.
+  Future<ZenohSubscriber> declareSubscriber(String key,
+      {bool extended = false}) async {
+    _checkClosed();
+
+    final id = _nextSubscriberId++;
+    final controller = StreamController<ZenohSample>();
+    _subscribers[id] = controller;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+
+    final subHandle = extended
+        ? _bindings.zenoh_declare_subscriber_ex(
+            _handle,
+            keyPtr,
+            _subscriberCallbackEx!.nativeFunction,
+            context,
+          )
+        : _bindings.zenoh_declare_subscriber(
+            _handle,
+            keyPtr,
+            _subscriberCallback!.nativeFunction,
+            context,
+          );
+    calloc.free(keyPtr);
+
+    if (subHandle == nullptr) {
+      _subscribers.remove(id);
+      throw ZenohSubscriberException(
+          'Failed to declare subscriber for key: $key');
+    }
+
+    controller.onCancel = () {
+      // Cleanup handled in undeclare
+    };
+
+    return ZenohSubscriber._(subHandle, controller, id);
+  }
+
+  /// Declare a subscriber for each of [keys] in one native call, stored in
+  /// one native block. Fails as a whole like [declarePublishers]. Like
+  /// [declareSubscriber], the subscribers take no options.
+  Future<List<ZenohSubscriber>> declareSubscribers(List<String> keys) async {
+    _checkClosed();
+    if (keys.isEmpty) return [];
+
+    final ids = <int>[];
+    final controllers = <StreamController<ZenohSample>>[];
+    final contextsPtr = calloc<Pointer<Void>>(keys.length);
+    for (var i = 0; i < keys.length; i++) {
+      final id = _nextSubscriberId++;
+      final controller = StreamController<ZenohSample>();
+      _subscribers[id] = controller;
+      ids.add(id);
+      controllers.add(controller);
+      contextsPtr[i] = Pointer<Void>.fromAddress(id);
+    }
+
+    final keysPtr = _packKeys(keys);
+    final handlesPtr = calloc<Pointer<bindings.ZenohSubscriber>>(keys.length);
+    try {
+      final declared = _bindings.zenoh_declare_subscribers_bulk(
+        _handle,
+        keysPtr,
+        keys.length,
+        _subscriberCallback!.nativeFunction,
+        contextsPtr,
+        handlesPtr,
+      );
+      if (declared < keys.length) {
+        final failed = [
+          for (var i = 0; i < keys.length; i++)
+            if (handlesPtr[i] == nullptr) keys[i],
+        ];
+        _bindings.zenoh_undeclare_subscribers_bulk(handlesPtr, keys.length);
+        for (var i = 0; i < keys.length; i++) {
+          _subscribers.remove(ids[i]);
+          controllers[i].close();
+        }
+        throw ZenohSubscriberException(
+            'Failed to declare subscribers for keys: ${failed.join(', ')}');
+      }
+      return [
+        for (var i = 0; i < keys.length; i++)
+          ZenohSubscriber._(handlesPtr[i], controllers[i], ids[i]),
+      ];
+    } finally {
+      calloc.free(keysPtr);
+      calloc.free(contextsPtr);
+      calloc.free(handlesPtr);
+    }
+  }
+
+  /// Declare a subscriber that receives shared-memory payloads without
+  /// copying. Payloads of SHM samples are views into the mapped segment,
+  /// released when the [ZenohSample.payload] is garbage collected; other
+  /// samples are delivered as regular copies.
+  Future<ZenohSubscriber> declareShmSubscriber(String key) async {
+    _checkClosed();
+
+    final id = _nextSubscriberId++;
+    final controller = StreamController<ZenohSample>();
+    _subscribers[id] = controller;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+
+    final subHandle = _bindings.zenoh_declare_subscriber_shm(
+      _handle,
+      keyPtr,
+      _shmSubscriberCallback!.nativeFunction,
+      context,
+    );
+    calloc.free(keyPtr);
+
+    if (subHandle == nullptr) {
+      _subscribers.remove(id);
+      throw ZenohSubscriberException(
+          'Failed to declare SHM subscriber for key: $key');
+    }
+
+    return ZenohSubscriber._(subHandle, controller, id);
+  }
+
+  /// Declare a subscriber that reassembles transfers sent with
+  /// [ZenohPublisher.putChunked] and only emits complete objects.
+  ///
+  /// Plain samples on [key] are passed through unchanged. Objects larger than
+  /// [maxObjectSize] bytes (0 = 256 MiB) or split into more than 2^20 chunks
+  /// are dropped, as are transfers that make no progress for [timeout]. New
+  /// transfers are also refused while the in-flight ones hold 512 MiB.
+  Future<ZenohSubscriber> declareChunkedSubscriber(
+    String key, {
+    int maxObjectSize = 256 * 1024 * 1024,
+    Duration timeout = const Duration(seconds: 30),
+    void Function(ZenohChunkProgress)? onProgress,
+  }) async {
+    _checkClosed();
+
+    final id = _nextSubscriberId++;
+    final controller = StreamController<ZenohSample>();
+    _subscribers[id] = controller;
+    if (onProgress != null) _chunkProgressHandlers[id] = onProgress;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+
+    final subHandle = _bindings.zenoh_declare_chunked_subscriber(
+      _handle,
+      keyPtr,
+      _chunkedCallback!.nativeFunction,
+      onProgress != null ? _chunkProgressCallback!.nativeFunction : nullptr,
+      maxObjectSize,
+      timeout.inMilliseconds,
+      context,
+    );
+    calloc.free(keyPtr);
+
+    if (subHandle == nullptr) {
+      _subscribers.remove(id);
+      _chunkProgressHandlers.remove(id);
+      throw ZenohSubscriberException(
+          'Failed to declare chunked subscriber for key: $key');
+    }
+
+    return ZenohSubscriber._(subHandle, controller, id);
+  }
+
+  /// Declare a subscriber that first queries [key] for the current state
+  ///
+  /// Live samples are held back natively until the query completes; replies
+  /// and held samples are then emitted in timestamp order without
+  /// duplicates, followed by the live stream. [ZenohQueryingSubscriber.ready]
+  /// completes once the initial state has been delivered. Throws
+  /// [ZenohSubscriberException] when the query cannot be sent.
+  Future<ZenohQueryingSubscriber> declareQueryingSubscriber(
+    String key, {
+    ZenohQueryingSubscriberOptions options =
+        ZenohQueryingSubscriberOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+
+    final id = _nextSubscriberId++;
+    final controller = StreamController<ZenohSample>();
+    final ready = Completer<void>();
+    _subscribers[id] = controller;
+    _subscriberReady[id] = ready;
+
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final selectorPtr =
+        options.querySelector?.toNativeUtf8().cast<Char>() ?? nullptr;
+    final optsPtr = calloc<bindings.ZenohQueryingSubscriberOptions>();
+    optsPtr.ref.query_selector = selectorPtr;
+    optsPtr.ref.query_target = options.queryTarget.value;
+    optsPtr.ref.query_consolidation = options.queryConsolidation.value;
+    optsPtr.ref.query_timeout_ms = options.queryTimeout.inMilliseconds;
+    optsPtr.ref.allowed_origin = options.allowedOrigin.value;
+
+    final subHandle = _bindings.zenoh_declare_querying_subscriber(
+      _handle,
+      keyPtr,
+      optsPtr,
+      _subscriberCallbackEx!.nativeFunction,
+      _subscriberReadyCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(keyPtr);
+    if (selectorPtr != nullptr) calloc.free(selectorPtr);
+    calloc.free(optsPtr);
+
+    if (subHandle == nullptr) {
+      _subscribers.remove(id);
+      _subscriberReady.remove(id);
+      throw ZenohSubscriberException(
+          'Failed to declare querying subscriber for key: $key');
+    }
+
+    return ZenohQueryingSubscriber._(subHandle, controller, ready.future, id);
+  }
+
+  /// Declare a subscriber that recovers history and lost samples from
+  /// advanced publishers
+  ///
+  /// Requires zenoh-c built with its unstable API; see
+  /// [ZenohAdvancedSubscriber.isAvailable]. [onMiss] reports samples that
+  /// could not be recovered.
+  Future<ZenohAdvancedSubscriber> declareAdvancedSubscriber(
+    String key, {
+    ZenohAdvancedSubscriberOptions options =
+        ZenohAdvancedSubscriberOptions.defaultOptions,
+    void Function(ZenohSampleMiss)? onMiss,
+  }) async {
+    _checkClosed();
+    if (!ZenohAdvancedSubscriber.isAvailable) {
+      throw ZenohSubscriberException(
+          'Advanced subscribers need zenoh-c built with the unstable API');
+    }
+
+    final id = _nextSubscriberId++;
+    final controller = StreamController<ZenohSample>();
+    _subscribers[id] = controller;
+    if (onMiss != null) _sampleMissHandlers[id] = onMiss;
+
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final optsPtr = calloc<bindings.ZenohAdvancedSubscriberOptions>();
+    optsPtr.ref.history = options.history;
+    optsPtr.ref.detect_late_publishers = options.detectLatePublishers;
+    optsPtr.ref.history_max_samples = options.historyMaxSamples;
+    optsPtr.ref.history_max_age_ms = options.historyMaxAge?.inMilliseconds ?? 0;
+    optsPtr.ref.recovery = options.recovery;
+    optsPtr.ref.recovery_period_ms = options.recoveryPeriod?.inMilliseconds ?? 0;
+    optsPtr.ref.query_timeout_ms = options.queryTimeout?.inMilliseconds ?? 0;
+    optsPtr.ref.subscriber_detection = options.subscriberDetection;
+    optsPtr.ref.allowed_origin = options.allowedOrigin.value;
+
+    final subHandle = _bindings.zenoh_declare_advanced_subscriber(
+      _handle,
+      keyPtr,
+      optsPtr,
+      _subscriberCallbackEx!.nativeFunction,
+      onMiss != null ? _sampleMissCallback!.nativeFunction : nullptr,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(keyPtr);
+    calloc.free(optsPtr);
+
+    if (subHandle == nullptr) {
+      _subscribers.remove(id);
+      _sampleMissHandlers.remove(id);
+      throw ZenohSubscriberException(
+          'Failed to declare advanced subscriber for key: $key');
+    }
+
+    return ZenohAdvancedSubscriber._(subHandle, controller, id);
+  }
+
+  // ============================================================================
+  // RPC
+  // ============================================================================
+
+  /// Serve RPC methods on [serviceKey]
+  ///
+  /// Register methods with [ZenohRpcServer.register] for Dart handlers or
+  /// [ZenohRpcServer.registerNative] for C handlers, which answer on the
+  /// zenoh thread without a Dart round trip.
+  Future<ZenohRpcServer> declareRpcServer(String serviceKey) async {
+    _checkClosed();
+    final id = _nextRpcId++;
+    final keyPtr = serviceKey.toNativeUtf8().cast<Char>();
+    final handle = _bindings.zenoh_declare_rpc_server(
+      _handle,
+      keyPtr,
+      _rpcRequestCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(keyPtr);
+
+    if (handle == nullptr) {
+      throw ZenohQueryableException(
+          'Failed to declare RPC server for key: $serviceKey');
+    }
+    final server = ZenohRpcServer._(handle, id);
+    _rpcServers[id] = server;
+    return server;
+  }
+
+  /// Create a client calling the RPC service on [serviceKey]
+  ///
+  /// All calls share one querier and may be in flight concurrently.
+  Future<ZenohRpcClient> declareRpcClient(
+    String serviceKey, {
+    ZenohRpcClientOptions options = ZenohRpcClientOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    final keyPtr = serviceKey.toNativeUtf8().cast<Char>();
+    final optsPtr = calloc<bindings.ZenohRpcClientOptions>();
+    optsPtr.ref.attempt_timeout_ms = options.attemptTimeout.inMilliseconds;
+    optsPtr.ref.priority = options.priority.value;
+    optsPtr.ref.is_express = options.express;
+    optsPtr.ref.target = options.target.value;
+    optsPtr.ref.allowed_destination = options.allowedDestination.value;
+
+    final handle = _bindings.zenoh_rpc_client_new(_handle, keyPtr, optsPtr);
+    calloc.free(keyPtr);
+    calloc.free(optsPtr);
+
+    if (handle == nullptr) {
+      throw ZenohQueryException(
+          'Failed to declare RPC client for key: $serviceKey');
+    }
+    return ZenohRpcClient._(handle);
+  }
+
+  // ============================================================================
+  // Query (Get) Operations
+  // ============================================================================
+
+  /// Query data from the network
+  ///
+  /// [selector] is a key expression optionally followed by `?` and
+  /// parameters, e.g. `sensors/**?limit=100`.
+  ///
+  /// Replies carry their encoding, attachment, timestamp and replier id.
+  /// Only successful replies are delivered; use [getEx] to also receive the
+  /// error replies of queryables.
+  Stream<ZenohReply> get(
+    String selector, {
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+  }) =>
+      getEx(selector, options: options).where((reply) => !reply.isError);
+
+  /// Like [get], but also delivers error replies from queryables, flagged
+  /// with [ZenohReply.isError] and carrying an empty [ZenohReply.key].
+  Stream<ZenohReply> getEx(
+    String selector, {
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+  }) {
+    _checkClosed();
+    final id = _nextQueryId++;
+    final controller = StreamController<ZenohReply>();
+    final completer = Completer<void>();
+    _queries[id] = controller;
+    _queryCompleters[id] = completer;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final selectorPtr = selector.toNativeUtf8().cast<Char>();
+
+    final optsPtr = _getOptionsToNative(options);
+
+    final result = _bindings.zenoh_get_async_ex(
+      _handle,
+      selectorPtr,
+      _queryCallbackEx!.nativeFunction,
+      _queryCompleteCallback!.nativeFunction,
+      context,
+      optsPtr,
+    );
+
+    calloc.free(selectorPtr);
+    _freeGetOptions(optsPtr);
+
+    if (result < 0) {
+      // No callback will ever run for this query
+      _queries.remove(id);
+      _queryCompleters.remove(id);
+      controller.addError(
+          ZenohQueryException('Failed to query: $selector', result));
+      controller.close();
+      return controller.stream;
+    }
+
+    // The stream will be closed when the query completes (via completion callback)
+    // Add a timeout fallback just in case
+    Future.delayed(options.timeout + const Duration(seconds: 1), () {
+      if (!controller.isClosed) {
+        controller.close();
+        _queries.remove(id);
+        _queryCompleters.remove(id);
+      }
+    });
+
+    return controller.stream;
+  }
+
+  /// Query and collect all replies into a list
+  Future<List<ZenohReply>> getCollect(
+    String selector, {
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+  }) async {
+    final replies = <ZenohReply>[];
+    await for (final reply in get(selector, options: options)) {
+      replies.add(reply);
+    }
+    return replies;
+  }
+
+  /// Query into a bounded native channel that is drained at the caller's pace
+  ///
+  /// Unlike [get], replies are not pushed to Dart: they wait in a channel of
+  /// [capacity] replies until pulled with [ZenohReplyChannel.tryRecvBatch]
+  /// or [ZenohReplyChannel.replies]. This bounds memory for queries with
+  /// very many replies.
+  ZenohReplyChannel getChannel(
+    String selector, {
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+    ZenohReplyChannelKind kind = ZenohReplyChannelKind.fifo,
+    int capacity = 256,
+  }) {
+    _checkClosed();
+    final selectorPtr = selector.toNativeUtf8().cast<Char>();
+    final optsPtr = _getOptionsToNative(options);
+    final handle = _bindings.zenoh_get_channel(
+        _handle, selectorPtr, optsPtr, kind.value, capacity);
+    calloc.free(selectorPtr);
+    _freeGetOptions(optsPtr);
+
+    if (handle == nullptr) {
+      throw ZenohQueryException('Failed to query: $selector');
+    }
+    return ZenohReplyChannel._(handle);
+  }
+
+  /// Query one page of at most [limit] replies, resuming after [cursor]
+  ///
+  /// The limit and cursor are pushed down to storages and enforced again
+  /// natively, so replies beyond the page are never copied into Dart. The
+  /// page holds the smallest keys after [cursor] in key order, whatever order
+  /// the replies arrive in. Pass [ZenohPage.nextCursor] as [cursor] to fetch
+  /// the following page.
+  Future<ZenohPage> getPage(
+    String selector, {
+    required int limit,
+    String? cursor,
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    if (limit < 0) {
+      throw ArgumentError.value(limit, 'limit', 'must not be negative');
+    }
+    final id = _nextQueryId++;
+    final controller = StreamController<ZenohReply>();
+    final next = Completer<String?>();
+    _queries[id] = controller;
+    _pageCompleters[id] = next;
+
+    final selectorPtr = selector.toNativeUtf8().cast<Char>();
+    final optsPtr = _getOptionsToNative(options);
+    optsPtr.ref.limit = limit;
+    if (optsPtr.ref.cursor != nullptr) calloc.free(optsPtr.ref.cursor);
+    optsPtr.ref.cursor = cursor?.toNativeUtf8().cast<Char>() ?? nullptr;
+
+    final result = _bindings.zenoh_get_async_paged(
+      _handle,
+      selectorPtr,
+      _queryCallbackEx!.nativeFunction,
+      _queryPageCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+      optsPtr,
+    );
+    calloc.free(selectorPtr);
+    _freeGetOptions(optsPtr);
+
+    if (result < 0) {
+      _queries.remove(id);
+      _pageCompleters.remove(id);
+      throw ZenohQueryException('Failed to query: $selector', result);
+    }
+
+    final replies = await controller.stream.toList();
+    return ZenohPage(replies, await next.future);
+  }
+
+  /// Query several selectors at once under one shared deadline
+  ///
+  /// All queries are issued natively in one call with the same [options];
+  /// [ZenohGetOptions.timeout] bounds the whole batch. Each reply is tagged
+  /// with the index of its selector. The stream closes when every query is
+  /// done, or once [quorum] data replies have arrived (0 waits for all).
+  Stream<ZenohMultiReply> getMulti(
+    List<String> selectors, {
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+    int quorum = 0,
+  }) {
+    _checkClosed();
+    if (quorum < 0) {
+      throw ArgumentError.value(quorum, 'quorum', 'must not be negative');
+    }
+    final id = _nextQueryId++;
+    final controller = StreamController<ZenohMultiReply>();
+    _multiQueries[id] = controller;
+
+    final selectorsPtr = calloc<Pointer<Char>>(selectors.length);
+    for (var i = 0; i < selectors.length; i++) {
+      selectorsPtr[i] = selectors[i].toNativeUtf8().cast<Char>();
+    }
+    final optsPtr = _getOptionsToNative(options);
+
+    _bindings.zenoh_get_multi(
+      _handle,
+      selectorsPtr,
+      selectors.length,
+      optsPtr,
+      quorum,
+      _multiQueryCallback!.nativeFunction,
+      _queryCompleteCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+
+    for (var i = 0; i < selectors.length; i++) {
+      calloc.free(selectorsPtr[i]);
+    }
+    calloc.free(selectorsPtr);
+    _freeGetOptions(optsPtr);
+
+    // Timeout fallback, as for get()
+    Future.delayed(options.timeout + const Duration(seconds: 1), () {
+      if (!controller.isClosed) {
+        controller.close();
+        _multiQueries.remove(id);
+      }
+    });
+
+    return controller.stream;
+  }
+
+  /// Query several selectors and collect the replies, grouped by selector
+  Future<List<List<ZenohReply>>> getMultiCollect(
+    List<String> selectors, {
+    ZenohGetOptions options = ZenohGetOptions.defaultOptions,
+    int quorum = 0,
+  }) async {
+    final replies = List.generate(selectors.length, (_) => <ZenohReply>[]);
+    await for (final r
+        in getMulti(selectors, options: options, quorum: quorum)) {
+      replies[r.selectorIndex].add(r.reply);
+    }
+    return replies;
+  }
+
+  static Pointer<bindings.ZenohGetOptions> _getOptionsToNative(
+      ZenohGetOptions options) {
+    final optsPtr = calloc<bindings.ZenohGetOptions>();
+    optsPtr.ref.timeout_ms = options.timeout.inMilliseconds;
+    optsPtr.ref.priority = options.priority.value;
+    optsPtr.ref.congestion_control = options.congestionControl.value;
+    optsPtr.ref.encoding = options.encoding.value;
+    optsPtr.ref.consolidation = options.consolidation.value;
+    optsPtr.ref.target = options.target.value;
+    optsPtr.ref.allowed_destination = options.allowedDestination.value;
+
+    if (options.payload != null && options.payload!.isNotEmpty) {
+      final payloadPtr = calloc<Uint8>(options.payload!.length);
+      payloadPtr
+          .asTypedList(options.payload!.length)
+          .setAll(0, options.payload!);
+      optsPtr.ref.payload = payloadPtr;
+      optsPtr.ref.payload_len = options.payload!.length;
+    } else {
+      optsPtr.ref.payload = nullptr;
+      optsPtr.ref.payload_len = 0;
+    }
+
+    if (options.attachment != null && options.attachment!.isNotEmpty) {
+      final attPtr = calloc<Uint8>(options.attachment!.length);
+      attPtr
+          .asTypedList(options.attachment!.length)
+          .setAll(0, options.attachment!);
+      optsPtr.ref.attachment = attPtr;
+      optsPtr.ref.attachment_len = options.attachment!.length;
+    } else {
+      optsPtr.ref.attachment = nullptr;
+      optsPtr.ref.attachment_len = 0;
+    }
+
+    optsPtr.ref.limit = options.limit;
+    optsPtr.ref.cursor =
+        options.cursor?.toNativeUtf8().cast<Char>() ?? nullptr;
+
+    return optsPtr;
+  }
+
+  static void _freeGetOptions(Pointer<bindings.ZenohGetOptions> optsPtr) {
+    if (optsPtr.ref.payload != nullptr) calloc.free(optsPtr.ref.payload);
+    if (optsPtr.ref.attachment != nullptr) calloc.free(optsPtr.ref.attachment);
+    if (optsPtr.ref.cursor != nullptr) calloc.free(optsPtr.ref.cursor);
+    calloc.free(optsPtr);
+  }
+
+  /// Declare a querier for issuing repeated queries on the same key
+  /// expression without re-resolving it for every query
+  Future<ZenohQuerier> declareQuerier(
+    String key, {
+    ZenohQuerierOptions options = ZenohQuerierOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+
+    // Create options struct
+    final optsPtr = calloc<bindings.ZenohQuerierOptions>();
+    optsPtr.ref.timeout_ms = options.timeout.inMilliseconds;
+    optsPtr.ref.priority = options.priority.value;
+    optsPtr.ref.congestion_control = options.congestionControl.value;
+    optsPtr.ref.is_express = options.express;
+    optsPtr.ref.consolidation = options.consolidation.value;
+    optsPtr.ref.target = options.target.value;
+    optsPtr.ref.allowed_destination = options.allowedDestination.value;
+
+    final querierHandle =
+        _bindings.zenoh_declare_querier(_handle, keyPtr, optsPtr);
+
+    calloc.free(keyPtr);
+    calloc.free(optsPtr);
+
+    if (querierHandle == nullptr) {
+      throw ZenohQueryException('Failed to declare querier for key: $key');
+    }
+
+    return ZenohQuerier._(querierHandle, key, options.timeout);
+  }
+
+  // ============================================================================
+  // Queryable Operations
+  // ============================================================================
+
+  /// Declare a queryable on a key expression
+  ///
+  /// Each query is finalized once [handler] returns, or once the future it
+  /// returns completes, so handlers may reply asynchronously.
+  Future<ZenohQueryable> declareQueryable(
+    String keyExpr,
+    FutureOr<void> Function(ZenohQuery) handler,
+  ) async {
+    _checkClosed();
+
+    final id = _nextQueryableId++;
+    _queryables[id] = handler;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+
+    final qHandle = _bindings.zenoh_declare_queryable(
+      _handle,
+      keyPtr,
+      _queryableCallback!.nativeFunction,
+      context,
+    );
+
+    calloc.free(keyPtr);
+
+    if (qHandle == nullptr) {
+      _queryables.remove(id);
+      throw ZenohQueryableException(
+          'Failed to declare queryable for key: $keyExpr');
+    }
+
+    return ZenohQueryable._(qHandle, id);
+  }
+
+  // ============================================================================
+  // Storage Operations
+  // ============================================================================
+
+  /// Declare a native in-memory storage on a key expression
+  ///
+  /// The storage subscribes to [keyExpr], keeps the latest value of every key
+  /// (last writer wins on sample timestamps) and answers queries, including
+  /// wildcard ones, without calling into Dart. Queries may select a time
+  /// range with a `_time=[now(-10m)..]` parameter.
+  Future<ZenohStorage> declareMemoryStorage(
+    String keyExpr, {
+    ZenohStorageOptions options = ZenohStorageOptions.defaultOptions,
+  }) async {
+    return _declareStorage(keyExpr, options, null);
+  }
+
+  /// Declare a storage on a key expression backed by a [ZenohLogStore]
+  ///
+  /// Behaves like [declareMemoryStorage] but persists every update to
+  /// [store], and answers queries from its memory-mapped segments. The
+  /// storage keeps [store] open until it is undeclared.
+  Future<ZenohStorage> declareLogStorage(
+    String keyExpr,
+    ZenohLogStore store, {
+    ZenohStorageOptions options = ZenohStorageOptions.defaultOptions,
+  }) async {
+    store._checkClosed();
+    return _declareStorage(keyExpr, options, store);
+  }
+
+  ZenohStorage _declareStorage(
+    String keyExpr,
+    ZenohStorageOptions options,
+    ZenohLogStore? store,
+  ) {
+    _checkClosed();
+
+    final id = _nextStorageId++;
+    StreamController<ZenohStorageChange>? changes;
+    if (options.notifyChanges) {
+      changes = StreamController<ZenohStorageChange>.broadcast();
+      _storageChanges[id] = changes;
+    }
+
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+    final optsPtr = calloc<bindings.ZenohStorageOptions>();
+    optsPtr.ref.max_entries = options.maxEntries;
+    optsPtr.ref.complete = options.complete;
+
+    final callback =
+        changes != null ? _storageChangeCallback!.nativeFunction : nullptr;
+    final storageHandle = store != null
+        ? _bindings.zenoh_declare_log_storage(_handle, keyPtr, store._handle,
+            optsPtr, callback, Pointer<Void>.fromAddress(id))
+        : _bindings.zenoh_declare_memory_storage(
+            _handle, keyPtr, optsPtr, callback, Pointer<Void>.fromAddress(id));
+
+    calloc.free(keyPtr);
+    calloc.free(optsPtr);
+
+    if (storageHandle == nullptr) {
+      _storageChanges.remove(id)?.close();
+      throw ZenohStorageException(
+          'Failed to declare storage for key: $keyExpr');
+    }
+
+    return ZenohStorage._(storageHandle, keyExpr, id);
+  }
+
+  // ============================================================================
+  // Time Series Operations
+  // ============================================================================
+
+  /// Declare a native time series on a key expression
+  ///
+  /// Every key under [keyExpr] gets a ring of the last
+  /// [ZenohTimeSeriesOptions.capacity] (time, value) points. Queries select
+  /// points with `_time=[now(-10m)..]` and may downsample with
+  /// `step=1s&agg=avg`; see [ZenohTimeSeries.selector].
+  Future<ZenohTimeSeries> declareTimeSeries(
+    String keyExpr, {
+    ZenohTimeSeriesOptions options = ZenohTimeSeriesOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+    final fieldPtr = options.jsonField?.toNativeUtf8().cast<Char>() ?? nullptr;
+    final optsPtr = calloc<bindings.ZenohTimeSeriesOptions>();
+    optsPtr.ref.capacity = options.capacity;
+    optsPtr.ref.max_series = options.maxSeries;
+    optsPtr.ref.format = options.format.value;
+    optsPtr.ref.json_field = fieldPtr;
+    optsPtr.ref.extractor = options.extractor ?? nullptr;
+    optsPtr.ref.complete = options.complete;
+
+    final handle = _bindings.zenoh_declare_timeseries(_handle, keyPtr, optsPtr);
+
+    calloc.free(keyPtr);
+    if (fieldPtr != nullptr) calloc.free(fieldPtr);
+    calloc.free(optsPtr);
+
+    if (handle == nullptr) {
+      throw ZenohStorageException(
+          'Failed to declare time series for key: $keyExpr');
+    }
+
+    return ZenohTimeSeries._(handle, keyExpr);
+  }
+
+  // ============================================================================
+  // Liveliness Operations
+  // ============================================================================
+
+  /// Declare a liveliness token
+  Future<ZenohLivelinessToken> declareLivelinessToken(String keyExpr) async {
+    _checkClosed();
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+
+    final tokenHandle =
+        _bindings.zenoh_declare_liveliness_token(_handle, keyPtr);
+    calloc.free(keyPtr);
+
+    if (tokenHandle == nullptr) {
+      throw ZenohLivelinessException(
+          'Failed to declare liveliness token for key: $keyExpr');
+    }
+
+    return ZenohLivelinessToken._(tokenHandle);
+  }
+
+  /// Subscribe to liveliness changes
+  Future<ZenohLivelinessSubscriber> declareLivelinessSubscriber(
+    String keyExpr, {
+    bool history = false,
+  }) async {
+    _checkClosed();
+
+    final id = _nextLivelinessId++;
+    final controller = StreamController<ZenohLivelinessEvent>();
+    _livelinessSubscribers[id] = controller;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+
+    final subHandle = _bindings.zenoh_declare_liveliness_subscriber(
+      _handle,
+      keyPtr,
+      _livelinessCallback!.nativeFunction,
+      context,
+      history,
+    );
+    calloc.free(keyPtr);
+
+    if (subHandle == nullptr) {
+      _livelinessSubscribers.remove(id);
+      throw ZenohLivelinessException(
+          'Failed to declare liveliness subscriber for key: $keyExpr');
+    }
+
+    return ZenohLivelinessSubscriber._(subHandle, controller, id);
+  }
+
+  /// Query currently alive tokens
+  Stream<ZenohLivelinessEvent> livelinessGet(
+    String keyExpr, {
+    Duration timeout = const Duration(seconds: 10),
+  }) {
+    _checkClosed();
+
+    final id = _nextLivelinessId++;
+    final controller = StreamController<ZenohLivelinessEvent>();
+    _livelinessSubscribers[id] = controller;
+
+    final context = Pointer<Void>.fromAddress(id);
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+
+    _bindings.zenoh_liveliness_get(
+      _handle,
+      keyPtr,
+      _livelinessCallback!.nativeFunction,
+      context,
+      timeout.inMilliseconds,
+    );
+
+    calloc.free(keyPtr);
+
+    // Close stream after timeout
+    Future.delayed(timeout + const Duration(milliseconds: 100), () {
+      if (!controller.isClosed) {
+        controller.close();
+        _livelinessSubscribers.remove(id);
+      }
+    });
+
+    return controller.stream;
+  }
+
+  /// Track the alive tokens under [keyExpr] natively. Changes are coalesced
+  /// into at most one [ZenohLivelinessDelta] per [interval], so a reconnect
+  /// storm costs one event instead of one per token. The first delta holds
+  /// the tokens that were already alive.
+  Future<ZenohLivelinessTracker> trackLiveliness(
+    String keyExpr, {
+    Duration interval = const Duration(milliseconds: 100),
+  }) async {
+    _checkClosed();
+
+    final id = _nextLivelinessId++;
+    final controller = StreamController<ZenohLivelinessDelta>();
+    _livelinessTrackers[id] = controller;
+
+    final keyPtr = keyExpr.toNativeUtf8().cast<Char>();
+    final handle = _bindings.zenoh_liveliness_tracker_open(
+      _handle,
+      keyPtr,
+      interval.inMilliseconds,
+      _livelinessDeltaCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(keyPtr);
+
+    if (handle == nullptr) {
+      _livelinessTrackers.remove(id);
+      throw ZenohLivelinessException(
+          'Failed to track liveliness for key: $keyExpr');
+    }
+
+    return ZenohLivelinessTracker._(handle, controller, id);
+  }
+
+  // ============================================================================
+  // Scouting
+  // ============================================================================
+
+  /// Scout for Zenoh peers and routers on the network
+  static Stream<String> scout({String what = 'peer|router', String? config}) {
+    final controller = StreamController<String>();
+
+    final whatPtr = what.toNativeUtf8().cast<Char>();
+    final configPtr =
+        config != null ? config.toNativeUtf8().cast<Char>() : nullptr;
+
+    final callback = NativeCallable<Void Function(Pointer<Char>)>.listener(
+      (Pointer<Char> info) {
+        final infoStr = info.cast<Utf8>().toDartString();
+        controller.add(infoStr);
+      },
+    );
+
+    Future(() {
+      _bindings.zenoh_scout(whatPtr, configPtr, callback.nativeFunction);
+
+      calloc.free(whatPtr);
+      if (configPtr != nullptr) calloc.free(configPtr);
+      callback.close();
+      controller.close();
+    });
+
+    return controller.stream;
+  }
+
+  /// Scout for zenoh nodes for [timeout] on a native thread. Each node is
+  /// reported once, and again only if it announces new locators. The
+  /// stream closes when scouting ends.
+  static Stream<ZenohHello> scoutNodes({
+    String what = 'peer|router',
+    ZenohConfigBuilder? config,
+    Duration timeout = const Duration(seconds: 1),
+  }) {
+    _ensureCallbacksInitialized();
+    final id = _nextScoutId++;
+    final controller = StreamController<ZenohHello>();
+    _scouts[id] = controller;
+
+    final whatPtr = what.toNativeUtf8().cast<Char>();
+    final configPtr =
+        config != null ? config.build().toNativeUtf8().cast<Char>() : nullptr;
+    final result = _bindings.zenoh_scout_ex(
+      whatPtr,
+      configPtr,
+      timeout.inMilliseconds,
+      _scoutCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(whatPtr);
+    if (configPtr != nullptr) calloc.free(configPtr);
+
+    if (result != 0) {
+      _scouts.remove(id);
+      controller.addError(ZenohSessionException('Failed to start scouting'));
+      controller.close();
+    }
+    return controller.stream;
+  }
+
+  /// Scout for up to [scoutTimeout], probing every TCP-based locator as it
+  /// is found for up to [probeTimeout], and open a session with [config]
+  /// connected to the first one to answer.
+  static Future<ZenohScoutConnection> scoutAndConnect({
+    String what = 'peer|router',
+    ZenohConfigBuilder? config,
+    Duration scoutTimeout = const Duration(seconds: 1),
+    Duration probeTimeout = const Duration(seconds: 1),
+  }) async {
+    _ensureCallbacksInitialized();
+    final id = _nextScoutId++;
+    final completer = Completer<ZenohScoutConnection>();
+    _scoutConnects[id] = completer;
+
+    final whatPtr = what.toNativeUtf8().cast<Char>();
+    final configPtr =
+        config != null ? config.build().toNativeUtf8().cast<Char>() : nullptr;
+    final result = _bindings.zenoh_scout_connect(
+      whatPtr,
+      configPtr,
+      scoutTimeout.inMilliseconds,
+      probeTimeout.inMilliseconds,
+      _scoutConnectCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(whatPtr);
+    if (configPtr != nullptr) calloc.free(configPtr);
+
+    if (result != 0) {
+      _scoutConnects.remove(id);
+      throw ZenohSessionException('Failed to start scouting', result);
+    }
+    return completer.future;
+  }
+
+  // ============================================================================
+  // Callbacks
+  // ============================================================================
+
+  static void _onSubscriberData(
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    Pointer<Char> kind,
+    Pointer<Char> attachment,
+    Pointer<Void> context,
+  ) {
+    try {
+      int id = context.address;
+      if (_subscribers.containsKey(id)) {
+        final keyStr = key.cast<Utf8>().toDartString();
+        final kindStr = kind.cast<Utf8>().toDartString();
+        final payload = len > 0 && value.address != 0
+            ? Uint8List.fromList(value.asTypedList(len))
+            : Uint8List(0);
+        final attStr = attachment.address != 0
+            ? attachment.cast<Utf8>().toDartString()
+            : '';
+
+        _subscribers[id]?.add(ZenohSample(
+          key: keyStr,
+          payload: payload,
+          kind: kindStr == 'DELETE'
+              ? ZenohSampleKind.delete
+              : ZenohSampleKind.put,
+          attachment: attStr.isNotEmpty
+              ? Uint8List.fromList(utf8.encode(attStr))
+              : null,
+        ));
+      }
+    } catch (e) {
+      print('Error in subscriber callback: $e');
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+      malloc.free(kind);
+      if (attachment.address != 0) malloc.free(attachment);
+      if (value.address != 0 && len > 0) malloc.free(value);
+    }
+  }
+
+  static void _onSubscriberDataEx(
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    int kind,
+    int priority,
+    int congestionControl,
+    Pointer<Char> encoding,
+    Pointer<Uint8> attachment,
+    int attachmentLen,
+    int timestamp,
+    Pointer<Void> context,
+  ) {
+    try {
+      final controller = _subscribers[context.address];
+      if (controller != null && !controller.isClosed) {
+        controller.add(ZenohSample(
+          key: key.cast<Utf8>().toDartString(),
+          payload: len > 0 && value.address != 0
+              ? Uint8List.fromList(value.asTypedList(len))
+              : Uint8List(0),
+          kind: ZenohSampleKind.fromValue(kind),
+          encoding:
+              ZenohEncoding.fromMimeType(encoding.cast<Utf8>().toDartString()),
+          attachment: attachmentLen > 0 && attachment.address != 0
+              ? Uint8List.fromList(attachment.asTypedList(attachmentLen))
+              : null,
+          priority: ZenohPriority.fromValue(priority),
+          congestionControl: ZenohCongestionControl.fromValue(congestionControl),
+          timestamp: _ntp64ToDateTime(timestamp),
+        ));
+      }
+    } catch (e) {
+      print('Error in subscriber callback: $e');
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+      malloc.free(encoding);
+      if (value.address != 0) malloc.free(value);
+      if (attachment.address != 0) malloc.free(attachment);
+    }
+  }
+
+  static void _onSubscriberReady(Pointer<Void> context) {
+    _subscriberReady.remove(context.address)?.complete();
+  }
+
+  static void _onSampleMiss(
+    Pointer<Char> sourceId,
+    int count,
+    Pointer<Void> context,
+  ) {
+    try {
+      _sampleMissHandlers[context.address]
+          ?.call(ZenohSampleMiss(sourceId.cast<Utf8>().toDartString(), count));
+    } finally {
+      malloc.free(sourceId);
+    }
+  }
+
+  static void _onShmSubscriberData(
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    Pointer<bindings.ZenohShmBuffer> shmBuffer,
+    Pointer<Void> context,
+  ) {
+    final isShm = shmBuffer.address != 0;
+    try {
+      int id = context.address;
+      final controller = _subscribers[id];
+      if (controller == null) {
+        if (isShm) _bindings.zenoh_shm_buffer_free(shmBuffer);
+        return;
+      }
+
+      final keyStr = key.cast<Utf8>().toDartString();
+      final Uint8List payload;
+      if (isShm) {
+        // Zero-copy view; the mapping is released by the finalizer
+        payload = len > 0
+            ? value.asTypedList(len,
+                finalizer: _shmBufferFinalizer, token: shmBuffer.cast())
+            : Uint8List(0);
+        if (len == 0) _bindings.zenoh_shm_buffer_free(shmBuffer);
+      } else {
+        payload = len > 0 && value.address != 0
+            ? Uint8List.fromList(value.asTypedList(len))
+            : Uint8List(0);
+      }
+
+      controller.add(ZenohSample(key: keyStr, payload: payload));
+    } catch (e) {
+      print('Error in SHM subscriber callback: $e');
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+      if (!isShm && value.address != 0 && len > 0) malloc.free(value);
+    }
+  }
+
+  static final Pointer<NativeFinalizerFunction> _shmBufferFinalizer =
+      _dylib.lookup<NativeFinalizerFunction>('zenoh_shm_buffer_free');
+
+  static void _onChunkedData(
+    Pointer<Char> key,
+    Pointer<Uint8> data,
+    int len,
+    int transferId,
+    Pointer<Void> context,
+  ) {
+    var handedOff = false;
+    try {
+      int id = context.address;
+      final controller = _subscribers[id];
+      if (controller == null) return;
+
+      final keyStr = key.cast<Utf8>().toDartString();
+      // The reassembled buffer is adopted as-is and freed by the finalizer
+      final payload = len > 0 && data.address != 0
+          ? data.asTypedList(len,
+              finalizer: _nativeBufferFinalizer, token: data.cast())
+          : Uint8List(0);
+      handedOff = len > 0 && data.address != 0;
+
+      controller.add(ZenohSample(key: keyStr, payload: payload));
+    } catch (e) {
+      print('Error in chunked subscriber callback: $e');
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+      if (!handedOff && data.address != 0) {
+        _bindings.zenoh_free_string(data.cast());
+      }
+    }
+  }
+
+  static final Pointer<NativeFinalizerFunction> _nativeBufferFinalizer =
+      _dylib.lookup<NativeFinalizerFunction>('zenoh_free_string');
+
+  static void _onChunkProgress(
+    int transferId,
+    int received,
+    int total,
+    Pointer<Void> context,
+  ) {
+    _chunkProgressHandlers[context.address]
+        ?.call(ZenohChunkProgress(transferId, received, total));
+  }
+
+  static void _onChunkedPut(
+      int transferId, int result, Pointer<Void> context) {
+    final completer = _chunkedPuts.remove(context.address);
+    if (completer == null) return;
+    if (result < 0) {
+      completer.completeError(
+          ZenohPublisherException('Publisher chunked put failed', result));
+    } else {
+      completer.complete(transferId);
+    }
+  }
+
+  static void _onQueryData(
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    Pointer<Char> kind,
+    Pointer<Void> context,
+  ) {
+    try {
+      int id = context.address;
+      if (_queries.containsKey(id)) {
+        final keyStr = key.cast<Utf8>().toDartString();
+        final kindStr = kind.cast<Utf8>().toDartString();
+        final payload = len > 0 && value.address != 0
+            ? Uint8List.fromList(value.asTypedList(len))
+            : Uint8List(0);
+
+        _queries[id]?.add(ZenohReply(
+          key: keyStr,
+          payload: payload,
+          kind:
+              kindStr == 'DELETE' ? ZenohSampleKind.delete : ZenohSampleKind.put,
+        ));
+      }
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+      malloc.free(kind);
+      if (value.address != 0 && len > 0) malloc.free(value);
+    }
+  }
+
+  static void _onQueryDataEx(
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    int replyKind,
+    Pointer<Char> encoding,
+    Pointer<Uint8> attachment,
+    int attachmentLen,
+    int timestamp,
+    Pointer<Char> replierId,
+    Pointer<Void> context,
+  ) {
+    final reply = _takeReply(key, value, len, replyKind, encoding, attachment,
+        attachmentLen, timestamp, replierId);
+    _queries[context.address]?.add(reply);
+  }
+
+  static void _onMultiQueryData(
+    int selectorIndex,
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    int replyKind,
+    Pointer<Char> encoding,
+    Pointer<Uint8> attachment,
+    int attachmentLen,
+    int timestamp,
+    Pointer<Char> replierId,
+    Pointer<Void> context,
+  ) {
+    final reply = _takeReply(key, value, len, replyKind, encoding, attachment,
+        attachmentLen, timestamp, replierId);
+    final controller = _multiQueries[context.address];
+    if (controller != null && !controller.isClosed) {
+      controller.add(ZenohMultiReply(selectorIndex, reply));
+    }
+  }
+
+  static void _onSessionOpened(
+    Pointer<bindings.ZenohSession> session,
+    int result,
+    int elapsedUs,
+    Pointer<Void> context,
+  ) {
+    final completer = _sessionOpens.remove(context.address);
+    if (completer == null) {
+      if (session != nullptr) _bindings.zenoh_close_session(session);
+      return;
+    }
+    if (session == nullptr) {
+      completer.completeError(ZenohSessionException(
+          'Failed to open Zenoh session with config', result));
+      return;
+    }
+    completer.complete(
+        ZenohSession._(session, Duration(microseconds: elapsedUs)));
+  }
+
+  static void _onScoutHello(
+    Pointer<Uint8> record,
+    int len,
+    int result,
+    Pointer<Void> context,
+  ) {
+    final controller = _scouts[context.address];
+    if (record == nullptr) {
+      _scouts.remove(context.address);
+      if (controller == null) return;
+      if (result != 0) {
+        controller.addError(ZenohSessionException('Scouting failed', result));
+      }
+      controller.close();
+      return;
+    }
+    try {
+      if (controller != null && !controller.isClosed) {
+        final bytes = Uint8List.fromList(record.asTypedList(len));
+        controller.add(ZenohHello.decode(bytes));
+      }
+    } catch (e) {
+      print('Error in scout callback: $e');
+    } finally {
+      _bindings.zenoh_free_string(record.cast());
+    }
+  }
+
+  static void _onScoutConnected(
+    Pointer<bindings.ZenohSession> session,
+    int result,
+    Pointer<Char> locator,
+    int rttUs,
+    Pointer<Void> context,
+  ) {
+    final endpoint =
+        locator != nullptr ? locator.cast<Utf8>().toDartString() : '';
+    if (locator != nullptr) _bindings.zenoh_free_string(locator);
+
+    final completer = _scoutConnects.remove(context.address);
+    if (completer == null) {
+      if (session != nullptr) _bindings.zenoh_close_session(session);
+      return;
+    }
+    if (session == nullptr) {
+      completer.completeError(ZenohSessionException(
+          result == -2
+              ? 'No zenoh node found while scouting'
+              : 'Failed to connect to scouted node $endpoint',
+          result));
+      return;
+    }
+    // UINT64_MAX arrives as -1
+    final rtt = rttUs < 0 ? null : Duration(microseconds: rttUs);
+    completer.complete(
+        ZenohScoutConnection(ZenohSession._(session), endpoint, rtt));
+  }
+
+  static void _onSessionClosed(
+      int result, int elapsedUs, Pointer<Void> context) {
+    _sessionCloses
+        .remove(context.address)
+        ?.complete(Duration(microseconds: elapsedUs));
+  }
+
+  static void _onSessionGroupOpened(
+    Pointer<bindings.ZenohSessionGroup> group,
+    int result,
+    int elapsedUs,
+    Pointer<Void> context,
+  ) {
+    final completer = _sessionGroupOpens.remove(context.address);
+    if (completer == null) {
+      if (group != nullptr) _bindings.zenoh_session_group_close(group);
+      return;
+    }
+    completer.complete(group);
+  }
+
+  static void _onQueryPage(Pointer<Char> nextCursor, Pointer<Void> context) {
+    final id = context.address;
+    String? cursor;
+    if (nextCursor.address != 0) {
+      cursor = nextCursor.cast<Utf8>().toDartString();
+      malloc.free(nextCursor);
+    }
+    _queries.remove(id)?.close();
+    _pageCompleters.remove(id)?.complete(cursor);
+  }
+
+  static void _onRpcRequest(
+    Pointer<Char> method,
+    Pointer<Uint8> request,
+    int len,
+    int callId,
+    Pointer<bindings.ZenohQuery> query,
+    Pointer<Void> context,
+  ) {
+    final name = method.cast<Utf8>().toDartString();
+    final data = len > 0 && request.address != 0
+        ? Uint8List.fromList(request.asTypedList(len))
+        : Uint8List(0);
+    malloc.free(method);
+    if (request.address != 0) malloc.free(request);
+
+    final handler = _rpcServers[context.address]?._handlers[name];
+    if (handler == null) {
+      ZenohRpcServer._respond(
+          query, callId, ZenohRpcStatus.notFound.value, Uint8List(0));
+      return;
+    }
+    Future.sync(() => handler(data)).then(
+      (response) => ZenohRpcServer._respond(
+          query, callId, ZenohRpcStatus.ok.value, response),
+      onError: (Object e) => ZenohRpcServer._respond(query, callId,
+          ZenohRpcStatus.error.value, utf8.encode(e.toString())),
+    );
+  }
+
+  static void _onRpcResponse(
+    int callId,
+    int status,
+    Pointer<Uint8> data,
+    int len,
+    Pointer<Void> context,
+  ) {
+    final payload = len > 0 && data.address != 0
+        ? Uint8List.fromList(data.asTypedList(len))
+        : Uint8List(0);
+    if (data.address != 0) malloc.free(data);
+
+    final completer = _rpcCalls.remove(context.address);
+    if (completer == null) return;
+    if (status == ZenohRpcStatus.ok.value) {
+      completer.complete(payload);
+    } else {
+      final message = payload.isNotEmpty
+          ? utf8.decode(payload, allowMalformed: true)
+          : (ZenohRpcStatus.fromValue(status)?.name ?? 'status $status');
+      completer.completeError(ZenohRpcException(message, status));
+    }
+  }
+
+  /// Decode a ZenohGetCallbackEx reply, freeing the native copies
+  static ZenohReply _takeReply(
+    Pointer<Char> key,
+    Pointer<Uint8> value,
+    int len,
+    int replyKind,
+    Pointer<Char> encoding,
+    Pointer<Uint8> attachment,
+    int attachmentLen,
+    int timestamp,
+    Pointer<Char> replierId,
+  ) {
+    try {
+      final payload = len > 0 && value.address != 0
+          ? Uint8List.fromList(value.asTypedList(len))
+          : Uint8List(0);
+
+      return ZenohReply(
+        key: key.address != 0 ? key.cast<Utf8>().toDartString() : '',
+        payload: payload,
+        kind: replyKind == bindings.ZenohReplyKind.ZENOH_REPLY_KIND_DELETE
+            ? ZenohSampleKind.delete
+            : ZenohSampleKind.put,
+        encoding:
+            ZenohEncoding.fromMimeType(encoding.cast<Utf8>().toDartString()),
+        attachment: attachmentLen > 0 && attachment.address != 0
+            ? Uint8List.fromList(attachment.asTypedList(attachmentLen))
+            : null,
+        timestamp: _ntp64ToDateTime(timestamp),
+        replierId: replierId.address != 0
+            ? replierId.cast<Utf8>().toDartString()
+            : null,
+        isError: replyKind == bindings.ZenohReplyKind.ZENOH_REPLY_KIND_ERROR,
+      );
+    } finally {
+      // Free native memory allocated by C side
+      if (key.address != 0) malloc.free(key);
+      malloc.free(encoding);
+      if (value.address != 0 && len > 0) malloc.free(value);
+      if (attachment.address != 0 && attachmentLen > 0) {
+        malloc.free(attachment);
+      }
+      if (replierId.address != 0) malloc.free(replierId);
+    }
+  }
+
+  static void _onQueryComplete(Pointer<Void> context) {
+    int id = context.address;
+    if (_queries.containsKey(id)) {
+      _queries[id]?.close();
+      _queries.remove(id);
+    }
+    if (_queryCompleters.containsKey(id)) {
+      _queryCompleters[id]?.complete();
+      _queryCompleters.remove(id);
+    }
+    _multiQueries.remove(id)?.close();
+  }
+
+  static void _onMatchingStatus(bool matching, Pointer<Void> context) {
+    _matchingListeners[context.address]?.add(matching);
+  }
+
+  static void _onStorageChange(
+    Pointer<Char> key,
+    int sampleKind,
+    Pointer<Void> context,
+  ) {
+    try {
+      _storageChanges[context.address]?.add(ZenohStorageChange(
+        key.cast<Utf8>().toDartString(),
+        ZenohSampleKind.fromValue(sampleKind),
+      ));
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+    }
+  }
+
+  static void _onQueryRequest(
+    Pointer<Char> key,
+    Pointer<Char> selector,
+    Pointer<Uint8> value,
+    int len,
+    Pointer<Char> kind,
+    Pointer<bindings.ZenohQuery> queryHandle,
+    Pointer<Void> userContext,
+  ) {
+    ZenohQuery? query;
+    try {
+      int id = userContext.address;
+      final handler = _queryables[id];
+      if (handler != null) {
+        final keyStr = key.cast<Utf8>().toDartString();
+        final selectorStr = selector.cast<Utf8>().toDartString();
+        final kindStr = kind.cast<Utf8>().toDartString();
+        final payload =
+            len > 0 && value.address != 0 ? Uint8List.fromList(value.asTypedList(len)) : null;
+
+        query = ZenohQuery(
+          key: keyStr,
+          selector: selectorStr,
+          value: payload,
+          kind:
+              kindStr == 'DELETE' ? ZenohSampleKind.delete : ZenohSampleKind.put,
+          replyContext: queryHandle.cast(),
+        );
+        final pending = query;
+        Future.sync(() => handler(pending))
+            .catchError((Object e) => print('Error in queryable handler: $e'))
+            .whenComplete(pending.finalize);
+      }
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+      malloc.free(selector);
+      malloc.free(kind);
+      if (value.address != 0 && len > 0) malloc.free(value);
+      // No handler (queryable undeclared meanwhile): close the reply stream
+      if (query == null) _bindings.zenoh_query_finalize(queryHandle);
+    }
+  }
+
+  static void _onLivelinessEvent(
+    Pointer<Char> key,
+    int isAlive,
+    Pointer<Void> context,
+  ) {
+    try {
+      int id = context.address;
+      if (_livelinessSubscribers.containsKey(id)) {
+        final keyStr = key.cast<Utf8>().toDartString();
+        _livelinessSubscribers[id]
+            ?.add(ZenohLivelinessEvent(keyStr, isAlive != 0));
+      }
+    } finally {
+      // Free native memory allocated by C side
+      malloc.free(key);
+    }
+  }
+
+  static void _onLivelinessDelta(
+    int version,
+    Pointer<Char> keys,
+    int len,
+    int joinedCount,
+    int leftCount,
+    Pointer<Void> context,
+  ) {
+    try {
+      final controller = _livelinessTrackers[context.address];
+      if (controller == null || controller.isClosed) return;
+      final all = ZenohLivelinessTracker._unpackKeys(keys, len);
+      controller.add(ZenohLivelinessDelta(
+        version,
+        all.sublist(0, joinedCount),
+        all.sublist(joinedCount, joinedCount + leftCount),
+      ));
+    } catch (e) {
+      print('Error in liveliness tracker callback: $e');
+    } finally {
+      _bindings.zenoh_free_string(keys);
+    }
+  }
+}
+
+// ============================================================================
+// Session Group
+// ============================================================================
+
+/// Live publishers and subscribers of one member of a session group
+class ZenohSessionGroupStats {
+  final int publishers;
+  final int subscribers;
+
+  ZenohSessionGroupStats(this.publishers, this.subscribers);
+
+  @override
+  String toString() =>
+      'ZenohSessionGroupStats(publishers: $publishers, subscribers: $subscribers)';
+}
+
+/// Several sessions opened from one config, spreading publishers and
+/// subscribers across them.
+///
+/// Entities go to the session their key hashes to, or to an explicit
+/// `affinity` index. Member sessions can be used directly through [sessions]
+/// but are only closed through [close].
+///
+/// Every member runs on zenoh's process-wide runtime, so a group adds
+/// sessions (transports, links and entity tables) but not threads. Size the
+/// runtime pools with [ZenohSession.configureRuntime] to use more cores.
+class ZenohSessionGroup {
+  final Pointer<bindings.ZenohSessionGroup> _handle;
+  final List<ZenohSession> sessions;
+  bool _isClosed = false;
+
+  ZenohSessionGroup._(this._handle, this.sessions);
+
+  /// Open [count] sessions in parallel on a native worker thread. Fails
+  /// unless all of them open.
+  static Future<ZenohSessionGroup> open(int count,
+      {ZenohConfigBuilder? config}) async {
+    if (count <= 0) {
+      throw ArgumentError.value(count, 'count', 'must be positive');
+    }
+    ZenohSession._ensureCallbacksInitialized();
+    final Pointer<Char> configPtr =
+        config != null ? config.build().toNativeUtf8().cast<Char>() : nullptr;
+
+    final id = ZenohSession._nextSessionOpId++;
+    final completer = Completer<Pointer<bindings.ZenohSessionGroup>>();
+    ZenohSession._sessionGroupOpens[id] = completer;
+
+    final result = _bindings.zenoh_session_group_open_async(
+      count,
+      configPtr,
+      ZenohSession._sessionGroupOpenCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    if (configPtr != nullptr) calloc.free(configPtr);
+
+    if (result != 0) {
+      ZenohSession._sessionGroupOpens.remove(id);
+      throw ZenohSessionException(
+          'Failed to open a group of $count sessions', result);
+    }
+    final handle = await completer.future;
+    if (handle == nullptr) {
+      throw ZenohSessionException('Failed to open a group of $count sessions');
+    }
+
+    final sessions = List.generate(
+      count,
+      (i) => ZenohSession._(
+          _bindings.zenoh_session_group_session(handle, i), null, true),
+      growable: false,
+    );
+    return ZenohSessionGroup._(handle, sessions);
+  }
+
+  void _checkClosed() {
+    if (_isClosed) throw ZenohSessionException('Session group is closed');
+  }
+
+  /// Index of the session [key] is routed to
+  int route(String key) {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final index = _bindings.zenoh_session_group_route(_handle, keyPtr);
+    calloc.free(keyPtr);
+    return index;
+  }
+
+  /// Session [key] is routed to, or the one at [affinity] when it is given
+  /// and not negative, as the native declare calls pick it
+  ZenohSession sessionFor(String key, {int? affinity}) => sessions[
+      affinity != null && affinity >= 0
+          ? affinity % sessions.length
+          : route(key)];
+
+  /// Declare a publisher on the session picked by key hash or [affinity]
+  Future<ZenohPublisher> declarePublisher(
+    String key, {
+    int? affinity,
+    ZenohPublisherOptions options = ZenohPublisherOptions.defaultOptions,
+  }) async {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final optsPtr = ZenohSession._publisherOptionsToNative(options);
+
+    final pubHandle = _bindings.zenoh_session_group_declare_publisher(
+        _handle, keyPtr, affinity ?? -1, optsPtr);
+
+    calloc.free(keyPtr);
+    calloc.free(optsPtr);
+
+    if (pubHandle == nullptr) {
+      throw ZenohPublisherException(
+          'Failed to declare publisher for key: $key');
+    }
+    return ZenohPublisher._(pubHandle);
+  }
+
+  /// Declare a subscriber on the session picked by key hash or [affinity]
+  Future<ZenohSubscriber> declareSubscriber(String key, {int? affinity}) async {
+    _checkClosed();
+
+    final id = ZenohSession._nextSubscriberId++;
+    final controller = StreamController<ZenohSample>();
+    ZenohSession._subscribers[id] = controller;
+
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final subHandle = _bindings.zenoh_session_group_declare_subscriber(
+      _handle,
+      keyPtr,
+      affinity ?? -1,
+      ZenohSession._subscriberCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(keyPtr);
+
+    if (subHandle == nullptr) {
+      ZenohSession._subscribers.remove(id);
+      throw ZenohSubscriberException(
+          'Failed to declare subscriber for key: $key');
+    }
+    return ZenohSubscriber._(subHandle, controller, id);
+  }
+
+  /// Counters summed over every member session
+  ZenohStats get totalStats {
+    _checkClosed();
+    final stats = ZenohStats._read(
+        (out) => _bindings.zenoh_session_group_stats_snapshot(_handle, out));
+    if (stats == null) {
+      throw ZenohSessionException('Failed to read session group stats');
+    }
+    return stats;
+  }
+
+  /// Live publishers and subscribers per member session, however they were
+  /// declared
+  List<ZenohSessionGroupStats> stats() {
+    _checkClosed();
+    final count = sessions.length;
+    final statsPtr = calloc<bindings.ZenohSessionGroupStats>(count);
+    final n = _bindings.zenoh_session_group_stats(_handle, statsPtr, count);
+    final result = [
+      for (var i = 0; i < n; i++)
+        ZenohSessionGroupStats(statsPtr[i].publishers, statsPtr[i].subscribers),
+    ];
+    calloc.free(statsPtr);
+    return result;
+  }
+
+  /// Close every member session on a native worker thread. Undeclare the
+  /// group's entities first.
+  Future<void> close() async {
+    if (_isClosed) return;
+    _isClosed = true;
+    for (final session in sessions) {
+      session._isClosed = true;
+    }
+
+    final id = ZenohSession._nextSessionOpId++;
+    final completer = Completer<Duration>();
+    ZenohSession._sessionCloses[id] = completer;
+
+    final result = _bindings.zenoh_session_group_close_async(
+      _handle,
+      ZenohSession._sessionCloseCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    if (result != 0) {
+      ZenohSession._sessionCloses.remove(id);
+      _bindings.zenoh_session_group_close(_handle);
+      return;
+    }
+    await completer.future;
+  }
+}
+
+// ============================================================================
+// Publisher
+// ============================================================================
+
+/// A Zenoh publisher for sending data on a specific key expression
+class ZenohPublisher {
+  final Pointer<bindings.ZenohPublisher> _handle;
+  bool _isUndeclared = false;
+
+  ZenohPublisher._(this._handle);
+
+  void _checkUndeclared() {
+    if (_isUndeclared) throw ZenohPublisherException('Publisher is undeclared');
+  }
+
+  /// Puts, bytes and errors of this publisher
+  ZenohStats get stats {
+    _checkUndeclared();
+    final stats = ZenohStats._read(
+        (out) => _bindings.zenoh_publisher_stats_snapshot(_handle, out));
+    if (stats == null) {
+      throw ZenohPublisherException('Publisher statistics are not available');
+    }
+    return stats;
+  }
+
+  /// Put data through this publisher
+  Future<void> put(Uint8List data, {ZenohPutOptions? options}) async {
+    _checkUndeclared();
+
+    final dataPtr = calloc<Uint8>(data.length);
+    final dataList = dataPtr.asTypedList(data.length);
+    dataList.setAll(0, data);
+
+    int result;
+    if (options != null) {
+      final optsPtr = calloc<bindings.ZenohPutOptions>();
+      optsPtr.ref.priority = options.priority.value;
+      optsPtr.ref.congestion_control = options.congestionControl.value;
+      optsPtr.ref.encoding = options.encoding.value;
+      optsPtr.ref.is_express = options.express;
+      optsPtr.ref.encoding_schema = nullptr;
+
+      if (options.attachment != null && options.attachment!.isNotEmpty) {
+        final attPtr = calloc<Uint8>(options.attachment!.length);
+        attPtr
+            .asTypedList(options.attachment!.length)
+            .setAll(0, options.attachment!);
+        optsPtr.ref.attachment = attPtr;
+        optsPtr.ref.attachment_len = options.attachment!.length;
+      } else {
+        optsPtr.ref.attachment = nullptr;
+        optsPtr.ref.attachment_len = 0;
+      }
+
+      result = _bindings.zenoh_publisher_put_with_options(
+          _handle, dataPtr, data.length, optsPtr);
+
+      if (optsPtr.ref.attachment != nullptr) {
+        calloc.free(optsPtr.ref.attachment);
+      }
+      calloc.free(optsPtr);
+    } else {
+      result = _bindings.zenoh_publisher_put(_handle, dataPtr, data.length);
+    }
+
+    calloc.free(dataPtr);
+
+    if (result < 0) {
+      throw ZenohPublisherException('Publisher put failed', result);
+    }
+  }
+
+  /// Put a string through this publisher
+  Future<void> putString(String value, {ZenohPutOptions? options}) async {
+    await put(
+      Uint8List.fromList(utf8.encode(value)),
+      options:
+          options ?? const ZenohPutOptions(encoding: ZenohEncoding.textPlain),
+    );
+  }
+
+  /// Put JSON data through this publisher
+  Future<void> putJson(Object value, {Uint8List? attachment}) async {
+    await put(
+      Uint8List.fromList(utf8.encode(jsonEncode(value))),
+      options: ZenohPutOptions(
+        encoding: ZenohEncoding.applicationJson,
+        attachment: attachment,
+      ),
+    );
+  }
+
+  /// Publish a large payload as a sequence of chunks of [chunkSize] bytes.
+  ///
+  /// Receivers declared with [ZenohSession.declareChunkedSubscriber]
+  /// reassemble the object natively. Use a publisher with
+  /// [ZenohCongestionControl.block] so chunks are not dropped under load.
+  /// Returns the transfer id reported in [ZenohChunkProgress].
+  ///
+  /// [data] is copied once into native memory; the chunks borrow slices of
+  /// that copy and are published on a native worker thread, so several
+  /// transfers can be in flight at once.
+  Future<int> putChunked(Uint8List data, {int chunkSize = 64 * 1024}) async {
+    _checkUndeclared();
+
+    final dataPtr = malloc<Uint8>(data.isEmpty ? 1 : data.length);
+    dataPtr.asTypedList(data.length).setAll(0, data);
+
+    final id = ZenohSession._nextChunkedPutId++;
+    final completer = Completer<int>();
+    ZenohSession._chunkedPuts[id] = completer;
+
+    // Native code owns dataPtr from here and frees it with the last chunk
+    final result = _bindings.zenoh_publisher_put_chunked_async(
+      _handle,
+      dataPtr,
+      data.length,
+      chunkSize,
+      malloc.nativeFree,
+      ZenohSession._chunkedPutCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    if (result < 0) {
+      ZenohSession._chunkedPuts.remove(id);
+      throw ZenohPublisherException('Publisher chunked put failed', result);
+    }
+    return completer.future;
+  }
+
+  /// Publish a shared-memory buffer without copying the payload.
+  ///
+  /// Ownership of [buffer] passes to Zenoh; it must not be used afterwards.
+  Future<void> putShm(ZenohShmBuffer buffer) async {
+    _checkUndeclared();
+    final handle = buffer._take();
+
+    final result = _bindings.zenoh_publisher_put_shm(_handle, handle);
+    if (result < 0) {
+      throw ZenohPublisherException('Publisher SHM put failed', result);
+    }
+  }
+
+  /// Delete through this publisher
+  Future<void> delete() async {
+    _checkUndeclared();
+    _bindings.zenoh_publisher_delete(_handle);
+  }
+
+  /// Undeclare and drop the publisher
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_publisher(_handle);
+    _isUndeclared = true;
+  }
+
+  /// Undeclare many publishers in one native call
+  static Future<void> undeclareAll(Iterable<ZenohPublisher> publishers) async {
+    final live = publishers.where((p) => !p._isUndeclared).toSet().toList();
+    if (live.isEmpty) return;
+    final handlesPtr = calloc<Pointer<bindings.ZenohPublisher>>(live.length);
+    for (var i = 0; i < live.length; i++) {
+      handlesPtr[i] = live[i]._handle;
+      live[i]._isUndeclared = true;
+    }
+    _bindings.zenoh_undeclare_publishers_bulk(handlesPtr, live.length);
+    calloc.free(handlesPtr);
+  }
+}
+
+// ============================================================================
+// Shared Memory
+// ============================================================================
+
+/// A POSIX shared-memory provider used to allocate zero-copy payloads.
+///
+/// Requires the native library to be built with `ZENOH_FFI_SHARED_MEMORY=ON`;
+/// check [isAvailable] before use.
+class ZenohShmProvider {
+  final Pointer<bindings.ZenohShmProvider> _handle;
+  bool _isClosed = false;
+
+  ZenohShmProvider._(this._handle);
+
+  /// Whether the native library was built with shared-memory support
+  static bool get isAvailable => _bindings.zenoh_shm_is_available();
+
+  /// Create a provider backed by a shared-memory segment of [size] bytes
+  static ZenohShmProvider create(int size) {
+    final handle = _bindings.zenoh_shm_provider_create(size);
+    if (handle == nullptr) {
+      throw ZenohShmException(isAvailable
+          ? 'Failed to create SHM provider of $size bytes'
+          : 'Shared memory is not supported by this build');
+    }
+    return ZenohShmProvider._(handle);
+  }
+
+  /// Allocate a buffer of [length] bytes from the segment
+  ZenohShmBuffer alloc(int length) {
+    if (_isClosed) throw ZenohShmException('SHM provider is closed');
+    final handle = _bindings.zenoh_shm_alloc(_handle, length);
+    if (handle == nullptr) {
+      throw ZenohShmException('Failed to allocate $length bytes of SHM');
+    }
+    return ZenohShmBuffer._(handle);
+  }
+
+  /// Destroy the provider. Buffers already published remain valid.
+  void close() {
+    if (_isClosed) return;
+    _bindings.zenoh_shm_provider_destroy(_handle);
+    _isClosed = true;
+  }
+}
+
+/// A writable buffer in shared memory, filled in place with [write] and
+/// published with [ZenohPublisher.putShm]. A buffer that is dropped without
+/// being published or freed returns its chunk when it is garbage collected.
+class ZenohShmBuffer implements Finalizable {
+  Pointer<bindings.ZenohShmBuffer> _handle;
+  final int length;
+
+  static final NativeFinalizer _finalizer = NativeFinalizer(
+      _dylib.lookup<NativeFinalizerFunction>('zenoh_shm_buffer_free'));
+
+  ZenohShmBuffer._(this._handle)
+      : length = _bindings.zenoh_shm_buffer_len(_handle) {
+    _finalizer.attach(this, _handle.cast(), detach: this);
+  }
+
+  /// Fill the buffer through [fill], which gets a view of its contents. The
+  /// view is only valid during the call; do not keep it.
+  T write<T>(T Function(Uint8List data) fill) {
+    if (_handle == nullptr) throw ZenohShmException('SHM buffer is released');
+    return fill(_bindings.zenoh_shm_buffer_data(_handle).asTypedList(length));
+  }
+
+  Pointer<bindings.ZenohShmBuffer> _take() {
+    if (_handle == nullptr) throw ZenohShmException('SHM buffer is released');
+    final handle = _handle;
+    _handle = nullptr;
+    _finalizer.detach(this);
+    return handle;
+  }
+
+  /// Release the buffer without publishing it
+  void free() {
+    if (_handle == nullptr) return;
+    _finalizer.detach(this);
+    _bindings.zenoh_shm_buffer_free(_handle);
+    _handle = nullptr;
+  }
+}
+
+// ============================================================================
+// Subscriber
+// ============================================================================
+
+/// A Zenoh subscriber for receiving data on a key expression
+class ZenohSubscriber {
+  final Pointer<bindings.ZenohSubscriber> _handle;
+  final StreamController<ZenohSample> _controller;
+  final int _id;
+  bool _isUndeclared = false;
+
+  ZenohSubscriber._(this._handle, this._controller, this._id);
+
+  /// Stream of received samples
+  Stream<ZenohSample> get stream => _controller.stream;
+
+  /// Samples, bytes, drops and sample copy times of this subscriber.
+  /// Chunked and liveliness subscribers are not tracked.
+  ZenohStats get stats {
+    if (_isUndeclared) {
+      throw ZenohSubscriberException('Subscriber is undeclared');
+    }
+    final stats = ZenohStats._read(
+        (out) => _bindings.zenoh_subscriber_stats_snapshot(_handle, out));
+    if (stats == null) {
+      throw ZenohSubscriberException('Subscriber statistics are not available');
+    }
+    return stats;
+  }
+
+  /// Undeclare and drop the subscriber
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_subscriber(_handle);
+    _isUndeclared = true;
+    _controller.close();
+    ZenohSession._subscribers.remove(_id);
+    ZenohSession._chunkProgressHandlers.remove(_id);
+  }
+
+  /// Undeclare many subscribers in one native call
+  static Future<void> undeclareAll(Iterable<ZenohSubscriber> subscribers) async {
+    final live = subscribers.where((s) => !s._isUndeclared).toSet().toList();
+    if (live.isEmpty) return;
+    final handlesPtr = calloc<Pointer<bindings.ZenohSubscriber>>(live.length);
+    for (var i = 0; i < live.length; i++) {
+      handlesPtr[i] = live[i]._handle;
+      live[i]._isUndeclared = true;
+    }
+    _bindings.zenoh_undeclare_subscribers_bulk(handlesPtr, live.length);
+    calloc.free(handlesPtr);
+    for (final s in live) {
+      s._controller.close();
+      ZenohSession._subscribers.remove(s._id);
+      ZenohSession._chunkProgressHandlers.remove(s._id);
+    }
+  }
+}
+
+/// A subscriber that delivers the queried state before live samples
+class ZenohQueryingSubscriber {
+  final Pointer<bindings.ZenohQueryingSubscriber> _handle;
+  final StreamController<ZenohSample> _controller;
+  final int _id;
+  bool _isUndeclared = false;
+
+  /// Completes once the initial query's replies have been emitted
+  final Future<void> ready;
+
+  ZenohQueryingSubscriber._(
+      this._handle, this._controller, this.ready, this._id);
+
+  /// Stream of queried, then live samples
+  Stream<ZenohSample> get stream => _controller.stream;
+
+  /// Samples, bytes, drops and sample copy times of this subscriber. Held
+  /// samples that could not be buffered during the query count as drops.
+  ZenohStats get stats {
+    if (_isUndeclared) {
+      throw ZenohSubscriberException('Subscriber is undeclared');
+    }
+    final stats = ZenohStats._read((out) =>
+        _bindings.zenoh_querying_subscriber_stats_snapshot(_handle, out));
+    if (stats == null) {
+      throw ZenohSubscriberException('Subscriber statistics are not available');
     }
+    return stats;
   }
 
-  static void _onQueryData(
-    Pointer<Char> key,
-    Pointer<Uint8> value,
-    int len,
-    Pointer<Char> kind,
-    Pointer<Void> context,
-  ) {
-    try {
-      int id = context.address;
-      if (_queries.containsKey(id)) {
-        final keyStr = key.cast<Utf8>().toDartString();
-        final kindStr = kind.cast<Utf8>().toDartString();
-        final payload = len > 0 && value.address != 0
-            ? Uint8List.fromList(value.asTypedList(len))
-            : Uint8List(0);
+  /// Undeclare and drop the subscriber
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_querying_subscriber(_handle);
+    _isUndeclared = true;
+    _controller.close();
+    ZenohSession._subscribers.remove(_id);
+    ZenohSession._subscriberReady.remove(_id)?.complete();
+  }
+}
 
-        _queries[id]?.add(ZenohReply(
-          key: keyStr,
-          payload: payload,
-          kind:
-              kindStr == 'DELETE' ? ZenohSampleKind.delete : ZenohSampleKind.put,
-        ));
+/// A subscriber with history and lost-sample recovery
+class ZenohAdvancedSubscriber {
+  final Pointer<bindings.ZenohAdvancedSubscriber> _handle;
+  final StreamController<ZenohSample> _controller;
+  final int _id;
+  bool _isUndeclared = false;
+
+  ZenohAdvancedSubscriber._(this._handle, this._controller, this._id);
+
+  /// Whether the native library was built with the zenoh-c unstable API
+  static bool get isAvailable =>
+      _bindings.zenoh_advanced_subscriber_is_available();
+
+  /// Stream of history, recovered and live samples
+  Stream<ZenohSample> get stream => _controller.stream;
+
+  /// Undeclare and drop the subscriber
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_advanced_subscriber(_handle);
+    _isUndeclared = true;
+    _controller.close();
+    ZenohSession._subscribers.remove(_id);
+    ZenohSession._sampleMissHandlers.remove(_id);
+  }
+}
+
+// ============================================================================
+// Querier
+// ============================================================================
+
+/// A Zenoh querier for sending repeated queries on a fixed key expression
+class ZenohQuerier {
+  final Pointer<bindings.ZenohQuerier> _handle;
+  final String key;
+  final Duration _timeout;
+  int? _matchingId;
+  bool _isUndeclared = false;
+
+  ZenohQuerier._(this._handle, this.key, this._timeout);
+
+  void _checkUndeclared() {
+    if (_isUndeclared) throw ZenohQueryException('Querier is undeclared');
+  }
+
+  /// Query the querier's key expression with optional selector [parameters]
+  Stream<ZenohReply> get({
+    String parameters = '',
+    Uint8List? payload,
+    ZenohEncoding encoding = ZenohEncoding.bytes,
+    Uint8List? attachment,
+  }) {
+    _checkUndeclared();
+    final id = ZenohSession._nextQueryId++;
+    final controller = StreamController<ZenohReply>();
+    ZenohSession._queries[id] = controller;
+    ZenohSession._queryCompleters[id] = Completer<void>();
+
+    final context = Pointer<Void>.fromAddress(id);
+    final paramsPtr = parameters.toNativeUtf8().cast<Char>();
+
+    Pointer<Uint8> payloadPtr = nullptr;
+    if (payload != null && payload.isNotEmpty) {
+      payloadPtr = calloc<Uint8>(payload.length);
+      payloadPtr.asTypedList(payload.length).setAll(0, payload);
+    }
+
+    Pointer<Uint8> attPtr = nullptr;
+    if (attachment != null && attachment.isNotEmpty) {
+      attPtr = calloc<Uint8>(attachment.length);
+      attPtr.asTypedList(attachment.length).setAll(0, attachment);
+    }
+
+    final result = _bindings.zenoh_querier_get(
+      _handle,
+      paramsPtr,
+      payloadPtr,
+      payload?.length ?? 0,
+      encoding.value,
+      attPtr,
+      attachment?.length ?? 0,
+      ZenohSession._queryCallback!.nativeFunction,
+      ZenohSession._queryCompleteCallback!.nativeFunction,
+      context,
+    );
+
+    calloc.free(paramsPtr);
+    if (payloadPtr != nullptr) calloc.free(payloadPtr);
+    if (attPtr != nullptr) calloc.free(attPtr);
+
+    if (result < 0) {
+      // The completion callback still fires and closes the stream
+      controller.addError(ZenohQueryException('Querier get failed', result));
+    }
+
+    // Timeout fallback, as for ZenohSession.get
+    Future.delayed(_timeout + const Duration(seconds: 1), () {
+      if (!controller.isClosed) {
+        controller.close();
+        ZenohSession._queries.remove(id);
+        ZenohSession._queryCompleters.remove(id);
       }
-    } finally {
-      // Free native memory allocated by C side
-      malloc.free(key);
-      malloc.free(kind);
-      if (value.address != 0 && len > 0) malloc.free(value);
+    });
+
+    return controller.stream;
+  }
+
+  /// Query and collect all replies into a list
+  Future<List<ZenohReply>> getCollect({
+    String parameters = '',
+    Uint8List? payload,
+    ZenohEncoding encoding = ZenohEncoding.bytes,
+    Uint8List? attachment,
+  }) async {
+    final replies = <ZenohReply>[];
+    await for (final reply in get(
+      parameters: parameters,
+      payload: payload,
+      encoding: encoding,
+      attachment: attachment,
+    )) {
+      replies.add(reply);
     }
+    return replies;
   }
 
-  static void _onQueryComplete(Pointer<Void> context) {
-    int id = context.address;
-    if (_queries.containsKey(id)) {
-      _queries[id]?.close();
-      _queries.remove(id);
+  /// Whether any queryable currently matches this querier
+  bool get hasMatchingQueryables {
+    _checkUndeclared();
+    final result = _bindings.zenoh_querier_get_matching_status(_handle);
+    if (result < 0) {
+      throw ZenohQueryException('Failed to get matching status', result);
     }
-    if (_queryCompleters.containsKey(id)) {
-      _queryCompleters[id]?.complete();
-      _queryCompleters.remove(id);
+    return result == 1;
+  }
+
+  /// Stream of matching status changes: true when the first matching
+  /// queryable appears, false when the last one goes away
+  Stream<bool> get matchingStatus {
+    _checkUndeclared();
+    final existing = ZenohSession._matchingListeners[_matchingId];
+    if (existing != null) return existing.stream;
+
+    final id = ZenohSession._nextMatchingId++;
+    final controller = StreamController<bool>.broadcast();
+    ZenohSession._matchingListeners[id] = controller;
+
+    final result = _bindings.zenoh_querier_declare_matching_listener(
+      _handle,
+      ZenohSession._matchingCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    if (result < 0) {
+      ZenohSession._matchingListeners.remove(id);
+      controller.close();
+      throw ZenohQueryException('Failed to declare matching listener', result);
     }
+    _matchingId = id;
+    return controller.stream;
   }
 
-  static void _onQueryRequest(
-    Pointer<Char> key,
-    Pointer<Char> selector,
-    Pointer<Uint8> value,
-    int len,
-    Pointer<Char> kind,
-    Pointer<Void> replyContext,
-    Pointer<Void> userContext,
-  ) {
-    try {
-      int id = userContext.address;
-      if (_queryables.containsKey(id)) {
-        final keyStr = key.cast<Utf8>().toDartString();
-        final selectorStr = selector.cast<Utf8>().toDartString();
-        final kindStr = kind.cast<Utf8>().toDartString();
-        final payload =
-            len > 0 && value.address != 0 ? Uint8List.fromList(value.asTypedList(len)) : null;
+  /// Undeclare and drop the querier
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_querier(_handle);
+    _isUndeclared = true;
+    ZenohSession._matchingListeners.remove(_matchingId)?.close();
+  }
+}
 
-        final query = ZenohQuery(
-          key: keyStr,
-          selector: selectorStr,
-          value: payload,
-          kind:
-              kindStr == 'DELETE' ? ZenohSampleKind.delete : ZenohSampleKind.put,
-          replyContext: replyContext,
-        );
-        _queryables[id]?.call(query);
+// ============================================================================
+// Reply Channel
+// ============================================================================
+
+/// Replies of a query, buffered natively until pulled
+///
+/// A [ZenohReplyChannelKind.fifo] channel that is full blocks the zenoh
+/// thread delivering the next reply, which also stalls other traffic on that
+/// thread. Drain the channel or [close] it; a channel that becomes
+/// unreachable without being closed is released by a finalizer, which also
+/// unblocks the sender.
+class ZenohReplyChannel implements Finalizable {
+  /// Largest batch returned by the native side
+  static const int maxBatch = 64;
+
+  static final NativeFinalizer _finalizer = NativeFinalizer(
+      _dylib.lookup<NativeFinalizerFunction>('zenoh_reply_channel_close'));
+  static final NativeFinalizer _recordsFinalizer =
+      NativeFinalizer(calloc.nativeFree);
+
+  final Pointer<bindings.ZenohReplyChannel> _handle;
+  final Pointer<bindings.ZenohReplyRecord> _records =
+      calloc<bindings.ZenohReplyRecord>(maxBatch);
+  bool _isClosed = false;
+  bool _isDone = false;
+
+  ZenohReplyChannel._(this._handle) {
+    _finalizer.attach(this, _handle.cast(), detach: this);
+    _recordsFinalizer.attach(this, _records.cast(), detach: this);
+  }
+
+  /// Whether every reply has been received
+  bool get isDone => _isDone;
+
+  /// Take up to [max] queued replies without waiting
+  ///
+  /// Returns an empty list when none are queued yet, and null once all
+  /// replies have been received.
+  List<ZenohReply>? tryRecvBatch([int max = maxBatch]) {
+    if (_isClosed || _isDone) return null;
+    final n = _bindings.zenoh_reply_try_recv_batch(
+        _handle, _records, max.clamp(1, maxBatch));
+    if (n < 0) {
+      _isDone = true;
+      return null;
+    }
+    return List.generate(n, (i) => _decode(_records[i]));
+  }
+
+  /// Stream of the replies, pulled only while the stream is listened to
+  ///
+  /// The channel is closed when the stream ends or is cancelled.
+  Stream<ZenohReply> replies({
+    int batchSize = maxBatch,
+    Duration pollInterval = const Duration(milliseconds: 5),
+  }) async* {
+    try {
+      while (true) {
+        final batch = tryRecvBatch(batchSize);
+        if (batch == null) break;
+        if (batch.isEmpty) {
+          await Future.delayed(pollInterval);
+          continue;
+        }
+        for (final reply in batch) {
+          yield reply;
+        }
       }
     } finally {
-      // Free native memory allocated by C side
-      malloc.free(key);
-      malloc.free(selector);
-      malloc.free(kind);
-      if (value.address != 0 && len > 0) malloc.free(value);
+      close();
+    }
+  }
+
+  /// Release the channel; pending replies are dropped
+  void close() {
+    if (_isClosed) return;
+    _isClosed = true;
+    _finalizer.detach(this);
+    _recordsFinalizer.detach(this);
+    _bindings.zenoh_reply_channel_close(_handle);
+    calloc.free(_records);
+  }
+
+  static ZenohReply _decode(bindings.ZenohReplyRecord r) {
+    return ZenohReply(
+      key: r.key != nullptr ? r.key.cast<Utf8>().toDartString() : '',
+      payload: r.payload_len > 0
+          ? Uint8List.fromList(r.payload.asTypedList(r.payload_len))
+          : Uint8List(0),
+      kind: r.reply_kind == bindings.ZenohReplyKind.ZENOH_REPLY_KIND_DELETE
+          ? ZenohSampleKind.delete
+          : ZenohSampleKind.put,
+      encoding:
+          ZenohEncoding.fromMimeType(r.encoding.cast<Utf8>().toDartString()),
+      attachment: r.attachment_len > 0
+          ? Uint8List.fromList(r.attachment.asTypedList(r.attachment_len))
+          : null,
+      timestamp: _ntp64ToDateTime(r.timestamp),
+      replierId: r.replier_id != nullptr
+          ? r.replier_id.cast<Utf8>().toDartString()
+          : null,
+      isError: r.reply_kind == bindings.ZenohReplyKind.ZENOH_REPLY_KIND_ERROR,
+    );
+  }
+}
+
+// ============================================================================
+// RPC
+// ============================================================================
+
+/// Handler of an RPC method implemented in Dart
+typedef ZenohRpcMethod = FutureOr<Uint8List> Function(Uint8List request);
+
+/// Serves RPC methods on a service key
+class ZenohRpcServer {
+  final Pointer<bindings.ZenohRpcServer> _handle;
+  final int _id;
+  final Map<String, ZenohRpcMethod> _handlers = {};
+  bool _isUndeclared = false;
+
+  ZenohRpcServer._(this._handle, this._id);
+
+  /// Serve [method] with a Dart handler. Exceptions thrown by the handler
+  /// are returned to the caller as [ZenohRpcStatus.error].
+  void register(String method, ZenohRpcMethod handler) {
+    _register(method, nullptr, nullptr);
+    _handlers[method] = handler;
+  }
+
+  /// Serve [method] with a native handler, run on zenoh threads
+  void registerNative(
+    String method,
+    bindings.ZenohRpcHandler handler, [
+    Pointer<Void>? context,
+  ]) {
+    _register(method, handler, context ?? nullptr);
+    _handlers.remove(method);
+  }
+
+  void _register(String method, bindings.ZenohRpcHandler handler,
+      Pointer<Void> context) {
+    if (_isUndeclared) throw ZenohQueryableException('RPC server undeclared');
+    final methodPtr = method.toNativeUtf8().cast<Char>();
+    final rc = _bindings.zenoh_rpc_server_register(
+        _handle, methodPtr, handler, context);
+    calloc.free(methodPtr);
+    if (rc != 0) {
+      throw ZenohQueryableException('Failed to register RPC method: $method');
+    }
+  }
+
+  /// Stop serving [method]
+  void unregister(String method) {
+    if (_isUndeclared) return;
+    final methodPtr = method.toNativeUtf8().cast<Char>();
+    _bindings.zenoh_rpc_server_unregister(_handle, methodPtr);
+    calloc.free(methodPtr);
+    _handlers.remove(method);
+  }
+
+  /// Undeclare the server
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_rpc_server(_handle);
+    _isUndeclared = true;
+    ZenohSession._rpcServers.remove(_id);
+  }
+
+  static void _respond(Pointer<bindings.ZenohQuery> query, int callId,
+      int status, List<int> data) {
+    final dataPtr = data.isNotEmpty ? calloc<Uint8>(data.length) : nullptr;
+    if (data.isNotEmpty) dataPtr.asTypedList(data.length).setAll(0, data);
+    _bindings.zenoh_rpc_respond(query, callId, status, dataPtr, data.length);
+    if (dataPtr != nullptr) calloc.free(dataPtr);
+  }
+}
+
+/// Calls the methods of an RPC service
+class ZenohRpcClient {
+  final Pointer<bindings.ZenohRpcClient> _handle;
+  bool _isClosed = false;
+
+  ZenohRpcClient._(this._handle);
+
+  /// Call [method] with [request]
+  ///
+  /// Attempts that get no reply are retried up to [retries] times (at most
+  /// 64) while [deadline] has not passed; no attempt waits past it. Fails
+  /// with a [ZenohRpcException] unless the server answers with
+  /// [ZenohRpcStatus.ok].
+  Future<Uint8List> call(
+    String method,
+    List<int> request, {
+    Duration? deadline,
+    int retries = 0,
+  }) {
+    if (_isClosed) throw ZenohQueryException('RPC client closed');
+    if (retries < 0) {
+      throw ArgumentError.value(retries, 'retries', 'must not be negative');
+    }
+    if (deadline != null && deadline.isNegative) {
+      throw ArgumentError.value(deadline, 'deadline', 'must not be negative');
+    }
+
+    final id = ZenohSession._nextRpcId++;
+    final completer = Completer<Uint8List>();
+    ZenohSession._rpcCalls[id] = completer;
+
+    final methodPtr = method.toNativeUtf8().cast<Char>();
+    final requestPtr =
+        request.isNotEmpty ? calloc<Uint8>(request.length) : nullptr;
+    if (request.isNotEmpty) {
+      requestPtr.asTypedList(request.length).setAll(0, request);
+    }
+
+    final callId = _bindings.zenoh_rpc_call(
+      _handle,
+      methodPtr,
+      requestPtr,
+      request.length,
+      deadline?.inMilliseconds ?? 0,
+      retries,
+      ZenohSession._rpcResponseCallback!.nativeFunction,
+      Pointer<Void>.fromAddress(id),
+    );
+    calloc.free(methodPtr);
+    if (requestPtr != nullptr) calloc.free(requestPtr);
+
+    if (callId == 0) {
+      ZenohSession._rpcCalls.remove(id);
+      throw ZenohQueryException('Failed to call RPC method: $method');
+    }
+    return completer.future;
+  }
+
+  /// Release the client; calls in flight still complete
+  void close() {
+    if (_isClosed) return;
+    _isClosed = true;
+    _bindings.zenoh_rpc_client_close(_handle);
+  }
+}
+
+// ============================================================================
+// Queryable
+// ============================================================================
+
+/// A Zenoh queryable for handling queries on a key expression
+class ZenohQueryable {
+  final Pointer<bindings.ZenohQueryable> _handle;
+  final int _id;
+  bool _isUndeclared = false;
+
+  ZenohQueryable._(this._handle, this._id);
+
+  /// Queries served by this queryable
+  ZenohStats get stats {
+    if (_isUndeclared) {
+      throw ZenohQueryableException('Queryable is undeclared');
+    }
+    final stats = ZenohStats._read(
+        (out) => _bindings.zenoh_queryable_stats_snapshot(_handle, out));
+    if (stats == null) {
+      throw ZenohQueryableException('Queryable statistics are not available');
+    }
+    return stats;
+  }
+
+  /// Undeclare and drop the queryable
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_queryable(_handle);
+    _isUndeclared = true;
+    ZenohSession._queryables.remove(_id);
+  }
+}
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+/// A native storage answering queries on its key expression
+class ZenohStorage {
+  final Pointer<bindings.ZenohStorage> _handle;
+  final String keyExpr;
+  final int _id;
+  bool _isUndeclared = false;
+
+  ZenohStorage._(this._handle, this.keyExpr, this._id);
+
+  void _checkUndeclared() {
+    if (_isUndeclared) throw ZenohStorageException('Storage is undeclared');
+  }
+
+  /// Stream of applied updates. Empty unless the storage was declared with
+  /// [ZenohStorageOptions.notifyChanges].
+  Stream<ZenohStorageChange> get changes =>
+      ZenohSession._storageChanges[_id]?.stream ??
+      const Stream<ZenohStorageChange>.empty();
+
+  /// Read the stored value of [key] without a network round trip
+  Uint8List? get(String key) {
+    _checkUndeclared();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final dataPtr = calloc<Pointer<Uint8>>();
+    final lenPtr = calloc<Size>();
+    try {
+      final result =
+          _bindings.zenoh_storage_get(_handle, keyPtr, dataPtr, lenPtr);
+      if (result < 0) throw ZenohStorageException('Storage read failed', result);
+      if (result == 0) return null;
+
+      final data = dataPtr.value;
+      if (data == nullptr) return Uint8List(0);
+      final value = Uint8List.fromList(data.asTypedList(lenPtr.value));
+      _bindings.zenoh_free_string(data.cast());
+      return value;
+    } finally {
+      calloc.free(keyPtr);
+      calloc.free(dataPtr);
+      calloc.free(lenPtr);
     }
   }
 
-  static void _onLivelinessEvent(
-    Pointer<Char> key,
-    int isAlive,
-    Pointer<Void> context,
-  ) {
+  /// Read the stored value of [key] as a UTF-8 string
+  String? getString(String key) {
+    final value = get(key);
+    return value != null ? utf8.decode(value, allowMalformed: true) : null;
+  }
+
+  /// Current storage counters
+  ZenohStorageStats get stats {
+    _checkUndeclared();
+    final statsPtr = calloc<bindings.ZenohStorageStats>();
     try {
-      int id = context.address;
-      if (_livelinessSubscribers.containsKey(id)) {
-        final keyStr = key.cast<Utf8>().toDartString();
-        _livelinessSubscribers[id]
-            ?.add(ZenohLivelinessEvent(keyStr, isAlive != 0));
+      final result = _bindings.zenoh_storage_stats(_handle, statsPtr);
+      if (result < 0) {
+        throw ZenohStorageException('Failed to read storage stats', result);
       }
+      return ZenohStorageStats(
+        entries: statsPtr.ref.entries,
+        tombstones: statsPtr.ref.tombstones,
+        memoryBytes: statsPtr.ref.memory_bytes,
+        queries: statsPtr.ref.queries,
+        rejected: statsPtr.ref.rejected,
+      );
     } finally {
-      // Free native memory allocated by C side
-      malloc.free(key);
+      calloc.free(statsPtr);
     }
   }
+
+  /// Undeclare the storage and free its contents
+  Future<void> undeclare() async {
+    if (_isUndeclared) return;
+    _bindings.zenoh_undeclare_storage(_handle);
+    _isUndeclared = true;
+    ZenohSession._storageChanges.remove(_id)?.close();
+  }
 }
 
 // ============================================================================
-// Publisher
+// Log Store
 // ============================================================================
 
-/// A Zenoh publisher for sending data on a specific key expression
-class ZenohPublisher {
-  final Pointer<bindings.ZenohPublisher> _handle;
-  bool _isUndeclared = false;
+/// A durable key-value store of append-only, memory-mapped segment files
+///
+/// Values stay on disk; only the key index lives in memory. Pass the store
+/// to [ZenohSession.declareLogStorage] to serve it over zenoh.
+class ZenohLogStore {
+  final Pointer<bindings.ZenohLogStore> _handle;
+  final String path;
+  bool _isClosed = false;
 
-  ZenohPublisher._(this._handle);
+  ZenohLogStore._(this._handle, this.path);
 
-  void _checkUndeclared() {
-    if (_isUndeclared) throw ZenohPublisherException('Publisher is undeclared');
+  /// Open the store in directory [path], creating it if needed
+  static ZenohLogStore open(
+    String path, {
+    ZenohLogStoreOptions options = ZenohLogStoreOptions.defaultOptions,
+  }) {
+    final pathPtr = path.toNativeUtf8().cast<Char>();
+    final optsPtr = calloc<bindings.ZenohLogStoreOptions>();
+    optsPtr.ref.segment_size = options.segmentSize;
+    optsPtr.ref.compaction_ratio = options.compactionRatio;
+    optsPtr.ref.compaction_interval_ms =
+        options.compactionInterval.inMilliseconds;
+    optsPtr.ref.sync_writes = options.syncWrites;
+
+    final handle = _bindings.zenoh_log_store_open(pathPtr, optsPtr);
+    calloc.free(pathPtr);
+    calloc.free(optsPtr);
+
+    if (handle == nullptr) {
+      throw ZenohStorageException('Failed to open log store at: $path');
+    }
+    return ZenohLogStore._(handle, path);
   }
 
-  /// Put data through this publisher
-  Future<void> put(Uint8List data, {ZenohPutOptions? options}) async {
-    _checkUndeclared();
+  void _checkClosed() {
+    if (_isClosed) throw ZenohStorageException('Log store is closed');
+  }
 
-    final dataPtr = calloc<Uint8>(data.length);
-    final dataList = dataPtr.asTypedList(data.length);
-    dataList.setAll(0, data);
+  /// Write [value] under [key]
+  void put(String key, Uint8List value,
+      {ZenohEncoding encoding = ZenohEncoding.bytes}) {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final dataPtr = calloc<Uint8>(value.length);
+    dataPtr.asTypedList(value.length).setAll(0, value);
 
-    int result;
-    if (options != null) {
-      final optsPtr = calloc<bindings.ZenohPutOptions>();
-      optsPtr.ref.priority = options.priority.value;
-      optsPtr.ref.congestion_control = options.congestionControl.value;
-      optsPtr.ref.encoding = options.encoding.value;
-      optsPtr.ref.is_express = options.express;
-      optsPtr.ref.encoding_schema = nullptr;
+    final result = _bindings.zenoh_log_store_put(
+        _handle, keyPtr, dataPtr, value.length, encoding.value);
+    calloc.free(keyPtr);
+    calloc.free(dataPtr);
 
-      if (options.attachment != null && options.attachment!.isNotEmpty) {
-        final attPtr = calloc<Uint8>(options.attachment!.length);
-        attPtr
-            .asTypedList(options.attachment!.length)
-            .setAll(0, options.attachment!);
-        optsPtr.ref.attachment = attPtr;
-        optsPtr.ref.attachment_len = options.attachment!.length;
-      } else {
-        optsPtr.ref.attachment = nullptr;
-        optsPtr.ref.attachment_len = 0;
-      }
+    if (result < 0) throw ZenohStorageException('Log store write failed', result);
+  }
 
-      result = _bindings.zenoh_publisher_put_with_options(
-          _handle, dataPtr, data.length, optsPtr);
+  /// Write a UTF-8 string under [key]
+  void putString(String key, String value) {
+    put(key, Uint8List.fromList(utf8.encode(value)),
+        encoding: ZenohEncoding.textPlain);
+  }
 
-      if (optsPtr.ref.attachment != nullptr) {
-        calloc.free(optsPtr.ref.attachment);
-      }
-      calloc.free(optsPtr);
-    } else {
-      result = _bindings.zenoh_publisher_put(_handle, dataPtr, data.length);
+  /// Delete [key], keeping a tombstone for last-writer-wins
+  void delete(String key) {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final result = _bindings.zenoh_log_store_delete(_handle, keyPtr);
+    calloc.free(keyPtr);
+
+    if (result < 0) {
+      throw ZenohStorageException('Log store delete failed', result);
     }
+  }
 
-    calloc.free(dataPtr);
+  /// Read the value of [key] from disk
+  Uint8List? get(String key) {
+    _checkClosed();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final dataPtr = calloc<Pointer<Uint8>>();
+    final lenPtr = calloc<Size>();
+    try {
+      final result =
+          _bindings.zenoh_log_store_get(_handle, keyPtr, dataPtr, lenPtr);
+      if (result < 0) {
+        throw ZenohStorageException('Log store read failed', result);
+      }
+      if (result == 0) return null;
 
-    if (result < 0) {
-      throw ZenohPublisherException('Publisher put failed', result);
+      final data = dataPtr.value;
+      if (data == nullptr) return Uint8List(0);
+      final value = Uint8List.fromList(data.asTypedList(lenPtr.value));
+      _bindings.zenoh_free_string(data.cast());
+      return value;
+    } finally {
+      calloc.free(keyPtr);
+      calloc.free(dataPtr);
+      calloc.free(lenPtr);
     }
   }
 
-  /// Put a string through this publisher
-  Future<void> putString(String value, {ZenohPutOptions? options}) async {
-    await put(
-      Uint8List.fromList(utf8.encode(value)),
-      options:
-          options ?? const ZenohPutOptions(encoding: ZenohEncoding.textPlain),
-    );
+  /// Read the value of [key] as a UTF-8 string
+  String? getString(String key) {
+    final value = get(key);
+    return value != null ? utf8.decode(value, allowMalformed: true) : null;
   }
 
-  /// Put JSON data through this publisher
-  Future<void> putJson(Object value, {Uint8List? attachment}) async {
-    await put(
-      Uint8List.fromList(utf8.encode(jsonEncode(value))),
-      options: ZenohPutOptions(
-        encoding: ZenohEncoding.applicationJson,
-        attachment: attachment,
-      ),
-    );
+  /// Current store counters
+  ZenohLogStoreStats get stats {
+    _checkClosed();
+    final statsPtr = calloc<bindings.ZenohLogStoreStats>();
+    try {
+      final result = _bindings.zenoh_log_store_stats(_handle, statsPtr);
+      if (result < 0) {
+        throw ZenohStorageException('Failed to read log store stats', result);
+      }
+      return ZenohLogStoreStats(
+        entries: statsPtr.ref.entries,
+        tombstones: statsPtr.ref.tombstones,
+        segments: statsPtr.ref.segments,
+        diskBytes: statsPtr.ref.disk_bytes,
+        liveBytes: statsPtr.ref.live_bytes,
+        indexBytes: statsPtr.ref.index_bytes,
+        compactions: statsPtr.ref.compactions,
+      );
+    } finally {
+      calloc.free(statsPtr);
+    }
   }
 
-  /// Delete through this publisher
-  Future<void> delete() async {
-    _checkUndeclared();
-    _bindings.zenoh_publisher_delete(_handle);
+  /// Compact every sealed segment now. Returns the number reclaimed.
+  int compact() {
+    _checkClosed();
+    final result = _bindings.zenoh_log_store_compact(_handle);
+    if (result < 0) {
+      throw ZenohStorageException('Log store compaction failed', result);
+    }
+    return result;
   }
 
-  /// Undeclare and drop the publisher
-  Future<void> undeclare() async {
-    if (_isUndeclared) return;
-    _bindings.zenoh_undeclare_publisher(_handle);
-    _isUndeclared = true;
+  /// Sync segments to disk and write the index snapshot
+  void flush() {
+    _checkClosed();
+    final result = _bindings.zenoh_log_store_flush(_handle);
+    if (result < 0) throw ZenohStorageException('Log store flush failed', result);
+  }
+
+  /// Write the index snapshot and release the store. Storages declared on it
+  /// keep it open until they are undeclared.
+  void close() {
+    if (_isClosed) return;
+    _bindings.zenoh_log_store_close(_handle);
+    _isClosed = true;
   }
 }
 
 // ============================================================================
-// Subscriber
+// Time Series
 // ============================================================================
 
-/// A Zenoh subscriber for receiving data on a key expression
-class ZenohSubscriber {
-  final Pointer<bindings.ZenohSubscriber> _handle;
-  final StreamController<ZenohSample> _controller;
-  final int _id;
+/// A native time series answering range and downsampling queries
+class ZenohTimeSeries {
+  final Pointer<bindings.ZenohTimeSeries> _handle;
+  final String keyExpr;
   bool _isUndeclared = false;
 
-  ZenohSubscriber._(this._handle, this._controller, this._id);
+  ZenohTimeSeries._(this._handle, this.keyExpr);
 
-  /// Stream of received samples
-  Stream<ZenohSample> get stream => _controller.stream;
+  void _checkUndeclared() {
+    if (_isUndeclared) throw ZenohStorageException('Time series is undeclared');
+  }
 
-  /// Undeclare and drop the subscriber
-  Future<void> undeclare() async {
-    if (_isUndeclared) return;
-    _bindings.zenoh_undeclare_subscriber(_handle);
-    _isUndeclared = true;
-    _controller.close();
-    ZenohSession._subscribers.remove(_id);
+  /// Selector parameters for a time-series query
+  ///
+  /// [range] uses the `_time` syntax, e.g. `[now(-1h)..]`. Points are
+  /// aggregated per [step] when it is given.
+  static String parameters({
+    String? range,
+    Duration? step,
+    ZenohTimeSeriesAgg agg = ZenohTimeSeriesAgg.avg,
+  }) {
+    return [
+      if (range != null) '_time=$range',
+      if (step != null) ...[
+        'step=${step.inMicroseconds}u',
+        'agg=${agg.name}',
+      ],
+    ].join(';');
   }
-}
 
-// ============================================================================
-// Queryable
-// ============================================================================
+  /// Selector for [ZenohSession.get]; decode replies with
+  /// [ZenohTimePoint.decode]
+  static String selector(
+    String keyExpr, {
+    String? range,
+    Duration? step,
+    ZenohTimeSeriesAgg agg = ZenohTimeSeriesAgg.avg,
+  }) {
+    final params = parameters(range: range, step: step, agg: agg);
+    return params.isEmpty ? keyExpr : '$keyExpr?$params';
+  }
 
-/// A Zenoh queryable for handling queries on a key expression
-class ZenohQueryable {
-  final Pointer<bindings.ZenohQueryable> _handle;
-  final int _id;
-  bool _isUndeclared = false;
+  /// Read the points of [key] locally, without a network round trip
+  List<ZenohTimePoint> read(
+    String key, {
+    String? range,
+    Duration? step,
+    ZenohTimeSeriesAgg agg = ZenohTimeSeriesAgg.avg,
+  }) {
+    _checkUndeclared();
+    final keyPtr = key.toNativeUtf8().cast<Char>();
+    final paramsPtr = parameters(range: range, step: step, agg: agg)
+        .toNativeUtf8()
+        .cast<Char>();
+    final dataPtr = calloc<Pointer<Uint8>>();
+    final lenPtr = calloc<Size>();
+    try {
+      final result = _bindings.zenoh_timeseries_read(
+          _handle, keyPtr, paramsPtr, dataPtr, lenPtr);
+      if (result < 0) {
+        throw ZenohStorageException('Time series read failed', result);
+      }
 
-  ZenohQueryable._(this._handle, this._id);
+      final data = dataPtr.value;
+      if (data == nullptr) return const [];
+      final points = ZenohTimePoint.decode(data.asTypedList(lenPtr.value));
+      _bindings.zenoh_free_string(data.cast());
+      return points;
+    } finally {
+      calloc.free(keyPtr);
+      calloc.free(paramsPtr);
+      calloc.free(dataPtr);
+      calloc.free(lenPtr);
+    }
+  }
 
-  /// Undeclare and drop the queryable
+  /// Current time series counters
+  ZenohTimeSeriesStats get stats {
+    _checkUndeclared();
+    final statsPtr = calloc<bindings.ZenohTimeSeriesStats>();
+    try {
+      final result = _bindings.zenoh_timeseries_stats(_handle, statsPtr);
+      if (result < 0) {
+        throw ZenohStorageException('Failed to read time series stats', result);
+      }
+      return ZenohTimeSeriesStats(
+        series: statsPtr.ref.series,
+        points: statsPtr.ref.points,
+        samples: statsPtr.ref.samples,
+        rejected: statsPtr.ref.rejected,
+        queries: statsPtr.ref.queries,
+        memoryBytes: statsPtr.ref.memory_bytes,
+      );
+    } finally {
+      calloc.free(statsPtr);
+    }
+  }
+
+  /// Undeclare the time series and free its rings
   Future<void> undeclare() async {
     if (_isUndeclared) return;
-    _bindings.zenoh_undeclare_queryable(_handle);
+    _bindings.zenoh_undeclare_timeseries(_handle);
     _isUndeclared = true;
-    ZenohSession._queryables.remove(_id);
   }
 }
 
@@ -1320,6 +5154,261 @@ class ZenohLivelinessSubscriber {
   }
 }
 
+/// Alive tokens under a key expression, kept natively
+class ZenohLivelinessTracker {
+  final Pointer<bindings.ZenohLivelinessTracker> _handle;
+  final StreamController<ZenohLivelinessDelta> _controller;
+  final int _id;
+  bool _isClosed = false;
+
+  ZenohLivelinessTracker._(this._handle, this._controller, this._id);
+
+  /// Coalesced changes, in version order
+  Stream<ZenohLivelinessDelta> get changes => _controller.stream;
+
+  /// Number of alive tokens as of the last delta
+  int get count {
+    _checkClosed();
+    return _bindings.zenoh_liveliness_tracker_count(_handle);
+  }
+
+  /// The alive set as of the last delta
+  ZenohLivelinessSnapshot snapshot() {
+    _checkClosed();
+    final versionPtr = calloc<Uint64>();
+    final countPtr = calloc<Size>();
+    final lenPtr = calloc<Size>();
+    try {
+      final keys = _bindings.zenoh_liveliness_snapshot(
+          _handle, versionPtr, countPtr, lenPtr);
+      if (keys == nullptr) {
+        throw ZenohLivelinessException('Failed to snapshot liveliness');
+      }
+      final alive = _unpackKeys(keys, lenPtr.value).toSet();
+      _bindings.zenoh_free_string(keys);
+      return ZenohLivelinessSnapshot(versionPtr.value, alive);
+    } finally {
+      calloc.free(versionPtr);
+      calloc.free(countPtr);
+      calloc.free(lenPtr);
+    }
+  }
+
+  /// Stop tracking and close [changes]
+  Future<void> close() async {
+    if (_isClosed) return;
+    _isClosed = true;
+    _bindings.zenoh_liveliness_tracker_close(_handle);
+    ZenohSession._livelinessTrackers.remove(_id);
+    await _controller.close();
+  }
+
+  void _checkClosed() {
+    if (_isClosed) {
+      throw ZenohLivelinessException('Liveliness tracker is closed');
+    }
+  }
+
+  /// Split NUL-terminated keys packed back to back
+  static List<String> _unpackKeys(Pointer<Char> keys, int len) {
+    if (len == 0) return const [];
+    return unpackKeys(keys.cast<Uint8>().asTypedList(len));
+  }
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+/// Zenoh serialization of numeric arrays and fixed-layout records, done in
+/// Dart straight into the returned buffer. Payloads are sequences framed by
+/// `ze_serializer_serialize_sequence_length`, so the other zenoh bindings
+/// read them as lists of the element type (or of tuples for records).
+class ZenohSerializer {
+  ZenohSerializer._();
+
+  static Uint8List float32List(Float32List values) =>
+      _serializeArray(ZenohSerialType.float32, values);
+
+  static Uint8List float64List(Float64List values) =>
+      _serializeArray(ZenohSerialType.float64, values);
+
+  static Uint8List int32List(Int32List values) =>
+      _serializeArray(ZenohSerialType.int32, values);
+
+  static Float32List toFloat32List(Uint8List payload) =>
+      _deserializeArray(ZenohSerialType.float32, payload)
+          .buffer
+          .asFloat32List();
+
+  static Float64List toFloat64List(Uint8List payload) =>
+      _deserializeArray(ZenohSerialType.float64, payload)
+          .buffer
+          .asFloat64List();
+
+  static Int32List toInt32List(Uint8List payload) =>
+      _deserializeArray(ZenohSerialType.int32, payload).buffer.asInt32List();
+
+  /// Serialize the records in [data], [stride] bytes apart, such as the
+  /// bytes of an array of FFI structs. Each record is written as [fields]
+  /// in order, without padding. [data] must hold a whole number of records.
+  static Uint8List records(
+      List<ZenohSerialField> fields, ByteData data, int stride) {
+    _recordSize(fields, stride);
+    if (data.lengthInBytes % stride != 0) {
+      throw ArgumentError.value(data.lengthInBytes, 'data',
+          'must be a whole number of $stride-byte records');
+    }
+    return _encode(fields,
+        data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes), stride);
+  }
+
+  /// Deserialize a payload written by [records] (or a list of tuples from
+  /// another binding) into records [stride] bytes apart
+  static ByteData toRecords(
+          List<ZenohSerialField> fields, Uint8List payload, int stride) =>
+      ByteData.sublistView(_decode(fields, payload, stride,
+          'Payload is not a sequence of records'));
+
+  static Uint8List _serializeArray(ZenohSerialType type, TypedData values) =>
+      _encode([ZenohSerialField(type, 0)],
+          values.buffer.asUint8List(values.offsetInBytes, values.lengthInBytes),
+          type.size);
+
+  /// The values of a [type] sequence payload as bytes
+  static Uint8List _deserializeArray(ZenohSerialType type, Uint8List payload) =>
+      _decode([ZenohSerialField(type, 0)], payload, type.size,
+          'Payload is not a sequence of ${type.name}');
+
+  static Uint8List _encode(
+      List<ZenohSerialField> fields, Uint8List src, int stride) {
+    final recordSize = _recordSize(fields, stride);
+    final count = src.length ~/ stride;
+    final headLen = _lengthPrefixSize(count);
+    final out = Uint8List(headLen + count * recordSize);
+
+    // The sequence length is a LEB128 varint
+    var v = count, o = 0;
+    while (v >= 0x80) {
+      out[o++] = (v & 0x7f) | 0x80;
+      v >>= 7;
+    }
+    out[o++] = v;
+
+    if (_isPacked(fields, stride)) {
+      out.setRange(o, out.length, src);
+      return out;
+    }
+    for (var r = 0; r < count; r++) {
+      final base = r * stride;
+      for (final field in fields) {
+        final from = base + field.offset;
+        if (field.type == ZenohSerialType.boolean) {
+          out[o] = src[from] != 0 ? 1 : 0;
+        } else {
+          _copyValue(src, from, out, o, field.type.size);
+        }
+        o += field.type.size;
+      }
+    }
+    return out;
+  }
+
+  static Uint8List _decode(List<ZenohSerialField> fields, Uint8List payload,
+      int stride, String error) {
+    final recordSize = _recordSize(fields, stride);
+
+    var count = 0, shift = 0, i = 0;
+    for (;; i++) {
+      if (i >= payload.length || i >= 9) throw ZenohException(error);
+      count |= (payload[i] & 0x7f) << shift;
+      shift += 7;
+      if ((payload[i] & 0x80) == 0) break;
+    }
+    i++;
+    final remaining = payload.length - i;
+    if (count < 0 ||
+        count > remaining ~/ recordSize ||
+        count * recordSize != remaining) {
+      throw ZenohException(error);
+    }
+
+    final out = Uint8List(count * stride);
+    if (_isPacked(fields, stride)) {
+      out.setRange(0, out.length, payload, i);
+      return out;
+    }
+    for (var r = 0; r < count; r++) {
+      final base = r * stride;
+      for (final field in fields) {
+        final to = base + field.offset;
+        if (field.type == ZenohSerialType.boolean) {
+          if (payload[i] > 1) throw ZenohException(error);
+          out[to] = payload[i];
+        } else {
+          _copyValue(payload, i, out, to, field.type.size);
+        }
+        i += field.type.size;
+      }
+    }
+    return out;
+  }
+
+  static int _lengthPrefixSize(int count) {
+    var size = 1;
+    for (var v = count; v >= 0x80; v >>= 7) {
+      size++;
+    }
+    return size;
+  }
+
+  /// Whether memory and wire layout are the same, so whole buffers can be
+  /// copied at once
+  static bool _isPacked(List<ZenohSerialField> fields, int stride) {
+    if (Endian.host != Endian.little) return false;
+    var size = 0;
+    for (final field in fields) {
+      if (field.offset != size || field.type == ZenohSerialType.boolean) {
+        return false;
+      }
+      size += field.type.size;
+    }
+    return size == stride;
+  }
+
+  // Copy one value between host order and wire (little-endian) order
+  static void _copyValue(
+      Uint8List src, int from, Uint8List dst, int to, int size) {
+    if (Endian.host == Endian.little) {
+      for (var k = 0; k < size; k++) {
+        dst[to + k] = src[from + k];
+      }
+    } else {
+      for (var k = 0; k < size; k++) {
+        dst[to + k] = src[from + size - 1 - k];
+      }
+    }
+  }
+
+  static int _recordSize(List<ZenohSerialField> fields, int stride) {
+    if (fields.isEmpty) {
+      throw ArgumentError.value(fields, 'fields', 'must not be empty');
+    }
+    if (stride <= 0) {
+      throw ArgumentError.value(stride, 'stride', 'must be positive');
+    }
+    var size = 0;
+    for (final field in fields) {
+      if (field.offset < 0 || field.offset + field.type.size > stride) {
+        throw ArgumentError.value(
+            field.offset, 'fields', 'must lie within the $stride-byte stride');
+      }
+      size += field.type.size;
+    }
+    return size;
+  }
+}
+
 // ============================================================================
 // Retry Wrapper
 // ============================================================================
@@ -1,15 +1,160 @@
+// Before any include: glibc hides syscall, clock_gettime, posix_fallocate,
+// pwrite and friends under a strict -std=c11
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "zenoh_ffi.h"
 
+#if defined(Z_FEATURE_SHARED_MEMORY) && defined(Z_FEATURE_UNSTABLE_API)
+#define ZENOH_FFI_HAS_SHM 1
+#else
+#define ZENOH_FFI_HAS_SHM 0
+#endif
+
+#if defined(Z_FEATURE_UNSTABLE_API)
+#define ZENOH_FFI_HAS_UNSTABLE 1
+#else
+#define ZENOH_FFI_HAS_UNSTABLE 0
+#endif
+
+#if defined(_WIN32)
+#include <io.h>
+#include <ws2tcpip.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+// ============================================================================
+// Atomics
+// ============================================================================
+
+#if defined(_WIN32)
+typedef volatile LONG atomic_count_t;
+
+static long atomic_count_inc(atomic_count_t *count) {
+  return InterlockedIncrement(count);
+}
+
+static long atomic_count_dec(atomic_count_t *count) {
+  return InterlockedDecrement(count);
+}
+
+static long atomic_count_load(atomic_count_t *count) {
+  return InterlockedCompareExchange(count, 0, 0);
+}
+
+static bool atomic_count_cas(atomic_count_t *count, long expected,
+                             long desired) {
+  return InterlockedCompareExchange(count, desired, expected) == expected;
+}
+
+typedef volatile LONG64 stat_counter_t;
+
+static void stat_add(stat_counter_t *counter, uint64_t n) {
+  InterlockedExchangeAdd64(counter, (LONG64)n);
+}
+
+static uint64_t stat_load(stat_counter_t *counter) {
+  return (uint64_t)InterlockedCompareExchange64(counter, 0, 0);
+}
+#else
+typedef volatile long atomic_count_t;
+
+static long atomic_count_inc(atomic_count_t *count) {
+  return __atomic_add_fetch(count, 1, __ATOMIC_ACQ_REL);
+}
+
+static long atomic_count_dec(atomic_count_t *count) {
+  return __atomic_sub_fetch(count, 1, __ATOMIC_ACQ_REL);
+}
+
+static long atomic_count_load(atomic_count_t *count) {
+  return __atomic_load_n(count, __ATOMIC_ACQUIRE);
+}
+
+static bool atomic_count_cas(atomic_count_t *count, long expected,
+                             long desired) {
+  return __atomic_compare_exchange_n(count, &expected, desired, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// Statistics only need atomicity, not ordering
+typedef volatile uint64_t stat_counter_t;
+
+static void stat_add(stat_counter_t *counter, uint64_t n) {
+  __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static uint64_t stat_load(stat_counter_t *counter) {
+  return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+#endif
+
 // ============================================================================
 // Struct definitions
 // ============================================================================
 
+#define STATS_CACHE_LINE 64
+
+enum StatsKind { STATS_SESSION, STATS_PUBLISHER, STATS_SUBSCRIBER, STATS_QUERYABLE };
+
+// Counters of one entity, allocated on their own cache lines so entities
+// updated from different threads never share one
+struct EntityStats {
+  stat_counter_t puts;
+  stat_counter_t bytes_out;
+  stat_counter_t put_errors;
+  stat_counter_t samples_in;
+  stat_counter_t bytes_in;
+  stat_counter_t dropped_samples;
+  stat_counter_t queries_served;
+  stat_counter_t sample_copy[ZENOH_STATS_COPY_BUCKETS];
+  // Registration, guarded by the owner's stats_mutex
+  enum StatsKind kind;
+  ZenohSession *owner; // Holds a session reference until released
+  struct EntityStats *prev;
+  struct EntityStats *next;
+};
+
 struct ZenohSession {
   z_owned_session_t session;
+  // The handle plus one per registered entity and RPC client. The zenoh
+  // session is closed with the handle but dropped with the last reference.
+  atomic_count_t refs;
+  struct EntityStats *stats; // Ad-hoc operations and undeclared entities
+  z_owned_mutex_t stats_mutex;
+  struct EntityStats *entities; // Live publishers, subscribers, queryables
+};
+
+// Contiguous storage of the entities declared by one bulk call, freed with
+// the last of them
+struct EntityPool {
+  atomic_count_t refs;
+  void *entities;
 };
 
 struct ZenohPublisher {
   z_owned_publisher_t publisher;
+  struct EntityStats *stats;
+  struct EntityPool *pool; // NULL unless declared in bulk
+  atomic_count_t sending; // chunked puts still running on a worker
 };
 
 struct ZenohSubscriber {
@@ -19,27 +164,86 @@ struct ZenohSubscriber {
   void *context;
   bool is_liveliness;
   ZenohLivelinessCallback liveliness_callback;
+  ZenohSubscriberShmCallback shm_callback;
+  struct EntityStats *stats; // NULL when not tracked
+  struct EntityPool *pool;   // NULL unless declared in bulk
 };
 
 struct ZenohQueryable {
   z_owned_queryable_t queryable;
   ZenohQueryCallback callback;
   void *context;
+  struct EntityStats *stats;
 };
 
 struct ZenohLivelinessToken {
   z_owned_liveliness_token_t token;
 };
 
+struct ZenohQuery {
+  z_owned_query_t query;
+  atomic_count_t refs;
+};
+
+struct ZenohReplyChannel {
+  bool ring;
+  z_owned_fifo_handler_reply_t fifo;
+  z_owned_ring_handler_reply_t ring_handler;
+  bool closed; // Disconnected and drained
+  // Backing store of the records returned by the last receive
+  uint8_t *arena;
+  size_t arena_len;
+  size_t arena_cap;
+};
+
+struct ZenohQuerier {
+  z_owned_querier_t querier;
+  z_owned_matching_listener_t matching_listener;
+  bool has_matching_listener;
+};
+
+struct ZenohShmProvider {
+#if ZENOH_FFI_HAS_SHM
+  z_owned_shm_provider_t provider;
+#endif
+  size_t size;
+};
+
+struct ZenohShmBuffer {
+#if ZENOH_FFI_HAS_SHM
+  z_owned_shm_mut_t buf; // writable buffer allocated by zenoh_shm_alloc
+  z_owned_shm_t shm;     // read-only buffer received from the network
+  bool is_mut;
+#endif
+  uint8_t *data;
+  size_t len;
+};
+
 // ============================================================================
 // Get Context for async queries
 // ============================================================================
 
 struct GetContext {
   ZenohGetCallback callback;
+  ZenohGetCallbackEx callback_ex;
   ZenohGetCompleteCallback complete_callback;
   void *user_context;
   uint64_t timeout_ms;
+  // Paging, active when limit or after is set
+  bool paged;
+  z_owned_mutex_t page_mutex;
+  uint32_t limit;    // 0 = unlimited
+  char *after;       // Only keys sorting after this one are delivered
+  uint32_t delivered;
+  bool more;         // A reply was dropped by the limit
+  char *last_key;    // Greatest key delivered, the next page's cursor
+  ZenohGetPageCallback page_callback;
+  // With a page callback and a limit, replies are held back in a max-heap
+  // on key and delivered in key order once the query is done, so the page
+  // is the smallest keys after the cursor whatever order replies arrive in
+  struct ReplyCopy *page;
+  size_t page_count;
+  size_t page_cap;
 };
 
 // ============================================================================
@@ -90,6 +294,52 @@ convert_congestion_control(ZenohCongestionControl cc) {
   }
 }
 
+static z_query_consolidation_t
+convert_consolidation(ZenohConsolidationMode mode) {
+  switch (mode) {
+  case ZENOH_CONSOLIDATION_NONE:
+    return z_query_consolidation_none();
+  case ZENOH_CONSOLIDATION_MONOTONIC:
+    return z_query_consolidation_monotonic();
+  case ZENOH_CONSOLIDATION_LATEST:
+    return z_query_consolidation_latest();
+  default:
+    return z_query_consolidation_auto();
+  }
+}
+
+static z_query_target_t convert_query_target(ZenohQueryTarget target) {
+  switch (target) {
+  case ZENOH_QUERY_TARGET_ALL:
+    return Z_QUERY_TARGET_ALL;
+  case ZENOH_QUERY_TARGET_ALL_COMPLETE:
+    return Z_QUERY_TARGET_ALL_COMPLETE;
+  default:
+    return Z_QUERY_TARGET_BEST_MATCHING;
+  }
+}
+
+static zc_locality_t convert_locality(ZenohLocality locality) {
+  switch (locality) {
+  case ZENOH_LOCALITY_SESSION_LOCAL:
+    return ZC_LOCALITY_SESSION_LOCAL;
+  case ZENOH_LOCALITY_REMOTE:
+    return ZC_LOCALITY_REMOTE;
+  default:
+    return ZC_LOCALITY_ANY;
+  }
+}
+
+// FNV-1a, used wherever a key needs a stable hash
+static uint64_t key_hash(const char *key, size_t len) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)key[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
 // Helper function to get all bytes data from z_loaned_bytes_t into a contiguous buffer.
 // Uses the reader API to correctly handle fragmented (multi-slice) data.
 // Caller must free the returned buffer.
@@ -167,6 +417,28 @@ static const z_loaned_encoding_t *get_encoding(ZenohEncodingId encoding) {
   }
 }
 
+#if ZENOH_FFI_HAS_UNSTABLE
+#define ZID_STRING_SIZE 37
+
+// Writes a zid in UUID form into str (ZID_STRING_SIZE bytes)
+static void format_zid(const z_id_t *zid, char *str) {
+  snprintf(str, ZID_STRING_SIZE,
+           "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+           zid->id[0], zid->id[1], zid->id[2], zid->id[3], zid->id[4],
+           zid->id[5], zid->id[6], zid->id[7], zid->id[8], zid->id[9],
+           zid->id[10], zid->id[11], zid->id[12], zid->id[13], zid->id[14],
+           zid->id[15]);
+}
+
+// Heap copy of a zid in UUID form (Dart will free)
+static char *copy_zid_string(const z_id_t *zid) {
+  char *str = (char *)malloc(ZID_STRING_SIZE);
+  if (str != NULL)
+    format_zid(zid, str);
+  return str;
+}
+#endif
+
 // ============================================================================
 // Initialization
 // ============================================================================
@@ -220,6 +492,90 @@ FFI_PLUGIN_EXPORT void zenoh_get_options_default(ZenohGetOptions *options) {
   options->encoding = ZENOH_ENCODING_BYTES;
   options->attachment = NULL;
   options->attachment_len = 0;
+  options->limit = 0;
+  options->cursor = NULL;
+  options->consolidation = ZENOH_CONSOLIDATION_AUTO;
+  options->target = ZENOH_QUERY_TARGET_BEST_MATCHING;
+  options->allowed_destination = ZENOH_LOCALITY_ANY;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_querier_options_default(ZenohQuerierOptions *options) {
+  if (options == NULL)
+    return;
+  options->timeout_ms = 10000; // 10 seconds default
+  options->priority = ZENOH_PRIORITY_DATA;
+  options->congestion_control = ZENOH_CONGESTION_CONTROL_DROP;
+  options->is_express = false;
+  options->consolidation = ZENOH_CONSOLIDATION_AUTO;
+  options->target = ZENOH_QUERY_TARGET_BEST_MATCHING;
+  options->allowed_destination = ZENOH_LOCALITY_ANY;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_storage_options_default(ZenohStorageOptions *options) {
+  if (options == NULL)
+    return;
+  options->max_entries = 0; // Unlimited
+  options->complete = true;
+}
+
+FFI_PLUGIN_EXPORT void
+zenoh_log_store_options_default(ZenohLogStoreOptions *options) {
+  if (options == NULL)
+    return;
+  options->segment_size = 64 * 1024 * 1024;
+  options->compaction_ratio = 0.5;
+  options->compaction_interval_ms = 30000;
+  options->sync_writes = false;
+}
+
+FFI_PLUGIN_EXPORT void
+zenoh_timeseries_options_default(ZenohTimeSeriesOptions *options) {
+  if (options == NULL)
+    return;
+  options->capacity = 3600;
+  options->max_series = 0; // Unlimited
+  options->format = ZENOH_TIMESERIES_FORMAT_AUTO;
+  options->json_field = NULL;
+  options->extractor = NULL;
+  options->extractor_context = NULL;
+  options->complete = false;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_querying_subscriber_options_default(
+    ZenohQueryingSubscriberOptions *options) {
+  if (options == NULL)
+    return;
+  options->query_selector = NULL; // The subscriber's key expression
+  options->query_target = ZENOH_QUERY_TARGET_BEST_MATCHING;
+  options->query_consolidation = ZENOH_CONSOLIDATION_NONE;
+  options->query_timeout_ms = 10000;
+  options->allowed_origin = ZENOH_LOCALITY_ANY;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_rpc_client_options_default(
+    ZenohRpcClientOptions *options) {
+  if (options == NULL)
+    return;
+  options->attempt_timeout_ms = 1000;
+  options->priority = ZENOH_PRIORITY_INTERACTIVE_HIGH;
+  options->is_express = true;
+  options->target = ZENOH_QUERY_TARGET_BEST_MATCHING;
+  options->allowed_destination = ZENOH_LOCALITY_ANY;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_advanced_subscriber_options_default(
+    ZenohAdvancedSubscriberOptions *options) {
+  if (options == NULL)
+    return;
+  options->history = true;
+  options->detect_late_publishers = true;
+  options->history_max_samples = 0; // Unlimited
+  options->history_max_age_ms = 0;  // Unlimited
+  options->recovery = true;
+  options->recovery_period_ms = 0; // Rely on publisher heartbeats
+  options->query_timeout_ms = 0;   // zenoh default
+  options->subscriber_detection = false;
+  options->allowed_origin = ZENOH_LOCALITY_ANY;
 }
 
 // ============================================================================
@@ -327,6 +683,586 @@ FFI_PLUGIN_EXPORT ZenohEncodingId zenoh_encoding_from_string(const char *str) {
   return ZENOH_ENCODING_CUSTOM;
 }
 
+// ============================================================================
+// Runtime and Threads
+// ============================================================================
+
+#define THREAD_MAX_TRACKED 64
+#define THREAD_KINDS 2
+
+#if defined(_WIN32)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+enum { THREAD_SLOT_FREE, THREAD_SLOT_CLAIMED, THREAD_SLOT_LIVE };
+
+// A thread that delivered a callback or runs a library task. Slots are
+// claimed lock-free and a worker gives its slot back when it exits; a zenoh
+// thread's slot is freed once zenoh_thread_stats can no longer read its CPU
+// clock.
+struct ThreadRecord {
+  atomic_count_t state;
+  uint64_t id;
+  ZenohThreadKind kind;
+  stat_counter_t callbacks;
+  long policy_epoch; // Policy generation last applied, written by the owner
+  int policy_result;
+#if defined(__APPLE__)
+  mach_port_t port;
+#elif !defined(_WIN32)
+  clockid_t clock;
+#endif
+};
+
+static struct ThreadRecord thread_records[THREAD_MAX_TRACKED];
+static THREAD_LOCAL struct ThreadRecord *thread_current;
+static THREAD_LOCAL uint64_t thread_current_id; // rec->id when claimed
+static THREAD_LOCAL bool thread_untracked; // The table was full
+// Set on threads that call the put/get API. zenoh delivers local samples
+// and queries synchronously on them, and they are usually the embedder's
+// own threads, so delivery policies leave them alone.
+static THREAD_LOCAL bool thread_is_caller;
+
+// Policies are published under a sequence lock: odd while being written
+static ZenohThreadPolicy thread_policies[THREAD_KINDS];
+static bool thread_policy_active[THREAD_KINDS];
+static atomic_count_t thread_policy_epoch;
+
+static stat_counter_t thread_retired_cpu_us; // Workers that already exited
+static atomic_count_t runtime_started;
+
+static void runtime_mark_started(void) {
+  if (atomic_count_load(&runtime_started) == 0)
+    atomic_count_inc(&runtime_started);
+}
+
+static void thread_mark_caller(void) { thread_is_caller = true; }
+
+static uint64_t thread_self_id(void) {
+#if defined(_WIN32)
+  return GetCurrentThreadId();
+#elif defined(__APPLE__)
+  uint64_t tid = 0;
+  pthread_threadid_np(NULL, &tid);
+  return tid;
+#elif defined(__linux__)
+  return (uint64_t)syscall(SYS_gettid);
+#else
+  return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+// User plus system time of a tracked thread, false once it has exited
+static bool thread_cpu_time_us(struct ThreadRecord *rec, uint64_t *us) {
+#if defined(_WIN32)
+  HANDLE h = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, (DWORD)rec->id);
+  if (h == NULL)
+    return false;
+  FILETIME created, exited, kernel, user;
+  BOOL ok = GetThreadTimes(h, &created, &exited, &kernel, &user);
+  CloseHandle(h);
+  if (!ok)
+    return false;
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  *us = (k.QuadPart + u.QuadPart) / 10;
+  return true;
+#elif defined(__APPLE__)
+  thread_basic_info_data_t info;
+  mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+  if (thread_info(rec->port, THREAD_BASIC_INFO, (thread_info_t)&info,
+                  &count) != KERN_SUCCESS)
+    return false;
+  *us = (uint64_t)info.user_time.seconds * 1000000 +
+        info.user_time.microseconds +
+        (uint64_t)info.system_time.seconds * 1000000 +
+        info.system_time.microseconds;
+  return true;
+#else
+  struct timespec ts;
+  if (clock_gettime(rec->clock, &ts) != 0)
+    return false;
+  *us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+  return true;
+#endif
+}
+
+// Applies policy to the calling thread. Returns 0, or -1 when any part was
+// refused (e.g. a lower niceness without the privilege to raise priority).
+static int thread_apply_policy(const ZenohThreadPolicy *policy) {
+  int rc = 0;
+#if defined(_WIN32)
+  if (policy->cpu_mask != 0 &&
+      SetThreadAffinityMask(GetCurrentThread(),
+                            (DWORD_PTR)policy->cpu_mask) == 0)
+    rc = -1;
+  if (policy->set_nice) {
+    int priority = policy->nice >= 10   ? THREAD_PRIORITY_LOWEST
+                   : policy->nice > 0   ? THREAD_PRIORITY_BELOW_NORMAL
+                   : policy->nice == 0  ? THREAD_PRIORITY_NORMAL
+                   : policy->nice > -10 ? THREAD_PRIORITY_ABOVE_NORMAL
+                                        : THREAD_PRIORITY_HIGHEST;
+    if (!SetThreadPriority(GetCurrentThread(), priority))
+      rc = -1;
+  }
+#elif defined(__APPLE__)
+  // Darwin has no hard affinity or per-thread nice; map niceness to a QoS
+  // class instead
+  if (policy->cpu_mask != 0)
+    rc = -1;
+  if (policy->set_nice) {
+    qos_class_t qos = policy->nice >= 10  ? QOS_CLASS_BACKGROUND
+                      : policy->nice > 0  ? QOS_CLASS_UTILITY
+                      : policy->nice == 0 ? QOS_CLASS_DEFAULT
+                                          : QOS_CLASS_USER_INITIATED;
+    if (pthread_set_qos_class_self_np(qos, 0) != 0)
+      rc = -1;
+  }
+#elif defined(__linux__)
+  // Raw syscalls: Android's libc lacks the cpu_set_t helpers. On Linux both
+  // the affinity mask and the niceness belong to the thread, not the process.
+  if (policy->cpu_mask != 0) {
+    uint64_t mask = policy->cpu_mask;
+    if (syscall(SYS_sched_setaffinity, 0, sizeof(mask), &mask) != 0)
+      rc = -1;
+  }
+  if (policy->set_nice &&
+      setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), policy->nice) != 0)
+    rc = -1;
+#else
+  if (policy->cpu_mask != 0 || policy->set_nice)
+    rc = -1;
+#endif
+  return rc;
+}
+
+static void thread_refresh_policy(struct ThreadRecord *rec) {
+  ZenohThreadPolicy policy;
+  bool active;
+  long epoch;
+  do {
+    epoch = atomic_count_load(&thread_policy_epoch);
+    if (epoch & 1)
+      return; // Being written; retry on the next entry
+    policy = thread_policies[rec->kind];
+    active = thread_policy_active[rec->kind];
+  } while (atomic_count_load(&thread_policy_epoch) != epoch);
+
+  rec->policy_epoch = epoch;
+  if (!active || (rec->kind == ZENOH_THREAD_DELIVERY && thread_is_caller))
+    return;
+  rec->policy_result = thread_apply_policy(&policy);
+}
+
+static struct ThreadRecord *thread_claim(ZenohThreadKind kind) {
+  for (int i = 0; i < THREAD_MAX_TRACKED; i++) {
+    struct ThreadRecord *rec = &thread_records[i];
+    if (!atomic_count_cas(&rec->state, THREAD_SLOT_FREE, THREAD_SLOT_CLAIMED))
+      continue;
+    rec->id = thread_self_id();
+    rec->kind = kind;
+    rec->callbacks = 0;
+    rec->policy_epoch = -1;
+    rec->policy_result = 0;
+#if defined(__APPLE__)
+    rec->port = pthread_mach_thread_np(pthread_self());
+#elif !defined(_WIN32)
+    if (pthread_getcpuclockid(pthread_self(), &rec->clock) != 0) {
+      atomic_count_cas(&rec->state, THREAD_SLOT_CLAIMED, THREAD_SLOT_FREE);
+      return NULL;
+    }
+#endif
+    atomic_count_cas(&rec->state, THREAD_SLOT_CLAIMED, THREAD_SLOT_LIVE);
+    return rec;
+  }
+  return NULL;
+}
+
+// Registers the calling thread on first use and applies a changed policy.
+// Costs a few thread-local reads and atomic loads once registered.
+static struct ThreadRecord *thread_enter(ZenohThreadKind kind) {
+  struct ThreadRecord *rec = thread_current;
+  // A slot freed by a failed clock read may have gone to another thread
+  if (rec != NULL && (atomic_count_load(&rec->state) != THREAD_SLOT_LIVE ||
+                      rec->id != thread_current_id))
+    rec = NULL;
+  if (rec == NULL) {
+    if (thread_untracked)
+      return NULL;
+    rec = thread_claim(kind);
+    if (rec == NULL) {
+      thread_untracked = true;
+      return NULL;
+    }
+    thread_current = rec;
+    thread_current_id = rec->id;
+  }
+  if (atomic_count_load(&thread_policy_epoch) != rec->policy_epoch)
+    thread_refresh_policy(rec);
+  return rec;
+}
+
+// Called at the top of every zenoh callback into this library
+static void thread_enter_delivery(void) {
+  struct ThreadRecord *rec = thread_enter(ZENOH_THREAD_DELIVERY);
+  if (rec != NULL)
+    stat_add(&rec->callbacks, 1);
+}
+
+// Called by library threads before they exit
+static void thread_leave(void) {
+  struct ThreadRecord *rec = thread_current;
+  thread_current = NULL;
+  if (rec == NULL || rec->id != thread_current_id)
+    return;
+  uint64_t us;
+  if (thread_cpu_time_us(rec, &us))
+    stat_add(&thread_retired_cpu_us, us);
+  atomic_count_cas(&rec->state, THREAD_SLOT_LIVE, THREAD_SLOT_FREE);
+}
+
+struct WorkerStart {
+  void *(*fn)(void *);
+  void *arg;
+};
+
+static void *worker_main(void *arg) {
+  struct WorkerStart start = *(struct WorkerStart *)arg;
+  free(arg);
+  thread_enter(ZENOH_THREAD_WORKER);
+  void *result = start.fn(start.arg);
+  thread_leave();
+  return result;
+}
+
+// z_task_init for threads of this library: they apply the worker policy
+// and are accounted in zenoh_thread_stats
+static int worker_start(z_owned_task_t *task, void *(*fn)(void *), void *arg) {
+  struct WorkerStart *start =
+      (struct WorkerStart *)malloc(sizeof(struct WorkerStart));
+  if (start == NULL)
+    return -1;
+  start->fn = fn;
+  start->arg = arg;
+  z_task_attr_t attr = {0};
+  int rc = z_task_init(task, &attr, worker_main, start);
+  if (rc != 0)
+    free(start);
+  return rc;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_runtime_configure(const ZenohRuntimeConfig *config) {
+  if (config == NULL)
+    return -1;
+  if (atomic_count_load(&runtime_started) != 0)
+    return -2;
+
+  // ZENOH_RUNTIME is a RON map of pool name to pool parameters
+  const char *names[] = {"app", "acc", "tx", "rx"};
+  uint32_t workers[] = {config->app_workers, config->acc_workers,
+                        config->tx_workers, config->rx_workers};
+  char ron[512];
+  size_t len = 0;
+  ron[len++] = '(';
+  for (int i = 0; i < 4; i++) {
+    if (workers[i] == 0 && config->max_blocking_threads == 0)
+      continue;
+    len += snprintf(ron + len, sizeof(ron) - len, "%s%s: (", len > 1 ? ", " : "",
+                    names[i]);
+    if (workers[i] != 0)
+      len += snprintf(ron + len, sizeof(ron) - len, "worker_threads: %u",
+                      workers[i]);
+    if (config->max_blocking_threads != 0)
+      len += snprintf(ron + len, sizeof(ron) - len,
+                      "%smax_blocking_threads: %u", workers[i] != 0 ? ", " : "",
+                      config->max_blocking_threads);
+    ron[len++] = ')';
+  }
+  ron[len++] = ')';
+  ron[len] = '\0';
+
+#if defined(_WIN32)
+  return SetEnvironmentVariableA("ZENOH_RUNTIME", len > 2 ? ron : NULL) ? 0
+                                                                        : -1;
+#else
+  return (len > 2 ? setenv("ZENOH_RUNTIME", ron, 1)
+                  : unsetenv("ZENOH_RUNTIME")) == 0
+             ? 0
+             : -1;
+#endif
+}
+
+FFI_PLUGIN_EXPORT int zenoh_set_thread_policy(ZenohThreadKind kind,
+                                              const ZenohThreadPolicy *policy) {
+  if (kind < 0 || kind >= THREAD_KINDS)
+    return -1;
+
+  long epoch;
+  do {
+    epoch = atomic_count_load(&thread_policy_epoch);
+  } while ((epoch & 1) || !atomic_count_cas(&thread_policy_epoch, epoch,
+                                             epoch + 1));
+  thread_policy_active[kind] = policy != NULL;
+  if (policy != NULL)
+    thread_policies[kind] = *policy;
+  atomic_count_inc(&thread_policy_epoch);
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT size_t zenoh_thread_stats(ZenohThreadStats *stats,
+                                            size_t max) {
+  if (stats == NULL)
+    return 0;
+
+  size_t n = 0;
+  for (int i = 0; i < THREAD_MAX_TRACKED && n < max; i++) {
+    struct ThreadRecord *rec = &thread_records[i];
+    if (atomic_count_load(&rec->state) != THREAD_SLOT_LIVE)
+      continue;
+    uint64_t us;
+    if (!thread_cpu_time_us(rec, &us)) {
+      // Exited without telling us, e.g. a blocking-pool thread: give the
+      // slot to the next thread
+      atomic_count_cas(&rec->state, THREAD_SLOT_LIVE, THREAD_SLOT_FREE);
+      continue;
+    }
+    stats[n].thread_id = rec->id;
+    stats[n].kind = rec->kind;
+    stats[n].cpu_time_us = us;
+    stats[n].callbacks = stat_load(&rec->callbacks);
+    stats[n].policy_result = rec->policy_result;
+    n++;
+  }
+  if (n < max) {
+    memset(&stats[n], 0, sizeof(stats[n]));
+    stats[n].kind = ZENOH_THREAD_WORKER;
+    stats[n].cpu_time_us = stat_load(&thread_retired_cpu_us);
+    n++;
+  }
+  return n;
+}
+
+// ============================================================================
+// Runtime Statistics
+// ============================================================================
+
+static struct EntityStats *stats_alloc(void) {
+  size_t size = (sizeof(struct EntityStats) + STATS_CACHE_LINE - 1) /
+                STATS_CACHE_LINE * STATS_CACHE_LINE;
+  void *p;
+#if defined(_WIN32)
+  p = _aligned_malloc(size, STATS_CACHE_LINE);
+#else
+  if (posix_memalign(&p, STATS_CACHE_LINE, size) != 0)
+    p = NULL;
+#endif
+  if (p != NULL)
+    memset(p, 0, size);
+  return (struct EntityStats *)p;
+}
+
+static void stats_free(struct EntityStats *stats) {
+#if defined(_WIN32)
+  _aligned_free(stats);
+#else
+  free(stats);
+#endif
+}
+
+static void stats_accumulate(ZenohSessionStats *out, struct EntityStats *s) {
+  out->puts += stat_load(&s->puts);
+  out->bytes_out += stat_load(&s->bytes_out);
+  out->put_errors += stat_load(&s->put_errors);
+  out->samples_in += stat_load(&s->samples_in);
+  out->bytes_in += stat_load(&s->bytes_in);
+  out->dropped_samples += stat_load(&s->dropped_samples);
+  out->queries_served += stat_load(&s->queries_served);
+  for (int i = 0; i < ZENOH_STATS_COPY_BUCKETS; i++)
+    out->sample_copy_us[i] += stat_load(&s->sample_copy[i]);
+}
+
+// Must be called with the session's stats_mutex held
+static void stats_fold(struct EntityStats *dst, struct EntityStats *src) {
+  ZenohSessionStats sum;
+  memset(&sum, 0, sizeof(sum));
+  stats_accumulate(&sum, src);
+  stat_add(&dst->puts, sum.puts);
+  stat_add(&dst->bytes_out, sum.bytes_out);
+  stat_add(&dst->put_errors, sum.put_errors);
+  stat_add(&dst->samples_in, sum.samples_in);
+  stat_add(&dst->bytes_in, sum.bytes_in);
+  stat_add(&dst->dropped_samples, sum.dropped_samples);
+  stat_add(&dst->queries_served, sum.queries_served);
+  for (int i = 0; i < ZENOH_STATS_COPY_BUCKETS; i++)
+    stat_add(&dst->sample_copy[i], sum.sample_copy_us[i]);
+}
+
+// Returns NULL when out of memory; the entity then simply goes uncounted
+static struct EntityStats *entity_stats_register(ZenohSession *session,
+                                                 enum StatsKind kind) {
+  struct EntityStats *stats = stats_alloc();
+  if (stats == NULL)
+    return NULL;
+  stats->kind = kind;
+  stats->owner = session;
+  atomic_count_inc(&session->refs);
+
+  z_mutex_lock(z_loan_mut(session->stats_mutex));
+  stats->next = session->entities;
+  if (session->entities != NULL)
+    session->entities->prev = stats;
+  session->entities = stats;
+  z_mutex_unlock(z_loan_mut(session->stats_mutex));
+  return stats;
+}
+
+static void session_release(ZenohSession *session);
+
+// Keeps the entity's counts in the session totals after it is undeclared
+static void entity_stats_release(struct EntityStats *stats) {
+  if (stats == NULL)
+    return;
+
+  ZenohSession *session = stats->owner;
+  z_mutex_lock(z_loan_mut(session->stats_mutex));
+  stats_fold(session->stats, stats);
+  if (stats->prev != NULL)
+    stats->prev->next = stats->next;
+  else
+    session->entities = stats->next;
+  if (stats->next != NULL)
+    stats->next->prev = stats->prev;
+  z_mutex_unlock(z_loan_mut(session->stats_mutex));
+  stats_free(stats);
+  session_release(session);
+}
+
+static void stats_record_put(struct EntityStats *stats, size_t len, int rc) {
+  if (stats == NULL)
+    return;
+  if (rc < 0) {
+    stat_add(&stats->put_errors, 1);
+  } else {
+    stat_add(&stats->puts, 1);
+    stat_add(&stats->bytes_out, len);
+  }
+}
+
+// Counts a sample that never reached the delivery path
+static void stats_record_drop(struct EntityStats *stats,
+                              const z_loaned_sample_t *sample) {
+  if (stats == NULL)
+    return;
+  stat_add(&stats->samples_in, 1);
+  stat_add(&stats->bytes_in, z_bytes_len(z_sample_payload(sample)));
+  stat_add(&stats->dropped_samples, 1);
+}
+
+// Bucket i counts samples copied for Dart in less than 2^i us, the last one
+// the rest
+static void stats_record_sample(struct EntityStats *stats,
+                                const z_loaned_sample_t *sample, bool delivered,
+                                const z_clock_t *start) {
+  if (stats == NULL)
+    return;
+  stat_add(&stats->samples_in, 1);
+  stat_add(&stats->bytes_in, z_bytes_len(z_sample_payload(sample)));
+  if (!delivered)
+    stat_add(&stats->dropped_samples, 1);
+
+  uint64_t us = z_clock_elapsed_us(start);
+  int bucket = 0;
+  while (bucket < ZENOH_STATS_COPY_BUCKETS - 1 && us >= (1ULL << bucket))
+    bucket++;
+  stat_add(&stats->sample_copy[bucket], 1);
+}
+
+// Takes ownership of s, dropping it on failure
+static ZenohSession *session_new(z_owned_session_t *s) {
+  ZenohSession *session = (ZenohSession *)calloc(1, sizeof(ZenohSession));
+  if (session != NULL)
+    session->stats = stats_alloc();
+  if (session == NULL || session->stats == NULL ||
+      z_mutex_init(&session->stats_mutex) < 0) {
+    if (session != NULL)
+      stats_free(session->stats);
+    free(session);
+    z_drop(z_move(*s));
+    return NULL;
+  }
+  session->stats->kind = STATS_SESSION;
+  session->session = *s;
+  session->refs = 1;
+  runtime_mark_started();
+  return session;
+}
+
+// Drops a reference once the zenoh session has been closed. Entities
+// undeclared after the close still fold into the session totals, so the
+// last of them frees the session.
+static void session_release(ZenohSession *session) {
+  if (atomic_count_dec(&session->refs) != 0)
+    return;
+  z_drop(z_move(session->session));
+  z_drop(z_move(session->stats_mutex));
+  stats_free(session->stats);
+  free(session);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_session_stats_snapshot(ZenohSession *session,
+                                                   ZenohSessionStats *stats) {
+  if (session == NULL || stats == NULL)
+    return -1;
+
+  memset(stats, 0, sizeof(*stats));
+  z_mutex_lock(z_loan_mut(session->stats_mutex));
+  stats_accumulate(stats, session->stats);
+  for (struct EntityStats *e = session->entities; e != NULL; e = e->next) {
+    stats_accumulate(stats, e);
+    if (e->kind == STATS_PUBLISHER)
+      stats->publishers++;
+    else if (e->kind == STATS_SUBSCRIBER)
+      stats->subscribers++;
+    else if (e->kind == STATS_QUERYABLE)
+      stats->queryables++;
+  }
+  z_mutex_unlock(z_loan_mut(session->stats_mutex));
+  return 0;
+}
+
+static int entity_stats_snapshot(struct EntityStats *entity,
+                                 ZenohSessionStats *stats) {
+  if (entity == NULL || stats == NULL)
+    return -1;
+  memset(stats, 0, sizeof(*stats));
+  stats_accumulate(stats, entity);
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_publisher_stats_snapshot(ZenohPublisher *publisher,
+                                                     ZenohSessionStats *stats) {
+  return entity_stats_snapshot(publisher != NULL ? publisher->stats : NULL,
+                               stats);
+}
+
+FFI_PLUGIN_EXPORT int
+zenoh_subscriber_stats_snapshot(ZenohSubscriber *subscriber,
+                                ZenohSessionStats *stats) {
+  return entity_stats_snapshot(subscriber != NULL ? subscriber->stats : NULL,
+                               stats);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_queryable_stats_snapshot(ZenohQueryable *queryable,
+                                                     ZenohSessionStats *stats) {
+  return entity_stats_snapshot(queryable != NULL ? queryable->stats : NULL,
+                               stats);
+}
+
 // ============================================================================
 // Session Management
 // ============================================================================
@@ -370,13 +1306,7 @@ FFI_PLUGIN_EXPORT ZenohSession *zenoh_open_session(const char *mode,
     return NULL;
   }
 
-  ZenohSession *session = (ZenohSession *)malloc(sizeof(ZenohSession));
-  if (session == NULL) {
-    z_drop(z_move(s));
-    return NULL;
-  }
-  session->session = s;
-  return session;
+  return session_new(&s);
 }
 
 FFI_PLUGIN_EXPORT ZenohSession *
@@ -394,19 +1324,13 @@ zenoh_open_session_with_config(const char *config_json) {
     return NULL;
   }
 
-  ZenohSession *session = (ZenohSession *)malloc(sizeof(ZenohSession));
-  if (session == NULL) {
-    z_drop(z_move(s));
-    return NULL;
-  }
-  session->session = s;
-  return session;
+  return session_new(&s);
 }
 
 FFI_PLUGIN_EXPORT void zenoh_close_session(ZenohSession *session) {
   if (session != NULL) {
-    z_drop(z_move(session->session));
-    free(session);
+    z_close(z_loan_mut(session->session), NULL);
+    session_release(session);
   }
 }
 
@@ -430,46 +1354,696 @@ FFI_PLUGIN_EXPORT const char *zenoh_session_info(ZenohSession *session) {
 }
 
 // ============================================================================
-// Publisher
+// Transport Tuning
 // ============================================================================
 
-FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_declare_publisher(ZenohSession *session,
-                                                          const char *key) {
-  if (session == NULL || key == NULL)
-    return NULL;
+struct ConfigWriter {
+  z_owned_config_t config;
+  char *applied; // JSON object of the keys written so far
+  size_t len;
+  size_t cap;
+  bool ok;
+  const char *rejected; // Key zenoh refused, if any
+};
 
-  z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, key) < 0) {
-    return NULL;
+static bool config_applied_append(struct ConfigWriter *w, const char *s,
+                                  size_t n) {
+  if (w->len + n + 2 > w->cap) {
+    size_t cap = (w->len + n + 2) * 2;
+    char *applied = (char *)realloc(w->applied, cap);
+    if (applied == NULL)
+      return false;
+    w->applied = applied;
+    w->cap = cap;
   }
+  memcpy(w->applied + w->len, s, n);
+  w->len += n;
+  w->applied[w->len] = '\0';
+  return true;
+}
 
-  z_publisher_options_t options;
-  z_publisher_options_default(&options);
+// Inserts one key and records the value zenoh reads back for it
+static void config_write(struct ConfigWriter *w, const char *key,
+                         const char *value) {
+  if (!w->ok)
+    return;
+  if (zc_config_insert_json5(z_loan_mut(w->config), key, value) < 0) {
+    w->rejected = key;
+    w->ok = false;
+    return;
+  }
+
+  z_owned_string_t stored;
+  if (zc_config_get_from_str(z_loan(w->config), key, &stored) < 0)
+    return;
+  w->ok = config_applied_append(w, w->len > 1 ? ",\"" : "\"",
+                                w->len > 1 ? 2 : 1) &&
+          config_applied_append(w, key, strlen(key)) &&
+          config_applied_append(w, "\":", 2) &&
+          config_applied_append(w, z_string_data(z_loan(stored)),
+                                z_string_len(z_loan(stored)));
+  z_drop(z_move(stored));
+}
+
+static void config_write_bool(struct ConfigWriter *w, const char *key,
+                              int value) {
+  if (value >= 0)
+    config_write(w, key, value ? "true" : "false");
+}
+
+static void config_write_u64(struct ConfigWriter *w, const char *key,
+                             uint64_t value) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value);
+  config_write(w, key, buf);
+}
+
+// Profile values, overridden field by field by the caller's tuning
+static void transport_profile_values(ZenohTransportProfile profile,
+                                     ZenohTransportTuning *t) {
+  zenoh_transport_tuning_default(t);
+  switch (profile) {
+  case ZENOH_TRANSPORT_PROFILE_LOW_LATENCY:
+    // Low-latency transport requires QoS off; send every message at once
+    t->lowlatency = 1;
+    t->qos = 0;
+    t->batching = 0;
+    t->compression = 0;
+    break;
+  case ZENOH_TRANSPORT_PROFILE_HIGH_THROUGHPUT:
+    // Large batches and deep queues, sent at most every millisecond
+    t->lowlatency = 0;
+    t->qos = 1;
+    t->batching = 1;
+    t->batching_time_limit_ms = 1;
+    t->batch_size = 65535;
+    t->queue_size = 8;
+    t->compression = 0;
+#if ZENOH_FFI_HAS_SHM
+    t->shared_memory = 1;
+#endif
+    break;
+  case ZENOH_TRANSPORT_PROFILE_CONSTRAINED_DEVICE:
+    // Small buffers and single-batch queues; trade CPU for bandwidth
+    t->lowlatency = 0;
+    t->qos = 0;
+    t->batching = 1;
+    t->batch_size = 8192;
+    t->rx_buffer_size = 8192;
+    t->queue_size = 1;
+    t->compression = 1;
+#if ZENOH_FFI_HAS_SHM
+    t->shared_memory = 0;
+#endif
+    break;
+  default:
+    break;
+  }
+}
+
+FFI_PLUGIN_EXPORT void
+zenoh_transport_tuning_default(ZenohTransportTuning *tuning) {
+  if (tuning == NULL)
+    return;
+  tuning->profile = ZENOH_TRANSPORT_PROFILE_DEFAULT;
+  tuning->lowlatency = -1;
+  tuning->qos = -1;
+  tuning->compression = -1;
+  tuning->shared_memory = -1;
+  tuning->batching = -1;
+  tuning->batching_time_limit_ms = -1;
+  tuning->batch_size = 0;
+  tuning->rx_buffer_size = 0;
+  tuning->queue_size = 0;
+  tuning->wait_before_drop_us = 0;
+}
+
+// Hands the refused key to the caller through applied
+static void config_reject(char **applied, const char *key) {
+  if (applied == NULL)
+    return;
+  *applied = (char *)malloc(strlen(key) + 1);
+  if (*applied != NULL)
+    strcpy(*applied, key);
+}
 
-  z_owned_publisher_t pub;
-  if (z_declare_publisher(z_loan(session->session), &pub, z_loan(keyexpr),
-                          &options) < 0) {
+FFI_PLUGIN_EXPORT char *zenoh_config_tune(const char *config_json,
+                                          const ZenohTransportTuning *tuning,
+                                          char **applied) {
+  if (applied != NULL)
+    *applied = NULL;
+  if (tuning == NULL)
+    return NULL;
+
+  ZenohTransportTuning t;
+  transport_profile_values(tuning->profile, &t);
+  if (tuning->lowlatency >= 0)
+    t.lowlatency = tuning->lowlatency;
+  if (tuning->qos >= 0)
+    t.qos = tuning->qos;
+  if (tuning->compression >= 0)
+    t.compression = tuning->compression;
+  if (tuning->shared_memory >= 0)
+    t.shared_memory = tuning->shared_memory;
+  if (tuning->batching >= 0)
+    t.batching = tuning->batching;
+  if (tuning->batching_time_limit_ms >= 0)
+    t.batching_time_limit_ms = tuning->batching_time_limit_ms;
+  if (tuning->batch_size > 0)
+    t.batch_size = tuning->batch_size;
+  if (tuning->rx_buffer_size > 0)
+    t.rx_buffer_size = tuning->rx_buffer_size;
+  if (tuning->queue_size > 0)
+    t.queue_size = tuning->queue_size;
+  if (tuning->wait_before_drop_us > 0)
+    t.wait_before_drop_us = tuning->wait_before_drop_us;
+
+  // Batches are framed with a 16-bit length; the receive buffer is not
+  if (t.batch_size > 65535) {
+    config_reject(applied, "transport/link/tx/batch_size");
+    return NULL;
+  }
+  if (t.queue_size > 16) {
+    config_reject(applied, "transport/link/tx/queue/size");
     return NULL;
   }
 
-  ZenohPublisher *publisher = (ZenohPublisher *)malloc(sizeof(ZenohPublisher));
-  if (publisher == NULL) {
-    z_drop(z_move(pub));
+  struct ConfigWriter w;
+  memset(&w, 0, sizeof(w));
+  if (config_json != NULL ? zc_config_from_str(&w.config, config_json) < 0
+                          : z_config_default(&w.config) < 0)
     return NULL;
+  w.ok = config_applied_append(&w, "{", 1);
+
+  // Zenoh refuses low latency and QoS together, so switch one off before
+  // the other is switched on
+  if (t.lowlatency == 1) {
+    config_write_bool(&w, "transport/unicast/qos/enabled", t.qos);
+    config_write_bool(&w, "transport/unicast/lowlatency", t.lowlatency);
+  } else {
+    config_write_bool(&w, "transport/unicast/lowlatency", t.lowlatency);
+    config_write_bool(&w, "transport/unicast/qos/enabled", t.qos);
   }
-  publisher->publisher = pub;
-  return publisher;
+  config_write_bool(&w, "transport/unicast/compression/enabled",
+                    t.compression);
+  config_write_bool(&w, "transport/shared_memory/enabled", t.shared_memory);
+  config_write_bool(&w, "transport/link/tx/queue/batching/enabled",
+                    t.batching);
+  if (t.batching_time_limit_ms >= 0)
+    config_write_u64(&w, "transport/link/tx/queue/batching/time_limit",
+                     (uint64_t)t.batching_time_limit_ms);
+  if (t.batch_size > 0)
+    config_write_u64(&w, "transport/link/tx/batch_size", t.batch_size);
+  if (t.rx_buffer_size > 0)
+    config_write_u64(&w, "transport/link/rx/buffer_size", t.rx_buffer_size);
+  if (t.queue_size > 0) {
+    char sizes[192];
+    snprintf(sizes, sizeof(sizes),
+             "{\"control\":%u,\"real_time\":%u,\"interactive_high\":%u,"
+             "\"interactive_low\":%u,\"data_high\":%u,\"data\":%u,"
+             "\"data_low\":%u,\"background\":%u}",
+             t.queue_size, t.queue_size, t.queue_size, t.queue_size,
+             t.queue_size, t.queue_size, t.queue_size, t.queue_size);
+    config_write(&w, "transport/link/tx/queue/size", sizes);
+  }
+  if (t.wait_before_drop_us > 0)
+    config_write_u64(
+        &w, "transport/link/tx/queue/congestion_control/drop/wait_before_drop",
+        t.wait_before_drop_us);
+
+  char *result = NULL;
+  z_owned_string_t out;
+  if (w.ok && config_applied_append(&w, "}", 1) &&
+      zc_config_to_string(z_loan(w.config), &out) == 0) {
+    size_t len = z_string_len(z_loan(out));
+    result = (char *)malloc(len + 1);
+    if (result != NULL) {
+      memcpy(result, z_string_data(z_loan(out)), len);
+      result[len] = '\0';
+    }
+    z_drop(z_move(out));
+  }
+  z_drop(z_move(w.config));
+
+  if (result != NULL && applied != NULL) {
+    *applied = w.applied;
+    w.applied = NULL;
+  } else if (w.rejected != NULL) {
+    config_reject(applied, w.rejected);
+  }
+  free(w.applied);
+  return result;
 }
 
-FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_declare_publisher_with_options(
-    ZenohSession *session, const char *key, ZenohPublisherOptions *opts) {
-  if (session == NULL || key == NULL)
+// ============================================================================
+// Asynchronous Session Open/Close
+// ============================================================================
+
+// Owns the config until the worker thread hands it to z_open
+struct SessionOpenTask {
+  z_owned_config_t config;
+  z_clock_t start;
+  ZenohSessionOpenCallback callback;
+  void *context;
+};
+
+struct SessionCloseTask {
+  ZenohSession *session;
+#if ZENOH_FFI_HAS_UNSTABLE
+  zc_owned_concurrent_close_handle_t handle;
+#endif
+  z_clock_t start;
+  ZenohSessionCloseCallback callback;
+  void *context;
+};
+
+static void *session_open_task(void *arg) {
+  struct SessionOpenTask *task = (struct SessionOpenTask *)arg;
+
+  ZenohSession *session = NULL;
+  z_owned_session_t s;
+  int rc = z_open(&s, z_move(task->config), NULL);
+  if (rc == 0) {
+    session = session_new(&s);
+    if (session == NULL)
+      rc = -1;
+  }
+
+  if (task->callback != NULL)
+    task->callback(session, rc, z_clock_elapsed_us(&task->start),
+                   task->context);
+  free(task);
+  return NULL;
+}
+
+static void *session_close_task(void *arg) {
+  struct SessionCloseTask *task = (struct SessionCloseTask *)arg;
+
+#if ZENOH_FFI_HAS_UNSTABLE
+  // z_close already started the shutdown; wait for it to finish
+  int rc = zc_concurrent_close_handle_wait(
+      (zc_moved_concurrent_close_handle_t *)&task->handle);
+#else
+  int rc = z_close(z_loan_mut(task->session->session), NULL);
+#endif
+  session_release(task->session);
+
+  if (task->callback != NULL)
+    task->callback(rc, z_clock_elapsed_us(&task->start), task->context);
+  free(task);
+  return NULL;
+}
+
+FFI_PLUGIN_EXPORT int
+zenoh_open_session_async(const char *config_json,
+                         ZenohSessionOpenCallback callback, void *context) {
+  struct SessionOpenTask *task =
+      (struct SessionOpenTask *)malloc(sizeof(struct SessionOpenTask));
+  if (task == NULL)
+    return -1;
+
+  if (config_json != NULL ? zc_config_from_str(&task->config, config_json) < 0
+                          : z_config_default(&task->config) < 0) {
+    free(task);
+    return -1;
+  }
+  task->start = z_clock_now();
+  task->callback = callback;
+  task->context = context;
+
+  z_owned_task_t thread;
+  if (worker_start(&thread, session_open_task, task) != 0) {
+    z_drop(z_move(task->config));
+    free(task);
+    return -1;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT int
+zenoh_close_session_async(ZenohSession *session,
+                          ZenohSessionCloseCallback callback, void *context) {
+  if (session == NULL)
+    return -1;
+
+  struct SessionCloseTask *task =
+      (struct SessionCloseTask *)malloc(sizeof(struct SessionCloseTask));
+  if (task == NULL)
+    return -1;
+  task->session = session;
+  task->start = z_clock_now();
+  task->callback = callback;
+  task->context = context;
+
+#if ZENOH_FFI_HAS_UNSTABLE
+  z_close_options_t options;
+  z_close_options_default(&options);
+  options.internal_out_concurrent = &task->handle;
+  if (z_close(z_loan_mut(session->session), &options) < 0) {
+    free(task);
+    return -1;
+  }
+#endif
+
+  z_owned_task_t thread;
+  if (worker_start(&thread, session_close_task, task) != 0) {
+    // No worker available: finish the close on this thread
+    session_close_task(task);
+    return 0;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
+
+// ============================================================================
+// Session Groups
+// ============================================================================
+
+struct SessionGroupMember {
+  ZenohSession *session;
+};
+
+struct ZenohSessionGroup {
+  size_t count;
+  struct SessionGroupMember members[];
+};
+
+struct SessionGroupOpenTask {
+  size_t count;
+  char *config_json; // NULL for the default config
+  z_clock_t start;
+  ZenohSessionGroupOpenCallback callback;
+  void *context;
+};
+
+struct SessionGroupCloseTask {
+  ZenohSessionGroup *group;
+  z_clock_t start;
+  ZenohSessionCloseCallback callback;
+  void *context;
+};
+
+struct SessionGroupOpen {
+  z_owned_config_t config;
+  z_owned_session_t session;
+  z_owned_task_t task;
+  bool started;
+  int result;
+};
+
+static void *session_group_open_task(void *arg) {
+  struct SessionGroupOpen *open = (struct SessionGroupOpen *)arg;
+  open->result = z_open(&open->session, z_move(open->config), NULL);
+  return NULL;
+}
+
+static void *session_group_close_task(void *arg) {
+  zenoh_close_session((ZenohSession *)arg);
+  return NULL;
+}
+
+static size_t session_group_pick(ZenohSessionGroup *group, const char *key,
+                                 int affinity) {
+  if (affinity >= 0)
+    return (size_t)affinity % group->count;
+  return (size_t)(key_hash(key, strlen(key)) % group->count);
+}
+
+FFI_PLUGIN_EXPORT ZenohSessionGroup *
+zenoh_session_group_open(size_t count, const char *config_json) {
+  if (count == 0)
     return NULL;
 
-  z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, key) < 0) {
+  z_owned_config_t config;
+  if (config_json != NULL ? zc_config_from_str(&config, config_json) < 0
+                          : z_config_default(&config) < 0)
+    return NULL;
+
+  ZenohSessionGroup *group = (ZenohSessionGroup *)calloc(
+      1, sizeof(ZenohSessionGroup) + count * sizeof(struct SessionGroupMember));
+  struct SessionGroupOpen *opens =
+      (struct SessionGroupOpen *)calloc(count, sizeof(struct SessionGroupOpen));
+  if (group == NULL || opens == NULL) {
+    z_drop(z_move(config));
+    free(group);
+    free(opens);
+    return NULL;
+  }
+  group->count = count;
+
+  // Open the sessions concurrently, each from its own copy of the config
+  for (size_t i = 0; i < count; i++) {
+    z_config_clone(&opens[i].config, z_loan(config));
+    opens[i].result = -1;
+    opens[i].started = worker_start(&opens[i].task, session_group_open_task,
+                                    &opens[i]) == 0;
+    if (!opens[i].started)
+      session_group_open_task(&opens[i]);
+  }
+  z_drop(z_move(config));
+
+  bool ok = true;
+  for (size_t i = 0; i < count; i++) {
+    if (opens[i].started)
+      z_task_join(z_move(opens[i].task));
+    if (opens[i].result < 0) {
+      ok = false;
+      continue;
+    }
+    group->members[i].session = session_new(&opens[i].session);
+    if (group->members[i].session == NULL)
+      ok = false;
+  }
+  free(opens);
+
+  if (!ok) {
+    for (size_t i = 0; i < count; i++)
+      zenoh_close_session(group->members[i].session);
+    free(group);
+    return NULL;
+  }
+  return group;
+}
+
+FFI_PLUGIN_EXPORT size_t zenoh_session_group_size(ZenohSessionGroup *group) {
+  return group != NULL ? group->count : 0;
+}
+
+FFI_PLUGIN_EXPORT ZenohSession *
+zenoh_session_group_session(ZenohSessionGroup *group, size_t index) {
+  if (group == NULL || index >= group->count)
+    return NULL;
+  return group->members[index].session;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_session_group_route(ZenohSessionGroup *group,
+                                                const char *key) {
+  if (group == NULL || key == NULL)
+    return -1;
+  return (int)session_group_pick(group, key, -1);
+}
+
+FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_session_group_declare_publisher(
+    ZenohSessionGroup *group, const char *key, int affinity,
+    ZenohPublisherOptions *opts) {
+  if (group == NULL || key == NULL)
+    return NULL;
+
+  struct SessionGroupMember *member =
+      &group->members[session_group_pick(group, key, affinity)];
+  return opts != NULL
+             ? zenoh_declare_publisher_with_options(member->session, key, opts)
+             : zenoh_declare_publisher(member->session, key);
+}
+
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_session_group_declare_subscriber(
+    ZenohSessionGroup *group, const char *key, int affinity,
+    ZenohSubscriberCallback callback, void *context) {
+  if (group == NULL || key == NULL)
+    return NULL;
+
+  struct SessionGroupMember *member =
+      &group->members[session_group_pick(group, key, affinity)];
+  return zenoh_declare_subscriber(member->session, key, callback, context);
+}
+
+FFI_PLUGIN_EXPORT size_t zenoh_session_group_stats(
+    ZenohSessionGroup *group, ZenohSessionGroupStats *stats, size_t max) {
+  if (group == NULL || stats == NULL)
+    return 0;
+
+  size_t n = group->count < max ? group->count : max;
+  for (size_t i = 0; i < n; i++) {
+    ZenohSessionStats member;
+    memset(&stats[i], 0, sizeof(stats[i]));
+    if (zenoh_session_stats_snapshot(group->members[i].session, &member) < 0)
+      continue;
+    stats[i].publishers = member.publishers;
+    stats[i].subscribers = member.subscribers;
+  }
+  return n;
+}
+
+FFI_PLUGIN_EXPORT int
+zenoh_session_group_stats_snapshot(ZenohSessionGroup *group,
+                                   ZenohSessionStats *stats) {
+  if (group == NULL || stats == NULL)
+    return -1;
+
+  memset(stats, 0, sizeof(*stats));
+  for (size_t i = 0; i < group->count; i++) {
+    ZenohSessionStats member;
+    if (zenoh_session_stats_snapshot(group->members[i].session, &member) < 0)
+      return -1;
+    stats->puts += member.puts;
+    stats->bytes_out += member.bytes_out;
+    stats->put_errors += member.put_errors;
+    stats->samples_in += member.samples_in;
+    stats->bytes_in += member.bytes_in;
+    stats->dropped_samples += member.dropped_samples;
+    stats->queries_served += member.queries_served;
+    for (int b = 0; b < ZENOH_STATS_COPY_BUCKETS; b++)
+      stats->sample_copy_us[b] += member.sample_copy_us[b];
+    stats->publishers += member.publishers;
+    stats->subscribers += member.subscribers;
+    stats->queryables += member.queryables;
+  }
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_session_group_close(ZenohSessionGroup *group) {
+  if (group == NULL)
+    return;
+
+  // Close the sessions in parallel and return once all are gone
+  z_owned_task_t *tasks =
+      (z_owned_task_t *)malloc(group->count * sizeof(z_owned_task_t));
+  for (size_t i = 0; i < group->count; i++) {
+    if (tasks == NULL || worker_start(&tasks[i], session_group_close_task,
+                                      group->members[i].session) != 0) {
+      zenoh_close_session(group->members[i].session);
+      group->members[i].session = NULL;
+    }
+  }
+  for (size_t i = 0; i < group->count; i++) {
+    if (group->members[i].session != NULL)
+      z_task_join(z_move(tasks[i]));
+  }
+  free(tasks);
+  free(group);
+}
+
+static void *session_group_open_async_task(void *arg) {
+  struct SessionGroupOpenTask *task = (struct SessionGroupOpenTask *)arg;
+  ZenohSessionGroup *group =
+      zenoh_session_group_open(task->count, task->config_json);
+  task->callback(group, group != NULL ? 0 : -1,
+                 z_clock_elapsed_us(&task->start), task->context);
+  free(task->config_json);
+  free(task);
+  return NULL;
+}
+
+FFI_PLUGIN_EXPORT int
+zenoh_session_group_open_async(size_t count, const char *config_json,
+                               ZenohSessionGroupOpenCallback callback,
+                               void *context) {
+  if (count == 0 || callback == NULL)
+    return -1;
+
+  struct SessionGroupOpenTask *task =
+      (struct SessionGroupOpenTask *)calloc(1, sizeof(*task));
+  if (task == NULL)
+    return -1;
+  if (config_json != NULL) {
+    task->config_json = (char *)malloc(strlen(config_json) + 1);
+    if (task->config_json == NULL) {
+      free(task);
+      return -1;
+    }
+    strcpy(task->config_json, config_json);
+  }
+  task->count = count;
+  task->start = z_clock_now();
+  task->callback = callback;
+  task->context = context;
+
+  z_owned_task_t thread;
+  if (worker_start(&thread, session_group_open_async_task, task) != 0) {
+    free(task->config_json);
+    free(task);
+    return -1;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
+
+static void *session_group_close_async_task(void *arg) {
+  struct SessionGroupCloseTask *task = (struct SessionGroupCloseTask *)arg;
+  zenoh_session_group_close(task->group);
+  if (task->callback != NULL)
+    task->callback(0, z_clock_elapsed_us(&task->start), task->context);
+  free(task);
+  return NULL;
+}
+
+FFI_PLUGIN_EXPORT int
+zenoh_session_group_close_async(ZenohSessionGroup *group,
+                                ZenohSessionCloseCallback callback,
+                                void *context) {
+  if (group == NULL)
+    return -1;
+
+  struct SessionGroupCloseTask *task =
+      (struct SessionGroupCloseTask *)malloc(sizeof(*task));
+  if (task == NULL)
+    return -1;
+  task->group = group;
+  task->start = z_clock_now();
+  task->callback = callback;
+  task->context = context;
+
+  z_owned_task_t thread;
+  if (worker_start(&thread, session_group_close_async_task, task) != 0) {
+    free(task);
+    return -1;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
+
+// ============================================================================
+// Publisher
+// ============================================================================
+
+static void entity_pool_release(struct EntityPool *pool) {
+  if (atomic_count_dec(&pool->refs) == 0) {
+    free(pool->entities);
+    free(pool);
+  }
+}
+
+// Allocates count zeroed entities of size bytes in one block
+static struct EntityPool *entity_pool_new(size_t count, size_t size) {
+  struct EntityPool *pool = (struct EntityPool *)malloc(sizeof(struct EntityPool));
+  if (pool == NULL)
+    return NULL;
+  pool->refs = 0;
+  pool->entities = calloc(count, size);
+  if (pool->entities == NULL) {
+    free(pool);
     return NULL;
   }
+  return pool;
+}
+
+// Declares into caller-provided storage. opts may be NULL.
+static bool publisher_init(ZenohPublisher *publisher, ZenohSession *session,
+                           const char *key, const ZenohPublisherOptions *opts) {
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return false;
 
   z_publisher_options_t options;
   z_publisher_options_default(&options);
@@ -485,21 +2059,72 @@ FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_declare_publisher_with_options(
     options.encoding = z_encoding_move(&encoding);
   }
 
-  z_owned_publisher_t pub;
-  if (z_declare_publisher(z_loan(session->session), &pub, z_loan(keyexpr),
-                          &options) < 0) {
+  if (z_declare_publisher(z_loan(session->session), &publisher->publisher,
+                          z_loan(keyexpr), &options) < 0)
+    return false;
+  publisher->stats = entity_stats_register(session, STATS_PUBLISHER);
+  return true;
+}
+
+FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_declare_publisher(ZenohSession *session,
+                                                          const char *key) {
+  return zenoh_declare_publisher_with_options(session, key, NULL);
+}
+
+FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_declare_publisher_with_options(
+    ZenohSession *session, const char *key, ZenohPublisherOptions *opts) {
+  if (session == NULL || key == NULL)
     return NULL;
-  }
 
-  ZenohPublisher *publisher = (ZenohPublisher *)malloc(sizeof(ZenohPublisher));
-  if (publisher == NULL) {
-    z_drop(z_move(pub));
+  ZenohPublisher *publisher = (ZenohPublisher *)calloc(1, sizeof(ZenohPublisher));
+  if (publisher == NULL)
+    return NULL;
+  if (!publisher_init(publisher, session, key, opts)) {
+    free(publisher);
     return NULL;
   }
-  publisher->publisher = pub;
   return publisher;
 }
 
+FFI_PLUGIN_EXPORT size_t zenoh_declare_publishers_bulk(
+    ZenohSession *session, const char *keys, size_t count,
+    const ZenohPublisherOptions *opts, size_t opts_count,
+    ZenohPublisher **publishers) {
+  if (session == NULL || keys == NULL || publishers == NULL || count == 0 ||
+      (opts_count > 1 && opts_count != count) || (opts_count > 0 && opts == NULL))
+    return 0;
+
+  struct EntityPool *pool = entity_pool_new(count, sizeof(ZenohPublisher));
+  if (pool == NULL) {
+    memset(publishers, 0, count * sizeof(ZenohPublisher *));
+    return 0;
+  }
+
+  size_t declared = 0;
+  const char *key = keys;
+  for (size_t i = 0; i < count; i++) {
+    ZenohPublisher *publisher = &((ZenohPublisher *)pool->entities)[i];
+    const ZenohPublisherOptions *o =
+        opts_count == 0 ? NULL : &opts[opts_count == 1 ? 0 : i];
+    if (publisher_init(publisher, session, key, o)) {
+      publisher->pool = pool;
+      publishers[i] = publisher;
+      declared++;
+    } else {
+      publishers[i] = NULL;
+    }
+    key += strlen(key) + 1;
+  }
+
+  // Each entity holds a reference; the pool goes with the last one
+  pool->refs = (atomic_count_t)declared;
+  if (declared == 0) {
+    free(pool->entities);
+    free(pool);
+  }
+  return declared;
+}
+
 FFI_PLUGIN_EXPORT int zenoh_publisher_put(ZenohPublisher *publisher,
                                           const uint8_t *data, size_t len) {
   if (publisher == NULL)
@@ -511,9 +2136,11 @@ FFI_PLUGIN_EXPORT int zenoh_publisher_put(ZenohPublisher *publisher,
   z_owned_bytes_t payload;
   z_bytes_copy_from_buf(&payload, data, len);
 
+  thread_mark_caller();
   int rc = z_publisher_put(z_loan(publisher->publisher), z_move(payload),
                          &options);
   printf("[zenoh_ffi] publisher_put(%zu bytes) -> rc=%d\n", len, rc);
+  stats_record_put(publisher->stats, len, rc);
   return rc;
 }
 
@@ -544,8 +2171,11 @@ FFI_PLUGIN_EXPORT int zenoh_publisher_put_with_options(ZenohPublisher *publisher
   z_owned_bytes_t payload;
   z_bytes_copy_from_buf(&payload, data, len);
 
-  return z_publisher_put(z_loan(publisher->publisher), z_move(payload),
-                         &options);
+  thread_mark_caller();
+  int rc = z_publisher_put(z_loan(publisher->publisher), z_move(payload),
+                           &options);
+  stats_record_put(publisher->stats, len, rc);
+  return rc;
 }
 
 FFI_PLUGIN_EXPORT int zenoh_publisher_delete(ZenohPublisher *publisher) {
@@ -555,32 +2185,46 @@ FFI_PLUGIN_EXPORT int zenoh_publisher_delete(ZenohPublisher *publisher) {
   z_publisher_delete_options_t options;
   z_publisher_delete_options_default(&options);
 
+  thread_mark_caller();
   return z_publisher_delete(z_loan(publisher->publisher), &options);
 }
 
 FFI_PLUGIN_EXPORT void zenoh_undeclare_publisher(ZenohPublisher *publisher) {
   if (publisher != NULL) {
+    while (atomic_count_load(&publisher->sending) != 0)
+      z_sleep_ms(1);
     z_drop(z_move(publisher->publisher));
-    free(publisher);
+    entity_stats_release(publisher->stats);
+    if (publisher->pool != NULL)
+      entity_pool_release(publisher->pool);
+    else
+      free(publisher);
   }
 }
 
+FFI_PLUGIN_EXPORT void zenoh_undeclare_publishers_bulk(
+    ZenohPublisher **publishers, size_t count) {
+  if (publishers == NULL)
+    return;
+  for (size_t i = 0; i < count; i++)
+    zenoh_undeclare_publisher(publishers[i]);
+}
+
 // ============================================================================
 // Subscriber Callbacks
 // ============================================================================
 
-static void subscriber_data_handler(z_loaned_sample_t *sample,
-                                    void *arg) {
-  ZenohSubscriber *sub = (ZenohSubscriber *)arg;
-  if (sub == NULL || sub->callback == NULL)
-    return;
+static bool subscriber_deliver(z_loaned_sample_t *sample,
+                               ZenohSubscriber *sub) {
+  if (sub->callback == NULL)
+    return false;
 
   // Get Key - null-terminated heap copy (Dart will free via zenoh_free_string)
   z_view_string_t key_str;
   z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
   size_t key_len = z_string_len(z_loan(key_str));
   char *key = (char *)malloc(key_len + 1);
-  if (key == NULL) return;
+  if (key == NULL) return false;
   memcpy(key, z_string_data(z_loan(key_str)), key_len);
   key[key_len] = '\0';
 
@@ -589,7 +2233,7 @@ static void subscriber_data_handler(z_loaned_sample_t *sample,
   const char *kind_literal = (kind == Z_SAMPLE_KIND_DELETE) ? "DELETE" : "PUT";
   size_t kind_len = strlen(kind_literal);
   char *kind_str = (char *)malloc(kind_len + 1);
-  if (kind_str == NULL) { free(key); return; }
+  if (kind_str == NULL) { free(key); return false; }
   memcpy(kind_str, kind_literal, kind_len + 1);
 
   // Get Payload - heap copy (Dart will free)
@@ -611,7 +2255,7 @@ static void subscriber_data_handler(z_loaned_sample_t *sample,
   // Get Attachment - heap copy (Dart will free)
   const z_loaned_bytes_t *attachment_bytes = z_sample_attachment(sample);
   char *attachment_str = (char *)malloc(1);
-  if (attachment_str == NULL) { free(key); free(kind_str); free(data); return; }
+  if (attachment_str == NULL) { free(key); free(kind_str); free(data); return false; }
   attachment_str[0] = '\0';
   if (attachment_bytes != NULL && z_bytes_len(attachment_bytes) > 0) {
     z_owned_string_t att_string;
@@ -632,20 +2276,30 @@ static void subscriber_data_handler(z_loaned_sample_t *sample,
 
   // DO NOT FREE - NativeCallable.listener is async, Dart will free these
   sub->callback(key, data, len, kind_str, attachment_str, sub->context);
+  return true;
 }
 
-static void subscriber_data_handler_ex(z_loaned_sample_t *sample,
-                                       void *arg) {
+static void subscriber_data_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
   ZenohSubscriber *sub = (ZenohSubscriber *)arg;
-  if (sub == NULL || sub->callback_ex == NULL)
+  if (sub == NULL)
     return;
+  z_clock_t start = z_clock_now();
+  bool delivered = subscriber_deliver(sample, sub);
+  stats_record_sample(sub->stats, sample, delivered, &start);
+}
+
+static bool subscriber_deliver_ex(z_loaned_sample_t *sample,
+                                  ZenohSubscriber *sub) {
+  if (sub->callback_ex == NULL)
+    return false;
 
   // Get Key - heap copy (Dart will free)
   z_view_string_t key_str;
   z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
   size_t key_len = z_string_len(z_loan(key_str));
   char *key = (char *)malloc(key_len + 1);
-  if (key == NULL) return;
+  if (key == NULL) return false;
   memcpy(key, z_string_data(z_loan(key_str)), key_len);
   key[key_len] = '\0';
 
@@ -662,7 +2316,7 @@ static void subscriber_data_handler_ex(z_loaned_sample_t *sample,
   z_encoding_to_string(enc, &enc_str);
   size_t enc_len = z_string_len(z_loan(enc_str));
   char *encoding = (char *)malloc(enc_len + 1);
-  if (encoding == NULL) { free(key); z_drop(z_move(enc_str)); return; }
+  if (encoding == NULL) { free(key); z_drop(z_move(enc_str)); return false; }
   memcpy(encoding, z_string_data(z_loan(enc_str)), enc_len);
   encoding[enc_len] = '\0';
   z_drop(z_move(enc_str));
@@ -688,37 +2342,42 @@ static void subscriber_data_handler_ex(z_loaned_sample_t *sample,
   size_t attachment_len = 0;
   uint8_t *attachment = get_bytes_data(attachment_bytes, &attachment_len);
 
-  // Get Timestamp (simplified - just use 0 for now)
-  uint64_t timestamp = 0;
+  // Get Timestamp (NTP64, 0 when the publisher's session has none)
+  const z_timestamp_t *ts = z_sample_timestamp(sample);
+  uint64_t timestamp = ts != NULL ? z_timestamp_ntp64_time(ts) : 0;
 
   // DO NOT FREE - NativeCallable.listener is async, Dart will free these
   sub->callback_ex(key, data, len, sample_kind, priority, congestion, encoding,
                    attachment, attachment_len, timestamp, sub->context);
+  return true;
+}
+
+static void subscriber_data_handler_ex(z_loaned_sample_t *sample,
+                                       void *arg) {
+  thread_enter_delivery();
+  ZenohSubscriber *sub = (ZenohSubscriber *)arg;
+  if (sub == NULL)
+    return;
+  z_clock_t start = z_clock_now();
+  bool delivered = subscriber_deliver_ex(sample, sub);
+  stats_record_sample(sub->stats, sample, delivered, &start);
 }
 
 static void drop_subscriber_wrapper(void *arg) {
   // Context cleanup handled elsewhere
 }
 
-FFI_PLUGIN_EXPORT ZenohSubscriber *
-zenoh_declare_subscriber(ZenohSession *session, const char *key,
-                         ZenohSubscriberCallback callback, void *context) {
-  if (session == NULL || key == NULL)
-    return NULL;
-
+// Declares into caller-provided, zeroed storage
+static bool subscriber_init(ZenohSubscriber *sub, ZenohSession *session,
+                            const char *key, ZenohSubscriberCallback callback,
+                            void *context) {
   z_view_keyexpr_t keyexpr;
   if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
-    return NULL;
-
-  ZenohSubscriber *sub = (ZenohSubscriber *)malloc(sizeof(ZenohSubscriber));
-  if (sub == NULL)
-    return NULL;
+    return false;
 
   sub->callback = callback;
-  sub->callback_ex = NULL;
   sub->context = context;
-  sub->is_liveliness = false;
-  sub->liveliness_callback = NULL;
+  sub->stats = entity_stats_register(session, STATS_SUBSCRIBER);
 
   z_subscriber_options_t options;
   z_subscriber_options_default(&options);
@@ -729,24 +2388,75 @@ zenoh_declare_subscriber(ZenohSession *session, const char *key,
 
   if (z_declare_subscriber(z_loan(session->session), &sub->subscriber,
                            z_loan(keyexpr), z_move(closure), &options) < 0) {
-    free(sub);
-    return NULL;
+    entity_stats_release(sub->stats);
+    return false;
   }
-
-  return sub;
+  return true;
 }
 
-FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_ex(
-    ZenohSession *session, const char *key, ZenohSubscriberCallbackEx callback,
-    void *context) {
-  if (session == NULL || key == NULL)
-    return NULL;
+FFI_PLUGIN_EXPORT ZenohSubscriber *
+zenoh_declare_subscriber(ZenohSession *session, const char *key,
+                         ZenohSubscriberCallback callback, void *context) {
+  if (session == NULL || key == NULL)
+    return NULL;
+
+  ZenohSubscriber *sub = (ZenohSubscriber *)calloc(1, sizeof(ZenohSubscriber));
+  if (sub == NULL)
+    return NULL;
+  if (!subscriber_init(sub, session, key, callback, context)) {
+    free(sub);
+    return NULL;
+  }
+  return sub;
+}
+
+FFI_PLUGIN_EXPORT size_t zenoh_declare_subscribers_bulk(
+    ZenohSession *session, const char *keys, size_t count,
+    ZenohSubscriberCallback callback, void *const *contexts,
+    ZenohSubscriber **subscribers) {
+  if (session == NULL || keys == NULL || subscribers == NULL || count == 0)
+    return 0;
+
+  struct EntityPool *pool = entity_pool_new(count, sizeof(ZenohSubscriber));
+  if (pool == NULL) {
+    memset(subscribers, 0, count * sizeof(ZenohSubscriber *));
+    return 0;
+  }
+
+  size_t declared = 0;
+  const char *key = keys;
+  for (size_t i = 0; i < count; i++) {
+    ZenohSubscriber *sub = &((ZenohSubscriber *)pool->entities)[i];
+    if (subscriber_init(sub, session, key, callback,
+                        contexts != NULL ? contexts[i] : NULL)) {
+      sub->pool = pool;
+      subscribers[i] = sub;
+      declared++;
+    } else {
+      subscribers[i] = NULL;
+    }
+    key += strlen(key) + 1;
+  }
+
+  pool->refs = (atomic_count_t)declared;
+  if (declared == 0) {
+    free(pool->entities);
+    free(pool);
+  }
+  return declared;
+}
+
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_ex(
+    ZenohSession *session, const char *key, ZenohSubscriberCallbackEx callback,
+    void *context) {
+  if (session == NULL || key == NULL)
+    return NULL;
 
   z_view_keyexpr_t keyexpr;
   if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
     return NULL;
 
-  ZenohSubscriber *sub = (ZenohSubscriber *)malloc(sizeof(ZenohSubscriber));
+  ZenohSubscriber *sub = (ZenohSubscriber *)calloc(1, sizeof(ZenohSubscriber));
   if (sub == NULL)
     return NULL;
 
@@ -755,6 +2465,8 @@ FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_ex(
   sub->context = context;
   sub->is_liveliness = false;
   sub->liveliness_callback = NULL;
+  sub->shm_callback = NULL;
+  sub->stats = entity_stats_register(session, STATS_SUBSCRIBER);
 
   z_subscriber_options_t options;
   z_subscriber_options_default(&options);
@@ -765,6 +2477,7 @@ FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_ex(
 
   if (z_declare_subscriber(z_loan(session->session), &sub->subscriber,
                            z_loan(keyexpr), z_move(closure), &options) < 0) {
+    entity_stats_release(sub->stats);
     free(sub);
     return NULL;
   }
@@ -775,354 +2488,6285 @@ FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_ex(
 FFI_PLUGIN_EXPORT void zenoh_undeclare_subscriber(ZenohSubscriber *subscriber) {
   if (subscriber != NULL) {
     z_drop(z_move(subscriber->subscriber));
-    free(subscriber);
+    entity_stats_release(subscriber->stats);
+    if (subscriber->pool != NULL)
+      entity_pool_release(subscriber->pool);
+    else
+      free(subscriber);
   }
 }
 
+FFI_PLUGIN_EXPORT void zenoh_undeclare_subscribers_bulk(
+    ZenohSubscriber **subscribers, size_t count) {
+  if (subscribers == NULL)
+    return;
+  for (size_t i = 0; i < count; i++)
+    zenoh_undeclare_subscriber(subscribers[i]);
+}
+
 // ============================================================================
-// Ad-hoc Operations
+// Querying Subscriber
 // ============================================================================
+//
+// Subscribes, then queries the key expression. Live samples are held back
+// until the query completes; the replies and held samples are then merged
+// in timestamp order, without duplicates, before live delivery resumes.
+
+struct PendingSample {
+  z_owned_sample_t sample;
+  size_t seq; // Arrival order
+};
 
-FFI_PLUGIN_EXPORT int zenoh_put(ZenohSession *session, const char *key,
-                                const uint8_t *data, size_t len) {
-  if (session == NULL || key == NULL)
-    return -1;
+struct ZenohQueryingSubscriber {
+  ZenohSubscriber base; // Delivers through subscriber_data_handler_ex
+  z_owned_mutex_t mutex;
+  atomic_count_t refs; // User handle plus the sample and reply closures
+  ZenohGetCompleteCallback ready_callback;
+  bool bootstrapping;
+  bool declaring;  // z_get has not returned yet
+  bool query_done; // The query finished while declaring
+  bool undeclared;
+  struct PendingSample *pending;
+  size_t pending_count;
+  size_t pending_cap;
+};
 
-  z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, key) < 0) {
-    printf("[zenoh_ffi] zenoh_put: invalid keyexpr '%s'\n", key);
-    return -1;
+// Must be called with the querying subscriber mutex held. Samples that do
+// not fit are counted as dropped.
+static void querying_push(ZenohQueryingSubscriber *qs,
+                          const z_loaned_sample_t *sample) {
+  if (qs->pending_count == qs->pending_cap) {
+    size_t cap = qs->pending_cap > 0 ? qs->pending_cap * 2 : 64;
+    struct PendingSample *pending = (struct PendingSample *)realloc(
+        qs->pending, cap * sizeof(struct PendingSample));
+    if (pending == NULL) {
+      stats_record_drop(qs->base.stats, sample);
+      return;
+    }
+    qs->pending = pending;
+    qs->pending_cap = cap;
   }
+  struct PendingSample *p = &qs->pending[qs->pending_count];
+  z_sample_clone(&p->sample, sample);
+  p->seq = qs->pending_count++;
+}
 
-  z_put_options_t options;
-  z_put_options_default(&options);
+// Timestamp order, then key. Samples without a timestamp come from
+// publishers without timestamping and are taken as the newest.
+static int pending_sample_order(const z_loaned_sample_t *a,
+                                const z_loaned_sample_t *b) {
+  const z_timestamp_t *ta = z_sample_timestamp(a);
+  const z_timestamp_t *tb = z_sample_timestamp(b);
+  if (ta == NULL || tb == NULL)
+    return ta != NULL ? -1 : (tb != NULL ? 1 : 0);
+
+  uint64_t na = z_timestamp_ntp64_time(ta);
+  uint64_t nb = z_timestamp_ntp64_time(tb);
+  if (na != nb)
+    return na < nb ? -1 : 1;
+  z_id_t ia = z_timestamp_id(ta);
+  z_id_t ib = z_timestamp_id(tb);
+  int c = memcmp(ia.id, ib.id, sizeof(ia.id));
+  if (c != 0)
+    return c;
+
+  z_view_string_t ka, kb;
+  z_keyexpr_as_view_string(z_sample_keyexpr(a), &ka);
+  z_keyexpr_as_view_string(z_sample_keyexpr(b), &kb);
+  size_t la = z_string_len(z_loan(ka)), lb = z_string_len(z_loan(kb));
+  c = memcmp(z_string_data(z_loan(ka)), z_string_data(z_loan(kb)),
+             la < lb ? la : lb);
+  if (c != 0)
+    return c;
+  return la < lb ? -1 : (la > lb ? 1 : 0);
+}
 
-  z_owned_bytes_t payload;
-  z_bytes_copy_from_buf(&payload, data, len);
+static int pending_sample_cmp(const void *a, const void *b) {
+  const struct PendingSample *pa = (const struct PendingSample *)a;
+  const struct PendingSample *pb = (const struct PendingSample *)b;
+  int c = pending_sample_order(z_loan(pa->sample), z_loan(pb->sample));
+  if (c != 0)
+    return c;
+  return pa->seq < pb->seq ? -1 : (pa->seq > pb->seq ? 1 : 0);
+}
 
-  int rc = z_put(z_loan(session->session), z_loan(keyexpr), z_move(payload),
-               &options);
-  printf("[zenoh_ffi] zenoh_put('%s', %zu bytes) -> rc=%d\n", key, len, rc);
-  return rc;
+// Same key and timestamp: the same update seen live and in a reply
+static bool pending_sample_duplicate(const struct PendingSample *a,
+                                     const struct PendingSample *b) {
+  return z_sample_timestamp(z_loan(a->sample)) != NULL &&
+         pending_sample_order(z_loan(a->sample), z_loan(b->sample)) == 0;
 }
 
-FFI_PLUGIN_EXPORT int zenoh_put_with_options(ZenohSession *session,
-                                             const char *key,
-                                             const uint8_t *data, size_t len,
-                                             ZenohPutOptions *opts) {
-  if (session == NULL || key == NULL)
-    return -1;
+static void querying_release(ZenohQueryingSubscriber *qs) {
+  if (atomic_count_dec(&qs->refs) != 0)
+    return;
+  for (size_t i = 0; i < qs->pending_count; i++)
+    z_drop(z_move(qs->pending[i].sample));
+  free(qs->pending);
+  entity_stats_release(qs->base.stats);
+  z_drop(z_move(qs->mutex));
+  free(qs);
+}
 
-  z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
-    return -1;
+static void drop_querying_closure(void *arg) {
+  querying_release((ZenohQueryingSubscriber *)arg);
+}
 
-  z_put_options_t options;
-  z_put_options_default(&options);
+static void querying_sample_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
+  ZenohQueryingSubscriber *qs = (ZenohQueryingSubscriber *)arg;
 
-  if (opts != NULL) {
-    options.priority = convert_priority(opts->priority);
-    options.congestion_control = convert_congestion_control(opts->congestion_control);
-    options.is_express = opts->is_express;
+  z_mutex_lock(z_loan_mut(qs->mutex));
+  if (qs->bootstrapping) {
+    querying_push(qs, sample);
+    z_mutex_unlock(z_loan_mut(qs->mutex));
+    return;
+  }
+  z_mutex_unlock(z_loan_mut(qs->mutex));
 
-    // Set encoding
-    z_owned_encoding_t encoding;
-    z_encoding_clone(&encoding, get_encoding(opts->encoding));
-    options.encoding = z_encoding_move(&encoding);
+  subscriber_data_handler_ex(sample, &qs->base);
+}
 
-    // Set attachment
-    if (opts->attachment != NULL && opts->attachment_len > 0) {
-      z_owned_bytes_t attachment;
-      z_bytes_copy_from_buf(&attachment, opts->attachment, opts->attachment_len);
-      options.attachment = z_bytes_move(&attachment);
-    }
+static void querying_reply_handler(struct z_loaned_reply_t *reply,
+                                   void *arg) {
+  thread_enter_delivery();
+  ZenohQueryingSubscriber *qs = (ZenohQueryingSubscriber *)arg;
+  if (!z_reply_is_ok(reply))
+    return;
+
+  z_mutex_lock(z_loan_mut(qs->mutex));
+  if (qs->bootstrapping)
+    querying_push(qs, z_reply_ok(reply));
+  z_mutex_unlock(z_loan_mut(qs->mutex));
+}
+
+// Delivers the merged backlog, then goes live
+static void querying_finish(ZenohQueryingSubscriber *qs) {
+  // Delivering under the lock keeps live samples behind the backlog
+  z_mutex_lock(z_loan_mut(qs->mutex));
+  qsort(qs->pending, qs->pending_count, sizeof(struct PendingSample),
+        pending_sample_cmp);
+  for (size_t i = 0; i < qs->pending_count; i++) {
+    if (!qs->undeclared &&
+        (i == 0 ||
+         !pending_sample_duplicate(&qs->pending[i - 1], &qs->pending[i])))
+      subscriber_data_handler_ex((z_loaned_sample_t *)z_loan(qs->pending[i].sample),
+                                 &qs->base);
   }
+  for (size_t i = 0; i < qs->pending_count; i++)
+    z_drop(z_move(qs->pending[i].sample));
+  free(qs->pending);
+  qs->pending = NULL;
+  qs->pending_count = 0;
+  qs->pending_cap = 0;
+  qs->bootstrapping = false;
+  bool notify = !qs->undeclared && qs->ready_callback != NULL;
+  z_mutex_unlock(z_loan_mut(qs->mutex));
+
+  if (notify)
+    qs->ready_callback(qs->base.context);
+  querying_release(qs);
+}
 
-  z_owned_bytes_t payload;
-  z_bytes_copy_from_buf(&payload, data, len);
+// A failed z_get drops the closure before returning, so a query that ends
+// while declaring is finished by the declare once it knows the outcome
+static void querying_query_done(void *arg) {
+  ZenohQueryingSubscriber *qs = (ZenohQueryingSubscriber *)arg;
 
-  return z_put(z_loan(session->session), z_loan(keyexpr), z_move(payload),
-               &options);
+  z_mutex_lock(z_loan_mut(qs->mutex));
+  bool deferred = qs->declaring;
+  qs->query_done = true;
+  z_mutex_unlock(z_loan_mut(qs->mutex));
+
+  if (!deferred)
+    querying_finish(qs);
 }
 
-FFI_PLUGIN_EXPORT int zenoh_delete(ZenohSession *session, const char *key) {
-  if (session == NULL || key == NULL)
-    return -1;
+FFI_PLUGIN_EXPORT ZenohQueryingSubscriber *zenoh_declare_querying_subscriber(
+    ZenohSession *session, const char *key_expr,
+    ZenohQueryingSubscriberOptions *opts, ZenohSubscriberCallbackEx callback,
+    ZenohGetCompleteCallback on_ready, void *context) {
+  if (session == NULL || key_expr == NULL || callback == NULL)
+    return NULL;
 
   z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
-    return -1;
+  if (z_view_keyexpr_from_str(&keyexpr, key_expr) < 0)
+    return NULL;
 
-  z_delete_options_t options;
-  z_delete_options_default(&options);
+  // Split the query selector into "key/expr?parameters"
+  const char *selector = opts != NULL && opts->query_selector != NULL
+                             ? opts->query_selector
+                             : key_expr;
+  const char *params = strchr(selector, '?');
+  size_t selector_len =
+      params != NULL ? (size_t)(params - selector) : strlen(selector);
+  params = params != NULL ? params + 1 : "";
+
+  z_view_keyexpr_t query_keyexpr;
+  if (z_view_keyexpr_from_substr(&query_keyexpr, selector, selector_len) < 0)
+    return NULL;
 
-  return z_delete(z_loan(session->session), z_loan(keyexpr), &options);
-}
+  ZenohQueryingSubscriber *qs =
+      (ZenohQueryingSubscriber *)calloc(1, sizeof(ZenohQueryingSubscriber));
+  if (qs == NULL || z_mutex_init(&qs->mutex) < 0) {
+    free(qs);
+    return NULL;
+  }
+  qs->refs = 1;
+  qs->base.callback_ex = callback;
+  qs->base.context = context;
+  qs->ready_callback = on_ready;
+  qs->bootstrapping = true;
+  qs->declaring = true;
+  qs->base.stats = entity_stats_register(session, STATS_SUBSCRIBER);
+
+  // Each closure holds a reference, released by its drop
+  atomic_count_inc(&qs->refs);
+  z_subscriber_options_t sub_options;
+  z_subscriber_options_default(&sub_options);
+  if (opts != NULL)
+    sub_options.allowed_origin = convert_locality(opts->allowed_origin);
+  z_owned_closure_sample_t sample_closure;
+  z_closure_sample(&sample_closure, querying_sample_handler,
+                   drop_querying_closure, qs);
+  if (z_declare_subscriber(z_loan(session->session), &qs->base.subscriber,
+                           z_loan(keyexpr), z_move(sample_closure),
+                           &sub_options) < 0) {
+    querying_release(qs);
+    return NULL;
+  }
 
-// ============================================================================
-// Query (Get)
-// ============================================================================
+  z_get_options_t get_options;
+  z_get_options_default(&get_options);
+  if (opts != NULL) {
+    get_options.target = convert_query_target(opts->query_target);
+    get_options.consolidation =
+        convert_consolidation(opts->query_consolidation);
+    if (opts->query_timeout_ms > 0)
+      get_options.timeout_ms = opts->query_timeout_ms;
+  }
 
-static void get_reply_handler(struct z_loaned_reply_t *reply, void *arg) {
-  struct GetContext *ctx = (struct GetContext *)arg;
-  if (ctx == NULL || ctx->callback == NULL)
+  atomic_count_inc(&qs->refs);
+  z_owned_closure_reply_t reply_closure;
+  z_closure_reply(&reply_closure, querying_reply_handler, querying_query_done,
+                  qs);
+  thread_mark_caller();
+  int rc = z_get(z_loan(session->session), z_loan(query_keyexpr), params,
+                 z_move(reply_closure), &get_options);
+
+  z_mutex_lock(z_loan_mut(qs->mutex));
+  qs->declaring = false;
+  bool done = qs->query_done;
+  if (rc < 0)
+    qs->undeclared = true;
+  z_mutex_unlock(z_loan_mut(qs->mutex));
+
+  // Without the initial state the subscriber is of no use, so a failed
+  // query fails the declare
+  if (done)
+    querying_finish(qs);
+  if (rc < 0) {
+    z_drop(z_move(qs->base.subscriber));
+    querying_release(qs);
+    return NULL;
+  }
+  return qs;
+}
+
+FFI_PLUGIN_EXPORT void
+zenoh_undeclare_querying_subscriber(ZenohQueryingSubscriber *qs) {
+  if (qs == NULL)
     return;
 
-  if (z_reply_is_ok(reply)) {
-    const z_loaned_sample_t *sample = z_reply_ok(reply);
+  z_mutex_lock(z_loan_mut(qs->mutex));
+  qs->undeclared = true;
+  z_mutex_unlock(z_loan_mut(qs->mutex));
 
-    // Key - null-terminated copy
-    z_view_string_t key_str;
-    z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
-    size_t key_len = z_string_len(z_loan(key_str));
-    char *key = (char *)malloc(key_len + 1);
-    if (key == NULL) return;
-    memcpy(key, z_string_data(z_loan(key_str)), key_len);
-    key[key_len] = '\0';
+  z_drop(z_move(qs->base.subscriber));
+  querying_release(qs);
+}
 
-    // Payload
-    const z_loaned_bytes_t *payload = z_sample_payload(sample);
-    z_owned_string_t payload_string;
-    size_t len = 0;
-    uint8_t *data = NULL;
-    if (z_bytes_to_string(payload, &payload_string) == 0) {
-      len = z_string_len(z_loan(payload_string));
-      data = (uint8_t *)malloc(len);
-      if (data != NULL) {
-        memcpy(data, z_string_data(z_loan(payload_string)), len);
-      }
-      z_drop(z_move(payload_string));
-    } else {
-      data = get_bytes_data(payload, &len);
-    }
+FFI_PLUGIN_EXPORT int
+zenoh_querying_subscriber_stats_snapshot(ZenohQueryingSubscriber *subscriber,
+                                         ZenohSessionStats *stats) {
+  return entity_stats_snapshot(
+      subscriber != NULL ? subscriber->base.stats : NULL, stats);
+}
 
-    // Kind - heap copy (Dart will free)
-    const char *kind_literal = (z_sample_kind(sample) == Z_SAMPLE_KIND_DELETE) ? "DELETE" : "PUT";
-    size_t kind_len = strlen(kind_literal);
-    char *kind_str = (char *)malloc(kind_len + 1);
-    if (kind_str == NULL) { free(key); free(data); return; }
-    memcpy(kind_str, kind_literal, kind_len + 1);
+// ============================================================================
+// Advanced Subscriber
+// ============================================================================
 
-    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
-    ctx->callback(key, data, len, kind_str, ctx->user_context);
-  }
+struct ZenohAdvancedSubscriber {
+  ZenohSubscriber base; // Delivers through subscriber_data_handler_ex
+#if ZENOH_FFI_HAS_UNSTABLE
+  ze_owned_advanced_subscriber_t subscriber;
+#endif
+  atomic_count_t refs; // User handle plus the sample and miss closures
+  ZenohSampleMissCallback miss_callback;
+};
+
+FFI_PLUGIN_EXPORT bool zenoh_advanced_subscriber_is_available(void) {
+  return ZENOH_FFI_HAS_UNSTABLE != 0;
 }
 
-static void drop_get_context(void *arg) {
-  struct GetContext *ctx = (struct GetContext *)arg;
-  if (ctx != NULL) {
-    // Call completion callback if provided
-    if (ctx->complete_callback != NULL) {
-      ctx->complete_callback(ctx->user_context);
-    }
-    free(ctx);
-  }
+#if ZENOH_FFI_HAS_UNSTABLE
+static void advanced_release(ZenohAdvancedSubscriber *adv) {
+  if (atomic_count_dec(&adv->refs) == 0)
+    free(adv);
 }
 
-FFI_PLUGIN_EXPORT void zenoh_get_async(ZenohSession *session,
-                                       const char *selector,
-                                       ZenohGetCallback callback,
-                                       void *context) {
-  ZenohGetOptions opts;
-  zenoh_get_options_default(&opts);
-  zenoh_get_async_with_options(session, selector, callback, NULL, context,
-                               &opts);
+static void drop_advanced_closure(void *arg) {
+  advanced_release((ZenohAdvancedSubscriber *)arg);
 }
 
-FFI_PLUGIN_EXPORT void zenoh_get_async_with_options(
-    ZenohSession *session, const char *selector, ZenohGetCallback callback,
-    ZenohGetCompleteCallback complete_callback, void *context,
-    ZenohGetOptions *opts) {
-  if (session == NULL || selector == NULL)
+static void advanced_miss_handler(const ze_miss_t *miss, void *arg) {
+  thread_enter_delivery();
+  ZenohAdvancedSubscriber *adv = (ZenohAdvancedSubscriber *)arg;
+  z_id_t zid = z_entity_global_id_zid(&miss->source);
+  char *source = copy_zid_string(&zid);
+  if (source == NULL)
     return;
 
-  z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, selector) < 0)
-    return;
+  // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+  adv->miss_callback(source, miss->nb, adv->base.context);
+}
+#endif
 
-  struct GetContext *ctx =
-      (struct GetContext *)malloc(sizeof(struct GetContext));
-  if (ctx == NULL)
-    return;
+FFI_PLUGIN_EXPORT ZenohAdvancedSubscriber *zenoh_declare_advanced_subscriber(
+    ZenohSession *session, const char *key_expr,
+    ZenohAdvancedSubscriberOptions *opts, ZenohSubscriberCallbackEx callback,
+    ZenohSampleMissCallback on_miss, void *context) {
+#if ZENOH_FFI_HAS_UNSTABLE
+  if (session == NULL || key_expr == NULL || callback == NULL)
+    return NULL;
 
-  ctx->callback = callback;
-  ctx->complete_callback = complete_callback;
-  ctx->user_context = context;
-  ctx->timeout_ms = opts ? opts->timeout_ms : 10000;
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key_expr) < 0)
+    return NULL;
 
-  z_get_options_t options;
-  z_get_options_default(&options);
+  ZenohAdvancedSubscriber *adv =
+      (ZenohAdvancedSubscriber *)calloc(1, sizeof(ZenohAdvancedSubscriber));
+  if (adv == NULL)
+    return NULL;
+  adv->refs = 1;
+  adv->base.callback_ex = callback;
+  adv->base.context = context;
+  adv->miss_callback = on_miss;
 
+  ze_advanced_subscriber_options_t options;
+  ze_advanced_subscriber_options_default(&options);
   if (opts != NULL) {
-    options.timeout_ms = opts->timeout_ms;
-    options.priority = convert_priority(opts->priority);
-    options.congestion_control = convert_congestion_control(opts->congestion_control);
-
-    // Set payload if provided
-    if (opts->payload != NULL && opts->payload_len > 0) {
-      z_owned_bytes_t payload;
-      z_bytes_copy_from_buf(&payload, opts->payload, opts->payload_len);
-      options.payload = z_bytes_move(&payload);
+    options.subscriber_options.allowed_origin =
+        convert_locality(opts->allowed_origin);
+    options.history.is_enabled = opts->history;
+    options.history.detect_late_publishers = opts->detect_late_publishers;
+    options.history.max_samples = opts->history_max_samples;
+    options.history.max_age_ms = opts->history_max_age_ms;
+    options.recovery.is_enabled = opts->recovery;
+    options.recovery.last_sample_miss_detection.is_enabled = opts->recovery;
+    options.recovery.last_sample_miss_detection.periodic_queries_period_ms =
+        opts->recovery_period_ms;
+    options.query_timeout_ms = opts->query_timeout_ms;
+    options.subscriber_detection = opts->subscriber_detection;
+  }
 
-      // Set encoding
-      z_owned_encoding_t encoding;
-      z_encoding_clone(&encoding, get_encoding(opts->encoding));
-      options.encoding = z_encoding_move(&encoding);
-    }
+  // Each closure holds a reference, released by its drop. base comes first,
+  // so adv doubles as the handler's ZenohSubscriber.
+  atomic_count_inc(&adv->refs);
+  z_owned_closure_sample_t closure;
+  z_closure_sample(&closure, subscriber_data_handler_ex, drop_advanced_closure,
+                   adv);
+  thread_mark_caller();
+  if (ze_declare_advanced_subscriber(z_loan(session->session),
+                                     &adv->subscriber, z_loan(keyexpr),
+                                     z_move(closure), &options) < 0) {
+    advanced_release(adv);
+    return NULL;
+  }
 
-    // Set attachment
-    if (opts->attachment != NULL && opts->attachment_len > 0) {
-      z_owned_bytes_t attachment;
-      z_bytes_copy_from_buf(&attachment, opts->attachment, opts->attachment_len);
-      options.attachment = z_bytes_move(&attachment);
-    }
+  // The ze_ types only join the z_move/z_loan generics in unstable builds of
+  // the headers, so they are moved and loaned explicitly
+  if (on_miss != NULL) {
+    atomic_count_inc(&adv->refs);
+    ze_owned_closure_miss_t miss_closure;
+    ze_closure_miss(&miss_closure, advanced_miss_handler,
+                    drop_advanced_closure, adv);
+    ze_advanced_subscriber_declare_background_sample_miss_listener(
+        ze_advanced_subscriber_loan(&adv->subscriber),
+        (ze_moved_closure_miss_t *)&miss_closure);
   }
 
-  z_owned_closure_reply_t closure;
-  z_closure_reply(&closure, get_reply_handler, drop_get_context, ctx);
+  return adv;
+#else
+  (void)session;
+  (void)key_expr;
+  (void)opts;
+  (void)callback;
+  (void)on_miss;
+  (void)context;
+  return NULL;
+#endif
+}
 
-  z_get(z_loan(session->session), z_loan(keyexpr), "", z_move(closure),
-        &options);
+FFI_PLUGIN_EXPORT void
+zenoh_undeclare_advanced_subscriber(ZenohAdvancedSubscriber *adv) {
+  if (adv == NULL)
+    return;
+#if ZENOH_FFI_HAS_UNSTABLE
+  // Drops the closures too; the last reference frees adv
+  ze_advanced_subscriber_drop(
+      (ze_moved_advanced_subscriber_t *)&adv->subscriber);
+  advanced_release(adv);
+#else
+  free(adv);
+#endif
 }
 
 // ============================================================================
-// Queryable
+// Shared Memory
 // ============================================================================
 
-static void query_handler(z_loaned_query_t *query, void *arg) {
-  ZenohQueryable *q = (ZenohQueryable *)arg;
-  if (q == NULL || q->callback == NULL)
-    return;
+FFI_PLUGIN_EXPORT bool zenoh_shm_is_available(void) {
+  return ZENOH_FFI_HAS_SHM != 0;
+}
 
-  // Get Key Selector - null-terminated copy
-  const z_loaned_keyexpr_t *keyexpr = z_query_keyexpr(query);
-  z_view_string_t key_str;
-  z_keyexpr_as_view_string(keyexpr, &key_str);
-  size_t key_len = z_string_len(z_loan(key_str));
-  char *key = (char *)malloc(key_len + 1);
-  if (key == NULL) return;
-  memcpy(key, z_string_data(z_loan(key_str)), key_len);
-  key[key_len] = '\0';
+FFI_PLUGIN_EXPORT ZenohShmProvider *zenoh_shm_provider_create(size_t size) {
+#if ZENOH_FFI_HAS_SHM
+  if (size == 0)
+    return NULL;
 
-  // Get Selector (parameters) - null-terminated copy
-  z_view_string_t selector_str;
-  z_query_parameters(query, &selector_str);
-  size_t sel_len = z_string_len(z_loan(selector_str));
-  char *selector = (char *)malloc(sel_len + 1);
-  if (selector == NULL) { free(key); return; }
-  memcpy(selector, z_string_data(z_loan(selector_str)), sel_len);
-  selector[sel_len] = '\0';
+  ZenohShmProvider *provider =
+      (ZenohShmProvider *)malloc(sizeof(ZenohShmProvider));
+  if (provider == NULL)
+    return NULL;
 
-  // Get Payload (Value)
-  const z_loaned_bytes_t *payload = z_query_payload(query);
-  size_t len = 0;
-  uint8_t *data = get_bytes_data(payload, &len);
+  if (z_posix_shm_provider_new(&provider->provider, size) < 0) {
+    free(provider);
+    return NULL;
+  }
+  provider->size = size;
+  return provider;
+#else
+  (void)size;
+  return NULL;
+#endif
+}
 
-  const char *kind = "GET";
+FFI_PLUGIN_EXPORT void zenoh_shm_provider_destroy(ZenohShmProvider *provider) {
+  if (provider != NULL) {
+#if ZENOH_FFI_HAS_SHM
+    z_drop(z_move(provider->provider));
+#endif
+    free(provider);
+  }
+}
 
-  // Kind - heap copy (Dart will free)
-  size_t kind_len = strlen(kind);
-  char *kind_copy = (char *)malloc(kind_len + 1);
-  if (kind_copy == NULL) { free(key); free(selector); free(data); return; }
-  memcpy(kind_copy, kind, kind_len + 1);
+FFI_PLUGIN_EXPORT ZenohShmBuffer *zenoh_shm_alloc(ZenohShmProvider *provider,
+                                                  size_t len) {
+#if ZENOH_FFI_HAS_SHM
+  if (provider == NULL || len == 0)
+    return NULL;
+
+  z_buf_layout_alloc_result_t result;
+  z_shm_provider_alloc_gc_defrag(&result, z_loan(provider->provider), len);
+  if (result.status != ZC_BUF_LAYOUT_ALLOC_STATUS_OK)
+    return NULL;
+
+  ZenohShmBuffer *buffer = (ZenohShmBuffer *)malloc(sizeof(ZenohShmBuffer));
+  if (buffer == NULL) {
+    z_drop(z_move(result.buf));
+    return NULL;
+  }
+  buffer->buf = result.buf;
+  z_internal_shm_null(&buffer->shm);
+  buffer->is_mut = true;
+  buffer->data = z_shm_mut_data_mut(z_loan_mut(buffer->buf));
+  buffer->len = z_shm_mut_len(z_loan(buffer->buf));
+  return buffer;
+#else
+  (void)provider;
+  (void)len;
+  return NULL;
+#endif
+}
+
+FFI_PLUGIN_EXPORT uint8_t *zenoh_shm_buffer_data(ZenohShmBuffer *buffer) {
+  return buffer != NULL ? buffer->data : NULL;
+}
+
+FFI_PLUGIN_EXPORT size_t zenoh_shm_buffer_len(ZenohShmBuffer *buffer) {
+  return buffer != NULL ? buffer->len : 0;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_shm_buffer_free(ZenohShmBuffer *buffer) {
+  if (buffer != NULL) {
+#if ZENOH_FFI_HAS_SHM
+    if (buffer->is_mut) {
+      z_drop(z_move(buffer->buf));
+    } else {
+      z_drop(z_move(buffer->shm));
+    }
+#endif
+    free(buffer);
+  }
+}
+
+FFI_PLUGIN_EXPORT int zenoh_publisher_put_shm(ZenohPublisher *publisher,
+                                              ZenohShmBuffer *buffer) {
+#if ZENOH_FFI_HAS_SHM
+  if (publisher == NULL || buffer == NULL || !buffer->is_mut) {
+    zenoh_shm_buffer_free(buffer);
+    return -1;
+  }
+
+  z_owned_bytes_t payload;
+  int rc = z_bytes_from_shm_mut(&payload, z_move(buffer->buf));
+  free(buffer);
+  if (rc < 0)
+    return rc;
+
+  z_publisher_put_options_t options;
+  z_publisher_put_options_default(&options);
+
+  size_t len = z_bytes_len(z_loan(payload));
+  thread_mark_caller();
+  rc = z_publisher_put(z_loan(publisher->publisher), z_move(payload),
+                       &options);
+  stats_record_put(publisher->stats, len, rc);
+  return rc;
+#else
+  (void)publisher;
+  zenoh_shm_buffer_free(buffer);
+  return -1;
+#endif
+}
+
+static bool subscriber_deliver_shm(z_loaned_sample_t *sample,
+                                   ZenohSubscriber *sub) {
+  if (sub->shm_callback == NULL)
+    return false;
+
+  // Key - heap copy (Dart will free)
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+  size_t key_len = z_string_len(z_loan(key_str));
+  char *key = (char *)malloc(key_len + 1);
+  if (key == NULL) return false;
+  memcpy(key, z_string_data(z_loan(key_str)), key_len);
+  key[key_len] = '\0';
+
+  const z_loaned_bytes_t *payload = z_sample_payload(sample);
+
+#if ZENOH_FFI_HAS_SHM
+  // SHM-backed payload: keep the segment mapped and hand out a view into it
+  const z_loaned_shm_t *shm = NULL;
+  if (z_bytes_as_loaned_shm(payload, &shm) == 0 && shm != NULL) {
+    ZenohShmBuffer *buffer = (ZenohShmBuffer *)malloc(sizeof(ZenohShmBuffer));
+    if (buffer == NULL) { free(key); return false; }
+    z_shm_clone(&buffer->shm, shm);
+    z_internal_shm_mut_null(&buffer->buf);
+    buffer->is_mut = false;
+    buffer->data = (uint8_t *)z_shm_data(z_loan(buffer->shm));
+    buffer->len = z_shm_len(z_loan(buffer->shm));
+
+    // DO NOT FREE - Dart releases the mapping via zenoh_shm_buffer_free
+    sub->shm_callback(key, buffer->data, buffer->len, buffer, sub->context);
+    return true;
+  }
+#endif
+
+  // Regular payload - heap copy (Dart will free)
+  size_t len = 0;
+  uint8_t *data = get_bytes_data(payload, &len);
 
   // DO NOT FREE - NativeCallable.listener is async, Dart will free these
-  q->callback(key, selector, data, len, kind_copy, (void *)query, q->context);
+  sub->shm_callback(key, data, len, NULL, sub->context);
+  return true;
 }
 
-static void drop_queryable_wrapper(void *arg) {
-  // Cleanup if needed
+static void subscriber_shm_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
+  ZenohSubscriber *sub = (ZenohSubscriber *)arg;
+  if (sub == NULL)
+    return;
+  z_clock_t start = z_clock_now();
+  bool delivered = subscriber_deliver_shm(sample, sub);
+  stats_record_sample(sub->stats, sample, delivered, &start);
 }
 
-FFI_PLUGIN_EXPORT ZenohQueryable *
-zenoh_declare_queryable(ZenohSession *session, const char *key_expr,
-                        ZenohQueryCallback callback, void *context) {
-  if (session == NULL || key_expr == NULL)
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_shm(
+    ZenohSession *session, const char *key,
+    ZenohSubscriberShmCallback callback, void *context) {
+  if (session == NULL || key == NULL)
     return NULL;
 
-  z_view_keyexpr_t keyopts;
-  if (z_view_keyexpr_from_str(&keyopts, key_expr) < 0)
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
     return NULL;
 
-  ZenohQueryable *q = (ZenohQueryable *)malloc(sizeof(ZenohQueryable));
-  if (q == NULL)
+  ZenohSubscriber *sub = (ZenohSubscriber *)calloc(1, sizeof(ZenohSubscriber));
+  if (sub == NULL)
     return NULL;
 
-  q->callback = callback;
-  q->context = context;
+  sub->callback = NULL;
+  sub->callback_ex = NULL;
+  sub->context = context;
+  sub->is_liveliness = false;
+  sub->liveliness_callback = NULL;
+  sub->shm_callback = callback;
+  sub->stats = entity_stats_register(session, STATS_SUBSCRIBER);
 
-  z_queryable_options_t options;
-  z_queryable_options_default(&options);
+  z_subscriber_options_t options;
+  z_subscriber_options_default(&options);
 
-  z_owned_closure_query_t closure;
-  z_closure_query(&closure, query_handler, drop_queryable_wrapper, q);
+  z_owned_closure_sample_t closure;
+  z_closure_sample(&closure, subscriber_shm_handler, drop_subscriber_wrapper,
+                   sub);
 
-  if (z_declare_queryable(z_loan(session->session), &q->queryable,
-                          z_loan(keyopts), z_move(closure), &options) < 0) {
-    free(q);
+  if (z_declare_subscriber(z_loan(session->session), &sub->subscriber,
+                           z_loan(keyexpr), z_move(closure), &options) < 0) {
+    entity_stats_release(sub->stats);
+    free(sub);
     return NULL;
   }
 
-  return q;
+  return sub;
 }
 
-FFI_PLUGIN_EXPORT void zenoh_undeclare_queryable(ZenohQueryable *queryable) {
-  if (queryable != NULL) {
-    z_drop(z_move(queryable->queryable));
-    free(queryable);
+// ============================================================================
+// Chunked Transfer
+// ============================================================================
+
+// Wire header, little-endian:
+//   magic u32 | transfer_id u64 | total_len u64 | chunk_size u32 |
+//   index u32 | count u32 | crc32 u32
+#define CHUNK_MAGIC 0x4b48435au // "ZCHK"
+#define CHUNK_HEADER_SIZE 36
+#define CHUNK_DEFAULT_SIZE (64 * 1024)
+#define CHUNK_DEFAULT_TIMEOUT_MS 30000
+#define CHUNK_MAX_IN_FLIGHT 64
+#define CHUNK_RECENT_COMPLETED 64
+// Receive-side bounds; headers come from the network and are not trusted
+#define CHUNK_DEFAULT_MAX_OBJECT_SIZE ((size_t)256 * 1024 * 1024)
+#define CHUNK_MAX_COUNT ((uint32_t)1 << 20)
+#define CHUNK_MAX_IN_FLIGHT_BYTES ((size_t)512 * 1024 * 1024)
+
+static const uint32_t crc32_table[256] = {
+    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
+    0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
+    0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
+    0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
+    0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
+    0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
+    0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
+    0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+    0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
+    0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
+    0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
+    0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
+    0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
+    0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
+    0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
+    0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
+    0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
+    0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
+    0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
+    0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
+    0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
+    0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
+    0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+    0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
+    0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
+    0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
+    0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
+    0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
+    0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
+    0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
+    0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
+    0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
+    0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
+
+static uint32_t compute_crc32(const uint8_t *data, size_t len) {
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < len; i++)
+    crc = crc32_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffffu;
+}
+
+static void put_u32_le(uint8_t *p, uint32_t v) {
+  for (int i = 0; i < 4; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64_le(uint8_t *p, uint64_t v) {
+  for (int i = 0; i < 8; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32_le(const uint8_t *p) {
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; i--)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+static uint64_t get_u64_le(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+// Payload of one chunked put. Every chunk borrows a slice of it instead of
+// copying, so it is released once zenoh has dropped the last chunk.
+struct ChunkSource {
+  atomic_count_t refs;
+  uint8_t *data;
+  void (*release)(void *data);
+};
+
+static void chunk_source_release(struct ChunkSource *src) {
+  if (atomic_count_dec(&src->refs) == 0) {
+    src->release(src->data);
+    free(src);
   }
 }
 
-FFI_PLUGIN_EXPORT void zenoh_query_reply(void *reply_context, const char *key,
-                                         const uint8_t *data, size_t len) {
-  const z_loaned_query_t *query = (const z_loaned_query_t *)reply_context;
-  if (query == NULL)
+// z_bytes_from_buf deleter of a chunk slice
+static void chunk_slice_drop(void *data, void *context) {
+  (void)data;
+  chunk_source_release((struct ChunkSource *)context);
+}
+
+// Takes ownership of data when release is set, copies it once otherwise. On
+// failure data has already been released.
+static struct ChunkSource *chunk_source_new(const uint8_t *data, size_t len,
+                                            void (*release)(void *data)) {
+  struct ChunkSource *src =
+      (struct ChunkSource *)malloc(sizeof(struct ChunkSource));
+  if (src == NULL) {
+    if (release != NULL)
+      release((void *)data);
+    return NULL;
+  }
+  src->refs = 1;
+  if (release != NULL) {
+    src->data = (uint8_t *)data;
+    src->release = release;
+    return src;
+  }
+  src->data = (uint8_t *)malloc(len > 0 ? len : 1);
+  if (src->data == NULL) {
+    free(src);
+    return NULL;
+  }
+  if (len > 0)
+    memcpy(src->data, data, len);
+  src->release = free;
+  return src;
+}
+
+// Publishes every chunk of src and drops the caller's reference to it.
+// Returns the number of chunks sent or < 0.
+static int chunk_send_all(ZenohPublisher *publisher, struct ChunkSource *src,
+                          size_t len, size_t chunk_size, size_t count,
+                          uint64_t id) {
+  uint8_t header[CHUNK_HEADER_SIZE];
+  put_u32_le(header, CHUNK_MAGIC);
+  put_u64_le(header + 4, id);
+  put_u64_le(header + 12, (uint64_t)len);
+  put_u32_le(header + 20, (uint32_t)chunk_size);
+  put_u32_le(header + 28, (uint32_t)count);
+
+  int rc = 0;
+  for (size_t i = 0; i < count && rc >= 0; i++) {
+    size_t offset = i * chunk_size;
+    size_t n = len - offset < chunk_size ? len - offset : chunk_size;
+
+    put_u32_le(header + 24, (uint32_t)i);
+    put_u32_le(header + 32, compute_crc32(src->data + offset, n));
+
+    // Only the header is copied; the data goes out as a borrowed slice
+    z_owned_bytes_writer_t writer;
+    rc = z_bytes_writer_empty(&writer);
+    if (rc < 0)
+      break;
+    rc = z_bytes_writer_write_all(z_loan_mut(writer), header,
+                                  CHUNK_HEADER_SIZE);
+    if (rc >= 0 && n > 0) {
+      z_owned_bytes_t slice;
+      atomic_count_inc(&src->refs);
+      rc = z_bytes_from_buf(&slice, src->data + offset, n, chunk_slice_drop,
+                            src);
+      if (rc < 0)
+        atomic_count_dec(&src->refs);
+      else
+        rc = z_bytes_writer_append(z_loan_mut(writer), z_move(slice));
+    }
+    z_owned_bytes_t payload;
+    z_bytes_writer_finish(z_move(writer), &payload);
+    if (rc < 0) {
+      z_drop(z_move(payload));
+      break;
+    }
+
+    z_publisher_put_options_t options;
+    z_publisher_put_options_default(&options);
+    thread_mark_caller();
+    rc = z_publisher_put(z_loan(publisher->publisher), z_move(payload),
+                         &options);
+  }
+
+  chunk_source_release(src);
+  stats_record_put(publisher->stats, len, rc);
+  return rc < 0 ? rc : (int)count;
+}
+
+// Validates the arguments and works out the chunk count
+static int chunk_plan(ZenohPublisher *publisher, const uint8_t *data,
+                      size_t len, size_t *chunk_size, size_t *count) {
+  if (publisher == NULL || (data == NULL && len > 0))
+    return -1;
+  if (*chunk_size == 0)
+    *chunk_size = CHUNK_DEFAULT_SIZE;
+  if (*chunk_size > UINT32_MAX)
+    return -1;
+  *count = len == 0 ? 1 : (len + *chunk_size - 1) / *chunk_size;
+  if (*count > UINT32_MAX)
+    return -1;
+  return 0;
+}
+
+// Random so concurrent senders on the same key do not collide; 0 is
+// reserved for plain samples on the receiving side.
+static uint64_t chunk_transfer_id(void) { return z_random_u64() | 1u; }
+
+FFI_PLUGIN_EXPORT int
+zenoh_publisher_put_chunked(ZenohPublisher *publisher, const uint8_t *data,
+                            size_t len, size_t chunk_size,
+                            void (*release)(void *data),
+                            uint64_t *transfer_id) {
+  size_t count;
+  if (chunk_plan(publisher, data, len, &chunk_size, &count) < 0) {
+    if (release != NULL && data != NULL)
+      release((void *)data);
+    return -1;
+  }
+  struct ChunkSource *src = chunk_source_new(data, len, release);
+  if (src == NULL)
+    return -1;
+
+  uint64_t id = chunk_transfer_id();
+  if (transfer_id != NULL)
+    *transfer_id = id;
+  return chunk_send_all(publisher, src, len, chunk_size, count, id);
+}
+
+struct ChunkPutTask {
+  ZenohPublisher *publisher;
+  struct ChunkSource *src;
+  size_t len;
+  size_t chunk_size;
+  size_t count;
+  uint64_t id;
+  ZenohChunkedPutCallback callback;
+  void *context;
+};
+
+static void *chunk_put_task(void *arg) {
+  struct ChunkPutTask *task = (struct ChunkPutTask *)arg;
+  int rc = chunk_send_all(task->publisher, task->src, task->len,
+                          task->chunk_size, task->count, task->id);
+  atomic_count_dec(&task->publisher->sending);
+  if (task->callback != NULL)
+    task->callback(task->id, rc, task->context);
+  free(task);
+  return NULL;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_publisher_put_chunked_async(
+    ZenohPublisher *publisher, const uint8_t *data, size_t len,
+    size_t chunk_size, void (*release)(void *data),
+    ZenohChunkedPutCallback callback, void *context) {
+  size_t count;
+  if (chunk_plan(publisher, data, len, &chunk_size, &count) < 0) {
+    if (release != NULL && data != NULL)
+      release((void *)data);
+    return -1;
+  }
+
+  struct ChunkPutTask *task =
+      (struct ChunkPutTask *)malloc(sizeof(struct ChunkPutTask));
+  if (task == NULL) {
+    if (release != NULL)
+      release((void *)data);
+    return -1;
+  }
+  task->src = chunk_source_new(data, len, release);
+  if (task->src == NULL) {
+    free(task);
+    return -1;
+  }
+  task->publisher = publisher;
+  task->len = len;
+  task->chunk_size = chunk_size;
+  task->count = count;
+  task->id = chunk_transfer_id();
+  task->callback = callback;
+  task->context = context;
+
+  // Holds zenoh_undeclare_publisher off until the worker is done
+  atomic_count_inc(&publisher->sending);
+  z_owned_task_t thread;
+  if (worker_start(&thread, chunk_put_task, task) != 0) {
+    // No worker available: send on this thread
+    chunk_put_task(task);
+    return 0;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
+
+struct ChunkTransfer {
+  uint64_t id;
+  uint8_t *data;
+  size_t len;
+  uint32_t chunk_size;
+  uint32_t count;
+  uint32_t received;
+  uint8_t *seen; // one bit per chunk
+  size_t footprint; // bytes counted against in_flight_bytes
+  z_clock_t last_seen;
+  struct ChunkTransfer *next;
+};
+
+struct ChunkAssembler {
+  z_owned_mutex_t mutex;
+  struct ChunkTransfer *transfers;
+  size_t in_flight;
+  size_t in_flight_bytes;
+  ZenohChunkedCallback callback;
+  ZenohChunkProgressCallback progress_callback;
+  size_t max_object_size;
+  size_t max_in_flight_bytes;
+  uint64_t timeout_ms;
+  void *context;
+  // Ring of recently completed transfer ids; late or duplicate chunks of
+  // these are dropped instead of starting a new transfer
+  uint64_t completed[CHUNK_RECENT_COMPLETED];
+  size_t completed_next;
+};
+
+static void chunk_transfer_free(struct ChunkTransfer *t) {
+  free(t->data);
+  free(t->seen);
+  free(t);
+}
+
+// Must be called with the assembler mutex held
+static void chunk_evict_stale(struct ChunkAssembler *asm_) {
+  struct ChunkTransfer **link = &asm_->transfers;
+  while (*link != NULL) {
+    struct ChunkTransfer *t = *link;
+    if (z_clock_elapsed_ms(&t->last_seen) > asm_->timeout_ms) {
+      *link = t->next;
+      asm_->in_flight--;
+      asm_->in_flight_bytes -= t->footprint;
+      chunk_transfer_free(t);
+    } else {
+      link = &t->next;
+    }
+  }
+}
+
+// Must be called with the assembler mutex held
+static struct ChunkTransfer *chunk_find_or_create(struct ChunkAssembler *asm_,
+                                                  uint64_t id, uint64_t len,
+                                                  uint32_t chunk_size,
+                                                  uint32_t count) {
+  for (struct ChunkTransfer *t = asm_->transfers; t != NULL; t = t->next) {
+    if (t->id == id) {
+      if (t->len != len || t->chunk_size != chunk_size || t->count != count)
+        return NULL;
+      return t;
+    }
+  }
+  for (size_t i = 0; i < CHUNK_RECENT_COMPLETED; i++) {
+    if (asm_->completed[i] == id)
+      return NULL;
+  }
+
+  if (len > asm_->max_object_size || count > CHUNK_MAX_COUNT ||
+      asm_->in_flight >= CHUNK_MAX_IN_FLIGHT)
+    return NULL;
+
+  // Sized in size_t: count can be close to UINT32_MAX before the bound above
+  size_t seen_len = ((size_t)count + 7) / 8;
+  if ((size_t)len > SIZE_MAX - seen_len)
+    return NULL;
+  size_t footprint = (size_t)len + seen_len;
+  if (footprint > asm_->max_in_flight_bytes - asm_->in_flight_bytes)
+    return NULL;
+
+  struct ChunkTransfer *t =
+      (struct ChunkTransfer *)calloc(1, sizeof(struct ChunkTransfer));
+  if (t == NULL)
+    return NULL;
+
+  t->data = (uint8_t *)malloc(len > 0 ? (size_t)len : 1);
+  t->seen = (uint8_t *)calloc(seen_len, 1);
+  if (t->data == NULL || t->seen == NULL) {
+    chunk_transfer_free(t);
+    return NULL;
+  }
+  t->id = id;
+  t->len = (size_t)len;
+  t->chunk_size = chunk_size;
+  t->count = count;
+  t->footprint = footprint;
+  t->next = asm_->transfers;
+  asm_->transfers = t;
+  asm_->in_flight++;
+  asm_->in_flight_bytes += footprint;
+  return t;
+}
+
+static char *copy_sample_key(const z_loaned_sample_t *sample) {
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+  size_t key_len = z_string_len(z_loan(key_str));
+  char *key = (char *)malloc(key_len + 1);
+  if (key != NULL) {
+    memcpy(key, z_string_data(z_loan(key_str)), key_len);
+    key[key_len] = '\0';
+  }
+  return key;
+}
+
+static void chunked_sample_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
+  struct ChunkAssembler *asm_ = (struct ChunkAssembler *)arg;
+  if (asm_ == NULL)
+    return;
+
+  const z_loaned_bytes_t *payload = z_sample_payload(sample);
+  size_t raw_len = z_bytes_len(payload);
+  uint8_t header[CHUNK_HEADER_SIZE];
+  z_bytes_reader_t reader = z_bytes_get_reader(payload);
+
+  if (raw_len < CHUNK_HEADER_SIZE ||
+      z_bytes_reader_read(&reader, header, CHUNK_HEADER_SIZE) !=
+          CHUNK_HEADER_SIZE ||
+      get_u32_le(header) != CHUNK_MAGIC) {
+    // Not a chunked transfer - deliver as a complete object
+    size_t len = 0;
+    uint8_t *data = get_bytes_data(payload, &len);
+    char *key = copy_sample_key(sample);
+    if (key == NULL) {
+      free(data);
+      return;
+    }
+
+    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+    asm_->callback(key, data, len, 0, asm_->context);
+    return;
+  }
+
+  uint64_t id = get_u64_le(header + 4);
+  uint64_t total_len = get_u64_le(header + 12);
+  uint32_t chunk_size = get_u32_le(header + 20);
+  uint32_t index = get_u32_le(header + 24);
+  uint32_t count = get_u32_le(header + 28);
+  uint32_t crc = get_u32_le(header + 32);
+  size_t n = raw_len - CHUNK_HEADER_SIZE;
+
+  // Validate the header against itself before touching any state
+  if (chunk_size == 0)
+    return;
+  uint64_t expected_count =
+      total_len == 0 ? 1 : (total_len + chunk_size - 1) / chunk_size;
+  if (count != expected_count || index >= count)
+    return;
+  uint64_t offset = (uint64_t)index * chunk_size;
+  uint64_t expected_n =
+      total_len - offset < chunk_size ? total_len - offset : chunk_size;
+  if (n != expected_n)
+    return;
+
+  struct ChunkTransfer *done = NULL;
+  uint32_t received = 0;
+
+  z_mutex_lock(z_loan_mut(asm_->mutex));
+  chunk_evict_stale(asm_);
+  struct ChunkTransfer *t =
+      chunk_find_or_create(asm_, id, total_len, chunk_size, count);
+  if (t != NULL && !(t->seen[index / 8] & (1u << (index % 8)))) {
+    // Read straight into the object buffer; a corrupt chunk is simply left
+    // unmarked and will be overwritten by a retransmission, if any.
+    uint8_t *dst = t->data + offset;
+    if (z_bytes_reader_read(&reader, dst, n) == n &&
+        compute_crc32(dst, n) == crc) {
+      t->seen[index / 8] |= (uint8_t)(1u << (index % 8));
+      t->received++;
+      t->last_seen = z_clock_now();
+      received = t->received;
+
+      if (t->received == t->count) {
+        // Unlink; the callback runs outside the lock
+        struct ChunkTransfer **link = &asm_->transfers;
+        while (*link != t)
+          link = &(*link)->next;
+        *link = t->next;
+        asm_->in_flight--;
+        asm_->in_flight_bytes -= t->footprint;
+        asm_->completed[asm_->completed_next] = id;
+        asm_->completed_next =
+            (asm_->completed_next + 1) % CHUNK_RECENT_COMPLETED;
+        done = t;
+      }
+    }
+  }
+  z_mutex_unlock(z_loan_mut(asm_->mutex));
+
+  if (received > 0 && asm_->progress_callback != NULL)
+    asm_->progress_callback(id, received, count, asm_->context);
+
+  if (done != NULL) {
+    char *key = copy_sample_key(sample);
+    uint8_t *data = NULL;
+    size_t len = done->len;
+    if (key != NULL && len > 0) {
+      // Hand the reassembled buffer over as-is, no extra copy
+      data = done->data;
+      done->data = NULL;
+    }
+    chunk_transfer_free(done);
+    if (key == NULL)
+      return;
+
+    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+    asm_->callback(key, data, len, id, asm_->context);
+  }
+}
+
+// Runs once the subscriber closure is gone, so no handler can still be
+// touching the in-flight transfers.
+static void drop_chunk_assembler(void *arg) {
+  struct ChunkAssembler *asm_ = (struct ChunkAssembler *)arg;
+  if (asm_ == NULL)
     return;
 
+  while (asm_->transfers != NULL) {
+    struct ChunkTransfer *t = asm_->transfers;
+    asm_->transfers = t->next;
+    chunk_transfer_free(t);
+  }
+  z_drop(z_move(asm_->mutex));
+  free(asm_);
+}
+
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_chunked_subscriber(
+    ZenohSession *session, const char *key, ZenohChunkedCallback callback,
+    ZenohChunkProgressCallback progress_callback, size_t max_object_size,
+    uint64_t timeout_ms, void *context) {
+  if (session == NULL || key == NULL || callback == NULL)
+    return NULL;
+
   z_view_keyexpr_t keyexpr;
   if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
-    return;
+    return NULL;
+
+  ZenohSubscriber *sub = (ZenohSubscriber *)calloc(1, sizeof(ZenohSubscriber));
+  if (sub == NULL)
+    return NULL;
+
+  struct ChunkAssembler *asm_ =
+      (struct ChunkAssembler *)calloc(1, sizeof(struct ChunkAssembler));
+  if (asm_ == NULL || z_mutex_init(&asm_->mutex) < 0) {
+    free(asm_);
+    free(sub);
+    return NULL;
+  }
+  asm_->callback = callback;
+  asm_->progress_callback = progress_callback;
+  asm_->max_object_size =
+      max_object_size > 0 ? max_object_size : CHUNK_DEFAULT_MAX_OBJECT_SIZE;
+  // Always leaves room for one object of the maximum size
+  size_t seen_max = CHUNK_MAX_COUNT / 8;
+  if (asm_->max_object_size > SIZE_MAX - seen_max)
+    asm_->max_in_flight_bytes = SIZE_MAX;
+  else if (asm_->max_object_size + seen_max > CHUNK_MAX_IN_FLIGHT_BYTES)
+    asm_->max_in_flight_bytes = asm_->max_object_size + seen_max;
+  else
+    asm_->max_in_flight_bytes = CHUNK_MAX_IN_FLIGHT_BYTES;
+  asm_->timeout_ms = timeout_ms > 0 ? timeout_ms : CHUNK_DEFAULT_TIMEOUT_MS;
+  asm_->context = context;
+
+  sub->callback = NULL;
+  sub->callback_ex = NULL;
+  sub->context = context;
+  sub->is_liveliness = false;
+  sub->liveliness_callback = NULL;
+  sub->shm_callback = NULL;
+  sub->stats = NULL;
+
+  z_subscriber_options_t options;
+  z_subscriber_options_default(&options);
+
+  z_owned_closure_sample_t closure;
+  z_closure_sample(&closure, chunked_sample_handler, drop_chunk_assembler,
+                   asm_);
+
+  if (z_declare_subscriber(z_loan(session->session), &sub->subscriber,
+                           z_loan(keyexpr), z_move(closure), &options) < 0) {
+    // The failed declaration already dropped the closure (and assembler)
+    free(sub);
+    return NULL;
+  }
+
+  return sub;
+}
+
+// ============================================================================
+// Ad-hoc Operations
+// ============================================================================
+
+FFI_PLUGIN_EXPORT int zenoh_put(ZenohSession *session, const char *key,
+                                const uint8_t *data, size_t len) {
+  if (session == NULL || key == NULL)
+    return -1;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0) {
+    printf("[zenoh_ffi] zenoh_put: invalid keyexpr '%s'\n", key);
+    return -1;
+  }
+
+  z_put_options_t options;
+  z_put_options_default(&options);
+
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_buf(&payload, data, len);
+
+  thread_mark_caller();
+  int rc = z_put(z_loan(session->session), z_loan(keyexpr), z_move(payload),
+               &options);
+  printf("[zenoh_ffi] zenoh_put('%s', %zu bytes) -> rc=%d\n", key, len, rc);
+  stats_record_put(session->stats, len, rc);
+  return rc;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_put_with_options(ZenohSession *session,
+                                             const char *key,
+                                             const uint8_t *data, size_t len,
+                                             ZenohPutOptions *opts) {
+  if (session == NULL || key == NULL)
+    return -1;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return -1;
+
+  z_put_options_t options;
+  z_put_options_default(&options);
+
+  if (opts != NULL) {
+    options.priority = convert_priority(opts->priority);
+    options.congestion_control = convert_congestion_control(opts->congestion_control);
+    options.is_express = opts->is_express;
+
+    // Set encoding
+    z_owned_encoding_t encoding;
+    z_encoding_clone(&encoding, get_encoding(opts->encoding));
+    options.encoding = z_encoding_move(&encoding);
+
+    // Set attachment
+    if (opts->attachment != NULL && opts->attachment_len > 0) {
+      z_owned_bytes_t attachment;
+      z_bytes_copy_from_buf(&attachment, opts->attachment, opts->attachment_len);
+      options.attachment = z_bytes_move(&attachment);
+    }
+  }
+
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_buf(&payload, data, len);
+
+  thread_mark_caller();
+  int rc = z_put(z_loan(session->session), z_loan(keyexpr), z_move(payload),
+                 &options);
+  stats_record_put(session->stats, len, rc);
+  return rc;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_delete(ZenohSession *session, const char *key) {
+  if (session == NULL || key == NULL)
+    return -1;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return -1;
+
+  z_delete_options_t options;
+  z_delete_options_default(&options);
+
+  thread_mark_caller();
+  return z_delete(z_loan(session->session), z_loan(keyexpr), &options);
+}
+
+// ============================================================================
+// Query (Get)
+// ============================================================================
+
+// Byte-wise key order, shared with storages so cursors agree
+static int key_cmp(const char *a, size_t a_len, const char *b) {
+  size_t b_len = strlen(b);
+  int c = memcmp(a, b, a_len < b_len ? a_len : b_len);
+  if (c != 0)
+    return c;
+  return a_len < b_len ? -1 : (a_len > b_len ? 1 : 0);
+}
+
+// Applies the limit and cursor before anything is copied. Error replies are
+// always delivered.
+static bool get_page_admit(struct GetContext *ctx,
+                           const z_loaned_reply_t *reply) {
+  if (!ctx->paged || !z_reply_is_ok(reply))
+    return true;
+
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(z_reply_ok(reply)), &key_str);
+  const char *key = z_string_data(z_loan(key_str));
+  size_t key_len = z_string_len(z_loan(key_str));
+  if (ctx->after != NULL && key_cmp(key, key_len, ctx->after) <= 0)
+    return false;
+
+  bool admit = true;
+  z_mutex_lock(z_loan_mut(ctx->page_mutex));
+  if (ctx->limit > 0 && ctx->delivered >= ctx->limit) {
+    ctx->more = true;
+    admit = false;
+  } else {
+    ctx->delivered++;
+    if (ctx->last_key == NULL ||
+        key_cmp(key, key_len, ctx->last_key) > 0) {
+      char *copy = (char *)realloc(ctx->last_key, key_len + 1);
+      if (copy != NULL) {
+        memcpy(copy, key, key_len);
+        copy[key_len] = '\0';
+        ctx->last_key = copy;
+      }
+    }
+  }
+  z_mutex_unlock(z_loan_mut(ctx->page_mutex));
+  return admit;
+}
+
+static void get_reply_handler(struct z_loaned_reply_t *reply, void *arg) {
+  thread_enter_delivery();
+  struct GetContext *ctx = (struct GetContext *)arg;
+  if (ctx == NULL || ctx->callback == NULL || !get_page_admit(ctx, reply))
+    return;
+
+  if (z_reply_is_ok(reply)) {
+    const z_loaned_sample_t *sample = z_reply_ok(reply);
+
+    // Key - null-terminated copy
+    z_view_string_t key_str;
+    z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+    size_t key_len = z_string_len(z_loan(key_str));
+    char *key = (char *)malloc(key_len + 1);
+    if (key == NULL) return;
+    memcpy(key, z_string_data(z_loan(key_str)), key_len);
+    key[key_len] = '\0';
+
+    // Payload
+    const z_loaned_bytes_t *payload = z_sample_payload(sample);
+    z_owned_string_t payload_string;
+    size_t len = 0;
+    uint8_t *data = NULL;
+    if (z_bytes_to_string(payload, &payload_string) == 0) {
+      len = z_string_len(z_loan(payload_string));
+      data = (uint8_t *)malloc(len);
+      if (data != NULL) {
+        memcpy(data, z_string_data(z_loan(payload_string)), len);
+      }
+      z_drop(z_move(payload_string));
+    } else {
+      data = get_bytes_data(payload, &len);
+    }
+
+    // Kind - heap copy (Dart will free)
+    const char *kind_literal = (z_sample_kind(sample) == Z_SAMPLE_KIND_DELETE) ? "DELETE" : "PUT";
+    size_t kind_len = strlen(kind_literal);
+    char *kind_str = (char *)malloc(kind_len + 1);
+    if (kind_str == NULL) { free(key); free(data); return; }
+    memcpy(kind_str, kind_literal, kind_len + 1);
+
+    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+    ctx->callback(key, data, len, kind_str, ctx->user_context);
+  }
+}
+
+// Heap copy of an encoding's string form (Dart will free)
+static char *copy_encoding_string(const z_loaned_encoding_t *enc) {
+  z_owned_string_t enc_str;
+  z_encoding_to_string(enc, &enc_str);
+  size_t enc_len = z_string_len(z_loan(enc_str));
+  char *encoding = (char *)malloc(enc_len + 1);
+  if (encoding != NULL) {
+    memcpy(encoding, z_string_data(z_loan(enc_str)), enc_len);
+    encoding[enc_len] = '\0';
+  }
+  z_drop(z_move(enc_str));
+  return encoding;
+}
+
+// Heap copies of a reply's fields, handed to Dart which frees them
+struct ReplyCopy {
+  char *key;
+  uint8_t *data;
+  size_t len;
+  int kind;
+  char *encoding;
+  uint8_t *attachment;
+  size_t attachment_len;
+  uint64_t timestamp;
+  char *replier_id;
+};
+
+static bool copy_reply(const z_loaned_reply_t *reply, struct ReplyCopy *out) {
+  const z_loaned_bytes_t *payload;
+  const z_loaned_encoding_t *enc;
+  const z_loaned_bytes_t *attachment_bytes = NULL;
+
+  memset(out, 0, sizeof(*out));
+  if (z_reply_is_ok(reply)) {
+    const z_loaned_sample_t *sample = z_reply_ok(reply);
+
+    z_view_string_t key_str;
+    z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+    size_t key_len = z_string_len(z_loan(key_str));
+    out->key = (char *)malloc(key_len + 1);
+    if (out->key == NULL) return false;
+    memcpy(out->key, z_string_data(z_loan(key_str)), key_len);
+    out->key[key_len] = '\0';
+
+    out->kind = (z_sample_kind(sample) == Z_SAMPLE_KIND_DELETE)
+                    ? ZENOH_REPLY_KIND_DELETE
+                    : ZENOH_REPLY_KIND_PUT;
+    payload = z_sample_payload(sample);
+    enc = z_sample_encoding(sample);
+    attachment_bytes = z_sample_attachment(sample);
+
+    const z_timestamp_t *ts = z_sample_timestamp(sample);
+    if (ts != NULL)
+      out->timestamp = z_timestamp_ntp64_time(ts);
+  } else {
+    const z_loaned_reply_err_t *err = z_reply_err(reply);
+    if (err == NULL) return false;
+    out->kind = ZENOH_REPLY_KIND_ERROR;
+    payload = z_reply_err_payload(err);
+    enc = z_reply_err_encoding(err);
+  }
+
+  out->encoding = copy_encoding_string(enc);
+  if (out->encoding == NULL) { free(out->key); return false; }
+
+  out->data = get_bytes_data(payload, &out->len);
+  out->attachment = get_bytes_data(attachment_bytes, &out->attachment_len);
+
+#if ZENOH_FFI_HAS_UNSTABLE
+  z_entity_global_id_t gid;
+  if (z_reply_replier_id(reply, &gid)) {
+    z_id_t zid = z_entity_global_id_zid(&gid);
+    out->replier_id = copy_zid_string(&zid);
+  }
+#endif
+  return true;
+}
+
+static void reply_copy_free(struct ReplyCopy *r) {
+  free(r->key);
+  free(r->data);
+  free(r->encoding);
+  free(r->attachment);
+  free(r->replier_id);
+}
+
+static void get_page_swap(struct GetContext *ctx, size_t a, size_t b) {
+  struct ReplyCopy tmp = ctx->page[a];
+  ctx->page[a] = ctx->page[b];
+  ctx->page[b] = tmp;
+}
+
+// Keeps reply in the page if its key is among the smallest `limit` after the
+// cursor, evicting the greatest held key when the page is full
+static void get_page_hold(struct GetContext *ctx,
+                          const z_loaned_reply_t *reply) {
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(z_reply_ok(reply)), &key_str);
+  const char *key = z_string_data(z_loan(key_str));
+  size_t key_len = z_string_len(z_loan(key_str));
+  if (ctx->after != NULL && key_cmp(key, key_len, ctx->after) <= 0)
+    return;
+
+  z_mutex_lock(z_loan_mut(ctx->page_mutex));
+  bool full = ctx->page_count == ctx->limit;
+  if (full && key_cmp(key, key_len, ctx->page[0].key) >= 0) {
+    ctx->more = true;
+    z_mutex_unlock(z_loan_mut(ctx->page_mutex));
+    return;
+  }
+  if (!full && ctx->page_count == ctx->page_cap) {
+    size_t cap = ctx->page_cap > 0 ? ctx->page_cap * 2 : 16;
+    if (cap > ctx->limit)
+      cap = ctx->limit;
+    struct ReplyCopy *page =
+        (struct ReplyCopy *)realloc(ctx->page, cap * sizeof(struct ReplyCopy));
+    if (page == NULL) {
+      z_mutex_unlock(z_loan_mut(ctx->page_mutex));
+      return;
+    }
+    ctx->page = page;
+    ctx->page_cap = cap;
+  }
+
+  struct ReplyCopy r;
+  if (!copy_reply(reply, &r)) {
+    z_mutex_unlock(z_loan_mut(ctx->page_mutex));
+    return;
+  }
+
+  size_t i;
+  if (full) {
+    // Evict the greatest key and sift down
+    ctx->more = true;
+    reply_copy_free(&ctx->page[0]);
+    ctx->page[0] = r;
+    i = 0;
+    for (;;) {
+      size_t largest = i, l = 2 * i + 1, rt = 2 * i + 2;
+      if (l < ctx->page_count &&
+          strcmp(ctx->page[l].key, ctx->page[largest].key) > 0)
+        largest = l;
+      if (rt < ctx->page_count &&
+          strcmp(ctx->page[rt].key, ctx->page[largest].key) > 0)
+        largest = rt;
+      if (largest == i)
+        break;
+      get_page_swap(ctx, i, largest);
+      i = largest;
+    }
+  } else {
+    // Sift up
+    i = ctx->page_count++;
+    ctx->page[i] = r;
+    while (i > 0) {
+      size_t parent = (i - 1) / 2;
+      if (strcmp(ctx->page[i].key, ctx->page[parent].key) <= 0)
+        break;
+      get_page_swap(ctx, i, parent);
+      i = parent;
+    }
+  }
+  z_mutex_unlock(z_loan_mut(ctx->page_mutex));
+}
+
+static int reply_copy_cmp(const void *a, const void *b) {
+  return strcmp(((const struct ReplyCopy *)a)->key,
+                ((const struct ReplyCopy *)b)->key);
+}
+
+// Delivers the held page in key order; its greatest key is the cursor
+static void get_page_flush(struct GetContext *ctx) {
+  if (ctx->page_count == 0)
+    return;
+  qsort(ctx->page, ctx->page_count, sizeof(struct ReplyCopy), reply_copy_cmp);
+  const char *last = ctx->page[ctx->page_count - 1].key;
+  ctx->last_key = (char *)malloc(strlen(last) + 1);
+  if (ctx->last_key != NULL)
+    strcpy(ctx->last_key, last);
+
+  for (size_t i = 0; i < ctx->page_count; i++) {
+    struct ReplyCopy *r = &ctx->page[i];
+    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+    ctx->callback_ex(r->key, r->data, r->len, r->kind, r->encoding,
+                     r->attachment, r->attachment_len, r->timestamp,
+                     r->replier_id, ctx->user_context);
+  }
+  ctx->page_count = 0;
+}
+
+static void get_reply_handler_ex(struct z_loaned_reply_t *reply, void *arg) {
+  thread_enter_delivery();
+  struct GetContext *ctx = (struct GetContext *)arg;
+  if (ctx == NULL || ctx->callback_ex == NULL)
+    return;
+  if (ctx->paged && ctx->page_callback != NULL && ctx->limit > 0 &&
+      z_reply_is_ok(reply)) {
+    get_page_hold(ctx, reply);
+    return;
+  }
+  if (!get_page_admit(ctx, reply))
+    return;
+
+  struct ReplyCopy r;
+  if (!copy_reply(reply, &r))
+    return;
+
+  // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+  ctx->callback_ex(r.key, r.data, r.len, r.kind, r.encoding, r.attachment,
+                   r.attachment_len, r.timestamp, r.replier_id,
+                   ctx->user_context);
+}
+
+static void free_get_context(struct GetContext *ctx) {
+  if (ctx->paged) {
+    z_drop(z_move(ctx->page_mutex));
+    free(ctx->after);
+    free(ctx->last_key);
+    for (size_t i = 0; i < ctx->page_count; i++)
+      reply_copy_free(&ctx->page[i]);
+    free(ctx->page);
+  }
+  free(ctx);
+}
+
+static void drop_get_context(void *arg) {
+  struct GetContext *ctx = (struct GetContext *)arg;
+  if (ctx != NULL) {
+    if (ctx->page_callback != NULL) {
+      if (ctx->paged && ctx->callback_ex != NULL)
+        get_page_flush(ctx);
+      // DO NOT FREE - Dart will free the cursor
+      char *cursor = ctx->more ? ctx->last_key : NULL;
+      if (cursor != NULL)
+        ctx->last_key = NULL;
+      ctx->page_callback(cursor, ctx->user_context);
+    }
+    // Call completion callback if provided
+    if (ctx->complete_callback != NULL) {
+      ctx->complete_callback(ctx->user_context);
+    }
+    free_get_context(ctx);
+  }
+}
+
+// Percent-encodes the characters that end or split a selector parameter
+static size_t param_escape(const char *in, char *out) {
+  static const char hex[] = "0123456789ABCDEF";
+  size_t n = 0;
+  for (const unsigned char *p = (const unsigned char *)in; *p; p++) {
+    if (*p == '%' || *p == ';' || *p == '&' || *p == '=') {
+      if (out != NULL) {
+        out[n] = '%';
+        out[n + 1] = hex[*p >> 4];
+        out[n + 2] = hex[*p & 0xF];
+      }
+      n += 3;
+    } else {
+      if (out != NULL)
+        out[n] = (char)*p;
+      n++;
+    }
+  }
+  return n;
+}
+
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Heap copy of a percent-encoded parameter value
+static char *param_unescape(const char *in, size_t len) {
+  char *out = (char *)malloc(len + 1);
+  if (out == NULL)
+    return NULL;
+  size_t n = 0;
+  for (size_t i = 0; i < len; i++) {
+    int hi, lo;
+    if (in[i] == '%' && i + 2 < len && (hi = hex_digit(in[i + 1])) >= 0 &&
+        (lo = hex_digit(in[i + 2])) >= 0) {
+      out[n++] = (char)(hi << 4 | lo);
+      i += 2;
+    } else {
+      out[n++] = in[i];
+    }
+  }
+  out[n] = '\0';
+  return out;
+}
+
+// Adds `_limit` and `_cursor` to params so storages can page natively. The
+// limit asks for one extra reply, which tells whether another page follows.
+// Returns NULL when opts requests no paging.
+static char *page_params(const char *params, const ZenohGetOptions *opts) {
+  if (opts == NULL || (opts->limit == 0 && opts->cursor == NULL))
+    return NULL;
+
+  size_t params_len = strlen(params);
+  size_t cursor_len = opts->cursor != NULL ? param_escape(opts->cursor, NULL)
+                                           : 0;
+  char *out = (char *)malloc(params_len + cursor_len + 40);
+  if (out == NULL)
+    return NULL;
+
+  size_t n = 0;
+  memcpy(out, params, params_len);
+  n += params_len;
+  if (opts->limit > 0)
+    n += (size_t)sprintf(out + n, "%s_limit=%lu", n > 0 ? ";" : "",
+                         (unsigned long)opts->limit + 1);
+  if (opts->cursor != NULL) {
+    n += (size_t)sprintf(out + n, "%s_cursor=", n > 0 ? ";" : "");
+    n += param_escape(opts->cursor, out + n);
+  }
+  out[n] = '\0';
+  return out;
+}
+
+// Arms ctx's limit and cursor from opts. Returns false on failure.
+static bool get_page_init(struct GetContext *ctx, const ZenohGetOptions *opts) {
+  if (opts == NULL || (opts->limit == 0 && opts->cursor == NULL))
+    return true;
+  if (z_mutex_init(&ctx->page_mutex) < 0)
+    return false;
+  ctx->paged = true;
+  ctx->limit = opts->limit;
+  if (opts->cursor != NULL) {
+    ctx->after = (char *)malloc(strlen(opts->cursor) + 1);
+    if (ctx->after == NULL)
+      return false;
+    strcpy(ctx->after, opts->cursor);
+  }
+  return true;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_get_async(ZenohSession *session,
+                                      const char *selector,
+                                      ZenohGetCallback callback,
+                                      void *context) {
+  ZenohGetOptions opts;
+  zenoh_get_options_default(&opts);
+  return zenoh_get_async_with_options(session, selector, callback, NULL,
+                                      context, &opts);
+}
+
+// Splits "key/expr?parameters"; params points into selector
+static int split_selector(const char *selector, z_view_keyexpr_t *keyexpr,
+                          const char **params) {
+  const char *sep = strchr(selector, '?');
+  size_t key_len = sep != NULL ? (size_t)(sep - selector) : strlen(selector);
+  *params = sep != NULL ? sep + 1 : "";
+  return z_view_keyexpr_from_substr(keyexpr, selector, key_len);
+}
+
+// Owned values moved into z_get_options_t; must outlive the z_get call
+struct GetOptionValues {
+  z_owned_bytes_t payload;
+  z_owned_encoding_t encoding;
+  z_owned_bytes_t attachment;
+};
+
+// Fills zenoh get options. Payload and attachment are copied into values and
+// consumed by z_get, so this must be called once per query.
+static void build_get_options(const ZenohGetOptions *opts,
+                              struct GetOptionValues *values,
+                              z_get_options_t *options) {
+  z_get_options_default(options);
+
+  if (opts != NULL) {
+    options->timeout_ms = opts->timeout_ms;
+    options->priority = convert_priority(opts->priority);
+    options->congestion_control = convert_congestion_control(opts->congestion_control);
+    options->consolidation = convert_consolidation(opts->consolidation);
+    options->target = convert_query_target(opts->target);
+    options->allowed_destination = convert_locality(opts->allowed_destination);
+
+    // Set payload if provided
+    if (opts->payload != NULL && opts->payload_len > 0) {
+      z_bytes_copy_from_buf(&values->payload, opts->payload, opts->payload_len);
+      options->payload = z_bytes_move(&values->payload);
+
+      // Set encoding
+      z_encoding_clone(&values->encoding, get_encoding(opts->encoding));
+      options->encoding = z_encoding_move(&values->encoding);
+    }
+
+    // Set attachment
+    if (opts->attachment != NULL && opts->attachment_len > 0) {
+      z_bytes_copy_from_buf(&values->attachment, opts->attachment,
+                            opts->attachment_len);
+      options->attachment = z_bytes_move(&values->attachment);
+    }
+  }
+}
+
+// Issues the query; ctx is owned by the reply closure from here on. Returns
+// < 0, without calling any callback, if the query could not be issued.
+static int start_get(ZenohSession *session, const char *selector,
+                     struct GetContext *ctx,
+                     void (*handler)(struct z_loaned_reply_t *, void *),
+                     ZenohGetOptions *opts) {
+  z_view_keyexpr_t keyexpr;
+  const char *params;
+  if (split_selector(selector, &keyexpr, &params) < 0 ||
+      !get_page_init(ctx, opts)) {
+    free_get_context(ctx);
+    return -1;
+  }
+  char *paged_params = page_params(params, opts);
+
+  ctx->timeout_ms = opts ? opts->timeout_ms : 10000;
+
+  struct GetOptionValues values;
+  z_get_options_t options;
+  build_get_options(opts, &values, &options);
+
+  z_owned_closure_reply_t closure;
+  z_closure_reply(&closure, handler, drop_get_context, ctx);
+
+  // A failed z_get drops the closure, which still reports completion
+  thread_mark_caller();
+  z_get(z_loan(session->session), z_loan(keyexpr),
+        paged_params != NULL ? paged_params : params, z_move(closure),
+        &options);
+  free(paged_params);
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_get_async_with_options(
+    ZenohSession *session, const char *selector, ZenohGetCallback callback,
+    ZenohGetCompleteCallback complete_callback, void *context,
+    ZenohGetOptions *opts) {
+  if (session == NULL || selector == NULL)
+    return -1;
+
+  struct GetContext *ctx =
+      (struct GetContext *)calloc(1, sizeof(struct GetContext));
+  if (ctx == NULL)
+    return -1;
+
+  ctx->callback = callback;
+  ctx->callback_ex = NULL;
+  ctx->complete_callback = complete_callback;
+  ctx->user_context = context;
+
+  return start_get(session, selector, ctx, get_reply_handler, opts);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_get_async_ex(
+    ZenohSession *session, const char *selector, ZenohGetCallbackEx callback,
+    ZenohGetCompleteCallback complete_callback, void *context,
+    ZenohGetOptions *opts) {
+  if (session == NULL || selector == NULL)
+    return -1;
+
+  struct GetContext *ctx =
+      (struct GetContext *)calloc(1, sizeof(struct GetContext));
+  if (ctx == NULL)
+    return -1;
+
+  ctx->callback = NULL;
+  ctx->callback_ex = callback;
+  ctx->complete_callback = complete_callback;
+  ctx->user_context = context;
+
+  return start_get(session, selector, ctx, get_reply_handler_ex, opts);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_get_async_paged(
+    ZenohSession *session, const char *selector, ZenohGetCallbackEx callback,
+    ZenohGetPageCallback page_callback, void *context,
+    ZenohGetOptions *opts) {
+  if (session == NULL || selector == NULL)
+    return -1;
+
+  struct GetContext *ctx =
+      (struct GetContext *)calloc(1, sizeof(struct GetContext));
+  if (ctx == NULL)
+    return -1;
+
+  ctx->callback_ex = callback;
+  ctx->page_callback = page_callback;
+  ctx->user_context = context;
+
+  return start_get(session, selector, ctx, get_reply_handler_ex, opts);
+}
+
+// ============================================================================
+// Multi-selector Query
+// ============================================================================
+//
+// Issues one query per selector under a single deadline. Each reply closure
+// holds a slot pointing back at the shared context; the last closure to be
+// dropped frees it. Completion fires once, when every query is done or when
+// the quorum of data replies has been delivered, whichever comes first.
+
+struct MultiGetContext;
+
+struct MultiGetSlot {
+  struct MultiGetContext *multi;
+  size_t index;
+};
+
+struct MultiGetContext {
+  ZenohGetMultiCallback callback;
+  ZenohGetCompleteCallback complete_callback;
+  void *user_context;
+  z_owned_mutex_t mutex;
+  size_t pending;  // Queries not yet dropped, plus one while issuing
+  size_t quorum;   // 0 = deliver everything
+  size_t replies;  // Data replies delivered so far
+  bool completed;
+  struct MultiGetSlot slots[];
+};
+
+// Must be called with the multi-get mutex held
+static void multi_get_complete(struct MultiGetContext *multi) {
+  if (multi->completed)
+    return;
+  multi->completed = true;
+  if (multi->complete_callback != NULL)
+    multi->complete_callback(multi->user_context);
+}
+
+// Drops one reference; returns true once the context has been freed
+static bool multi_get_release(struct MultiGetContext *multi) {
+  z_mutex_lock(z_loan_mut(multi->mutex));
+  bool last = --multi->pending == 0;
+  if (last)
+    multi_get_complete(multi);
+  z_mutex_unlock(z_loan_mut(multi->mutex));
+
+  if (last) {
+    z_drop(z_move(multi->mutex));
+    free(multi);
+  }
+  return last;
+}
+
+static void multi_get_reply_handler(struct z_loaned_reply_t *reply,
+                                    void *arg) {
+  thread_enter_delivery();
+  struct MultiGetSlot *slot = (struct MultiGetSlot *)arg;
+  struct MultiGetContext *multi = slot->multi;
+
+  // Replies are delivered under the lock so the completion can never
+  // overtake a reply counted towards the quorum
+  z_mutex_lock(z_loan_mut(multi->mutex));
+  struct ReplyCopy r;
+  if (!multi->completed && copy_reply(reply, &r)) {
+    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+    multi->callback(slot->index, r.key, r.data, r.len, r.kind, r.encoding,
+                    r.attachment, r.attachment_len, r.timestamp, r.replier_id,
+                    multi->user_context);
+    if (r.kind != ZENOH_REPLY_KIND_ERROR && multi->quorum > 0 &&
+        ++multi->replies >= multi->quorum)
+      multi_get_complete(multi);
+  }
+  z_mutex_unlock(z_loan_mut(multi->mutex));
+}
+
+static void drop_multi_get_slot(void *arg) {
+  struct MultiGetSlot *slot = (struct MultiGetSlot *)arg;
+  multi_get_release(slot->multi);
+}
+
+FFI_PLUGIN_EXPORT void zenoh_get_multi(
+    ZenohSession *session, const char *const *selectors, size_t count,
+    ZenohGetOptions *opts, size_t quorum, ZenohGetMultiCallback callback,
+    ZenohGetCompleteCallback complete_callback, void *context) {
+  if (session == NULL || (selectors == NULL && count > 0) ||
+      callback == NULL)
+    return;
+
+  struct MultiGetContext *multi = (struct MultiGetContext *)calloc(
+      1, sizeof(struct MultiGetContext) + count * sizeof(struct MultiGetSlot));
+  if (multi == NULL)
+    return;
+  if (z_mutex_init(&multi->mutex) != 0) {
+    free(multi);
+    return;
+  }
+  multi->callback = callback;
+  multi->complete_callback = complete_callback;
+  multi->user_context = context;
+  multi->quorum = quorum;
+  multi->pending = count + 1;
+
+  // Every query times out at the same instant, however long issuing takes
+  uint64_t timeout_ms = opts != NULL ? opts->timeout_ms : 10000;
+  z_clock_t start = z_clock_now();
+
+  for (size_t i = 0; i < count; i++) {
+    struct MultiGetSlot *slot = &multi->slots[i];
+    slot->multi = multi;
+    slot->index = i;
+
+    z_view_keyexpr_t keyexpr;
+    const char *params;
+    if (selectors[i] == NULL ||
+        split_selector(selectors[i], &keyexpr, &params) < 0) {
+      multi_get_release(multi);
+      continue;
+    }
+
+    struct GetOptionValues values;
+    z_get_options_t options;
+    build_get_options(opts, &values, &options);
+    if (timeout_ms > 0) {
+      uint64_t elapsed = z_clock_elapsed_ms(&start);
+      options.timeout_ms = elapsed < timeout_ms ? timeout_ms - elapsed : 1;
+    }
+
+    z_owned_closure_reply_t closure;
+    z_closure_reply(&closure, multi_get_reply_handler, drop_multi_get_slot,
+                    slot);
+    thread_mark_caller();
+    z_get(z_loan(session->session), z_loan(keyexpr), params, z_move(closure),
+          &options);
+  }
+
+  multi_get_release(multi);
+}
+
+// ============================================================================
+// Reply Channel
+// ============================================================================
+//
+// Replies are queued in a zenoh channel instead of being pushed to Dart, and
+// pulled in batches. A FIFO channel blocks the delivering zenoh thread when
+// full, pushing back on the network; a ring channel drops the oldest reply.
+// Batches are copied into an arena owned by the channel, so a receive costs
+// no allocation once the arena has grown to the batch size.
+
+#define ARENA_NONE SIZE_MAX
+
+// Reserves len bytes in the arena; returns their offset or ARENA_NONE
+static size_t reply_arena_reserve(ZenohReplyChannel *ch, size_t len) {
+  if (ch->arena_len + len > ch->arena_cap) {
+    size_t cap = ch->arena_cap > 0 ? ch->arena_cap : 4096;
+    while (cap < ch->arena_len + len)
+      cap *= 2;
+    uint8_t *arena = (uint8_t *)realloc(ch->arena, cap);
+    if (arena == NULL)
+      return ARENA_NONE;
+    ch->arena = arena;
+    ch->arena_cap = cap;
+  }
+  size_t offset = ch->arena_len;
+  ch->arena_len += len;
+  return offset;
+}
+
+static size_t reply_arena_bytes(ZenohReplyChannel *ch,
+                                const z_loaned_bytes_t *bytes, size_t *len) {
+  *len = bytes != NULL ? z_bytes_len(bytes) : 0;
+  if (*len == 0)
+    return ARENA_NONE;
+  size_t offset = reply_arena_reserve(ch, *len);
+  if (offset == ARENA_NONE) {
+    *len = 0;
+    return ARENA_NONE;
+  }
+  z_bytes_reader_t reader = z_bytes_get_reader(bytes);
+  z_bytes_reader_read(&reader, ch->arena + offset, *len);
+  return offset;
+}
+
+static size_t reply_arena_string(ZenohReplyChannel *ch, const char *str,
+                                 size_t len) {
+  size_t offset = reply_arena_reserve(ch, len + 1);
+  if (offset != ARENA_NONE) {
+    memcpy(ch->arena + offset, str, len);
+    ch->arena[offset + len] = '\0';
+  }
+  return offset;
+}
+
+// Arena offsets of a record, turned into pointers once the batch is complete
+struct ReplyRecordOffsets {
+  size_t key;
+  size_t payload;
+  size_t encoding;
+  size_t attachment;
+  size_t replier_id;
+};
+
+// Copies reply into the arena. Returns false if it cannot be represented.
+static bool reply_channel_copy(ZenohReplyChannel *ch,
+                               const z_loaned_reply_t *reply,
+                               ZenohReplyRecord *rec,
+                               struct ReplyRecordOffsets *off) {
+  const z_loaned_bytes_t *payload;
+  const z_loaned_encoding_t *enc;
+  const z_loaned_bytes_t *attachment = NULL;
+
+  memset(rec, 0, sizeof(*rec));
+  off->key = off->replier_id = ARENA_NONE;
+  if (z_reply_is_ok(reply)) {
+    const z_loaned_sample_t *sample = z_reply_ok(reply);
+    z_view_string_t key_str;
+    z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+    off->key = reply_arena_string(ch, z_string_data(z_loan(key_str)),
+                                  z_string_len(z_loan(key_str)));
+    if (off->key == ARENA_NONE)
+      return false;
+    rec->reply_kind = (z_sample_kind(sample) == Z_SAMPLE_KIND_DELETE)
+                          ? ZENOH_REPLY_KIND_DELETE
+                          : ZENOH_REPLY_KIND_PUT;
+    payload = z_sample_payload(sample);
+    enc = z_sample_encoding(sample);
+    attachment = z_sample_attachment(sample);
+    const z_timestamp_t *ts = z_sample_timestamp(sample);
+    if (ts != NULL)
+      rec->timestamp = z_timestamp_ntp64_time(ts);
+  } else {
+    const z_loaned_reply_err_t *err = z_reply_err(reply);
+    if (err == NULL)
+      return false;
+    rec->reply_kind = ZENOH_REPLY_KIND_ERROR;
+    payload = z_reply_err_payload(err);
+    enc = z_reply_err_encoding(err);
+  }
+
+  z_owned_string_t enc_str;
+  z_encoding_to_string(enc, &enc_str);
+  off->encoding = reply_arena_string(ch, z_string_data(z_loan(enc_str)),
+                                     z_string_len(z_loan(enc_str)));
+  z_drop(z_move(enc_str));
+  if (off->encoding == ARENA_NONE)
+    return false;
+
+  off->payload = reply_arena_bytes(ch, payload, &rec->payload_len);
+  off->attachment = reply_arena_bytes(ch, attachment, &rec->attachment_len);
+
+#if ZENOH_FFI_HAS_UNSTABLE
+  z_entity_global_id_t gid;
+  if (z_reply_replier_id(reply, &gid)) {
+    z_id_t zid = z_entity_global_id_zid(&gid);
+    off->replier_id = reply_arena_reserve(ch, ZID_STRING_SIZE);
+    if (off->replier_id != ARENA_NONE)
+      format_zid(&zid, (char *)ch->arena + off->replier_id);
+  }
+#endif
+  return true;
+}
+
+FFI_PLUGIN_EXPORT ZenohReplyChannel *
+zenoh_get_channel(ZenohSession *session, const char *selector,
+                  ZenohGetOptions *opts, ZenohReplyChannelKind kind,
+                  size_t capacity) {
+  if (session == NULL || selector == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  const char *params;
+  if (split_selector(selector, &keyexpr, &params) < 0)
+    return NULL;
+
+  ZenohReplyChannel *ch =
+      (ZenohReplyChannel *)calloc(1, sizeof(ZenohReplyChannel));
+  if (ch == NULL)
+    return NULL;
+  ch->ring = kind == ZENOH_REPLY_CHANNEL_RING;
+  if (capacity == 0)
+    capacity = 256;
+
+  z_owned_closure_reply_t closure;
+  if (ch->ring)
+    z_ring_channel_reply_new(&closure, &ch->ring_handler, capacity);
+  else
+    z_fifo_channel_reply_new(&closure, &ch->fifo, capacity);
+
+  struct GetOptionValues values;
+  z_get_options_t options;
+  build_get_options(opts, &values, &options);
+
+  thread_mark_caller();
+  if (z_get(z_loan(session->session), z_loan(keyexpr), params,
+            z_move(closure), &options) != Z_OK) {
+    zenoh_reply_channel_close(ch);
+    return NULL;
+  }
+  return ch;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_reply_try_recv_batch(ZenohReplyChannel *channel,
+                                                 ZenohReplyRecord *out,
+                                                 size_t max) {
+  if (channel == NULL || out == NULL)
+    return -1;
+  if (channel->closed)
+    return -1;
+
+  struct ReplyRecordOffsets offsets[64];
+  if (max > 64)
+    max = 64;
+
+  channel->arena_len = 0;
+  size_t n = 0;
+  while (n < max) {
+    z_owned_reply_t reply;
+    z_result_t res =
+        channel->ring
+            ? z_ring_handler_reply_try_recv(z_loan(channel->ring_handler),
+                                            &reply)
+            : z_fifo_handler_reply_try_recv(z_loan(channel->fifo), &reply);
+    if (res != Z_OK) {
+      if (res == Z_CHANNEL_DISCONNECTED)
+        channel->closed = true;
+      break;
+    }
+    bool copied = reply_channel_copy(channel, z_loan(reply), &out[n],
+                                     &offsets[n]);
+    z_drop(z_move(reply));
+    if (copied)
+      n++;
+  }
+
+  // The arena may have moved while growing, so pointers are set last
+  for (size_t i = 0; i < n; i++) {
+    ZenohReplyRecord *rec = &out[i];
+    struct ReplyRecordOffsets *off = &offsets[i];
+    rec->key = off->key != ARENA_NONE
+                   ? (const char *)channel->arena + off->key : NULL;
+    rec->encoding = (const char *)channel->arena + off->encoding;
+    rec->payload = off->payload != ARENA_NONE
+                       ? channel->arena + off->payload : NULL;
+    rec->attachment = off->attachment != ARENA_NONE
+                          ? channel->arena + off->attachment : NULL;
+    rec->replier_id = off->replier_id != ARENA_NONE
+                          ? (const char *)channel->arena + off->replier_id
+                          : NULL;
+  }
+
+  if (n == 0 && channel->closed)
+    return -1;
+  return (int)n;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_reply_channel_close(ZenohReplyChannel *channel) {
+  if (channel == NULL)
+    return;
+  if (channel->ring)
+    z_drop(z_move(channel->ring_handler));
+  else
+    z_drop(z_move(channel->fifo));
+  free(channel->arena);
+  free(channel);
+}
+
+// ============================================================================
+// Querier
+// ============================================================================
+
+FFI_PLUGIN_EXPORT ZenohQuerier *
+zenoh_declare_querier(ZenohSession *session, const char *key,
+                      ZenohQuerierOptions *opts) {
+  if (session == NULL || key == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return NULL;
+
+  ZenohQuerier *querier = (ZenohQuerier *)malloc(sizeof(ZenohQuerier));
+  if (querier == NULL)
+    return NULL;
+  querier->has_matching_listener = false;
+
+  z_querier_options_t options;
+  z_querier_options_default(&options);
+
+  if (opts != NULL) {
+    options.timeout_ms = opts->timeout_ms;
+    options.priority = convert_priority(opts->priority);
+    options.congestion_control =
+        convert_congestion_control(opts->congestion_control);
+    options.is_express = opts->is_express;
+    options.consolidation = convert_consolidation(opts->consolidation);
+    options.target = convert_query_target(opts->target);
+    options.allowed_destination = convert_locality(opts->allowed_destination);
+  }
+
+  if (z_declare_querier(z_loan(session->session), &querier->querier,
+                        z_loan(keyexpr), &options) < 0) {
+    free(querier);
+    return NULL;
+  }
+
+  return querier;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_querier_get(
+    ZenohQuerier *querier, const char *parameters, const uint8_t *payload,
+    size_t payload_len, ZenohEncodingId encoding, const uint8_t *attachment,
+    size_t attachment_len, ZenohGetCallback callback,
+    ZenohGetCompleteCallback complete_callback, void *context) {
+  if (querier == NULL)
+    return -1;
+
+  struct GetContext *ctx =
+      (struct GetContext *)calloc(1, sizeof(struct GetContext));
+  if (ctx == NULL)
+    return -1;
+
+  ctx->callback = callback;
+  ctx->callback_ex = NULL;
+  ctx->complete_callback = complete_callback;
+  ctx->user_context = context;
+  ctx->timeout_ms = 0; // Owned by the querier
+
+  z_querier_get_options_t options;
+  z_querier_get_options_default(&options);
+
+  // Set payload if provided
+  if (payload != NULL && payload_len > 0) {
+    z_owned_bytes_t bytes;
+    z_bytes_copy_from_buf(&bytes, payload, payload_len);
+    options.payload = z_bytes_move(&bytes);
+
+    z_owned_encoding_t enc;
+    z_encoding_clone(&enc, get_encoding(encoding));
+    options.encoding = z_encoding_move(&enc);
+  }
+
+  // Set attachment
+  if (attachment != NULL && attachment_len > 0) {
+    z_owned_bytes_t bytes;
+    z_bytes_copy_from_buf(&bytes, attachment, attachment_len);
+    options.attachment = z_bytes_move(&bytes);
+  }
+
+  z_owned_closure_reply_t closure;
+  z_closure_reply(&closure, get_reply_handler, drop_get_context, ctx);
+
+  // The closure (and its completion callback) is consumed even on failure
+  thread_mark_caller();
+  return z_querier_get(z_loan(querier->querier),
+                       parameters != NULL ? parameters : "", z_move(closure),
+                       &options);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_querier_get_matching_status(ZenohQuerier *querier) {
+  if (querier == NULL)
+    return -1;
+
+  z_matching_status_t status;
+  int rc = z_querier_get_matching_status(z_loan(querier->querier), &status);
+  if (rc < 0)
+    return rc;
+  return status.matching ? 1 : 0;
+}
+
+struct MatchingContext {
+  ZenohMatchingCallback callback;
+  void *user_context;
+};
+
+static void matching_status_handler(const z_matching_status_t *status,
+                                    void *arg) {
+  thread_enter_delivery();
+  struct MatchingContext *ctx = (struct MatchingContext *)arg;
+  if (ctx != NULL && ctx->callback != NULL)
+    ctx->callback(status->matching, ctx->user_context);
+}
+
+static void drop_matching_context(void *arg) { free(arg); }
+
+FFI_PLUGIN_EXPORT int zenoh_querier_declare_matching_listener(
+    ZenohQuerier *querier, ZenohMatchingCallback callback, void *context) {
+  if (querier == NULL || callback == NULL)
+    return -1;
+
+  struct MatchingContext *ctx =
+      (struct MatchingContext *)malloc(sizeof(struct MatchingContext));
+  if (ctx == NULL)
+    return -1;
+  ctx->callback = callback;
+  ctx->user_context = context;
+
+  if (querier->has_matching_listener) {
+    z_drop(z_move(querier->matching_listener));
+    querier->has_matching_listener = false;
+  }
+
+  z_owned_closure_matching_status_t closure;
+  z_closure_matching_status(&closure, matching_status_handler,
+                            drop_matching_context, ctx);
+
+  int rc = z_querier_declare_matching_listener(z_loan(querier->querier),
+                                               &querier->matching_listener,
+                                               z_move(closure));
+  if (rc == 0)
+    querier->has_matching_listener = true;
+  return rc;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_undeclare_querier(ZenohQuerier *querier) {
+  if (querier != NULL) {
+    if (querier->has_matching_listener)
+      z_drop(z_move(querier->matching_listener));
+    z_drop(z_move(querier->querier));
+    free(querier);
+  }
+}
+
+// ============================================================================
+// Queryable
+// ============================================================================
+
+static void query_handler(z_loaned_query_t *query, void *arg) {
+  thread_enter_delivery();
+  ZenohQueryable *q = (ZenohQueryable *)arg;
+  if (q == NULL || q->callback == NULL)
+    return;
+  if (q->stats != NULL)
+    stat_add(&q->stats->queries_served, 1);
+
+  // Get Key Selector - null-terminated copy
+  const z_loaned_keyexpr_t *keyexpr = z_query_keyexpr(query);
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(keyexpr, &key_str);
+  size_t key_len = z_string_len(z_loan(key_str));
+  char *key = (char *)malloc(key_len + 1);
+  if (key == NULL) return;
+  memcpy(key, z_string_data(z_loan(key_str)), key_len);
+  key[key_len] = '\0';
+
+  // Get Selector (parameters) - null-terminated copy
+  z_view_string_t selector_str;
+  z_query_parameters(query, &selector_str);
+  size_t sel_len = z_string_len(z_loan(selector_str));
+  char *selector = (char *)malloc(sel_len + 1);
+  if (selector == NULL) { free(key); return; }
+  memcpy(selector, z_string_data(z_loan(selector_str)), sel_len);
+  selector[sel_len] = '\0';
+
+  // Get Payload (Value)
+  const z_loaned_bytes_t *payload = z_query_payload(query);
+  size_t len = 0;
+  uint8_t *data = get_bytes_data(payload, &len);
+
+  const char *kind = "GET";
+
+  // Kind - heap copy (Dart will free)
+  size_t kind_len = strlen(kind);
+  char *kind_copy = (char *)malloc(kind_len + 1);
+  if (kind_copy == NULL) { free(key); free(selector); free(data); return; }
+  memcpy(kind_copy, kind, kind_len + 1);
+
+  // Take ownership so replies can outlive this callback; the query is
+  // finalized when Dart drops the last reference via zenoh_query_finalize.
+  ZenohQuery *owned = (ZenohQuery *)malloc(sizeof(ZenohQuery));
+  if (owned == NULL) {
+    free(key);
+    free(selector);
+    free(data);
+    free(kind_copy);
+    return;
+  }
+  z_query_take_from_loaned(&owned->query, query);
+  owned->refs = 1;
+
+  // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+  q->callback(key, selector, data, len, kind_copy, owned, q->context);
+}
+
+static void drop_queryable_wrapper(void *arg) {
+  // Cleanup if needed
+}
+
+FFI_PLUGIN_EXPORT ZenohQueryable *
+zenoh_declare_queryable(ZenohSession *session, const char *key_expr,
+                        ZenohQueryCallback callback, void *context) {
+  if (session == NULL || key_expr == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyopts;
+  if (z_view_keyexpr_from_str(&keyopts, key_expr) < 0)
+    return NULL;
+
+  ZenohQueryable *q = (ZenohQueryable *)malloc(sizeof(ZenohQueryable));
+  if (q == NULL)
+    return NULL;
+
+  q->callback = callback;
+  q->context = context;
+  q->stats = entity_stats_register(session, STATS_QUERYABLE);
+
+  z_queryable_options_t options;
+  z_queryable_options_default(&options);
+
+  z_owned_closure_query_t closure;
+  z_closure_query(&closure, query_handler, drop_queryable_wrapper, q);
+
+  if (z_declare_queryable(z_loan(session->session), &q->queryable,
+                          z_loan(keyopts), z_move(closure), &options) < 0) {
+    entity_stats_release(q->stats);
+    free(q);
+    return NULL;
+  }
+
+  return q;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_undeclare_queryable(ZenohQueryable *queryable) {
+  if (queryable != NULL) {
+    z_drop(z_move(queryable->queryable));
+    entity_stats_release(queryable->stats);
+    free(queryable);
+  }
+}
+
+FFI_PLUGIN_EXPORT int zenoh_query_reply(ZenohQuery *query, const char *key,
+                                        const uint8_t *data, size_t len) {
+  if (query == NULL || key == NULL)
+    return -1;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return -1;
+
+  z_query_reply_options_t options;
+  z_query_reply_options_default(&options);
+
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_buf(&payload, data, len);
+
+  return z_query_reply(z_loan(query->query), z_loan(keyexpr), z_move(payload),
+                       &options);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_query_reply_with_options(
+    ZenohQuery *query, const char *key, const uint8_t *data, size_t len,
+    ZenohEncodingId encoding, const uint8_t *attachment,
+    size_t attachment_len) {
+  if (query == NULL || key == NULL)
+    return -1;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return -1;
+
+  z_query_reply_options_t options;
+  z_query_reply_options_default(&options);
+
+  // Set encoding
+  z_owned_encoding_t enc;
+  z_encoding_clone(&enc, get_encoding(encoding));
+  options.encoding = z_encoding_move(&enc);
+
+  // Set attachment
+  if (attachment != NULL && attachment_len > 0) {
+    z_owned_bytes_t att;
+    z_bytes_copy_from_buf(&att, attachment, attachment_len);
+    options.attachment = z_bytes_move(&att);
+  }
+
+  z_owned_bytes_t payload;
+  z_bytes_copy_from_buf(&payload, data, len);
+
+  return z_query_reply(z_loan(query->query), z_loan(keyexpr), z_move(payload),
+                       &options);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_query_reply_batch(ZenohQuery *query,
+                                              const ZenohReplyItem *items,
+                                              size_t n) {
+  if (query == NULL || (items == NULL && n > 0))
+    return -1;
+
+  const z_loaned_query_t *loaned = z_loan(query->query);
+  for (size_t i = 0; i < n; i++) {
+    const ZenohReplyItem *item = &items[i];
+
+    z_view_keyexpr_t keyexpr;
+    if (item->key == NULL || z_view_keyexpr_from_str(&keyexpr, item->key) < 0)
+      return -1;
+
+    z_query_reply_options_t options;
+    z_query_reply_options_default(&options);
+
+    // Set encoding
+    z_owned_encoding_t enc;
+    z_encoding_clone(&enc, get_encoding(item->encoding));
+    options.encoding = z_encoding_move(&enc);
+
+    // Set attachment
+    if (item->attachment != NULL && item->attachment_len > 0) {
+      z_owned_bytes_t att;
+      z_bytes_copy_from_buf(&att, item->attachment, item->attachment_len);
+      options.attachment = z_bytes_move(&att);
+    }
+
+    z_owned_bytes_t payload;
+    z_bytes_copy_from_buf(&payload, item->payload, item->payload_len);
+
+    int rc = z_query_reply(loaned, z_loan(keyexpr), z_move(payload), &options);
+    if (rc < 0)
+      return rc;
+  }
+  return (int)n;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_query_reply_err(ZenohQuery *query,
+                                            const uint8_t *payload, size_t len,
+                                            ZenohEncodingId encoding) {
+  if (query == NULL)
+    return -1;
+
+  z_query_reply_err_options_t options;
+  z_query_reply_err_options_default(&options);
+
+  // Set encoding
+  z_owned_encoding_t enc;
+  z_encoding_clone(&enc, get_encoding(encoding));
+  options.encoding = z_encoding_move(&enc);
+
+  z_owned_bytes_t bytes;
+  z_bytes_copy_from_buf(&bytes, payload, len);
+
+  return z_query_reply_err(z_loan(query->query), z_move(bytes), &options);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_query_reply_del(ZenohQuery *query,
+                                            const char *key) {
+  if (query == NULL || key == NULL)
+    return -1;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
+    return -1;
+
+  z_query_reply_del_options_t options;
+  z_query_reply_del_options_default(&options);
+
+  return z_query_reply_del(z_loan(query->query), z_loan(keyexpr), &options);
+}
+
+// Finds name in a "a=1;b=2&c" parameter string
+static bool find_selector_param(const char *params, size_t params_len,
+                                const char *name, const char **value,
+                                size_t *value_len) {
+  size_t name_len = strlen(name);
+  const char *end = params + params_len;
+  const char *p = params;
+
+  while (p < end) {
+    const char *sep = p;
+    while (sep < end && *sep != ';' && *sep != '&')
+      sep++;
+
+    const char *eq = memchr(p, '=', (size_t)(sep - p));
+    const char *name_end = eq != NULL ? eq : sep;
+    if ((size_t)(name_end - p) == name_len && memcmp(p, name, name_len) == 0) {
+      *value = eq != NULL ? eq + 1 : sep;
+      *value_len = (size_t)(sep - *value);
+      return true;
+    }
+    p = sep + 1;
+  }
+  return false;
+}
+
+FFI_PLUGIN_EXPORT const char *zenoh_query_param_get(ZenohQuery *query,
+                                                    const char *name) {
+  if (query == NULL || name == NULL)
+    return NULL;
+
+  z_view_string_t params;
+  z_query_parameters(z_loan(query->query), &params);
+
+  const char *value;
+  size_t value_len;
+  if (!find_selector_param(z_string_data(z_loan(params)),
+                           z_string_len(z_loan(params)), name, &value,
+                           &value_len))
+    return NULL;
+
+  char *result = (char *)malloc(value_len + 1);
+  if (result == NULL)
+    return NULL;
+  memcpy(result, value, value_len);
+  result[value_len] = '\0';
+  return result;
+}
+
+FFI_PLUGIN_EXPORT ZenohQuery *zenoh_query_retain(ZenohQuery *query) {
+  if (query != NULL)
+    atomic_count_inc(&query->refs);
+  return query;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_query_finalize(ZenohQuery *query) {
+  if (query != NULL && atomic_count_dec(&query->refs) == 0) {
+    // Dropping the owned query sends the final reply marker to the querier
+    z_drop(z_move(query->query));
+    free(query);
+  }
+}
+
+// ============================================================================
+// RPC
+// ============================================================================
+//
+// Request/response calls over a querier and a queryable. The method travels
+// in the `method` selector parameter, and a correlation id in the request
+// attachment. Replies echo the id and add a status:
+//
+//   request attachment: u64 call id
+//   reply attachment:   u64 call id | u32 status
+//
+// Queries use no consolidation, so a reply is handed over as soon as it
+// arrives. Methods with a native handler are answered on the zenoh thread
+// without involving Dart; the others are forwarded to the server callback.
+
+#define RPC_REQUEST_ATTACHMENT_SIZE 8
+#define RPC_REPLY_ATTACHMENT_SIZE 12
+
+struct ZenohRpcResponse {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+};
+
+struct RpcMethod {
+  char *name;
+  ZenohRpcHandler handler; // NULL = forwarded to Dart
+  void *context;
+};
+
+struct ZenohRpcServer {
+  z_owned_queryable_t queryable;
+  z_owned_mutex_t mutex; // Guards the method table
+  atomic_count_t refs;   // User handle plus the query closure
+  struct RpcMethod *methods; // Sorted by name
+  size_t method_count;
+  size_t method_cap;
+  ZenohRpcRequestCallback callback;
+  void *context;
+};
+
+struct ZenohRpcClient {
+  z_owned_querier_t querier;
+  ZenohSession *session; // Referenced, for attempts cut short by a deadline
+  z_owned_keyexpr_t keyexpr;
+  ZenohRpcClientOptions options;
+  atomic_count_t refs; // User handle plus in-flight calls
+  atomic_count_t next_id;
+  atomic_count_t closed;
+};
+
+struct RpcCall {
+  ZenohRpcClient *client;
+  uint64_t id;
+  char *parameters; // "method=<name>"
+  uint8_t *request;
+  size_t request_len;
+  uint32_t attempts_left;
+  uint64_t deadline_ms; // From start, 0 = none
+  z_clock_t start;
+  atomic_count_t answered; // Claimed by the first matching reply
+  atomic_count_t issuing;  // RPC_ISSUING while an attempt is being sent
+  ZenohRpcResponseCallback callback;
+  void *context;
+};
+
+FFI_PLUGIN_EXPORT int zenoh_rpc_response_write(ZenohRpcResponse *response,
+                                               const uint8_t *data,
+                                               size_t len) {
+  if (response == NULL || (data == NULL && len > 0))
+    return -1;
+  if (response->len + len > response->cap) {
+    size_t cap = response->cap > 0 ? response->cap : 256;
+    while (cap < response->len + len)
+      cap *= 2;
+    uint8_t *buf = (uint8_t *)realloc(response->data, cap);
+    if (buf == NULL)
+      return -1;
+    response->data = buf;
+    response->cap = cap;
+  }
+  if (len > 0)
+    memcpy(response->data + response->len, data, len);
+  response->len += len;
+  return 0;
+}
+
+static void rpc_free_deleter(void *data, void *context) {
+  (void)context;
+  free(data);
+}
+
+// Sends a reply carrying call id and status. data is taken over when owned.
+static int rpc_send_reply(const z_loaned_query_t *query, uint64_t call_id,
+                          int status, uint8_t *data, size_t len, bool owned) {
+  uint8_t header[RPC_REPLY_ATTACHMENT_SIZE];
+  put_u64_le(header, call_id);
+  put_u32_le(header + 8, (uint32_t)status);
+
+  z_query_reply_options_t options;
+  z_query_reply_options_default(&options);
+  z_owned_bytes_t attachment;
+  z_bytes_copy_from_buf(&attachment, header, sizeof(header));
+  options.attachment = z_bytes_move(&attachment);
+
+  z_owned_bytes_t payload;
+  if (owned && len > 0)
+    z_bytes_from_buf(&payload, data, len, rpc_free_deleter, NULL);
+  else {
+    z_bytes_copy_from_buf(&payload, data, len);
+    if (owned)
+      free(data);
+  }
+  return z_query_reply(query, z_query_keyexpr(query), z_move(payload),
+                       &options);
+}
+
+// Must be called with the server mutex held. Returns the insertion point in
+// pos when the method is not registered.
+static struct RpcMethod *rpc_method_find(ZenohRpcServer *server,
+                                         const char *name, size_t name_len,
+                                         size_t *pos) {
+  size_t lo = 0, hi = server->method_count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    const char *m = server->methods[mid].name;
+    int cmp = strncmp(m, name, name_len);
+    if (cmp == 0 && m[name_len] != '\0')
+      cmp = 1;
+    if (cmp == 0) {
+      *pos = mid;
+      return &server->methods[mid];
+    }
+    if (cmp < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *pos = lo;
+  return NULL;
+}
+
+static void rpc_server_release(ZenohRpcServer *server) {
+  if (atomic_count_dec(&server->refs) != 0)
+    return;
+  for (size_t i = 0; i < server->method_count; i++)
+    free(server->methods[i].name);
+  free(server->methods);
+  z_drop(z_move(server->mutex));
+  free(server);
+}
+
+static void drop_rpc_server_closure(void *arg) {
+  rpc_server_release((ZenohRpcServer *)arg);
+}
+
+static void rpc_query_handler(z_loaned_query_t *query, void *arg) {
+  thread_enter_delivery();
+  ZenohRpcServer *server = (ZenohRpcServer *)arg;
+
+  // Correlation id
+  uint64_t call_id = 0;
+  const z_loaned_bytes_t *attachment = z_query_attachment(query);
+  if (attachment != NULL &&
+      z_bytes_len(attachment) == RPC_REQUEST_ATTACHMENT_SIZE) {
+    uint8_t header[RPC_REQUEST_ATTACHMENT_SIZE];
+    z_bytes_reader_t reader = z_bytes_get_reader(attachment);
+    z_bytes_reader_read(&reader, header, sizeof(header));
+    call_id = get_u64_le(header);
+  }
+
+  z_view_string_t params;
+  z_query_parameters(query, &params);
+  const char *name;
+  size_t name_len;
+  if (!find_selector_param(z_string_data(z_loan(params)),
+                           z_string_len(z_loan(params)), "method", &name,
+                           &name_len)) {
+    rpc_send_reply(query, call_id, ZENOH_RPC_NOT_FOUND, NULL, 0, false);
+    return;
+  }
+
+  z_mutex_lock(z_loan_mut(server->mutex));
+  size_t pos;
+  struct RpcMethod *method = rpc_method_find(server, name, name_len, &pos);
+  struct RpcMethod entry = {NULL, NULL, NULL};
+  if (method != NULL)
+    entry = *method;
+  z_mutex_unlock(z_loan_mut(server->mutex));
+
+  if (method == NULL ||
+      (entry.handler == NULL && server->callback == NULL)) {
+    rpc_send_reply(query, call_id, ZENOH_RPC_NOT_FOUND, NULL, 0, false);
+    return;
+  }
+
+  size_t len = 0;
+  uint8_t *request = get_bytes_data(z_query_payload(query), &len);
+
+  if (entry.handler != NULL) {
+    ZenohRpcResponse response = {NULL, 0, 0};
+    int status = entry.handler(request, len, &response, entry.context);
+    free(request);
+    rpc_send_reply(query, call_id, status, response.data, response.len, true);
+    return;
+  }
+
+  // Forward to Dart, which answers with zenoh_rpc_respond
+  char *method_name = (char *)malloc(name_len + 1);
+  ZenohQuery *owned = (ZenohQuery *)malloc(sizeof(ZenohQuery));
+  if (method_name == NULL || owned == NULL) {
+    free(method_name);
+    free(owned);
+    free(request);
+    rpc_send_reply(query, call_id, ZENOH_RPC_ERROR, NULL, 0, false);
+    return;
+  }
+  memcpy(method_name, name, name_len);
+  method_name[name_len] = '\0';
+  z_query_take_from_loaned(&owned->query, query);
+  owned->refs = 1;
+
+  // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+  server->callback(method_name, request, len, call_id, owned, server->context);
+}
+
+FFI_PLUGIN_EXPORT ZenohRpcServer *
+zenoh_declare_rpc_server(ZenohSession *session, const char *service_key,
+                         ZenohRpcRequestCallback callback, void *context) {
+  if (session == NULL || service_key == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, service_key) < 0)
+    return NULL;
+
+  ZenohRpcServer *server =
+      (ZenohRpcServer *)calloc(1, sizeof(ZenohRpcServer));
+  if (server == NULL || z_mutex_init(&server->mutex) < 0) {
+    free(server);
+    return NULL;
+  }
+  server->refs = 2;
+  server->callback = callback;
+  server->context = context;
+
+  z_queryable_options_t options;
+  z_queryable_options_default(&options);
+  z_owned_closure_query_t closure;
+  z_closure_query(&closure, rpc_query_handler, drop_rpc_server_closure,
+                  server);
+  if (z_declare_queryable(z_loan(session->session), &server->queryable,
+                          z_loan(keyexpr), z_move(closure), &options) < 0) {
+    rpc_server_release(server);
+    return NULL;
+  }
+  return server;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_rpc_server_register(ZenohRpcServer *server,
+                                                const char *method,
+                                                ZenohRpcHandler handler,
+                                                void *context) {
+  if (server == NULL || method == NULL || method[0] == '\0')
+    return -1;
+
+  int rc = 0;
+  z_mutex_lock(z_loan_mut(server->mutex));
+  size_t pos;
+  struct RpcMethod *entry =
+      rpc_method_find(server, method, strlen(method), &pos);
+  if (entry == NULL) {
+    if (server->method_count == server->method_cap) {
+      size_t cap = server->method_cap > 0 ? server->method_cap * 2 : 8;
+      struct RpcMethod *methods = (struct RpcMethod *)realloc(
+          server->methods, cap * sizeof(struct RpcMethod));
+      if (methods == NULL) {
+        rc = -1;
+        goto out;
+      }
+      server->methods = methods;
+      server->method_cap = cap;
+    }
+    char *name = (char *)malloc(strlen(method) + 1);
+    if (name == NULL) {
+      rc = -1;
+      goto out;
+    }
+    strcpy(name, method);
+    memmove(&server->methods[pos + 1], &server->methods[pos],
+            (server->method_count - pos) * sizeof(struct RpcMethod));
+    server->method_count++;
+    entry = &server->methods[pos];
+    entry->name = name;
+  }
+  entry->handler = handler;
+  entry->context = context;
+out:
+  z_mutex_unlock(z_loan_mut(server->mutex));
+  return rc;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_rpc_server_unregister(ZenohRpcServer *server,
+                                                  const char *method) {
+  if (server == NULL || method == NULL)
+    return -1;
+
+  z_mutex_lock(z_loan_mut(server->mutex));
+  size_t pos;
+  struct RpcMethod *entry =
+      rpc_method_find(server, method, strlen(method), &pos);
+  if (entry != NULL) {
+    free(entry->name);
+    memmove(&server->methods[pos], &server->methods[pos + 1],
+            (server->method_count - pos - 1) * sizeof(struct RpcMethod));
+    server->method_count--;
+  }
+  z_mutex_unlock(z_loan_mut(server->mutex));
+  return entry != NULL ? 0 : -1;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_undeclare_rpc_server(ZenohRpcServer *server) {
+  if (server == NULL)
+    return;
+  z_drop(z_move(server->queryable));
+  rpc_server_release(server);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_rpc_respond(ZenohQuery *query, uint64_t call_id,
+                                        int status, const uint8_t *data,
+                                        size_t len) {
+  if (query == NULL)
+    return -1;
+  int rc = rpc_send_reply(z_loan(query->query), call_id, status,
+                          (uint8_t *)data, len, false);
+  zenoh_query_finalize(query);
+  return rc;
+}
+
+static void rpc_client_release(ZenohRpcClient *client) {
+  if (atomic_count_dec(&client->refs) == 0) {
+    z_drop(z_move(client->querier));
+    z_drop(z_move(client->keyexpr));
+    session_release(client->session);
+    free(client);
+  }
+}
+
+static void rpc_call_reply_handler(struct z_loaned_reply_t *reply,
+                                   void *arg) {
+  thread_enter_delivery();
+  struct RpcCall *call = (struct RpcCall *)arg;
+
+  int status;
+  const z_loaned_bytes_t *payload;
+  if (z_reply_is_ok(reply)) {
+    const z_loaned_sample_t *sample = z_reply_ok(reply);
+    const z_loaned_bytes_t *attachment = z_sample_attachment(sample);
+    uint8_t header[RPC_REPLY_ATTACHMENT_SIZE];
+    if (attachment == NULL ||
+        z_bytes_len(attachment) != RPC_REPLY_ATTACHMENT_SIZE)
+      return; // Not an RPC reply
+    z_bytes_reader_t reader = z_bytes_get_reader(attachment);
+    z_bytes_reader_read(&reader, header, sizeof(header));
+    if (get_u64_le(header) != call->id)
+      return;
+    status = (int)get_u32_le(header + 8);
+    payload = z_sample_payload(sample);
+  } else {
+    const z_loaned_reply_err_t *err = z_reply_err(reply);
+    if (err == NULL)
+      return;
+    status = ZENOH_RPC_ERROR;
+    payload = z_reply_err_payload(err);
+  }
+  if (atomic_count_inc(&call->answered) != 1)
+    return;
+
+  size_t len = 0;
+  uint8_t *data = NULL;
+  if (call->deadline_ms > 0 &&
+      z_clock_elapsed_ms(&call->start) > call->deadline_ms)
+    status = ZENOH_RPC_TIMEOUT;
+  else
+    data = get_bytes_data(payload, &len);
+
+  // DO NOT FREE - NativeCallable.listener is async, Dart will free data
+  call->callback(call->id, status, data, len, call->context);
+}
+
+// RpcCall.issuing states. A closure dropped while its attempt is still
+// being sent hands the call back to the sender instead of retrying from
+// inside z_get, so retries loop rather than recurse.
+#define RPC_IDLE 0
+#define RPC_ISSUING 1
+#define RPC_DROPPED 2
+
+// Retries are also capped here, whatever the caller asks for
+#define RPC_MAX_RETRIES 64
+
+// Claims another attempt while attempts and time remain
+static bool rpc_call_retry(struct RpcCall *call) {
+  if (atomic_count_load(&call->answered) != 0 || call->attempts_left == 0 ||
+      atomic_count_load(&call->client->closed) != 0)
+    return false;
+  if (call->deadline_ms > 0 &&
+      z_clock_elapsed_ms(&call->start) >= call->deadline_ms)
+    return false;
+  call->attempts_left--;
+  return true;
+}
+
+static void rpc_call_finish(struct RpcCall *call) {
+  ZenohRpcClient *client = call->client;
+  if (atomic_count_load(&call->answered) == 0) {
+    bool expired = call->deadline_ms > 0 &&
+                   z_clock_elapsed_ms(&call->start) >= call->deadline_ms;
+    call->callback(call->id, expired ? ZENOH_RPC_TIMEOUT : ZENOH_RPC_UNAVAILABLE,
+                   NULL, 0, call->context);
+  }
+
+  free(call->parameters);
+  free(call->request);
+  free(call);
+  rpc_client_release(client);
+}
+
+static void drop_rpc_call(void *arg);
+
+// Sends one attempt of call. The closure owns call, even on failure. An
+// attempt never outlives the deadline: when less time remains than the
+// querier's timeout it goes out as a plain get bounded by what is left.
+static int rpc_call_attempt(struct RpcCall *call) {
+  ZenohRpcClient *client = call->client;
+  uint8_t header[RPC_REQUEST_ATTACHMENT_SIZE];
+  put_u64_le(header, call->id);
+  z_owned_bytes_t attachment;
+  z_bytes_copy_from_buf(&attachment, header, sizeof(header));
+  z_owned_bytes_t payload;
+  if (call->request_len > 0)
+    z_bytes_copy_from_buf(&payload, call->request, call->request_len);
+
+  z_owned_closure_reply_t closure;
+  z_closure_reply(&closure, rpc_call_reply_handler, drop_rpc_call, call);
+
+  uint64_t remaining = 0;
+  if (call->deadline_ms > 0) {
+    uint64_t elapsed = z_clock_elapsed_ms(&call->start);
+    remaining = elapsed < call->deadline_ms ? call->deadline_ms - elapsed : 1;
+  }
+  // zenoh's default attempt timeout is unknown here, so a deadline bounds
+  // every attempt of a client without its own
+  if (remaining > 0 && (client->options.attempt_timeout_ms == 0 ||
+                        remaining < client->options.attempt_timeout_ms)) {
+    z_get_options_t options;
+    z_get_options_default(&options);
+    options.timeout_ms = remaining;
+    options.priority = convert_priority(client->options.priority);
+    options.is_express = client->options.is_express;
+    options.target = convert_query_target(client->options.target);
+    options.allowed_destination =
+        convert_locality(client->options.allowed_destination);
+    options.consolidation = z_query_consolidation_none();
+    options.attachment = z_bytes_move(&attachment);
+    if (call->request_len > 0)
+      options.payload = z_bytes_move(&payload);
+    return z_get(z_loan(client->session->session), z_loan(client->keyexpr),
+                 call->parameters, z_move(closure), &options);
+  }
+
+  z_querier_get_options_t options;
+  z_querier_get_options_default(&options);
+  options.attachment = z_bytes_move(&attachment);
+  if (call->request_len > 0)
+    options.payload = z_bytes_move(&payload);
+  return z_querier_get(z_loan(client->querier), call->parameters,
+                       z_move(closure), &options);
+}
+
+// Sends attempts until one is in flight or the call is over. A get that
+// fails outright is reported at once rather than retried.
+static void rpc_call_issue(struct RpcCall *call) {
+  for (;;) {
+    call->issuing = RPC_ISSUING;
+    int rc = rpc_call_attempt(call);
+    if (atomic_count_cas(&call->issuing, RPC_ISSUING, RPC_IDLE))
+      return; // In flight; drop_rpc_call takes it from here
+    // The closure was dropped before z_get returned
+    if (rc < 0 || !rpc_call_retry(call)) {
+      rpc_call_finish(call);
+      return;
+    }
+  }
+}
+
+static void drop_rpc_call(void *arg) {
+  struct RpcCall *call = (struct RpcCall *)arg;
+  if (atomic_count_cas(&call->issuing, RPC_ISSUING, RPC_DROPPED))
+    return; // rpc_call_issue is still sending and takes the call back
+  if (rpc_call_retry(call))
+    rpc_call_issue(call);
+  else
+    rpc_call_finish(call);
+}
+
+FFI_PLUGIN_EXPORT ZenohRpcClient *
+zenoh_rpc_client_new(ZenohSession *session, const char *service_key,
+                     ZenohRpcClientOptions *opts) {
+  if (session == NULL || service_key == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, service_key) < 0)
+    return NULL;
+
+  ZenohRpcClientOptions defaults;
+  if (opts == NULL) {
+    zenoh_rpc_client_options_default(&defaults);
+    opts = &defaults;
+  }
+
+  ZenohRpcClient *client =
+      (ZenohRpcClient *)calloc(1, sizeof(ZenohRpcClient));
+  if (client == NULL)
+    return NULL;
+  if (z_keyexpr_from_str(&client->keyexpr, service_key) < 0) {
+    free(client);
+    return NULL;
+  }
+  client->refs = 1;
+  client->options = *opts;
+
+  z_querier_options_t options;
+  z_querier_options_default(&options);
+  options.timeout_ms = opts->attempt_timeout_ms;
+  options.priority = convert_priority(opts->priority);
+  options.is_express = opts->is_express;
+  options.target = convert_query_target(opts->target);
+  options.allowed_destination = convert_locality(opts->allowed_destination);
+  options.consolidation = z_query_consolidation_none();
+
+  if (z_declare_querier(z_loan(session->session), &client->querier,
+                        z_loan(keyexpr), &options) < 0) {
+    z_drop(z_move(client->keyexpr));
+    free(client);
+    return NULL;
+  }
+  client->session = session;
+  atomic_count_inc(&session->refs);
+  return client;
+}
+
+FFI_PLUGIN_EXPORT uint64_t zenoh_rpc_call(ZenohRpcClient *client,
+                                          const char *method,
+                                          const uint8_t *request, size_t len,
+                                          uint64_t deadline_ms,
+                                          uint32_t retries,
+                                          ZenohRpcResponseCallback callback,
+                                          void *context) {
+  if (client == NULL || atomic_count_load(&client->closed) != 0 ||
+      method == NULL ||
+      callback == NULL || (request == NULL && len > 0))
+    return 0;
+
+  struct RpcCall *call = (struct RpcCall *)calloc(1, sizeof(struct RpcCall));
+  if (call == NULL)
+    return 0;
+  size_t method_len = strlen(method);
+  call->parameters = (char *)malloc(method_len + sizeof("method="));
+  call->request = len > 0 ? (uint8_t *)malloc(len) : NULL;
+  if (call->parameters == NULL || (len > 0 && call->request == NULL)) {
+    free(call->parameters);
+    free(call->request);
+    free(call);
+    return 0;
+  }
+  memcpy(call->parameters, "method=", 7);
+  memcpy(call->parameters + 7, method, method_len + 1);
+  if (len > 0)
+    memcpy(call->request, request, len);
+  call->request_len = len;
+
+  call->client = client;
+  call->id = (uint64_t)atomic_count_inc(&client->next_id);
+  call->attempts_left = retries < RPC_MAX_RETRIES ? retries : RPC_MAX_RETRIES;
+  call->deadline_ms = deadline_ms;
+  call->start = z_clock_now();
+  call->callback = callback;
+  call->context = context;
+
+  uint64_t id = call->id;
+  atomic_count_inc(&client->refs);
+  // Failures are reported through callback, never by the return value
+  thread_mark_caller();
+  rpc_call_issue(call);
+  return id;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_rpc_client_close(ZenohRpcClient *client) {
+  if (client == NULL)
+    return;
+  // In-flight calls complete (without retries) before the querier goes
+  atomic_count_cas(&client->closed, 0, 1);
+  rpc_client_release(client);
+}
+
+// ============================================================================
+// Time Ranges
+// ============================================================================
+
+// Inclusive range of NTP64 times, parsed from a `_time=[start..end]` selector
+// parameter
+struct TimeRange {
+  uint64_t start;
+  uint64_t end;
+};
+
+static uint64_t ntp64_from_seconds(double seconds) {
+  if (seconds <= 0)
+    return 0;
+  if (seconds >= 4294967296.0)
+    return UINT64_MAX;
+  return (uint64_t)(seconds * 4294967296.0);
+}
+
+static uint64_t ntp64_now(void) {
+#if defined(_WIN32)
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  uint64_t ticks = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+  // 100 ns ticks since 1601-01-01
+  ticks -= 116444736000000000ULL;
+  return ((ticks / 10000000) << 32) |
+         (((ticks % 10000000) << 32) / 10000000);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return ((uint64_t)ts.tv_sec << 32) |
+         (((uint64_t)ts.tv_nsec << 32) / 1000000000u);
+#endif
+}
+
+// Parses durations such as "10m", "-1.5h" or "250ms" into seconds
+static bool parse_duration(const char *s, size_t len, double *out) {
+  char buf[32];
+  if (len == 0 || len >= sizeof(buf))
+    return false;
+  memcpy(buf, s, len);
+  buf[len] = '\0';
+
+  char *unit;
+  double value = strtod(buf, &unit);
+  if (unit == buf)
+    return false;
+
+  if (strcmp(unit, "u") == 0)
+    value *= 1e-6;
+  else if (strcmp(unit, "ms") == 0)
+    value *= 1e-3;
+  else if (strcmp(unit, "s") == 0 || *unit == '\0')
+    ;
+  else if (strcmp(unit, "m") == 0)
+    value *= 60;
+  else if (strcmp(unit, "h") == 0)
+    value *= 3600;
+  else if (strcmp(unit, "d") == 0)
+    value *= 86400;
+  else if (strcmp(unit, "w") == 0)
+    value *= 604800;
+  else
+    return false;
+
+  *out = value;
+  return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned)(y - era * 400);
+  unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int64_t)doe - 719468;
+}
+
+// Parses "now()", "now(-1h)", RFC 3339 UTC times ("2024-05-01T12:00:00Z")
+// and plain seconds since the Unix epoch
+static bool parse_time_value(const char *s, size_t len, uint64_t now,
+                             uint64_t *out) {
+  if (len >= 5 && memcmp(s, "now(", 4) == 0 && s[len - 1] == ')') {
+    double offset = 0;
+    if (len > 5 && !parse_duration(s + 4, len - 5, &offset))
+      return false;
+    double seconds = (double)(now >> 32) +
+                     (double)(now & 0xffffffffu) / 4294967296.0 + offset;
+    *out = ntp64_from_seconds(seconds);
+    return true;
+  }
+
+  char buf[40];
+  if (len == 0 || len >= sizeof(buf))
+    return false;
+  memcpy(buf, s, len);
+  buf[len] = '\0';
+
+  int year, month, day, hour, minute;
+  double second;
+  int consumed = 0;
+  if (sscanf(buf, "%4d-%2d-%2dT%2d:%2d:%lf%n", &year, &month, &day, &hour,
+             &minute, &second, &consumed) == 6 &&
+      (buf[consumed] == 'Z' || buf[consumed] == 'z') &&
+      buf[consumed + 1] == '\0') {
+    int64_t days = days_from_civil(year, (unsigned)month, (unsigned)day);
+    *out = ntp64_from_seconds((double)days * 86400 + hour * 3600 +
+                              minute * 60 + second);
+    return true;
+  }
+
+  char *end;
+  double seconds = strtod(buf, &end);
+  if (end == buf || *end != '\0')
+    return false;
+  *out = ntp64_from_seconds(seconds);
+  return true;
+}
+
+// Parses "[start..end]" or "[start;duration]". Brackets facing outwards
+// ("]start..end[") exclude the bound; empty bounds are open.
+static bool parse_time_range(const char *s, size_t len, uint64_t now,
+                             struct TimeRange *out) {
+  if (len < 2)
+    return false;
+  bool start_inclusive = s[0] == '[';
+  bool end_inclusive = s[len - 1] == ']';
+  if ((s[0] != '[' && s[0] != ']') || (s[len - 1] != ']' && s[len - 1] != '['))
+    return false;
+
+  const char *body = s + 1;
+  size_t body_len = len - 2;
+  out->start = 0;
+  out->end = UINT64_MAX;
+
+  const char *dots = NULL;
+  for (size_t i = 0; i + 1 < body_len; i++) {
+    if (body[i] == '.' && body[i + 1] == '.') {
+      dots = body + i;
+      break;
+    }
+  }
+
+  if (dots != NULL) {
+    size_t start_len = (size_t)(dots - body);
+    const char *end_s = dots + 2;
+    size_t end_len = body_len - start_len - 2;
+    if (start_len > 0 && !parse_time_value(body, start_len, now, &out->start))
+      return false;
+    if (end_len > 0 && !parse_time_value(end_s, end_len, now, &out->end))
+      return false;
+  } else {
+    const char *semi = memchr(body, ';', body_len);
+    if (semi == NULL)
+      return false;
+    size_t start_len = (size_t)(semi - body);
+    double duration;
+    if (!parse_time_value(body, start_len, now, &out->start) ||
+        !parse_duration(semi + 1, body_len - start_len - 1, &duration))
+      return false;
+    double start_s = (double)(out->start >> 32) +
+                     (double)(out->start & 0xffffffffu) / 4294967296.0;
+    out->end = ntp64_from_seconds(start_s + duration);
+  }
+
+  if (!start_inclusive && out->start < UINT64_MAX)
+    out->start++;
+  if (!end_inclusive && out->end > 0)
+    out->end--;
+  return true;
+}
+
+// Reads the `_time` parameter of a query. An absent or malformed parameter
+// selects the whole time line.
+static void query_time_range(const z_loaned_query_t *query,
+                             struct TimeRange *out) {
+  out->start = 0;
+  out->end = UINT64_MAX;
+
+  z_view_string_t params;
+  z_query_parameters(query, &params);
+
+  const char *value;
+  size_t value_len;
+  struct TimeRange range;
+  if (find_selector_param(z_string_data(z_loan(params)),
+                          z_string_len(z_loan(params)), "_time", &value,
+                          &value_len) &&
+      parse_time_range(value, value_len, ntp64_now(), &range))
+    *out = range;
+}
+
+// Reads the `_limit` and `_cursor` paging parameters of a query; *after is
+// a heap copy or NULL
+static void query_page(const z_loaned_query_t *query, size_t *limit,
+                       char **after) {
+  *limit = 0;
+  *after = NULL;
+
+  z_view_string_t params;
+  z_query_parameters(query, &params);
+  const char *data = z_string_data(z_loan(params));
+  size_t len = z_string_len(z_loan(params));
+
+  const char *value;
+  size_t value_len;
+  if (find_selector_param(data, len, "_limit", &value, &value_len)) {
+    char buf[24];
+    if (value_len > 0 && value_len < sizeof(buf)) {
+      memcpy(buf, value, value_len);
+      buf[value_len] = '\0';
+      char *end;
+      unsigned long n = strtoul(buf, &end, 10);
+      if (*end == '\0')
+        *limit = (size_t)n;
+    }
+  }
+  if (find_selector_param(data, len, "_cursor", &value, &value_len) &&
+      value_len > 0)
+    *after = param_unescape(value, value_len);
+}
+
+// ============================================================================
+// Log Store
+// ============================================================================
+//
+// Append-only segment files, memory-mapped and pre-sized, named
+// <id>.zlog. Records are little-endian and 8-byte aligned:
+//
+//   u32 magic "ZLOG", u32 crc32 of the rest of the record,
+//   u64 NTP64 time, u8[16] writer zid, u8[24] zenoh timestamp,
+//   u32 flags, u32 key_len, u32 encoding_len, u32 value_len,
+//   key, encoding, value, zero padding
+//
+// The in-memory hash index maps every key to its latest record. It is
+// snapshotted to index.zidx on flush, compaction and close; at startup the
+// snapshot is loaded and only records appended after it are replayed.
+
+#define LOG_RECORD_MAGIC 0x474f4c5au // "ZLOG"
+#define LOG_INDEX_MAGIC 0x5844495au  // "ZIDX"
+#define LOG_INDEX_VERSION 1
+#define LOG_RECORD_HEADER_SIZE 72
+#define LOG_FLAG_DELETED 1u
+#define LOG_FLAG_TIMESTAMP 2u // The zenoh timestamp bytes are valid
+#define LOG_DEFAULT_SEGMENT_SIZE (64u * 1024 * 1024)
+#define LOG_DEFAULT_COMPACTION_RATIO 0.5
+#define LOG_DEFAULT_COMPACTION_INTERVAL_MS 30000
+#define LOG_COMPACTOR_TICK_MS 100
+#define LOG_COMPACT_BATCH_BYTES (1024 * 1024) // Copied per store lock hold
+#define LOG_COLLECT_BATCH 1024 // Index slots matched per store lock hold
+#define LOG_COLLECT_RETRIES 3
+
+struct LogSegment {
+  uint32_t id;
+  uint8_t *base;
+  size_t size; // Mapped size
+  size_t end;  // Append offset
+  size_t live; // Bytes of records the index still points to
+  size_t synced; // Prefix known to be on disk
+#if defined(_WIN32)
+  HANDLE file;
+  HANDLE mapping;
+#else
+  int fd;
+#endif
+};
+
+struct LogIndexEntry {
+  char *key; // NULL for an empty slot
+  uint64_t hash;
+  uint32_t segment;
+  uint32_t len;
+  uint64_t offset;
+  uint64_t time;
+  uint8_t zid[16];
+  bool deleted;
+};
+
+struct ZenohLogStore {
+  z_owned_mutex_t mutex;
+  z_owned_mutex_t compact_mutex; // Serializes compactions; taken before mutex
+  atomic_count_t refs; // User handle plus attached storages
+  char *dir;
+  struct LogSegment *segments; // Sorted by id; the last one is appended to
+  size_t segment_count;
+  size_t segment_cap;
+  uint32_t next_segment_id;
+  struct LogIndexEntry *index;
+  size_t index_cap; // Power of two
+  uint64_t index_epoch; // Bumped whenever entries move between slots
+  ZenohLogStoreStats stats;
+  size_t segment_size;
+  double compaction_ratio;
+  uint64_t compaction_interval_ms;
+  bool sync_writes;
+  z_owned_task_t compactor;
+  bool stopping;
+};
+
+static size_t log_record_size(uint32_t key_len, uint32_t enc_len,
+                              uint32_t value_len) {
+  size_t n = LOG_RECORD_HEADER_SIZE + (size_t)key_len + enc_len + value_len;
+  return (n + 7) & ~(size_t)7;
+}
+
+static void log_segment_path(const ZenohLogStore *store, uint32_t id,
+                             char *path, size_t path_len) {
+  snprintf(path, path_len, "%s/%08u.zlog", store->dir, id);
+}
+
+#if !defined(_WIN32)
+// Grows the file to size with its blocks allocated. A sparse file maps fine
+// but the first write into a hole faults with SIGBUS once the disk is full;
+// this fails up front instead.
+static int log_file_reserve(int fd, size_t from, size_t size) {
+#if !defined(__APPLE__)
+  int rc = posix_fallocate(fd, (off_t)from, (off_t)(size - from));
+  if (rc == 0)
+    return 0;
+  if (rc != EINVAL && rc != EOPNOTSUPP)
+    return -1;
+#endif
+  // No fallocate here: write the zeros out
+  static const uint8_t zeros[65536];
+  while (from < size) {
+    size_t n = size - from < sizeof(zeros) ? size - from : sizeof(zeros);
+    ssize_t written = pwrite(fd, zeros, n, (off_t)from);
+    if (written <= 0) {
+      if (written < 0 && errno == EINTR)
+        continue;
+      return -1;
+    }
+    from += (size_t)written;
+  }
+  return 0;
+}
+#endif
+
+static int log_segment_map(struct LogSegment *seg, const char *path,
+                           size_t min_size) {
+#if defined(_WIN32)
+  seg->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                          NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (seg->file == INVALID_HANDLE_VALUE)
+    return -1;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(seg->file, &file_size)) {
+    CloseHandle(seg->file);
+    return -1;
+  }
+  size_t size = (size_t)file_size.QuadPart;
+  if (size < min_size)
+    size = min_size;
+  if (size == 0) {
+    CloseHandle(seg->file);
+    return -1;
+  }
+
+  seg->mapping =
+      CreateFileMappingA(seg->file, NULL, PAGE_READWRITE,
+                         (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+  if (seg->mapping == NULL) {
+    CloseHandle(seg->file);
+    return -1;
+  }
+  seg->base = (uint8_t *)MapViewOfFile(seg->mapping, FILE_MAP_ALL_ACCESS, 0,
+                                       0, size);
+  if (seg->base == NULL) {
+    CloseHandle(seg->mapping);
+    CloseHandle(seg->file);
+    return -1;
+  }
+#else
+  seg->fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (seg->fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(seg->fd, &st) < 0) {
+    close(seg->fd);
+    return -1;
+  }
+  size_t size = (size_t)st.st_size;
+  if (size < min_size) {
+    if (log_file_reserve(seg->fd, size, min_size) < 0) {
+      close(seg->fd);
+      return -1;
+    }
+    size = min_size;
+  }
+  if (size == 0) {
+    close(seg->fd);
+    return -1;
+  }
+
+  void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, seg->fd, 0);
+  if (base == MAP_FAILED) {
+    close(seg->fd);
+    return -1;
+  }
+  seg->base = (uint8_t *)base;
+#endif
+  seg->size = size;
+  seg->end = 0;
+  seg->live = 0;
+  seg->synced = 0;
+  return 0;
+}
+
+static void log_segment_sync(struct LogSegment *seg, size_t offset,
+                             size_t len) {
+#if defined(_WIN32)
+  FlushViewOfFile(seg->base + offset, len);
+  FlushFileBuffers(seg->file);
+#else
+  long page = sysconf(_SC_PAGESIZE);
+  size_t start = offset - offset % (size_t)(page > 0 ? page : 4096);
+  msync(seg->base + start, len + (offset - start), MS_SYNC);
+#endif
+}
+
+static void log_segment_unmap(struct LogSegment *seg) {
+#if defined(_WIN32)
+  UnmapViewOfFile(seg->base);
+  CloseHandle(seg->mapping);
+  CloseHandle(seg->file);
+#else
+  munmap(seg->base, seg->size);
+  close(seg->fd);
+#endif
+  seg->base = NULL;
+}
+
+static struct LogSegment *log_segment_find(ZenohLogStore *store, uint32_t id) {
+  size_t lo = 0, hi = store->segment_count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (store->segments[mid].id == id)
+      return &store->segments[mid];
+    if (store->segments[mid].id < id)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return NULL;
+}
+
+// Maps segment id and appends it; ids must be added in increasing order
+static struct LogSegment *log_segment_add(ZenohLogStore *store, uint32_t id,
+                                          size_t min_size) {
+  if (store->segment_count == store->segment_cap) {
+    size_t cap = store->segment_cap > 0 ? store->segment_cap * 2 : 8;
+    struct LogSegment *segments = (struct LogSegment *)realloc(
+        store->segments, cap * sizeof(struct LogSegment));
+    if (segments == NULL)
+      return NULL;
+    store->segments = segments;
+    store->segment_cap = cap;
+  }
+
+  char path[1024];
+  log_segment_path(store, id, path, sizeof(path));
+  struct LogSegment *seg = &store->segments[store->segment_count];
+  if (log_segment_map(seg, path, min_size) < 0)
+    return NULL;
+  seg->id = id;
+  store->segment_count++;
+  store->stats.segments = store->segment_count;
+  store->stats.disk_bytes += seg->size;
+  if (id >= store->next_segment_id)
+    store->next_segment_id = id + 1;
+  return seg;
+}
+
+static void log_segment_remove(ZenohLogStore *store, size_t i) {
+  struct LogSegment *seg = &store->segments[i];
+  char path[1024];
+  log_segment_path(store, seg->id, path, sizeof(path));
+  store->stats.disk_bytes -= seg->size;
+  log_segment_unmap(seg);
+#if defined(_WIN32)
+  DeleteFileA(path);
+#else
+  unlink(path);
+#endif
+  memmove(&store->segments[i], &store->segments[i + 1],
+          (store->segment_count - i - 1) * sizeof(struct LogSegment));
+  store->segment_count--;
+  store->stats.segments = store->segment_count;
+}
+
+static struct LogIndexEntry *log_index_find(ZenohLogStore *store,
+                                            const char *key, size_t key_len,
+                                            uint64_t hash) {
+  size_t mask = store->index_cap - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    struct LogIndexEntry *e = &store->index[i];
+    if (e->key == NULL)
+      return e;
+    if (e->hash == hash && strlen(e->key) == key_len &&
+        memcmp(e->key, key, key_len) == 0)
+      return e;
+  }
+}
+
+static bool log_index_grow(ZenohLogStore *store) {
+  size_t cap = store->index_cap * 2;
+  struct LogIndexEntry *index =
+      (struct LogIndexEntry *)calloc(cap, sizeof(struct LogIndexEntry));
+  if (index == NULL)
+    return false;
+
+  struct LogIndexEntry *old = store->index;
+  size_t old_cap = store->index_cap;
+  store->index = index;
+  store->index_cap = cap;
+  store->index_epoch++;
+  for (size_t i = 0; i < old_cap; i++) {
+    if (old[i].key == NULL)
+      continue;
+    size_t mask = cap - 1;
+    size_t j = old[i].hash & mask;
+    while (index[j].key != NULL)
+      j = (j + 1) & mask;
+    index[j] = old[i];
+  }
+  free(old);
+  return true;
+}
+
+// Removes e, moving later entries of its probe run back so that lookups
+// still reach them
+static void log_index_remove(ZenohLogStore *store, struct LogIndexEntry *e) {
+  size_t mask = store->index_cap - 1;
+  size_t hole = (size_t)(e - store->index);
+  store->stats.index_bytes -= strlen(e->key) + 1;
+  free(e->key);
+  store->index_epoch++;
+  for (size_t j = (hole + 1) & mask; store->index[j].key != NULL;
+       j = (j + 1) & mask) {
+    size_t home = store->index[j].hash & mask;
+    // Entry j stays put if its home slot lies cyclically in (hole, j]
+    bool stays = hole <= j ? (home > hole && home <= j)
+                           : (home > hole || home <= j);
+    if (!stays) {
+      store->index[hole] = store->index[j];
+      hole = j;
+    }
+  }
+  memset(&store->index[hole], 0, sizeof(struct LogIndexEntry));
+}
+
+// Returns the entry for key, inserting an empty (key-less) slot if missing
+static struct LogIndexEntry *log_index_slot(ZenohLogStore *store,
+                                            const char *key, size_t key_len) {
+  uint64_t keys = store->stats.entries + store->stats.tombstones;
+  if ((keys + 1) * 10 > store->index_cap * 7 && !log_index_grow(store))
+    return NULL;
+  uint64_t hash = key_hash(key, key_len);
+  struct LogIndexEntry *e = log_index_find(store, key, key_len, hash);
+  e->hash = hash;
+  return e;
+}
+
+static bool log_newer(uint64_t time_a, const uint8_t *zid_a, uint64_t time_b,
+                      const uint8_t *zid_b) {
+  if (time_a != time_b)
+    return time_a > time_b;
+  return memcmp(zid_a, zid_b, 16) > 0;
+}
+
+// Points entry at a record, keeping the counters in sync. The entry's key
+// must already be set.
+static void log_index_point(ZenohLogStore *store, struct LogIndexEntry *e,
+                            bool existed, uint32_t segment, uint64_t offset,
+                            uint32_t len, uint64_t time, const uint8_t *zid,
+                            bool deleted) {
+  if (existed) {
+    struct LogSegment *old = log_segment_find(store, e->segment);
+    if (old != NULL)
+      old->live -= e->len;
+    store->stats.live_bytes -= e->len;
+    if (e->deleted)
+      store->stats.tombstones--;
+    else
+      store->stats.entries--;
+  }
+
+  e->segment = segment;
+  e->offset = offset;
+  e->len = len;
+  e->time = time;
+  memcpy(e->zid, zid, 16);
+  e->deleted = deleted;
+
+  struct LogSegment *seg = log_segment_find(store, segment);
+  if (seg != NULL)
+    seg->live += len;
+  store->stats.live_bytes += len;
+  if (deleted)
+    store->stats.tombstones++;
+  else
+    store->stats.entries++;
+}
+
+// Space for a record of size bytes in the active segment, rolling over to a
+// new segment when it is full
+static struct LogSegment *log_reserve(ZenohLogStore *store, size_t size) {
+  struct LogSegment *active = store->segment_count > 0
+                                  ? &store->segments[store->segment_count - 1]
+                                  : NULL;
+  if (active != NULL && active->size - active->end >= size)
+    return active;
+
+  size_t min_size = size > store->segment_size ? size : store->segment_size;
+  return log_segment_add(store, store->next_segment_id, min_size);
+}
+
+// Must be called with the store mutex held. value is read from payload when
+// it is non-NULL.
+static int log_append(ZenohLogStore *store, const char *key, size_t key_len,
+                      uint64_t time, const uint8_t *zid,
+                      const z_timestamp_t *timestamp, bool deleted,
+                      const char *encoding, size_t enc_len,
+                      const z_loaned_bytes_t *payload, const uint8_t *value,
+                      size_t value_len, uint32_t *segment, uint64_t *offset,
+                      uint32_t *record_len) {
+  if (payload != NULL)
+    value_len = z_bytes_len(payload);
+  if (key_len > UINT32_MAX || enc_len > UINT32_MAX || value_len > UINT32_MAX)
+    return -1;
+
+  size_t size = log_record_size((uint32_t)key_len, (uint32_t)enc_len,
+                                (uint32_t)value_len);
+  if (size > UINT32_MAX)
+    return -1;
+  struct LogSegment *seg = log_reserve(store, size);
+  if (seg == NULL)
+    return -1;
+
+  uint8_t *p = seg->base + seg->end;
+  uint32_t flags = deleted ? LOG_FLAG_DELETED : 0;
+  memset(p + 16, 0, 40);
+  memcpy(p + 16, zid, 16);
+  if (timestamp != NULL) {
+    memcpy(p + 32, timestamp, sizeof(z_timestamp_t));
+    flags |= LOG_FLAG_TIMESTAMP;
+  }
+  put_u64_le(p + 8, time);
+  put_u32_le(p + 56, flags);
+  put_u32_le(p + 60, (uint32_t)key_len);
+  put_u32_le(p + 64, (uint32_t)enc_len);
+  put_u32_le(p + 68, (uint32_t)value_len);
+
+  uint8_t *q = p + LOG_RECORD_HEADER_SIZE;
+  memcpy(q, key, key_len);
+  q += key_len;
+  if (enc_len > 0)
+    memcpy(q, encoding, enc_len);
+  q += enc_len;
+  if (payload != NULL) {
+    z_bytes_reader_t reader = z_bytes_get_reader(payload);
+    z_bytes_reader_read(&reader, q, value_len);
+  } else if (value_len > 0) {
+    memcpy(q, value, value_len);
+  }
+  q += value_len;
+  memset(q, 0, size - (size_t)(q - p));
+
+  put_u32_le(p + 4, compute_crc32(p + 8, size - 8));
+  // The magic goes last so a torn write never looks like a valid record
+  put_u32_le(p, LOG_RECORD_MAGIC);
+
+  if (store->sync_writes) {
+    log_segment_sync(seg, seg->end, size);
+    if (seg->synced == seg->end)
+      seg->synced = seg->end + size;
+  }
+
+  *segment = seg->id;
+  *offset = seg->end;
+  *record_len = (uint32_t)size;
+  seg->end += size;
+  return 0;
+}
+
+// Validates the record at offset; returns its size or 0
+static size_t log_record_check(const struct LogSegment *seg, size_t offset) {
+  if (seg->size - offset < LOG_RECORD_HEADER_SIZE)
+    return 0;
+  const uint8_t *p = seg->base + offset;
+  if (get_u32_le(p) != LOG_RECORD_MAGIC)
+    return 0;
+  size_t size = log_record_size(get_u32_le(p + 60), get_u32_le(p + 64),
+                                get_u32_le(p + 68));
+  if (size > seg->size - offset)
+    return 0;
+  if (compute_crc32(p + 8, size - 8) != get_u32_le(p + 4))
+    return 0;
+  return size;
+}
+
+// Applies an update. Returns 1 if applied, 0 if older than the stored value
+// (or over max_entries for a new key), < 0 on error.
+static int log_store_apply(ZenohLogStore *store, const char *key,
+                           uint64_t time, const uint8_t *zid,
+                           const z_timestamp_t *timestamp, bool deleted,
+                           const char *encoding,
+                           const z_loaned_bytes_t *payload,
+                           const uint8_t *value, size_t value_len,
+                           size_t max_entries) {
+  size_t key_len = strlen(key);
+  size_t enc_len = encoding != NULL ? strlen(encoding) : 0;
+
+  z_mutex_lock(z_loan_mut(store->mutex));
+
+  int rc = 0;
+  struct LogIndexEntry *e = log_index_slot(store, key, key_len);
+  if (e == NULL) {
+    rc = -1;
+  } else {
+    bool existed = e->key != NULL;
+    uint64_t keys = store->stats.entries + store->stats.tombstones;
+    if (existed ? log_newer(time, zid, e->time, e->zid)
+                : (max_entries == 0 || keys < max_entries)) {
+      uint32_t segment, record_len;
+      uint64_t offset;
+      char *key_copy = existed ? e->key : (char *)malloc(key_len + 1);
+      if (key_copy == NULL ||
+          log_append(store, key, key_len, time, zid, timestamp, deleted,
+                     encoding, enc_len, payload, value, value_len, &segment,
+                     &offset, &record_len) < 0) {
+        if (!existed)
+          free(key_copy);
+        rc = -1;
+      } else {
+        if (!existed) {
+          memcpy(key_copy, key, key_len + 1);
+          e->key = key_copy;
+          store->stats.index_bytes += key_len + 1;
+        }
+        log_index_point(store, e, existed, segment, offset, record_len, time,
+                        zid, deleted);
+        rc = 1;
+      }
+    }
+  }
+
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  return rc;
+}
+
+// Replays the records of seg from offset. Must be called with the store
+// mutex held.
+static void log_replay_segment(ZenohLogStore *store, struct LogSegment *seg,
+                               size_t offset) {
+  size_t size;
+  while ((size = log_record_check(seg, offset)) > 0) {
+    const uint8_t *p = seg->base + offset;
+    uint64_t time = get_u64_le(p + 8);
+    bool deleted = (get_u32_le(p + 56) & LOG_FLAG_DELETED) != 0;
+    const char *key = (const char *)(p + LOG_RECORD_HEADER_SIZE);
+    size_t key_len = get_u32_le(p + 60);
+
+    struct LogIndexEntry *e = log_index_slot(store, key, key_len);
+    if (e == NULL)
+      break;
+    bool existed = e->key != NULL;
+    // Later copies of equal records win, as compaction rewrites records
+    if (!existed || !log_newer(e->time, e->zid, time, p + 16)) {
+      if (!existed) {
+        e->key = (char *)malloc(key_len + 1);
+        if (e->key == NULL)
+          break;
+        memcpy(e->key, key, key_len);
+        e->key[key_len] = '\0';
+        store->stats.index_bytes += key_len + 1;
+      }
+      log_index_point(store, e, existed, seg->id, offset, (uint32_t)size, time,
+                      p + 16, deleted);
+    }
+    offset += size;
+  }
+  seg->end = offset;
+}
+
+static void log_index_clear(ZenohLogStore *store) {
+  for (size_t i = 0; i < store->index_cap; i++)
+    free(store->index[i].key);
+  memset(store->index, 0, store->index_cap * sizeof(struct LogIndexEntry));
+  store->index_epoch++;
+  for (size_t i = 0; i < store->segment_count; i++) {
+    store->segments[i].live = 0;
+    store->segments[i].end = 0;
+  }
+  store->stats.entries = 0;
+  store->stats.tombstones = 0;
+  store->stats.live_bytes = 0;
+  store->stats.index_bytes = store->index_cap * sizeof(struct LogIndexEntry);
+}
+
+// Index snapshot, little-endian:
+//   u32 magic "ZIDX", u32 version, u32 segment_count, u64 entry_count,
+//   segment_count x (u32 id, u64 end),
+//   entry_count x (u32 segment, u64 offset, u32 len, u64 time, u8[16] zid,
+//                  u32 flags, u32 key_len, key),
+//   u32 crc32 of everything before it
+// Must be called with the store mutex held. Also copies into *dirty the
+// segments with data past their synced prefix.
+static uint8_t *log_build_index(ZenohLogStore *store, size_t *size_out,
+                                struct LogSegment **dirty,
+                                size_t *dirty_count) {
+  size_t size = 20 + store->segment_count * 12 + 4;
+  uint64_t count = 0;
+  for (size_t i = 0; i < store->index_cap; i++) {
+    if (store->index[i].key != NULL) {
+      size += 48 + strlen(store->index[i].key);
+      count++;
+    }
+  }
+
+  uint8_t *buf = (uint8_t *)malloc(size);
+  *dirty = (struct LogSegment *)malloc(
+      (store->segment_count > 0 ? store->segment_count : 1) *
+      sizeof(struct LogSegment));
+  if (buf == NULL || *dirty == NULL) {
+    free(buf);
+    free(*dirty);
+    return NULL;
+  }
+
+  uint8_t *p = buf;
+  put_u32_le(p, LOG_INDEX_MAGIC);
+  put_u32_le(p + 4, LOG_INDEX_VERSION);
+  put_u32_le(p + 8, (uint32_t)store->segment_count);
+  put_u64_le(p + 12, count);
+  p += 20;
+  *dirty_count = 0;
+  for (size_t i = 0; i < store->segment_count; i++) {
+    const struct LogSegment *seg = &store->segments[i];
+    put_u32_le(p, seg->id);
+    put_u64_le(p + 4, seg->end);
+    p += 12;
+    if (seg->end > seg->synced)
+      (*dirty)[(*dirty_count)++] = *seg;
+  }
+  for (size_t i = 0; i < store->index_cap; i++) {
+    const struct LogIndexEntry *e = &store->index[i];
+    if (e->key == NULL)
+      continue;
+    size_t key_len = strlen(e->key);
+    put_u32_le(p, e->segment);
+    put_u64_le(p + 4, e->offset);
+    put_u32_le(p + 12, e->len);
+    put_u64_le(p + 16, e->time);
+    memcpy(p + 24, e->zid, 16);
+    put_u32_le(p + 40, e->deleted ? LOG_FLAG_DELETED : 0);
+    put_u32_le(p + 44, (uint32_t)key_len);
+    memcpy(p + 48, e->key, key_len);
+    p += 48 + key_len;
+  }
+  put_u32_le(p, compute_crc32(buf, size - 4));
+  *size_out = size;
+  return buf;
+}
+
+// Records that segment id is on disk up to end. Must be called with the
+// store mutex held.
+static void log_mark_synced(ZenohLogStore *store, uint32_t id, size_t end) {
+  struct LogSegment *seg = log_segment_find(store, id);
+  if (seg != NULL && seg->synced < end)
+    seg->synced = end;
+}
+
+// Writes an index snapshot. The store mutex is only held to build it: the
+// msyncs and the file write run without it, and only the parts of segments
+// appended since the last sync are flushed. Must be called with
+// compact_mutex held, which keeps the segments mapped and serializes
+// snapshot writers, and without the store mutex.
+static int log_write_index(ZenohLogStore *store) {
+  size_t size = 0, dirty_count = 0;
+  struct LogSegment *dirty = NULL;
+  z_mutex_lock(z_loan_mut(store->mutex));
+  uint8_t *buf = log_build_index(store, &size, &dirty, &dirty_count);
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  if (buf == NULL)
+    return -1;
+
+  // Segments first, so the snapshot never points past durable data
+  for (size_t i = 0; i < dirty_count; i++)
+    log_segment_sync(&dirty[i], dirty[i].synced,
+                     dirty[i].end - dirty[i].synced);
+
+  char tmp_path[1024], path[1024];
+  snprintf(tmp_path, sizeof(tmp_path), "%s/index.zidx.tmp", store->dir);
+  snprintf(path, sizeof(path), "%s/index.zidx", store->dir);
+
+  int rc = -1;
+  FILE *f = fopen(tmp_path, "wb");
+  if (f != NULL) {
+    bool ok = fwrite(buf, 1, size, f) == size && fflush(f) == 0;
+    // Durable before the rename makes it visible
+#if defined(_WIN32)
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && fsync(fileno(f)) == 0;
+#endif
+    fclose(f);
+#if defined(_WIN32)
+    ok = ok && MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && rename(tmp_path, path) == 0;
+#endif
+    rc = ok ? 0 : -1;
+  }
+  free(buf);
+
+  z_mutex_lock(z_loan_mut(store->mutex));
+  for (size_t i = 0; i < dirty_count; i++)
+    log_mark_synced(store, dirty[i].id, dirty[i].end);
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  free(dirty);
+  return rc;
+}
+
+// Loads the snapshot into the index and sets each known segment's end to the
+// snapshot's. Must be called with the store mutex held. On failure the index
+// is left empty.
+static bool log_read_index(ZenohLogStore *store) {
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/index.zidx", store->dir);
+  FILE *f = fopen(path, "rb");
+  if (f == NULL)
+    return false;
+
+  uint8_t *buf = NULL;
+  long size = -1;
+  if (fseek(f, 0, SEEK_END) == 0)
+    size = ftell(f);
+  if (size >= 24 && fseek(f, 0, SEEK_SET) == 0) {
+    buf = (uint8_t *)malloc((size_t)size);
+    if (buf != NULL && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+      free(buf);
+      buf = NULL;
+    }
+  }
+  fclose(f);
+  if (buf == NULL)
+    return false;
+
+  const uint8_t *p = buf;
+  const uint8_t *end = buf + size - 4;
+  bool ok = get_u32_le(p) == LOG_INDEX_MAGIC &&
+            get_u32_le(p + 4) == LOG_INDEX_VERSION &&
+            compute_crc32(buf, (size_t)size - 4) == get_u32_le(end);
+  uint32_t segment_count = ok ? get_u32_le(p + 8) : 0;
+  uint64_t count = ok ? get_u64_le(p + 12) : 0;
+  p += 20;
+
+  if (ok && (size_t)(end - p) < (size_t)segment_count * 12)
+    ok = false;
+  for (uint32_t i = 0; ok && i < segment_count; i++) {
+    struct LogSegment *seg = log_segment_find(store, get_u32_le(p));
+    uint64_t seg_end = get_u64_le(p + 4);
+    if (seg != NULL && seg_end <= seg->size)
+      seg->end = (size_t)seg_end;
+    p += 12;
+  }
+
+  for (uint64_t i = 0; ok && i < count; i++) {
+    if (end - p < 48) {
+      ok = false;
+      break;
+    }
+    uint32_t key_len = get_u32_le(p + 44);
+    if ((size_t)(end - p - 48) < key_len) {
+      ok = false;
+      break;
+    }
+
+    // The record must still be where the snapshot says
+    const char *key = (const char *)(p + 48);
+    struct LogSegment *seg = log_segment_find(store, get_u32_le(p));
+    uint64_t offset = get_u64_le(p + 4);
+    uint32_t len = get_u32_le(p + 12);
+    if (seg == NULL || offset > seg->end || seg->end - offset < len ||
+        len < LOG_RECORD_HEADER_SIZE + key_len ||
+        get_u32_le(seg->base + offset) != LOG_RECORD_MAGIC ||
+        get_u32_le(seg->base + offset + 60) != key_len ||
+        memcmp(seg->base + offset + LOG_RECORD_HEADER_SIZE, key, key_len) !=
+            0) {
+      ok = false;
+      break;
+    }
+
+    struct LogIndexEntry *e = log_index_slot(store, key, key_len);
+    if (e == NULL || e->key != NULL) {
+      ok = false;
+      break;
+    }
+    e->key = (char *)malloc(key_len + 1);
+    if (e->key == NULL) {
+      ok = false;
+      break;
+    }
+    memcpy(e->key, key, key_len);
+    e->key[key_len] = '\0';
+    store->stats.index_bytes += key_len + 1;
+    log_index_point(store, e, false, seg->id, offset, len, get_u64_le(p + 16),
+                    p + 24, (get_u32_le(p + 40) & LOG_FLAG_DELETED) != 0);
+    p += 48 + key_len;
+  }
+
+  free(buf);
+  if (!ok)
+    log_index_clear(store);
+  return ok;
+}
+
+static int log_segment_id_cmp(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// Ids of the segment files in dir, sorted
+static uint32_t *log_list_segments(const char *dir, size_t *count) {
+  size_t n = 0, cap = 16;
+  uint32_t *ids = (uint32_t *)malloc(cap * sizeof(uint32_t));
+  if (ids == NULL)
+    return NULL;
+
+#if defined(_WIN32)
+  char pattern[1024];
+  snprintf(pattern, sizeof(pattern), "%s/*.zlog", dir);
+  WIN32_FIND_DATAA fd;
+  HANDLE h = FindFirstFileA(pattern, &fd);
+  if (h != INVALID_HANDLE_VALUE) {
+    do {
+      const char *name = fd.cFileName;
+#else
+  DIR *d = opendir(dir);
+  if (d != NULL) {
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+      const char *name = ent->d_name;
+#endif
+      char *suffix;
+      unsigned long id = strtoul(name, &suffix, 10);
+      if (suffix == name || strcmp(suffix, ".zlog") != 0 || id > UINT32_MAX)
+        continue;
+      if (n == cap) {
+        uint32_t *grown = (uint32_t *)realloc(ids, cap * 2 * sizeof(uint32_t));
+        if (grown == NULL)
+          break;
+        ids = grown;
+        cap *= 2;
+      }
+      ids[n++] = (uint32_t)id;
+#if defined(_WIN32)
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+  }
+#else
+    }
+    closedir(d);
+  }
+#endif
+
+  qsort(ids, n, sizeof(uint32_t), log_segment_id_cmp);
+  *count = n;
+  return ids;
+}
+
+// Picks the next sealed segment, with an id in [from, active_id), that has
+// enough garbage to compact. Must be called with the store mutex held.
+static struct LogSegment *log_compact_victim(ZenohLogStore *store,
+                                             uint32_t from, uint32_t active_id,
+                                             bool force) {
+  for (size_t i = 0; i < store->segment_count; i++) {
+    struct LogSegment *seg = &store->segments[i];
+    if (seg->id < from)
+      continue;
+    if (seg->id >= active_id)
+      return NULL;
+    double garbage =
+        seg->end > 0 ? (double)(seg->end - seg->live) / (double)seg->end : 1.0;
+    if (force || seg->live == 0 || garbage >= store->compaction_ratio)
+      return seg;
+  }
+  return NULL;
+}
+
+// Copies the live records of segment id from *offset into the active
+// segment, stopping after about LOG_COMPACT_BATCH_BYTES. Returns 1 when the
+// segment is done, 0 if more remains and < 0 on error. Must be called with
+// the store mutex held.
+static int log_compact_batch(ZenohLogStore *store, uint32_t id,
+                             size_t *offset) {
+  size_t copied = 0, size;
+  struct LogSegment *seg = log_segment_find(store, id);
+  // Tombstones only shadow records of older segments; in the oldest one
+  // they have nothing left to hide
+  bool oldest = seg == &store->segments[0];
+  while (*offset < seg->end &&
+         (size = log_record_check(seg, *offset)) > 0) {
+    if (copied >= LOG_COMPACT_BATCH_BYTES)
+      return 0;
+    const uint8_t *p = seg->base + *offset;
+    const char *key = (const char *)(p + LOG_RECORD_HEADER_SIZE);
+    size_t key_len = get_u32_le(p + 60);
+    struct LogIndexEntry *e =
+        log_index_find(store, key, key_len, key_hash(key, key_len));
+
+    if (e->key != NULL && e->segment == id && e->offset == *offset &&
+        e->deleted && oldest) {
+      seg->live -= size;
+      store->stats.live_bytes -= size;
+      store->stats.tombstones--;
+      log_index_remove(store, e);
+    } else if (e->key != NULL && e->segment == id && e->offset == *offset) {
+      struct LogSegment *dst = log_reserve(store, size);
+      if (dst == NULL)
+        return -1;
+      // log_reserve may have moved the segment array
+      seg = log_segment_find(store, id);
+      p = seg->base + *offset;
+      memcpy(dst->base + dst->end, p, size);
+      seg->live -= size;
+      dst->live += size;
+      e->segment = dst->id;
+      e->offset = dst->end;
+      dst->end += size;
+      copied += size;
+    }
+    *offset += size;
+  }
+  return 1;
+}
+
+// Flushes everything appended since (dst_id, dst_start) to disk. Segments
+// are only unmapped by compaction and close, so the mappings stay valid
+// while the store mutex is released for the msync.
+static int log_compact_sync(ZenohLogStore *store, uint32_t dst_id,
+                            size_t dst_start) {
+  z_mutex_lock(z_loan_mut(store->mutex));
+  size_t n = 0;
+  for (size_t i = 0; i < store->segment_count; i++)
+    n += store->segments[i].id >= dst_id;
+  struct LogSegment *segs =
+      (struct LogSegment *)malloc((n > 0 ? n : 1) * sizeof(struct LogSegment));
+  if (segs != NULL)
+    memcpy(segs, &store->segments[store->segment_count - n],
+           n * sizeof(struct LogSegment));
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  if (segs == NULL)
+    return -1;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t start = segs[i].id == dst_id ? dst_start : 0;
+    if (segs[i].synced > start)
+      start = segs[i].synced;
+    if (segs[i].end > start)
+      log_segment_sync(&segs[i], start, segs[i].end - start);
+  }
+
+  z_mutex_lock(z_loan_mut(store->mutex));
+  for (size_t i = 0; i < n; i++)
+    log_mark_synced(store, segs[i].id, segs[i].end);
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  free(segs);
+  return 0;
+}
+
+// Rewrites the live records of sealed segments with too much garbage into the
+// active segment and deletes them. Records are copied in batches so puts can
+// interleave, and the copies are synced before the old segment is unlinked.
+static int log_compact(ZenohLogStore *store, bool force) {
+  z_mutex_lock(z_loan_mut(store->compact_mutex));
+  z_mutex_lock(z_loan_mut(store->mutex));
+  // Segments sealed while compacting are left for the next round
+  uint32_t active_id = store->segments[store->segment_count - 1].id;
+
+  int compacted = 0;
+  uint32_t from = 0;
+  struct LogSegment *seg;
+  while ((seg = log_compact_victim(store, from, active_id, force)) != NULL) {
+    uint32_t id = seg->id;
+    const struct LogSegment *dst = &store->segments[store->segment_count - 1];
+    uint32_t dst_id = dst->id;
+    size_t dst_start = dst->end;
+
+    size_t offset = 0;
+    int rc;
+    while ((rc = log_compact_batch(store, id, &offset)) == 0) {
+      z_mutex_unlock(z_loan_mut(store->mutex));
+      z_mutex_lock(z_loan_mut(store->mutex));
+    }
+    z_mutex_unlock(z_loan_mut(store->mutex));
+
+    if (rc < 0 || log_compact_sync(store, dst_id, dst_start) < 0) {
+      z_mutex_unlock(z_loan_mut(store->compact_mutex));
+      return -1;
+    }
+
+    z_mutex_lock(z_loan_mut(store->mutex));
+    seg = log_segment_find(store, id);
+    log_segment_remove(store, (size_t)(seg - store->segments));
+    store->stats.compactions++;
+    compacted++;
+    from = id + 1;
+  }
+
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  if (compacted > 0)
+    log_write_index(store);
+  z_mutex_unlock(z_loan_mut(store->compact_mutex));
+  return compacted;
+}
+
+static void *log_compactor_task(void *arg) {
+  ZenohLogStore *store = (ZenohLogStore *)arg;
+  uint64_t waited = 0;
+  for (;;) {
+    z_sleep_ms(LOG_COMPACTOR_TICK_MS);
+    waited += LOG_COMPACTOR_TICK_MS;
+    thread_enter(ZENOH_THREAD_WORKER); // Pick up policy changes
+
+    z_mutex_lock(z_loan_mut(store->mutex));
+    bool stopping = store->stopping;
+    z_mutex_unlock(z_loan_mut(store->mutex));
+
+    if (stopping)
+      return NULL;
+    if (waited >= store->compaction_interval_ms) {
+      log_compact(store, false);
+      waited = 0;
+    }
+  }
+}
+
+static void log_store_release(ZenohLogStore *store) {
+  if (atomic_count_dec(&store->refs) != 0)
+    return;
+
+  z_mutex_lock(z_loan_mut(store->mutex));
+  store->stopping = true;
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  z_task_join(z_move(store->compactor));
+
+  z_mutex_lock(z_loan_mut(store->compact_mutex));
+  log_write_index(store);
+  z_mutex_unlock(z_loan_mut(store->compact_mutex));
+  for (size_t i = 0; i < store->segment_count; i++)
+    log_segment_unmap(&store->segments[i]);
+  for (size_t i = 0; i < store->index_cap; i++)
+    free(store->index[i].key);
+  free(store->index);
+  free(store->segments);
+  free(store->dir);
+  z_drop(z_move(store->compact_mutex));
+  z_drop(z_move(store->mutex));
+  free(store);
+}
+
+FFI_PLUGIN_EXPORT ZenohLogStore *
+zenoh_log_store_open(const char *path, ZenohLogStoreOptions *opts) {
+  if (path == NULL)
+    return NULL;
+
+#if defined(_WIN32)
+  CreateDirectoryA(path, NULL);
+#else
+  mkdir(path, 0755);
+#endif
+
+  ZenohLogStore *store = (ZenohLogStore *)calloc(1, sizeof(ZenohLogStore));
+  if (store == NULL)
+    return NULL;
+  store->dir = (char *)malloc(strlen(path) + 1);
+  store->index_cap = 1024;
+  store->index = (struct LogIndexEntry *)calloc(store->index_cap,
+                                                sizeof(struct LogIndexEntry));
+  if (store->dir == NULL || store->index == NULL ||
+      z_mutex_init(&store->mutex) < 0) {
+    free(store->dir);
+    free(store->index);
+    free(store);
+    return NULL;
+  }
+  if (z_mutex_init(&store->compact_mutex) < 0) {
+    z_drop(z_move(store->mutex));
+    free(store->dir);
+    free(store->index);
+    free(store);
+    return NULL;
+  }
+  strcpy(store->dir, path);
+  store->refs = 1;
+  store->stats.index_bytes = store->index_cap * sizeof(struct LogIndexEntry);
+  store->segment_size = opts != NULL && opts->segment_size > 0
+                            ? opts->segment_size
+                            : LOG_DEFAULT_SEGMENT_SIZE;
+  store->compaction_ratio = opts != NULL && opts->compaction_ratio > 0
+                                ? opts->compaction_ratio
+                                : LOG_DEFAULT_COMPACTION_RATIO;
+  store->compaction_interval_ms = opts != NULL &&
+                                          opts->compaction_interval_ms > 0
+                                      ? opts->compaction_interval_ms
+                                      : LOG_DEFAULT_COMPACTION_INTERVAL_MS;
+  store->sync_writes = opts != NULL && opts->sync_writes;
+
+  size_t id_count = 0;
+  uint32_t *ids = log_list_segments(path, &id_count);
+  bool ok = ids != NULL;
+  for (size_t i = 0; ok && i < id_count; i++)
+    ok = log_segment_add(store, ids[i], 0) != NULL;
+  free(ids);
+
+  if (ok) {
+    // Known segments resume after the snapshot, newer ones from the start
+    bool indexed = log_read_index(store);
+    for (size_t i = 0; i < store->segment_count; i++) {
+      struct LogSegment *seg = &store->segments[i];
+      log_replay_segment(store, seg, indexed ? seg->end : 0);
+      seg->synced = seg->end; // Read back from the file
+    }
+    ok = store->segment_count > 0 ||
+         log_segment_add(store, 0, store->segment_size) != NULL;
+  }
+
+  if (ok) {
+    ok = worker_start(&store->compactor, log_compactor_task, store) == 0;
+  }
+
+  if (!ok) {
+    for (size_t i = 0; i < store->segment_count; i++)
+      log_segment_unmap(&store->segments[i]);
+    for (size_t i = 0; i < store->index_cap; i++)
+      free(store->index[i].key);
+    free(store->index);
+    free(store->segments);
+    free(store->dir);
+    z_drop(z_move(store->compact_mutex));
+    z_drop(z_move(store->mutex));
+    free(store);
+    return NULL;
+  }
+
+  return store;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_log_store_close(ZenohLogStore *store) {
+  if (store != NULL)
+    log_store_release(store);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_log_store_put(ZenohLogStore *store,
+                                          const char *key, const uint8_t *data,
+                                          size_t len,
+                                          ZenohEncodingId encoding) {
+  if (store == NULL || key == NULL || (data == NULL && len > 0))
+    return -1;
+
+  static const uint8_t local_zid[16] = {0};
+  int rc = log_store_apply(store, key, ntp64_now(), local_zid, NULL, false,
+                           zenoh_encoding_to_string(encoding), NULL, data, len,
+                           0);
+  return rc < 0 ? rc : 0;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_log_store_delete(ZenohLogStore *store,
+                                             const char *key) {
+  if (store == NULL || key == NULL)
+    return -1;
+
+  static const uint8_t local_zid[16] = {0};
+  int rc = log_store_apply(store, key, ntp64_now(), local_zid, NULL, true,
+                           NULL, NULL, NULL, 0, 0);
+  return rc < 0 ? rc : 0;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_log_store_get(ZenohLogStore *store,
+                                          const char *key, uint8_t **data,
+                                          size_t *len) {
+  if (store == NULL || key == NULL || data == NULL || len == NULL)
+    return -1;
+
+  *data = NULL;
+  *len = 0;
+
+  int found = 0;
+  size_t key_len = strlen(key);
+  z_mutex_lock(z_loan_mut(store->mutex));
+  struct LogIndexEntry *e =
+      log_index_find(store, key, key_len, key_hash(key, key_len));
+  if (e->key != NULL && !e->deleted) {
+    const uint8_t *p = log_segment_find(store, e->segment)->base + e->offset;
+    size_t value_len = get_u32_le(p + 68);
+    found = 1;
+    if (value_len > 0) {
+      *data = (uint8_t *)malloc(value_len);
+      if (*data == NULL) {
+        found = -1;
+      } else {
+        memcpy(*data,
+               p + LOG_RECORD_HEADER_SIZE + key_len + get_u32_le(p + 64),
+               value_len);
+        *len = value_len;
+      }
+    }
+  }
+  z_mutex_unlock(z_loan_mut(store->mutex));
+
+  return found;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_log_store_stats(ZenohLogStore *store,
+                                            ZenohLogStoreStats *stats) {
+  if (store == NULL || stats == NULL)
+    return -1;
+
+  z_mutex_lock(z_loan_mut(store->mutex));
+  *stats = store->stats;
+  z_mutex_unlock(z_loan_mut(store->mutex));
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_log_store_compact(ZenohLogStore *store) {
+  if (store == NULL)
+    return -1;
+
+  return log_compact(store, true);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_log_store_flush(ZenohLogStore *store) {
+  if (store == NULL)
+    return -1;
+
+  z_mutex_lock(z_loan_mut(store->compact_mutex));
+  int rc = log_write_index(store);
+  z_mutex_unlock(z_loan_mut(store->compact_mutex));
+  return rc;
+}
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+struct StorageEntry {
+  uint8_t *payload;
+  size_t len;
+  z_owned_encoding_t encoding;
+  z_timestamp_t timestamp;
+  bool deleted;   // Tombstone, so a late older put cannot resurrect the key
+  uint64_t visit; // Last query that reported this entry
+};
+
+// Key trie with one node per '/'-separated chunk
+struct StorageNode {
+  char *chunk;
+  size_t chunk_len;
+  struct StorageNode **children; // Sorted by chunk
+  size_t child_count;
+  size_t child_cap;
+  struct StorageEntry *entry;
+};
+
+struct ZenohStorage {
+  z_owned_subscriber_t subscriber;
+  z_owned_queryable_t queryable;
+  z_owned_mutex_t mutex;
+  atomic_count_t refs; // User handle plus the subscriber and queryable closures
+  ZenohSession *session;
+  ZenohLogStore *log; // Persistent backend; the trie is used when NULL
+  struct StorageNode root;
+  size_t max_entries;
+  ZenohStorageChangeCallback change_callback;
+  void *context;
+  uint64_t visit;
+  ZenohStorageStats stats; // Guarded by mutex
+};
+
+struct StorageReply {
+  char *key;
+  z_owned_bytes_t payload;
+  z_owned_encoding_t encoding;
+  z_timestamp_t timestamp;
+  bool has_timestamp;
+};
+
+// With a limit, items is a max-heap on key holding the smallest keys seen,
+// so matches past the limit are dropped before their values are copied
+struct StorageReplyList {
+  struct StorageReply *items;
+  size_t count;
+  size_t cap;
+  struct TimeRange range;
+  size_t limit;     // `_limit` parameter, 0 = unlimited
+  char *after;      // `_cursor` parameter, keys up to it are skipped
+  bool replacing;   // The pushed slot replaces the heap top
+};
+
+static int storage_chunk_cmp(const char *a, size_t a_len, const char *b,
+                             size_t b_len) {
+  int c = memcmp(a, b, a_len < b_len ? a_len : b_len);
+  if (c != 0)
+    return c;
+  return a_len < b_len ? -1 : (a_len > b_len ? 1 : 0);
+}
+
+// Binary search; returns the child or NULL and the insertion position
+static struct StorageNode *storage_child_find(struct StorageNode *node,
+                                              const char *chunk, size_t len,
+                                              size_t *pos) {
+  size_t lo = 0, hi = node->child_count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    struct StorageNode *child = node->children[mid];
+    int c = storage_chunk_cmp(child->chunk, child->chunk_len, chunk, len);
+    if (c == 0) {
+      *pos = mid;
+      return child;
+    }
+    if (c < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *pos = lo;
+  return NULL;
+}
+
+// Must be called with the storage mutex held
+static struct StorageNode *storage_node_get(ZenohStorage *storage,
+                                            const char *key, bool create) {
+  struct StorageNode *node = &storage->root;
+  const char *p = key;
+
+  for (;;) {
+    const char *slash = strchr(p, '/');
+    size_t len = slash != NULL ? (size_t)(slash - p) : strlen(p);
+
+    size_t pos;
+    struct StorageNode *child = storage_child_find(node, p, len, &pos);
+    if (child == NULL) {
+      if (!create)
+        return NULL;
+
+      if (node->child_count == node->child_cap) {
+        size_t cap = node->child_cap > 0 ? node->child_cap * 2 : 4;
+        struct StorageNode **children = (struct StorageNode **)realloc(
+            node->children, cap * sizeof(struct StorageNode *));
+        if (children == NULL)
+          return NULL;
+        storage->stats.memory_bytes +=
+            (cap - node->child_cap) * sizeof(struct StorageNode *);
+        node->children = children;
+        node->child_cap = cap;
+      }
+
+      child = (struct StorageNode *)calloc(1, sizeof(struct StorageNode));
+      if (child == NULL)
+        return NULL;
+      child->chunk = (char *)malloc(len + 1);
+      if (child->chunk == NULL) {
+        free(child);
+        return NULL;
+      }
+      memcpy(child->chunk, p, len);
+      child->chunk[len] = '\0';
+      child->chunk_len = len;
+      storage->stats.memory_bytes += sizeof(struct StorageNode) + len + 1;
+
+      memmove(&node->children[pos + 1], &node->children[pos],
+              (node->child_count - pos) * sizeof(struct StorageNode *));
+      node->children[pos] = child;
+      node->child_count++;
+    }
+
+    node = child;
+    if (slash == NULL)
+      return node;
+    p = slash + 1;
+  }
+}
+
+static void storage_node_free(struct StorageNode *node) {
+  for (size_t i = 0; i < node->child_count; i++) {
+    storage_node_free(node->children[i]);
+    free(node->children[i]);
+  }
+  free(node->children);
+  free(node->chunk);
+  if (node->entry != NULL) {
+    free(node->entry->payload);
+    z_drop(z_move(node->entry->encoding));
+    free(node->entry);
+  }
+}
+
+// Last-writer-wins order: NTP64 time, then the writer's zid
+static bool storage_timestamp_newer(const z_timestamp_t *a,
+                                    const z_timestamp_t *b) {
+  uint64_t ta = z_timestamp_ntp64_time(a);
+  uint64_t tb = z_timestamp_ntp64_time(b);
+  if (ta != tb)
+    return ta > tb;
+  z_id_t ida = z_timestamp_id(a);
+  z_id_t idb = z_timestamp_id(b);
+  return memcmp(ida.id, idb.id, sizeof(ida.id)) > 0;
+}
+
+// Matches one key chunk against a pattern chunk that may contain "$*"
+static bool storage_chunk_matches(const char *pat, size_t pat_len,
+                                  const char *chunk, size_t chunk_len) {
+  if (pat_len == 1 && pat[0] == '*')
+    return chunk_len == 0 || chunk[0] != '@';
+
+  while (pat_len > 0) {
+    if (pat_len >= 2 && pat[0] == '$' && pat[1] == '*') {
+      for (size_t skip = 0; skip <= chunk_len; skip++) {
+        if (storage_chunk_matches(pat + 2, pat_len - 2, chunk + skip,
+                                  chunk_len - skip))
+          return true;
+      }
+      return false;
+    }
+    if (chunk_len == 0 || *pat != *chunk)
+      return false;
+    pat++, pat_len--;
+    chunk++, chunk_len--;
+  }
+  return chunk_len == 0;
+}
+
+struct StorageMatch {
+  const char **chunks;
+  size_t *chunk_lens;
+  size_t chunk_count;
+  uint64_t visit;
+  void (*visitor)(struct StorageNode *node, const char *key, void *arg);
+  void *arg;
+  char *key; // Path of the current node
+  size_t key_len;
+  size_t key_cap;
+};
+
+static bool storage_match_push(struct StorageMatch *m, struct StorageNode *n) {
+  size_t need = m->key_len + n->chunk_len + 2;
+  if (need > m->key_cap) {
+    size_t cap = need * 2;
+    char *key = (char *)realloc(m->key, cap);
+    if (key == NULL)
+      return false;
+    m->key = key;
+    m->key_cap = cap;
+  }
+  if (m->key_len > 0)
+    m->key[m->key_len++] = '/';
+  memcpy(m->key + m->key_len, n->chunk, n->chunk_len);
+  m->key_len += n->chunk_len;
+  m->key[m->key_len] = '\0';
+  return true;
+}
+
+// Must be called with the storage mutex held
+static void storage_match(struct StorageMatch *m, struct StorageNode *node,
+                          size_t i) {
+  if (i == m->chunk_count) {
+    struct StorageEntry *e = node->entry;
+    if (e != NULL && !e->deleted && e->visit != m->visit) {
+      e->visit = m->visit;
+      m->visitor(node, m->key, m->arg);
+    }
+    return;
+  }
+
+  const char *pat = m->chunks[i];
+  size_t pat_len = m->chunk_lens[i];
+  size_t saved_len = m->key_len;
+
+  if (pat_len == 2 && pat[0] == '*' && pat[1] == '*') {
+    // "**" matches zero chunks, or one chunk and stays on the pattern
+    storage_match(m, node, i + 1);
+    for (size_t c = 0; c < node->child_count; c++) {
+      struct StorageNode *child = node->children[c];
+      if (child->chunk_len > 0 && child->chunk[0] == '@')
+        continue;
+      if (!storage_match_push(m, child))
+        return;
+      storage_match(m, child, i);
+      m->key_len = saved_len;
+    }
+  } else if (memchr(pat, '*', pat_len) != NULL) {
+    for (size_t c = 0; c < node->child_count; c++) {
+      struct StorageNode *child = node->children[c];
+      if (!storage_chunk_matches(pat, pat_len, child->chunk, child->chunk_len))
+        continue;
+      if (!storage_match_push(m, child))
+        return;
+      storage_match(m, child, i + 1);
+      m->key_len = saved_len;
+    }
+  } else {
+    size_t pos;
+    struct StorageNode *child = storage_child_find(node, pat, pat_len, &pos);
+    if (child != NULL && storage_match_push(m, child)) {
+      storage_match(m, child, i + 1);
+      m->key_len = saved_len;
+    }
+  }
+  if (m->key != NULL)
+    m->key[m->key_len] = '\0';
+}
+
+// Must be called with the storage mutex held. Calls visitor for every live
+// entry whose key matches key_expr, at most once per entry.
+static void storage_for_each_match(ZenohStorage *storage, const char *key_expr,
+                                   size_t key_expr_len,
+                                   void (*visitor)(struct StorageNode *,
+                                                   const char *, void *),
+                                   void *arg) {
+  size_t count = 1;
+  for (size_t i = 0; i < key_expr_len; i++) {
+    if (key_expr[i] == '/')
+      count++;
+  }
+
+  const char **chunks = (const char **)malloc(count * sizeof(const char *));
+  size_t *chunk_lens = (size_t *)malloc(count * sizeof(size_t));
+  if (chunks == NULL || chunk_lens == NULL) {
+    free(chunks);
+    free(chunk_lens);
+    return;
+  }
+
+  size_t n = 0;
+  const char *start = key_expr;
+  const char *end = key_expr + key_expr_len;
+  for (const char *p = key_expr; p <= end; p++) {
+    if (p == end || *p == '/') {
+      chunks[n] = start;
+      chunk_lens[n] = (size_t)(p - start);
+      n++;
+      start = p + 1;
+    }
+  }
+
+  struct StorageMatch m = {chunks, chunk_lens, n, ++storage->visit,
+                           visitor, arg, NULL, 0, 0};
+  storage_match(&m, &storage->root, 0);
+
+  free(m.key);
+  free(chunks);
+  free(chunk_lens);
+}
+
+static void storage_release(ZenohStorage *storage) {
+  if (atomic_count_dec(&storage->refs) != 0)
+    return;
+  storage_node_free(&storage->root);
+  if (storage->log != NULL)
+    log_store_release(storage->log);
+  session_release(storage->session);
+  z_drop(z_move(storage->mutex));
+  free(storage);
+}
+
+static void drop_storage_closure(void *arg) {
+  storage_release((ZenohStorage *)arg);
+}
+
+// Applies an update to the key trie. Takes ownership of payload.
+static bool memory_storage_apply(ZenohStorage *storage, const char *key,
+                                 const z_timestamp_t *ts,
+                                 const z_loaned_encoding_t *encoding,
+                                 uint8_t *payload, size_t len, bool deleted) {
+  z_mutex_lock(z_loan_mut(storage->mutex));
+
+  bool applied = false;
+  struct StorageNode *node = storage_node_get(storage, key, false);
+  if (node == NULL || node->entry == NULL) {
+    uint64_t keys = storage->stats.entries + storage->stats.tombstones;
+    if (storage->max_entries == 0 || keys < storage->max_entries) {
+      node = storage_node_get(storage, key, true);
+      if (node != NULL) {
+        node->entry =
+            (struct StorageEntry *)calloc(1, sizeof(struct StorageEntry));
+        if (node->entry != NULL) {
+          z_encoding_clone(&node->entry->encoding, z_encoding_loan_default());
+          node->entry->deleted = true;
+          storage->stats.tombstones++;
+          storage->stats.memory_bytes += sizeof(struct StorageEntry);
+          applied = true;
+        }
+      }
+    }
+  } else {
+    applied = storage_timestamp_newer(ts, &node->entry->timestamp);
+  }
+
+  if (applied) {
+    struct StorageEntry *e = node->entry;
+    if (e->deleted)
+      storage->stats.tombstones--;
+    else
+      storage->stats.entries--;
+    storage->stats.memory_bytes -= e->len;
+
+    free(e->payload);
+    e->payload = payload;
+    e->len = len;
+    e->timestamp = *ts;
+    e->deleted = deleted;
+    z_drop(z_move(e->encoding));
+    z_encoding_clone(&e->encoding, encoding);
+    payload = NULL;
+
+    if (deleted)
+      storage->stats.tombstones++;
+    else
+      storage->stats.entries++;
+    storage->stats.memory_bytes += len;
+  } else {
+    storage->stats.rejected++;
+  }
+
+  z_mutex_unlock(z_loan_mut(storage->mutex));
+  free(payload);
+  return applied;
+}
+
+// Appends an update to the log store, reading the payload straight into the
+// mapped segment
+static bool log_storage_apply(ZenohStorage *storage, const char *key,
+                              const z_timestamp_t *ts,
+                              const z_loaned_sample_t *sample, bool deleted) {
+  z_id_t zid = z_timestamp_id(ts);
+  char *encoding =
+      deleted ? NULL : copy_encoding_string(z_sample_encoding(sample));
+  int rc = log_store_apply(storage->log, key, z_timestamp_ntp64_time(ts),
+                           zid.id, ts, deleted, encoding,
+                           deleted ? NULL : z_sample_payload(sample), NULL, 0,
+                           storage->max_entries);
+  free(encoding);
+
+  if (rc <= 0) {
+    z_mutex_lock(z_loan_mut(storage->mutex));
+    storage->stats.rejected++;
+    z_mutex_unlock(z_loan_mut(storage->mutex));
+  }
+  return rc > 0;
+}
+
+static void storage_sample_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
+  ZenohStorage *storage = (ZenohStorage *)arg;
+
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+  size_t key_len = z_string_len(z_loan(key_str));
+  char *key = (char *)malloc(key_len + 1);
+  if (key == NULL)
+    return;
+  memcpy(key, z_string_data(z_loan(key_str)), key_len);
+  key[key_len] = '\0';
+
+  // Wildcard updates are not applied
+  if (strchr(key, '*') != NULL) {
+    z_mutex_lock(z_loan_mut(storage->mutex));
+    storage->stats.rejected++;
+    z_mutex_unlock(z_loan_mut(storage->mutex));
+    free(key);
+    return;
+  }
+
+  // Samples from sessions without timestamping get a local one
+  z_timestamp_t ts;
+  const z_timestamp_t *sample_ts = z_sample_timestamp(sample);
+  if (sample_ts != NULL) {
+    ts = *sample_ts;
+  } else if (z_timestamp_new(&ts, z_loan(storage->session->session)) < 0) {
+    free(key);
+    return;
+  }
+
+  bool deleted = z_sample_kind(sample) == Z_SAMPLE_KIND_DELETE;
+  bool applied;
+  if (storage->log != NULL) {
+    applied = log_storage_apply(storage, key, &ts, sample, deleted);
+  } else {
+    size_t len = 0;
+    uint8_t *payload =
+        deleted ? NULL : get_bytes_data(z_sample_payload(sample), &len);
+    applied = memory_storage_apply(storage, key, &ts, z_sample_encoding(sample),
+                                   payload, len, deleted);
+  }
+
+  if (applied && storage->change_callback != NULL) {
+    // DO NOT FREE - NativeCallable.listener is async, Dart will free these
+    storage->change_callback(key, deleted ? ZENOH_SAMPLE_KIND_DELETE
+                                          : ZENOH_SAMPLE_KIND_PUT,
+                             storage->context);
+  } else {
+    free(key);
+  }
+}
+
+static void storage_reply_swap(struct StorageReplyList *list, size_t a,
+                               size_t b) {
+  struct StorageReply tmp = list->items[a];
+  list->items[a] = list->items[b];
+  list->items[b] = tmp;
+}
+
+// Whether key falls outside the requested page
+static bool storage_reply_skip(const struct StorageReplyList *list,
+                               const char *key, size_t key_len) {
+  if (list->after != NULL && key_cmp(key, key_len, list->after) <= 0)
+    return true;
+  return list->limit > 0 && list->count == list->limit &&
+         key_cmp(key, key_len, list->items[0].key) >= 0;
+}
+
+// Next free reply slot with its key set, or NULL. The caller fills in the
+// rest and calls storage_reply_commit.
+static struct StorageReply *storage_reply_push(struct StorageReplyList *list,
+                                               const char *key,
+                                               size_t key_len) {
+  list->replacing = list->limit > 0 && list->count == list->limit;
+  if (list->replacing) {
+    char *copy = (char *)malloc(key_len + 1);
+    if (copy == NULL)
+      return NULL;
+    memcpy(copy, key, key_len);
+    copy[key_len] = '\0';
+
+    // Evict the greatest key
+    struct StorageReply *top = &list->items[0];
+    z_drop(z_move(top->payload));
+    z_drop(z_move(top->encoding));
+    free(top->key);
+    top->key = copy;
+    return top;
+  }
+
+  if (list->count == list->cap) {
+    size_t cap = list->cap > 0 ? list->cap * 2 : 16;
+    struct StorageReply *items = (struct StorageReply *)realloc(
+        list->items, cap * sizeof(struct StorageReply));
+    if (items == NULL)
+      return NULL;
+    list->items = items;
+    list->cap = cap;
+  }
+
+  struct StorageReply *r = &list->items[list->count];
+  r->key = (char *)malloc(key_len + 1);
+  if (r->key == NULL)
+    return NULL;
+  memcpy(r->key, key, key_len);
+  r->key[key_len] = '\0';
+  return r;
+}
+
+// Adds the slot returned by storage_reply_push, restoring the heap order
+static void storage_reply_commit(struct StorageReplyList *list) {
+  if (list->limit == 0) {
+    list->count++;
+    return;
+  }
+
+  size_t i;
+  if (list->replacing) {
+    // Sift down
+    i = 0;
+    for (;;) {
+      size_t largest = i, l = 2 * i + 1, r = 2 * i + 2;
+      if (l < list->count &&
+          strcmp(list->items[l].key, list->items[largest].key) > 0)
+        largest = l;
+      if (r < list->count &&
+          strcmp(list->items[r].key, list->items[largest].key) > 0)
+        largest = r;
+      if (largest == i)
+        break;
+      storage_reply_swap(list, i, largest);
+      i = largest;
+    }
+    return;
+  }
+
+  // Sift up
+  i = list->count++;
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (strcmp(list->items[i].key, list->items[parent].key) <= 0)
+      break;
+    storage_reply_swap(list, i, parent);
+    i = parent;
+  }
+}
+
+static int storage_reply_cmp(const void *a, const void *b) {
+  return strcmp(((const struct StorageReply *)a)->key,
+                ((const struct StorageReply *)b)->key);
+}
+
+static void storage_collect_reply(struct StorageNode *node, const char *key,
+                                  void *arg) {
+  struct StorageReplyList *list = (struct StorageReplyList *)arg;
+  uint64_t time = z_timestamp_ntp64_time(&node->entry->timestamp);
+  if (time < list->range.start || time > list->range.end)
+    return;
+  size_t key_len = strlen(key);
+  if (storage_reply_skip(list, key, key_len))
+    return;
+
+  struct StorageReply *r = storage_reply_push(list, key, key_len);
+  if (r == NULL)
+    return;
+  z_bytes_copy_from_buf(&r->payload, node->entry->payload, node->entry->len);
+  z_encoding_clone(&r->encoding, z_loan(node->entry->encoding));
+  r->timestamp = node->entry->timestamp;
+  r->has_timestamp = true;
+  storage_reply_commit(list);
+}
+
+static void storage_reply_list_clear(struct StorageReplyList *list) {
+  for (size_t i = 0; i < list->count; i++) {
+    z_drop(z_move(list->items[i].payload));
+    z_drop(z_move(list->items[i].encoding));
+    free(list->items[i].key);
+  }
+  list->count = 0;
+}
+
+// Copies the record of one index entry into list. Returns false when the
+// list could not grow.
+static bool log_storage_collect_entry(ZenohLogStore *store,
+                                      const struct LogIndexEntry *e,
+                                      struct StorageReplyList *list) {
+  if (e->key == NULL || e->deleted || e->time < list->range.start ||
+      e->time > list->range.end)
+    return true;
+
+  const uint8_t *p = log_segment_find(store, e->segment)->base + e->offset;
+  size_t key_len = get_u32_le(p + 60);
+  size_t enc_len = get_u32_le(p + 64);
+  const uint8_t *enc = p + LOG_RECORD_HEADER_SIZE + key_len;
+  if (storage_reply_skip(list, e->key, key_len))
+    return true;
+
+  struct StorageReply *r = storage_reply_push(list, e->key, key_len);
+  if (r == NULL)
+    return false;
+  z_bytes_copy_from_buf(&r->payload, enc + enc_len, get_u32_le(p + 68));
+  if (z_encoding_from_substr(&r->encoding, (const char *)enc, enc_len) < 0)
+    z_encoding_clone(&r->encoding, z_encoding_loan_default());
+
+  // Local writes carry no zenoh timestamp
+  r->has_timestamp = false;
+  if ((get_u32_le(p + 56) & LOG_FLAG_TIMESTAMP) != 0) {
+    memcpy(&r->timestamp, p + 32, sizeof(z_timestamp_t));
+    z_id_t zid = z_timestamp_id(&r->timestamp);
+    r->has_timestamp = z_timestamp_ntp64_time(&r->timestamp) == e->time &&
+                       memcmp(zid.id, e->zid, 16) == 0;
+  }
+  storage_reply_commit(list);
+  return true;
+}
+
+// Copies the live records intersecting key_expr out of the mapped segments.
+// A key expression without wildcards is a single index lookup. Wildcard
+// scans release the store lock every LOG_COLLECT_BATCH slots so puts are
+// not held up by a large index. Entries only change slots when the index
+// grows or drops a tombstone; the scan then starts over, and after
+// LOG_COLLECT_RETRIES restarts keeps the lock to the end.
+static void log_storage_collect(ZenohLogStore *store,
+                                const z_loaned_keyexpr_t *key_expr,
+                                struct StorageReplyList *list) {
+  z_view_string_t ke_str;
+  z_keyexpr_as_view_string(key_expr, &ke_str);
+  const char *ke = z_string_data(z_loan(ke_str));
+  size_t ke_len = z_string_len(z_loan(ke_str));
+
+  z_mutex_lock(z_loan_mut(store->mutex));
+  if (memchr(ke, '*', ke_len) == NULL) {
+    log_storage_collect_entry(
+        store, log_index_find(store, ke, ke_len, key_hash(ke, ke_len)), list);
+  } else {
+    uint64_t epoch = store->index_epoch;
+    int restarts = 0;
+    bool ok = true;
+    size_t i = 0;
+    while (ok && i < store->index_cap) {
+      size_t batch_end = i + LOG_COLLECT_BATCH;
+      for (; ok && i < store->index_cap && i < batch_end; i++) {
+        const struct LogIndexEntry *e = &store->index[i];
+        if (e->key == NULL)
+          continue;
+
+        z_view_keyexpr_t entry_ke;
+        z_view_keyexpr_from_str_unchecked(&entry_ke, e->key);
+        if (z_keyexpr_intersects(key_expr, z_loan(entry_ke)))
+          ok = log_storage_collect_entry(store, e, list);
+      }
+      if (!ok || i >= store->index_cap || restarts >= LOG_COLLECT_RETRIES)
+        continue;
+
+      z_mutex_unlock(z_loan_mut(store->mutex));
+      z_mutex_lock(z_loan_mut(store->mutex));
+      if (store->index_epoch != epoch) {
+        storage_reply_list_clear(list);
+        epoch = store->index_epoch;
+        restarts++;
+        i = 0;
+      }
+    }
+  }
+  z_mutex_unlock(z_loan_mut(store->mutex));
+}
+
+static void storage_query_handler(z_loaned_query_t *query, void *arg) {
+  thread_enter_delivery();
+  ZenohStorage *storage = (ZenohStorage *)arg;
+
+  z_view_string_t ke;
+  z_keyexpr_as_view_string(z_query_keyexpr(query), &ke);
+
+  // Copy matches out so replies are sent without holding the lock
+  struct StorageReplyList list = {NULL, 0, 0, {0, UINT64_MAX}, 0, NULL, false};
+  query_time_range(query, &list.range);
+  query_page(query, &list.limit, &list.after);
+  z_mutex_lock(z_loan_mut(storage->mutex));
+  storage->stats.queries++;
+  if (storage->log == NULL)
+    storage_for_each_match(storage, z_string_data(z_loan(ke)),
+                           z_string_len(z_loan(ke)), storage_collect_reply,
+                           &list);
+  z_mutex_unlock(z_loan_mut(storage->mutex));
+  if (storage->log != NULL)
+    log_storage_collect(storage->log, z_query_keyexpr(query), &list);
+  if (list.limit > 0)
+    qsort(list.items, list.count, sizeof(struct StorageReply),
+          storage_reply_cmp);
+
+  for (size_t i = 0; i < list.count; i++) {
+    struct StorageReply *r = &list.items[i];
+
+    z_view_keyexpr_t keyexpr;
+    if (z_view_keyexpr_from_str(&keyexpr, r->key) == 0) {
+      z_query_reply_options_t options;
+      z_query_reply_options_default(&options);
+      options.encoding = z_move(r->encoding);
+      options.timestamp = r->has_timestamp ? &r->timestamp : NULL;
+      z_query_reply(query, z_loan(keyexpr), z_move(r->payload), &options);
+    }
+
+    // No-ops once moved into the reply
+    z_drop(z_move(r->payload));
+    z_drop(z_move(r->encoding));
+    free(r->key);
+  }
+  free(list.items);
+  free(list.after);
+}
+
+static ZenohStorage *declare_storage(ZenohSession *session,
+                                     const char *key_expr,
+                                     ZenohLogStore *log,
+                                     ZenohStorageOptions *opts,
+                                     ZenohStorageChangeCallback on_change,
+                                     void *context) {
+  if (session == NULL || key_expr == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key_expr) < 0)
+    return NULL;
+
+  ZenohStorage *storage = (ZenohStorage *)calloc(1, sizeof(ZenohStorage));
+  if (storage == NULL || z_mutex_init(&storage->mutex) < 0) {
+    free(storage);
+    return NULL;
+  }
+  storage->refs = 1;
+  // Kept alive for z_timestamp_new in the sample handler
+  storage->session = session;
+  atomic_count_inc(&session->refs);
+  if (log != NULL) {
+    atomic_count_inc(&log->refs);
+    storage->log = log;
+  }
+  storage->max_entries = opts != NULL ? opts->max_entries : 0;
+  storage->change_callback = on_change;
+  storage->context = context;
+
+  // Each closure holds a reference, released by its drop
+  atomic_count_inc(&storage->refs);
+  z_subscriber_options_t sub_options;
+  z_subscriber_options_default(&sub_options);
+  z_owned_closure_sample_t sample_closure;
+  z_closure_sample(&sample_closure, storage_sample_handler,
+                   drop_storage_closure, storage);
+  if (z_declare_subscriber(z_loan(session->session), &storage->subscriber,
+                           z_loan(keyexpr), z_move(sample_closure),
+                           &sub_options) < 0) {
+    storage_release(storage);
+    return NULL;
+  }
+
+  atomic_count_inc(&storage->refs);
+  z_queryable_options_t q_options;
+  z_queryable_options_default(&q_options);
+  q_options.complete = opts != NULL ? opts->complete : true;
+  z_owned_closure_query_t query_closure;
+  z_closure_query(&query_closure, storage_query_handler, drop_storage_closure,
+                  storage);
+  if (z_declare_queryable(z_loan(session->session), &storage->queryable,
+                          z_loan(keyexpr), z_move(query_closure),
+                          &q_options) < 0) {
+    z_drop(z_move(storage->subscriber));
+    storage_release(storage);
+    return NULL;
+  }
+
+  return storage;
+}
+
+FFI_PLUGIN_EXPORT ZenohStorage *zenoh_declare_memory_storage(
+    ZenohSession *session, const char *key_expr, ZenohStorageOptions *opts,
+    ZenohStorageChangeCallback on_change, void *context) {
+  return declare_storage(session, key_expr, NULL, opts, on_change, context);
+}
+
+FFI_PLUGIN_EXPORT ZenohStorage *zenoh_declare_log_storage(
+    ZenohSession *session, const char *key_expr, ZenohLogStore *store,
+    ZenohStorageOptions *opts, ZenohStorageChangeCallback on_change,
+    void *context) {
+  if (store == NULL)
+    return NULL;
+  return declare_storage(session, key_expr, store, opts, on_change, context);
+}
+
+FFI_PLUGIN_EXPORT int zenoh_storage_get(ZenohStorage *storage, const char *key,
+                                        uint8_t **data, size_t *len) {
+  if (storage == NULL || key == NULL || data == NULL || len == NULL)
+    return -1;
+
+  if (storage->log != NULL)
+    return zenoh_log_store_get(storage->log, key, data, len);
+
+  *data = NULL;
+  *len = 0;
+
+  int found = 0;
+  z_mutex_lock(z_loan_mut(storage->mutex));
+  struct StorageNode *node = storage_node_get(storage, key, false);
+  if (node != NULL && node->entry != NULL && !node->entry->deleted) {
+    found = 1;
+    if (node->entry->len > 0) {
+      *data = (uint8_t *)malloc(node->entry->len);
+      if (*data == NULL) {
+        found = -1;
+      } else {
+        memcpy(*data, node->entry->payload, node->entry->len);
+        *len = node->entry->len;
+      }
+    }
+  }
+  z_mutex_unlock(z_loan_mut(storage->mutex));
+
+  return found;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_storage_stats(ZenohStorage *storage,
+                                          ZenohStorageStats *stats) {
+  if (storage == NULL || stats == NULL)
+    return -1;
+
+  z_mutex_lock(z_loan_mut(storage->mutex));
+  *stats = storage->stats;
+  z_mutex_unlock(z_loan_mut(storage->mutex));
+
+  if (storage->log != NULL) {
+    ZenohLogStoreStats log_stats;
+    zenoh_log_store_stats(storage->log, &log_stats);
+    stats->entries = log_stats.entries;
+    stats->tombstones = log_stats.tombstones;
+    stats->memory_bytes = log_stats.index_bytes;
+  }
+  return 0;
+}
+
+FFI_PLUGIN_EXPORT void zenoh_undeclare_storage(ZenohStorage *storage) {
+  if (storage == NULL)
+    return;
+
+  z_drop(z_move(storage->queryable));
+  z_drop(z_move(storage->subscriber));
+  storage_release(storage);
+}
+
+// ============================================================================
+// Time Series
+// ============================================================================
+//
+// Each key keeps a fixed-capacity ring of (NTP64 time, value) columns.
+// Queries reply with one payload per key of packed little-endian
+// (u64 NTP64 time, f64 value) points, optionally downsampled with
+// `step=<duration>&agg=min|max|avg|last`.
+
+#define TS_DEFAULT_CAPACITY 3600
+#define TS_POINT_SIZE 16
+
+enum TimeSeriesAgg {
+  TS_AGG_NONE,
+  TS_AGG_MIN,
+  TS_AGG_MAX,
+  TS_AGG_AVG,
+  TS_AGG_LAST,
+};
+
+struct TimeSeriesRing {
+  char *key;
+  uint64_t *times; // Oldest at head
+  double *values;
+  size_t head;
+  size_t count;
+};
+
+struct ZenohTimeSeries {
+  z_owned_subscriber_t subscriber;
+  z_owned_queryable_t queryable;
+  z_owned_mutex_t mutex;
+  atomic_count_t refs; // User handle plus the subscriber and queryable closures
+  struct TimeSeriesRing **series; // Sorted by key
+  size_t series_count;
+  size_t series_cap;
+  size_t capacity;
+  size_t max_series;
+  ZenohTimeSeriesFormat format;
+  char *json_field;
+  ZenohTimeSeriesExtractor extractor;
+  void *extractor_context;
+  ZenohTimeSeriesStats stats; // Guarded by mutex
+};
+
+// Parses the number at the start of s, skipping leading blanks. With
+// whole, nothing but blanks may follow the number.
+static bool ts_parse_number(const char *s, size_t len, bool whole,
+                            double *out) {
+  while (len > 0 && (*s == ' ' || *s == '\t' || *s == '\n' || *s == '\r' ||
+                     *s == '"')) {
+    s++;
+    len--;
+  }
+
+  char buf[64];
+  if (len == 0)
+    return false;
+  if (len >= sizeof(buf)) {
+    if (whole)
+      return false;
+    len = sizeof(buf) - 1;
+  }
+  memcpy(buf, s, len);
+  buf[len] = '\0';
+
+  char *end;
+  double value = strtod(buf, &end);
+  if (end == buf)
+    return false;
+  if (whole) {
+    while (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r' ||
+           *end == '"')
+      end++;
+    if (end != buf + len)
+      return false;
+  }
+  *out = value;
+  return true;
+}
+
+// Finds "field": in a JSON document and parses the number after it. The first
+// occurrence at any depth is used.
+static bool ts_parse_json_field(const char *json, size_t len,
+                                const char *field, double *out) {
+  size_t field_len = strlen(field);
+  for (size_t i = 0; i + field_len + 2 <= len; i++) {
+    if (json[i] != '"' || memcmp(json + i + 1, field, field_len) != 0 ||
+        json[i + field_len + 1] != '"')
+      continue;
+
+    size_t j = i + field_len + 2;
+    while (j < len && (json[j] == ' ' || json[j] == '\t' || json[j] == '\n' ||
+                       json[j] == '\r'))
+      j++;
+    if (j < len && json[j] == ':')
+      return ts_parse_number(json + j + 1, len - j - 1, false, out);
+  }
+  return false;
+}
+
+static bool ts_extract(const ZenohTimeSeries *ts, const uint8_t *data,
+                       size_t len, double *out) {
+  if (ts->extractor != NULL)
+    return ts->extractor(data, len, out, ts->extractor_context);
+
+  switch (ts->format) {
+  case ZENOH_TIMESERIES_FORMAT_F64_LE:
+    if (len != 8)
+      return false;
+    {
+      uint64_t bits = get_u64_le(data);
+      memcpy(out, &bits, sizeof(*out));
+    }
+    return true;
+  case ZENOH_TIMESERIES_FORMAT_F32_LE:
+    if (len != 4)
+      return false;
+    {
+      uint32_t bits = get_u32_le(data);
+      float f;
+      memcpy(&f, &bits, sizeof(f));
+      *out = f;
+    }
+    return true;
+  case ZENOH_TIMESERIES_FORMAT_I64_LE:
+    if (len != 8)
+      return false;
+    *out = (double)(int64_t)get_u64_le(data);
+    return true;
+  case ZENOH_TIMESERIES_FORMAT_TEXT:
+    return ts_parse_number((const char *)data, len, false, out);
+  case ZENOH_TIMESERIES_FORMAT_JSON_FIELD:
+    return ts->json_field != NULL &&
+           ts_parse_json_field((const char *)data, len, ts->json_field, out);
+  case ZENOH_TIMESERIES_FORMAT_AUTO:
+  default:
+    // Binary payloads need an explicit format: any 8 bytes are a valid
+    // float64, so guessing would misread short text values
+    return ts_parse_number((const char *)data, len, true, out);
+  }
+}
+
+// Binary search; returns the series or NULL and the insertion position
+static struct TimeSeriesRing *ts_series_find(ZenohTimeSeries *ts,
+                                             const char *key, size_t *pos) {
+  size_t lo = 0, hi = ts->series_count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    int c = strcmp(ts->series[mid]->key, key);
+    if (c == 0) {
+      *pos = mid;
+      return ts->series[mid];
+    }
+    if (c < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *pos = lo;
+  return NULL;
+}
+
+// Narrows the sorted series to the ones that can match key expression ke:
+// every match starts with the literal text before the first wildcard
+// (minus a trailing '/', as "a/**" also matches "a"). Must be called with
+// the time series mutex held.
+static void ts_series_range(ZenohTimeSeries *ts, const char *ke,
+                            size_t ke_len, size_t *first, size_t *last) {
+  size_t prefix_len = 0;
+  while (prefix_len < ke_len && ke[prefix_len] != '*' && ke[prefix_len] != '$')
+    prefix_len++;
+  if (prefix_len < ke_len && prefix_len > 0 && ke[prefix_len - 1] == '/')
+    prefix_len--;
+
+  size_t lo = 0, hi = ts->series_count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (strncmp(ts->series[mid]->key, ke, prefix_len) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *first = lo;
+  hi = ts->series_count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (strncmp(ts->series[mid]->key, ke, prefix_len) <= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *last = lo;
+}
+
+// Must be called with the time series mutex held
+static struct TimeSeriesRing *ts_series_get(ZenohTimeSeries *ts,
+                                            const char *key) {
+  size_t pos;
+  struct TimeSeriesRing *ring = ts_series_find(ts, key, &pos);
+  if (ring != NULL)
+    return ring;
+  if (ts->max_series > 0 && ts->series_count >= ts->max_series)
+    return NULL;
+
+  if (ts->series_count == ts->series_cap) {
+    size_t cap = ts->series_cap > 0 ? ts->series_cap * 2 : 8;
+    struct TimeSeriesRing **series = (struct TimeSeriesRing **)realloc(
+        ts->series, cap * sizeof(struct TimeSeriesRing *));
+    if (series == NULL)
+      return NULL;
+    ts->series = series;
+    ts->series_cap = cap;
+  }
+
+  size_t key_len = strlen(key);
+  ring = (struct TimeSeriesRing *)calloc(1, sizeof(struct TimeSeriesRing));
+  if (ring == NULL)
+    return NULL;
+  ring->key = (char *)malloc(key_len + 1);
+  ring->times = (uint64_t *)malloc(ts->capacity * sizeof(uint64_t));
+  ring->values = (double *)malloc(ts->capacity * sizeof(double));
+  if (ring->key == NULL || ring->times == NULL || ring->values == NULL) {
+    free(ring->key);
+    free(ring->times);
+    free(ring->values);
+    free(ring);
+    return NULL;
+  }
+  memcpy(ring->key, key, key_len + 1);
+
+  memmove(&ts->series[pos + 1], &ts->series[pos],
+          (ts->series_count - pos) * sizeof(struct TimeSeriesRing *));
+  ts->series[pos] = ring;
+  ts->series_count++;
+  ts->stats.series++;
+  ts->stats.memory_bytes += sizeof(struct TimeSeriesRing) + key_len + 1 +
+                            ts->capacity * TS_POINT_SIZE;
+  return ring;
+}
+
+// Must be called with the time series mutex held. Points older than the
+// newest one are dropped, so rings stay sorted by time.
+static bool ts_ring_push(ZenohTimeSeries *ts, struct TimeSeriesRing *ring,
+                         uint64_t time, double value) {
+  if (ring->count > 0) {
+    size_t last = (ring->head + ring->count - 1) % ts->capacity;
+    if (time < ring->times[last])
+      return false;
+  }
+
+  size_t slot;
+  if (ring->count < ts->capacity) {
+    slot = (ring->head + ring->count) % ts->capacity;
+    ring->count++;
+    ts->stats.points++;
+  } else {
+    slot = ring->head;
+    ring->head = (ring->head + 1) % ts->capacity;
+  }
+  ring->times[slot] = time;
+  ring->values[slot] = value;
+  return true;
+}
+
+// First logical index whose time is >= start
+static size_t ts_ring_lower_bound(const ZenohTimeSeries *ts,
+                                  const struct TimeSeriesRing *ring,
+                                  uint64_t start) {
+  size_t lo = 0, hi = ring->count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (ring->times[(ring->head + mid) % ts->capacity] < start)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static void ts_put_point(uint8_t *p, uint64_t time, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  put_u64_le(p, time);
+  put_u64_le(p + 8, bits);
+}
+
+// Packs the points of ring within range, one per step bucket when step is
+// non-zero. Must be called with the time series mutex held. Returns a heap
+// buffer (NULL if empty) and its point count.
+static uint8_t *ts_ring_collect(const ZenohTimeSeries *ts,
+                                const struct TimeSeriesRing *ring,
+                                const struct TimeRange *range, uint64_t step,
+                                enum TimeSeriesAgg agg, size_t *points) {
+  *points = 0;
+  size_t first = ts_ring_lower_bound(ts, ring, range->start);
+  size_t last = first;
+  while (last < ring->count &&
+         ring->times[(ring->head + last) % ts->capacity] <= range->end)
+    last++;
+  if (last == first)
+    return NULL;
+
+  uint8_t *buf = (uint8_t *)malloc((last - first) * TS_POINT_SIZE);
+  if (buf == NULL)
+    return NULL;
+
+  if (step == 0 || agg == TS_AGG_NONE) {
+    for (size_t i = first; i < last; i++) {
+      size_t slot = (ring->head + i) % ts->capacity;
+      ts_put_point(buf + *points * TS_POINT_SIZE, ring->times[slot],
+                   ring->values[slot]);
+      (*points)++;
+    }
+    return buf;
+  }
+
+  // Buckets are aligned on the range start, or on the first point when the
+  // range is open
+  uint64_t origin =
+      range->start > 0 ? range->start
+                       : ring->times[(ring->head + first) % ts->capacity];
+  size_t i = first;
+  while (i < last) {
+    size_t slot = (ring->head + i) % ts->capacity;
+    uint64_t bucket = origin + (ring->times[slot] - origin) / step * step;
+    double acc = ring->values[slot];
+    size_t n = 1;
+
+    for (i++; i < last; i++) {
+      slot = (ring->head + i) % ts->capacity;
+      if (ring->times[slot] - bucket >= step)
+        break;
+      double v = ring->values[slot];
+      switch (agg) {
+      case TS_AGG_MIN:
+        acc = v < acc ? v : acc;
+        break;
+      case TS_AGG_MAX:
+        acc = v > acc ? v : acc;
+        break;
+      case TS_AGG_AVG:
+        acc += v;
+        break;
+      default:
+        acc = v;
+        break;
+      }
+      n++;
+    }
+
+    if (agg == TS_AGG_AVG)
+      acc /= (double)n;
+    ts_put_point(buf + *points * TS_POINT_SIZE, bucket, acc);
+    (*points)++;
+  }
+  return buf;
+}
+
+// Reads `_time`, `step` and `agg` from a parameter string
+static void ts_parse_params(const char *params, size_t len,
+                            struct TimeRange *range, uint64_t *step,
+                            enum TimeSeriesAgg *agg) {
+  range->start = 0;
+  range->end = UINT64_MAX;
+  *step = 0;
+  *agg = TS_AGG_NONE;
+
+  const char *value;
+  size_t value_len;
+  struct TimeRange parsed;
+  if (find_selector_param(params, len, "_time", &value, &value_len) &&
+      parse_time_range(value, value_len, ntp64_now(), &parsed))
+    *range = parsed;
+
+  double seconds;
+  if (find_selector_param(params, len, "step", &value, &value_len) &&
+      parse_duration(value, value_len, &seconds) && seconds > 0) {
+    *step = ntp64_from_seconds(seconds);
+    *agg = TS_AGG_AVG;
+  }
+
+  if (*step > 0 &&
+      find_selector_param(params, len, "agg", &value, &value_len)) {
+    if (value_len == 3 && memcmp(value, "min", 3) == 0)
+      *agg = TS_AGG_MIN;
+    else if (value_len == 3 && memcmp(value, "max", 3) == 0)
+      *agg = TS_AGG_MAX;
+    else if (value_len == 4 && memcmp(value, "last", 4) == 0)
+      *agg = TS_AGG_LAST;
+  }
+}
+
+static void timeseries_release(ZenohTimeSeries *ts) {
+  if (atomic_count_dec(&ts->refs) != 0)
+    return;
+  for (size_t i = 0; i < ts->series_count; i++) {
+    free(ts->series[i]->key);
+    free(ts->series[i]->times);
+    free(ts->series[i]->values);
+    free(ts->series[i]);
+  }
+  free(ts->series);
+  free(ts->json_field);
+  z_drop(z_move(ts->mutex));
+  free(ts);
+}
+
+static void drop_timeseries_closure(void *arg) {
+  timeseries_release((ZenohTimeSeries *)arg);
+}
+
+static void timeseries_sample_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
+  ZenohTimeSeries *ts = (ZenohTimeSeries *)arg;
+  if (z_sample_kind(sample) != Z_SAMPLE_KIND_PUT)
+    return;
+
+  size_t len = 0;
+  uint8_t *data = get_bytes_data(z_sample_payload(sample), &len);
+  double value;
+  bool ok = ts_extract(ts, data, len, &value);
+  free(data);
+
+  const z_timestamp_t *sample_ts = z_sample_timestamp(sample);
+  uint64_t time =
+      sample_ts != NULL ? z_timestamp_ntp64_time(sample_ts) : ntp64_now();
+
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+  size_t key_len = z_string_len(z_loan(key_str));
+  char *key = (char *)malloc(key_len + 1);
+  if (key == NULL)
+    return;
+  memcpy(key, z_string_data(z_loan(key_str)), key_len);
+  key[key_len] = '\0';
+
+  z_mutex_lock(z_loan_mut(ts->mutex));
+  ts->stats.samples++;
+  struct TimeSeriesRing *ring = ok ? ts_series_get(ts, key) : NULL;
+  if (ring == NULL || !ts_ring_push(ts, ring, time, value))
+    ts->stats.rejected++;
+  z_mutex_unlock(z_loan_mut(ts->mutex));
+
+  free(key);
+}
+
+struct TimeSeriesReply {
+  char *key;
+  uint8_t *data;
+  size_t len;
+};
+
+static void timeseries_query_handler(z_loaned_query_t *query, void *arg) {
+  thread_enter_delivery();
+  ZenohTimeSeries *ts = (ZenohTimeSeries *)arg;
+
+  z_view_string_t params;
+  z_query_parameters(query, &params);
+  struct TimeRange range;
+  uint64_t step;
+  enum TimeSeriesAgg agg;
+  ts_parse_params(z_string_data(z_loan(params)), z_string_len(z_loan(params)),
+                  &range, &step, &agg);
+
+  z_view_string_t ke_str;
+  z_keyexpr_as_view_string(z_query_keyexpr(query), &ke_str);
+  const char *ke = z_string_data(z_loan(ke_str));
+  size_t ke_len = z_string_len(z_loan(ke_str));
+
+  // Pack matches under the lock, reply without it
+  struct TimeSeriesReply *replies = NULL;
+  size_t count = 0;
+  z_mutex_lock(z_loan_mut(ts->mutex));
+  ts->stats.queries++;
+  size_t first, last;
+  ts_series_range(ts, ke, ke_len, &first, &last);
+  if (last > first)
+    replies = (struct TimeSeriesReply *)malloc((last - first) *
+                                               sizeof(struct TimeSeriesReply));
+  for (size_t i = first; replies != NULL && i < last; i++) {
+    struct TimeSeriesRing *ring = ts->series[i];
+    z_view_keyexpr_t ke;
+    z_view_keyexpr_from_str_unchecked(&ke, ring->key);
+    if (!z_keyexpr_intersects(z_query_keyexpr(query), z_loan(ke)))
+      continue;
+
+    size_t points;
+    uint8_t *data = ts_ring_collect(ts, ring, &range, step, agg, &points);
+    if (data == NULL)
+      continue;
+    replies[count].key = (char *)malloc(strlen(ring->key) + 1);
+    if (replies[count].key == NULL) {
+      free(data);
+      continue;
+    }
+    strcpy(replies[count].key, ring->key);
+    replies[count].data = data;
+    replies[count].len = points * TS_POINT_SIZE;
+    count++;
+  }
+  z_mutex_unlock(z_loan_mut(ts->mutex));
+
+  for (size_t i = 0; i < count; i++) {
+    z_view_keyexpr_t keyexpr;
+    if (z_view_keyexpr_from_str(&keyexpr, replies[i].key) == 0) {
+      z_owned_bytes_t payload;
+      z_bytes_copy_from_buf(&payload, replies[i].data, replies[i].len);
+      z_query_reply_options_t options;
+      z_query_reply_options_default(&options);
+      z_owned_encoding_t encoding;
+      z_encoding_clone(&encoding,
+                       get_encoding(ZENOH_ENCODING_APPLICATION_OCTET_STREAM));
+      options.encoding = z_move(encoding);
+      z_query_reply(query, z_loan(keyexpr), z_move(payload), &options);
+    }
+    free(replies[i].key);
+    free(replies[i].data);
+  }
+  free(replies);
+}
+
+FFI_PLUGIN_EXPORT ZenohTimeSeries *
+zenoh_declare_timeseries(ZenohSession *session, const char *key_expr,
+                         ZenohTimeSeriesOptions *opts) {
+  if (session == NULL || key_expr == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key_expr) < 0)
+    return NULL;
+
+  ZenohTimeSeries *ts = (ZenohTimeSeries *)calloc(1, sizeof(ZenohTimeSeries));
+  if (ts == NULL || z_mutex_init(&ts->mutex) < 0) {
+    free(ts);
+    return NULL;
+  }
+  ts->refs = 1;
+  ts->capacity = opts != NULL && opts->capacity > 0 ? opts->capacity
+                                                    : TS_DEFAULT_CAPACITY;
+  if (opts != NULL) {
+    ts->max_series = opts->max_series;
+    ts->format = opts->format;
+    ts->extractor = opts->extractor;
+    ts->extractor_context = opts->extractor_context;
+    if (opts->json_field != NULL) {
+      ts->json_field = (char *)malloc(strlen(opts->json_field) + 1);
+      if (ts->json_field != NULL)
+        strcpy(ts->json_field, opts->json_field);
+    }
+  }
 
-  z_query_reply_options_t options;
-  z_query_reply_options_default(&options);
+  // Each closure holds a reference, released by its drop
+  atomic_count_inc(&ts->refs);
+  z_subscriber_options_t sub_options;
+  z_subscriber_options_default(&sub_options);
+  z_owned_closure_sample_t sample_closure;
+  z_closure_sample(&sample_closure, timeseries_sample_handler,
+                   drop_timeseries_closure, ts);
+  if (z_declare_subscriber(z_loan(session->session), &ts->subscriber,
+                           z_loan(keyexpr), z_move(sample_closure),
+                           &sub_options) < 0) {
+    timeseries_release(ts);
+    return NULL;
+  }
 
-  z_owned_bytes_t payload;
-  z_bytes_copy_from_buf(&payload, data, len);
+  atomic_count_inc(&ts->refs);
+  z_queryable_options_t q_options;
+  z_queryable_options_default(&q_options);
+  q_options.complete = opts != NULL ? opts->complete : false;
+  z_owned_closure_query_t query_closure;
+  z_closure_query(&query_closure, timeseries_query_handler,
+                  drop_timeseries_closure, ts);
+  if (z_declare_queryable(z_loan(session->session), &ts->queryable,
+                          z_loan(keyexpr), z_move(query_closure),
+                          &q_options) < 0) {
+    z_drop(z_move(ts->subscriber));
+    timeseries_release(ts);
+    return NULL;
+  }
 
-  z_query_reply(query, z_loan(keyexpr), z_move(payload), &options);
+  return ts;
 }
 
-FFI_PLUGIN_EXPORT void zenoh_query_reply_with_options(
-    void *reply_context, const char *key, const uint8_t *data, size_t len,
-    ZenohEncodingId encoding, const uint8_t *attachment,
-    size_t attachment_len) {
-  const z_loaned_query_t *query = (const z_loaned_query_t *)reply_context;
-  if (query == NULL)
-    return;
-
-  z_view_keyexpr_t keyexpr;
-  if (z_view_keyexpr_from_str(&keyexpr, key) < 0)
-    return;
+FFI_PLUGIN_EXPORT int zenoh_timeseries_read(ZenohTimeSeries *ts,
+                                            const char *key,
+                                            const char *parameters,
+                                            uint8_t **data, size_t *len) {
+  if (ts == NULL || key == NULL || data == NULL || len == NULL)
+    return -1;
 
-  z_query_reply_options_t options;
-  z_query_reply_options_default(&options);
+  *data = NULL;
+  *len = 0;
+
+  struct TimeRange range;
+  uint64_t step;
+  enum TimeSeriesAgg agg;
+  ts_parse_params(parameters != NULL ? parameters : "",
+                  parameters != NULL ? strlen(parameters) : 0, &range, &step,
+                  &agg);
+
+  size_t points = 0;
+  z_mutex_lock(z_loan_mut(ts->mutex));
+  size_t pos;
+  struct TimeSeriesRing *ring = ts_series_find(ts, key, &pos);
+  if (ring != NULL)
+    *data = ts_ring_collect(ts, ring, &range, step, agg, &points);
+  z_mutex_unlock(z_loan_mut(ts->mutex));
+
+  *len = points * TS_POINT_SIZE;
+  return (int)points;
+}
 
-  // Set encoding
-  z_owned_encoding_t enc;
-  z_encoding_clone(&enc, get_encoding(encoding));
-  options.encoding = z_encoding_move(&enc);
+FFI_PLUGIN_EXPORT int zenoh_timeseries_stats(ZenohTimeSeries *ts,
+                                             ZenohTimeSeriesStats *stats) {
+  if (ts == NULL || stats == NULL)
+    return -1;
 
-  // Set attachment
-  if (attachment != NULL && attachment_len > 0) {
-    z_owned_bytes_t att;
-    z_bytes_copy_from_buf(&att, attachment, attachment_len);
-    options.attachment = z_bytes_move(&att);
-  }
+  z_mutex_lock(z_loan_mut(ts->mutex));
+  *stats = ts->stats;
+  z_mutex_unlock(z_loan_mut(ts->mutex));
+  return 0;
+}
 
-  z_owned_bytes_t payload;
-  z_bytes_copy_from_buf(&payload, data, len);
+FFI_PLUGIN_EXPORT void zenoh_undeclare_timeseries(ZenohTimeSeries *ts) {
+  if (ts == NULL)
+    return;
 
-  z_query_reply(query, z_loan(keyexpr), z_move(payload), &options);
+  z_drop(z_move(ts->queryable));
+  z_drop(z_move(ts->subscriber));
+  timeseries_release(ts);
 }
 
 // ============================================================================
@@ -1146,6 +8790,7 @@ zenoh_declare_liveliness_token(ZenohSession *session, const char *key_expr) {
   z_liveliness_token_options_t options;
   z_liveliness_token_options_default(&options);
 
+  thread_mark_caller();
   if (z_liveliness_declare_token(z_loan(session->session), &token->token,
                                  z_loan(keyexpr), &options) < 0) {
     free(token);
@@ -1166,6 +8811,7 @@ zenoh_undeclare_liveliness_token(ZenohLivelinessToken *token) {
 // Liveliness subscriber callback
 static void liveliness_sample_handler(z_loaned_sample_t *sample,
                                       void *arg) {
+  thread_enter_delivery();
   ZenohSubscriber *sub = (ZenohSubscriber *)arg;
   if (sub == NULL || sub->liveliness_callback == NULL)
     return;
@@ -1196,7 +8842,7 @@ FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_liveliness_subscriber(
   if (z_view_keyexpr_from_str(&keyexpr, key_expr) < 0)
     return NULL;
 
-  ZenohSubscriber *sub = (ZenohSubscriber *)malloc(sizeof(ZenohSubscriber));
+  ZenohSubscriber *sub = (ZenohSubscriber *)calloc(1, sizeof(ZenohSubscriber));
   if (sub == NULL)
     return NULL;
 
@@ -1205,6 +8851,8 @@ FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_liveliness_subscriber(
   sub->context = context;
   sub->is_liveliness = true;
   sub->liveliness_callback = callback;
+  sub->shm_callback = NULL;
+  sub->stats = NULL;
 
   z_liveliness_subscriber_options_t options;
   z_liveliness_subscriber_options_default(&options);
@@ -1231,6 +8879,7 @@ struct LivelinessGetContext {
 };
 
 static void liveliness_get_reply_handler(struct z_loaned_reply_t *reply, void *arg) {
+  thread_enter_delivery();
   struct LivelinessGetContext *ctx = (struct LivelinessGetContext *)arg;
   if (ctx == NULL || ctx->callback == NULL)
     return;
@@ -1285,15 +8934,327 @@ FFI_PLUGIN_EXPORT void zenoh_liveliness_get(ZenohSession *session,
   z_closure_reply(&closure, liveliness_get_reply_handler,
                   drop_liveliness_get_context, ctx);
 
+  thread_mark_caller();
   z_liveliness_get(z_loan(session->session), z_loan(keyexpr), z_move(closure),
                    &options);
 }
 
+// ============================================================================
+// Liveliness Tracker
+// ============================================================================
+//
+// Keeps the set of alive tokens under a key expression natively. Changes are
+// coalesced and published as one delta per interval: a token that appears
+// and vanishes between two deltas is never reported at all.
+
+#define TRACKER_DEFAULT_INTERVAL_MS 100
+#define TRACKER_MAX_TICK_MS 50
+
+struct TrackedKey {
+  struct TrackedKey *next;       // Hash chain
+  struct TrackedKey *next_dirty; // Changed since the last delta
+  uint32_t hash;
+  bool alive;     // Latest state seen from zenoh
+  bool published; // State as of the last delta
+  bool dirty;
+  size_t len;
+  char key[];
+};
+
+struct ZenohLivelinessTracker {
+  z_owned_subscriber_t subscriber;
+  z_owned_mutex_t mutex;
+  struct TrackedKey **buckets;
+  size_t bucket_count; // Power of two
+  size_t entries;
+  size_t published; // Alive as of the last delta
+  struct TrackedKey *dirty;
+  uint64_t version;
+  uint64_t interval_ms;
+  bool stopping;
+  z_owned_task_t notifier;
+  ZenohLivelinessDeltaCallback callback;
+  void *context;
+};
+
+static bool tracker_grow(ZenohLivelinessTracker *t) {
+  size_t count = t->bucket_count * 2;
+  struct TrackedKey **buckets =
+      (struct TrackedKey **)calloc(count, sizeof(struct TrackedKey *));
+  if (buckets == NULL)
+    return false;
+  for (size_t i = 0; i < t->bucket_count; i++) {
+    struct TrackedKey *e = t->buckets[i];
+    while (e != NULL) {
+      struct TrackedKey *next = e->next;
+      e->next = buckets[e->hash & (count - 1)];
+      buckets[e->hash & (count - 1)] = e;
+      e = next;
+    }
+  }
+  free(t->buckets);
+  t->buckets = buckets;
+  t->bucket_count = count;
+  return true;
+}
+
+static void tracker_sample_handler(z_loaned_sample_t *sample, void *arg) {
+  thread_enter_delivery();
+  ZenohLivelinessTracker *t = (ZenohLivelinessTracker *)arg;
+
+  z_view_string_t key_str;
+  z_keyexpr_as_view_string(z_sample_keyexpr(sample), &key_str);
+  const char *key = z_string_data(z_loan(key_str));
+  size_t len = z_string_len(z_loan(key_str));
+  uint32_t hash = key_hash(key, len);
+  bool alive = z_sample_kind(sample) == Z_SAMPLE_KIND_PUT;
+
+  z_mutex_lock(z_loan_mut(t->mutex));
+  struct TrackedKey *e = t->buckets[hash & (t->bucket_count - 1)];
+  while (e != NULL &&
+         (e->hash != hash || e->len != len || memcmp(e->key, key, len) != 0))
+    e = e->next;
+
+  if (e == NULL && alive) {
+    if (t->entries >= t->bucket_count)
+      tracker_grow(t); // On failure the chains just get longer
+    e = (struct TrackedKey *)malloc(sizeof(struct TrackedKey) + len + 1);
+    if (e != NULL) {
+      e->hash = hash;
+      e->published = false;
+      e->dirty = false;
+      e->len = len;
+      memcpy(e->key, key, len);
+      e->key[len] = '\0';
+      e->next = t->buckets[hash & (t->bucket_count - 1)];
+      t->buckets[hash & (t->bucket_count - 1)] = e;
+      t->entries++;
+    }
+  }
+  if (e != NULL) {
+    e->alive = alive;
+    if (!e->dirty) {
+      e->dirty = true;
+      e->next_dirty = t->dirty;
+      t->dirty = e;
+    }
+  }
+  z_mutex_unlock(z_loan_mut(t->mutex));
+}
+
+static void tracker_remove(ZenohLivelinessTracker *t, struct TrackedKey *e) {
+  struct TrackedKey **link = &t->buckets[e->hash & (t->bucket_count - 1)];
+  while (*link != e)
+    link = &(*link)->next;
+  *link = e->next;
+  t->entries--;
+  free(e);
+}
+
+// Sends the changes since the last delta, packed back to back as
+// NUL-terminated keys: the joined ones first, then the ones that left
+static void tracker_publish(ZenohLivelinessTracker *t) {
+  z_mutex_lock(z_loan_mut(t->mutex));
+  size_t len = 0, joined = 0, left = 0;
+  for (struct TrackedKey *e = t->dirty; e != NULL; e = e->next_dirty) {
+    if (e->alive == e->published)
+      continue;
+    len += e->len + 1;
+    if (e->alive)
+      joined++;
+    else
+      left++;
+  }
+
+  char *keys = NULL;
+  if (joined + left > 0) {
+    keys = (char *)malloc(len);
+    if (keys == NULL) {
+      z_mutex_unlock(z_loan_mut(t->mutex));
+      return; // Retried on the next tick
+    }
+    char *p = keys;
+    for (int pass = 0; pass < 2; pass++) {
+      for (struct TrackedKey *e = t->dirty; e != NULL; e = e->next_dirty) {
+        if (e->alive == e->published || e->alive != (pass == 0))
+          continue;
+        memcpy(p, e->key, e->len + 1);
+        p += e->len + 1;
+      }
+    }
+    t->version++;
+    t->published = t->published + joined - left;
+  }
+
+  struct TrackedKey *e = t->dirty;
+  t->dirty = NULL;
+  while (e != NULL) {
+    struct TrackedKey *next = e->next_dirty;
+    e->dirty = false;
+    e->published = e->alive;
+    if (!e->alive)
+      tracker_remove(t, e);
+    e = next;
+  }
+  uint64_t version = t->version;
+  z_mutex_unlock(z_loan_mut(t->mutex));
+
+  // Only this thread publishes, so deltas arrive in version order
+  if (keys != NULL)
+    t->callback(version, keys, len, joined, left, t->context);
+}
+
+static void *tracker_notifier_task(void *arg) {
+  ZenohLivelinessTracker *t = (ZenohLivelinessTracker *)arg;
+  uint64_t tick = t->interval_ms < TRACKER_MAX_TICK_MS ? t->interval_ms
+                                                       : TRACKER_MAX_TICK_MS;
+  uint64_t waited = 0;
+  for (;;) {
+    z_sleep_ms(tick);
+    waited += tick;
+
+    z_mutex_lock(z_loan_mut(t->mutex));
+    bool stopping = t->stopping;
+    z_mutex_unlock(z_loan_mut(t->mutex));
+    if (stopping)
+      return NULL;
+
+    if (waited >= t->interval_ms) {
+      thread_enter(ZENOH_THREAD_WORKER); // Pick up policy changes
+      tracker_publish(t);
+      waited = 0;
+    }
+  }
+}
+
+// The subscriber closure's drop callback: runs once no sample handler can
+// still be touching the table, and close joins the notifier before that.
+static void drop_tracker(void *arg) {
+  ZenohLivelinessTracker *t = (ZenohLivelinessTracker *)arg;
+  for (size_t i = 0; i < t->bucket_count; i++) {
+    struct TrackedKey *e = t->buckets[i];
+    while (e != NULL) {
+      struct TrackedKey *next = e->next;
+      free(e);
+      e = next;
+    }
+  }
+  free(t->buckets);
+  z_drop(z_move(t->mutex));
+  free(t);
+}
+
+FFI_PLUGIN_EXPORT ZenohLivelinessTracker *
+zenoh_liveliness_tracker_open(ZenohSession *session, const char *key_expr,
+                              uint64_t interval_ms,
+                              ZenohLivelinessDeltaCallback callback,
+                              void *context) {
+  if (session == NULL || key_expr == NULL || callback == NULL)
+    return NULL;
+
+  z_view_keyexpr_t keyexpr;
+  if (z_view_keyexpr_from_str(&keyexpr, key_expr) < 0)
+    return NULL;
+
+  ZenohLivelinessTracker *t =
+      (ZenohLivelinessTracker *)calloc(1, sizeof(ZenohLivelinessTracker));
+  if (t == NULL)
+    return NULL;
+  t->bucket_count = 64;
+  t->buckets =
+      (struct TrackedKey **)calloc(t->bucket_count, sizeof(struct TrackedKey *));
+  if (t->buckets == NULL || z_mutex_init(&t->mutex) < 0) {
+    free(t->buckets);
+    free(t);
+    return NULL;
+  }
+  t->interval_ms =
+      interval_ms > 0 ? interval_ms : TRACKER_DEFAULT_INTERVAL_MS;
+  t->callback = callback;
+  t->context = context;
+
+  // History replays the tokens already alive into the first delta
+  z_liveliness_subscriber_options_t options;
+  z_liveliness_subscriber_options_default(&options);
+  options.history = true;
+
+  z_owned_closure_sample_t closure;
+  z_closure_sample(&closure, tracker_sample_handler, drop_tracker, t);
+  if (z_liveliness_declare_subscriber(z_loan(session->session), &t->subscriber,
+                                      z_loan(keyexpr), z_move(closure),
+                                      &options) < 0) {
+    // The failed declaration already dropped the closure (and tracker)
+    return NULL;
+  }
+
+  if (worker_start(&t->notifier, tracker_notifier_task, t) != 0) {
+    z_drop(z_move(t->subscriber)); // Frees the tracker
+    return NULL;
+  }
+  return t;
+}
+
+FFI_PLUGIN_EXPORT char *zenoh_liveliness_snapshot(ZenohLivelinessTracker *t,
+                                                  uint64_t *version,
+                                                  size_t *count, size_t *len) {
+  if (t == NULL || version == NULL || count == NULL || len == NULL)
+    return NULL;
+
+  z_mutex_lock(z_loan_mut(t->mutex));
+  size_t total = 0;
+  for (size_t i = 0; i < t->bucket_count; i++)
+    for (struct TrackedKey *e = t->buckets[i]; e != NULL; e = e->next)
+      if (e->published)
+        total += e->len + 1;
+
+  char *keys = (char *)malloc(total > 0 ? total : 1);
+  if (keys != NULL) {
+    char *p = keys;
+    for (size_t i = 0; i < t->bucket_count; i++) {
+      for (struct TrackedKey *e = t->buckets[i]; e != NULL; e = e->next) {
+        if (!e->published)
+          continue;
+        memcpy(p, e->key, e->len + 1);
+        p += e->len + 1;
+      }
+    }
+    *version = t->version;
+    *count = t->published;
+    *len = total;
+  }
+  z_mutex_unlock(z_loan_mut(t->mutex));
+  return keys;
+}
+
+FFI_PLUGIN_EXPORT size_t
+zenoh_liveliness_tracker_count(ZenohLivelinessTracker *t) {
+  if (t == NULL)
+    return 0;
+  z_mutex_lock(z_loan_mut(t->mutex));
+  size_t count = t->published;
+  z_mutex_unlock(z_loan_mut(t->mutex));
+  return count;
+}
+
+FFI_PLUGIN_EXPORT void
+zenoh_liveliness_tracker_close(ZenohLivelinessTracker *t) {
+  if (t == NULL)
+    return;
+
+  z_mutex_lock(z_loan_mut(t->mutex));
+  t->stopping = true;
+  z_mutex_unlock(z_loan_mut(t->mutex));
+  z_task_join(z_move(t->notifier));
+  // Frees the tracker from the closure's drop callback
+  z_drop(z_move(t->subscriber));
+}
+
 // ============================================================================
 // Scouting
 // ============================================================================
 
 static void scout_callback_wrapper(struct z_loaned_hello_t *hello, void *arg) {
+  thread_enter_delivery();
   void (*cb)(const char *) = (void (*)(const char *))arg;
   if (cb) {
     // Extract whatami
@@ -1327,17 +9288,20 @@ static void scout_callback_wrapper(struct z_loaned_hello_t *hello, void *arg) {
 
 static void drop_scout_wrapper(void *arg) {}
 
-FFI_PLUGIN_EXPORT void zenoh_scout(const char *what, const char *config,
-                                   void (*callback)(const char *info)) {
-  z_what_t w = Z_WHAT_ROUTER_PEER;
+static z_what_t scout_what_parse(const char *what) {
   if (what && strcmp(what, "router") == 0)
-    w = Z_WHAT_ROUTER;
-  else if (what && strcmp(what, "peer") == 0)
-    w = Z_WHAT_PEER;
+    return Z_WHAT_ROUTER;
+  if (what && strcmp(what, "peer") == 0)
+    return Z_WHAT_PEER;
+  return Z_WHAT_ROUTER_PEER;
+}
 
+FFI_PLUGIN_EXPORT void zenoh_scout(const char *what, const char *config,
+                                   void (*callback)(const char *info)) {
+  runtime_mark_started();
   z_scout_options_t options;
   z_scout_options_default(&options);
-  options.what = w;
+  options.what = scout_what_parse(what);
   options.timeout_ms = 1000;
 
   z_owned_config_t cfg;
@@ -1349,3 +9313,600 @@ FFI_PLUGIN_EXPORT void zenoh_scout(const char *what, const char *config,
 
   z_scout(z_move(cfg), z_move(closure), &options);
 }
+
+struct ScoutPeer {
+  z_id_t zid;
+  z_whatami_t whatami;
+  char *locators; // NUL-terminated, back to back
+  size_t len;
+  size_t count;
+};
+
+// Shared by the scouting thread and the hello closure, whichever lets go
+// last frees it. Records are reported under the mutex so a zid's records
+// arrive in order.
+struct ScoutTask {
+  atomic_count_t refs;
+  z_owned_config_t config;
+  z_scout_options_t options;
+  z_owned_mutex_t mutex;
+  struct ScoutPeer *peers;
+  size_t peer_count;
+  size_t peer_cap;
+  int result;
+  ZenohScoutCallback callback; // NULL when scouting for zenoh_scout_connect
+  void *context;
+
+  char *connect_config;
+  uint64_t probe_timeout_ms;
+  ZenohScoutConnectCallback connect_callback;
+  char *fresh; // Locators not probed yet, NUL-terminated, back to back
+  size_t fresh_len;
+  size_t fresh_count;
+  bool scouting_done;
+};
+
+static struct ScoutPeer *scout_peer_find_or_add(struct ScoutTask *task,
+                                                const z_id_t *zid,
+                                                bool *added) {
+  *added = false;
+  for (size_t i = 0; i < task->peer_count; i++)
+    if (memcmp(task->peers[i].zid.id, zid->id, sizeof(zid->id)) == 0)
+      return &task->peers[i];
+
+  if (task->peer_count == task->peer_cap) {
+    size_t cap = task->peer_cap ? task->peer_cap * 2 : 8;
+    struct ScoutPeer *peers = (struct ScoutPeer *)realloc(
+        task->peers, cap * sizeof(struct ScoutPeer));
+    if (peers == NULL)
+      return NULL;
+    task->peers = peers;
+    task->peer_cap = cap;
+  }
+  struct ScoutPeer *peer = &task->peers[task->peer_count++];
+  memset(peer, 0, sizeof(*peer));
+  peer->zid = *zid;
+  *added = true;
+  return peer;
+}
+
+// Append a locator unless the peer already has it. Returns whether it was
+// appended.
+static bool scout_peer_add_locator(struct ScoutPeer *peer, const char *data,
+                                   size_t n) {
+  for (const char *p = peer->locators; p < peer->locators + peer->len;
+       p += strlen(p) + 1)
+    if (strlen(p) == n && memcmp(p, data, n) == 0)
+      return false;
+
+  char *locators = (char *)realloc(peer->locators, peer->len + n + 1);
+  if (locators == NULL)
+    return false;
+  memcpy(locators + peer->len, data, n);
+  locators[peer->len + n] = '\0';
+  peer->locators = locators;
+  peer->len += n + 1;
+  peer->count++;
+  return true;
+}
+
+// Locators are spliced into a JSON5 string by scout_connect_open, so quotes,
+// backslashes and control characters are refused rather than escaped.
+static bool scout_locator_json_safe(const char *data, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    if (data[i] == '"' || data[i] == '\\' || (unsigned char)data[i] < 0x20)
+      return false;
+  return true;
+}
+
+// Queue a new locator for zenoh_scout_connect to probe
+static void scout_fresh_add(struct ScoutTask *task, const char *data,
+                            size_t n) {
+  if (!scout_locator_json_safe(data, n))
+    return;
+  char *fresh = (char *)realloc(task->fresh, task->fresh_len + n + 1);
+  if (fresh == NULL)
+    return;
+  memcpy(fresh + task->fresh_len, data, n);
+  fresh[task->fresh_len + n] = '\0';
+  task->fresh = fresh;
+  task->fresh_len += n + 1;
+  task->fresh_count++;
+}
+
+static uint8_t *scout_record_build(const struct ScoutPeer *peer,
+                                   size_t *len) {
+  *len = 1 + sizeof(peer->zid.id) + 4 + peer->len;
+  uint8_t *record = (uint8_t *)malloc(*len);
+  if (record == NULL)
+    return NULL;
+  record[0] = (uint8_t)peer->whatami;
+  memcpy(record + 1, peer->zid.id, sizeof(peer->zid.id));
+  put_u32_le(record + 1 + sizeof(peer->zid.id), (uint32_t)peer->count);
+  if (peer->len > 0)
+    memcpy(record + 1 + sizeof(peer->zid.id) + 4, peer->locators, peer->len);
+  return record;
+}
+
+static void scout_hello_handler(struct z_loaned_hello_t *hello, void *arg) {
+  thread_enter_delivery();
+  struct ScoutTask *task = (struct ScoutTask *)arg;
+  z_id_t zid = z_hello_zid(hello);
+  z_owned_string_array_t locators;
+  z_hello_locators(hello, &locators);
+
+  z_mutex_lock(z_loan_mut(task->mutex));
+  bool added;
+  struct ScoutPeer *peer = scout_peer_find_or_add(task, &zid, &added);
+  if (peer != NULL) {
+    peer->whatami = z_hello_whatami(hello);
+    bool changed = added;
+    size_t count = z_string_array_len(z_loan(locators));
+    for (size_t i = 0; i < count; i++) {
+      const z_loaned_string_t *locator =
+          z_string_array_get(z_loan(locators), i);
+      if (scout_peer_add_locator(peer, z_string_data(locator),
+                                 z_string_len(locator))) {
+        changed = true;
+        if (task->connect_callback != NULL)
+          scout_fresh_add(task, z_string_data(locator),
+                          z_string_len(locator));
+      }
+    }
+    if (changed && task->callback != NULL) {
+      size_t len;
+      uint8_t *record = scout_record_build(peer, &len);
+      if (record != NULL)
+        task->callback(record, len, 0, task->context);
+    }
+  }
+  z_mutex_unlock(z_loan_mut(task->mutex));
+  z_drop(z_move(locators));
+}
+
+static void scout_task_release(void *arg) {
+  struct ScoutTask *task = (struct ScoutTask *)arg;
+  if (atomic_count_dec(&task->refs) != 0)
+    return;
+
+  if (task->callback != NULL)
+    task->callback(NULL, 0, task->result, task->context);
+  for (size_t i = 0; i < task->peer_count; i++)
+    free(task->peers[i].locators);
+  free(task->peers);
+  free(task->connect_config);
+  free(task->fresh);
+  z_drop(z_move(task->mutex));
+  free(task);
+}
+
+static struct ScoutTask *scout_task_new(const char *what,
+                                        const char *config_json,
+                                        uint64_t timeout_ms) {
+  struct ScoutTask *task =
+      (struct ScoutTask *)calloc(1, sizeof(struct ScoutTask));
+  if (task == NULL)
+    return NULL;
+  if (config_json != NULL ? zc_config_from_str(&task->config, config_json) < 0
+                          : z_config_default(&task->config) < 0) {
+    free(task);
+    return NULL;
+  }
+  if (z_mutex_init(&task->mutex) != 0) {
+    z_drop(z_move(task->config));
+    free(task);
+    return NULL;
+  }
+  z_scout_options_default(&task->options);
+  task->options.what = scout_what_parse(what);
+  task->options.timeout_ms = timeout_ms > 0 ? timeout_ms : 1000;
+  task->refs = 1;
+  return task;
+}
+
+// Blocks for the scouting timeout. The caller's reference is still held
+// on return.
+static void scout_task_run(struct ScoutTask *task) {
+  atomic_count_inc(&task->refs); // owned by the closure
+  z_owned_closure_hello_t closure;
+  z_closure_hello(&closure, scout_hello_handler, scout_task_release, task);
+  task->result = z_scout(z_move(task->config), z_move(closure),
+                         &task->options) < 0
+                     ? -1
+                     : 0;
+}
+
+static void *scout_task_main(void *arg) {
+  struct ScoutTask *task = (struct ScoutTask *)arg;
+  scout_task_run(task);
+  scout_task_release(task);
+  return NULL;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_scout_ex(const char *what, const char *config_json,
+                                     uint64_t timeout_ms,
+                                     ZenohScoutCallback callback,
+                                     void *context) {
+  if (callback == NULL)
+    return -1;
+  runtime_mark_started();
+  struct ScoutTask *task = scout_task_new(what, config_json, timeout_ms);
+  if (task == NULL)
+    return -1;
+  task->callback = callback;
+  task->context = context;
+
+  z_owned_task_t thread;
+  if (worker_start(&thread, scout_task_main, task) != 0) {
+    task->callback = NULL;
+    z_drop(z_move(task->config));
+    scout_task_release(task);
+    return -1;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
+
+#if defined(_WIN32)
+typedef SOCKET probe_socket_t;
+#define PROBE_INVALID_SOCKET INVALID_SOCKET
+#define probe_poll WSAPoll
+#define probe_close closesocket
+
+static bool probe_set_nonblocking(probe_socket_t s) {
+  u_long on = 1;
+  return ioctlsocket(s, FIONBIO, &on) == 0;
+}
+
+static bool probe_in_progress(void) {
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+#else
+typedef int probe_socket_t;
+#define PROBE_INVALID_SOCKET (-1)
+#define probe_poll poll
+#define probe_close close
+
+static bool probe_set_nonblocking(probe_socket_t s) {
+  int flags = fcntl(s, F_GETFL, 0);
+  return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static bool probe_in_progress(void) { return errno == EINPROGRESS; }
+#endif
+
+// Resolve the address of a TCP-based locator such as "tcp/10.0.0.2:7447" or
+// "tls/[fe80::1]:7447". Other protocols cannot be probed with a handshake.
+static struct addrinfo *probe_resolve(const char *locator) {
+  const char *addr;
+  if (strncmp(locator, "tcp/", 4) == 0 || strncmp(locator, "tls/", 4) == 0)
+    addr = locator + 4;
+  else if (strncmp(locator, "ws/", 3) == 0)
+    addr = locator + 3;
+  else
+    return NULL;
+
+  char host[256];
+  size_t n = strcspn(addr, "?#"); // drop metadata and config
+  if (n >= sizeof(host))
+    return NULL;
+  memcpy(host, addr, n);
+  host[n] = '\0';
+
+  char *port = strrchr(host, ':');
+  if (port == NULL)
+    return NULL;
+  *port++ = '\0';
+  char *name = host;
+  if (name[0] == '[') {
+    size_t end = strlen(name) - 1;
+    if (name[end] != ']')
+      return NULL;
+    name[end] = '\0';
+    name++;
+  }
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo *info = NULL;
+  if (getaddrinfo(name, port, &hints, &info) != 0)
+    return NULL;
+  return info;
+}
+
+#define PROBE_TICK_MS 10
+
+// Handshakes in flight. A locator is probed as soon as its hello arrives and
+// the first handshake to complete has the lowest round trip.
+struct ProbeSet {
+  struct pollfd *fds;
+  char **locators;
+  z_clock_t *started;
+  size_t active;
+  size_t cap;
+};
+
+static bool probe_reserve(struct ProbeSet *set, size_t cap) {
+  if (cap <= set->cap)
+    return true;
+  struct pollfd *fds =
+      (struct pollfd *)realloc(set->fds, cap * sizeof(struct pollfd));
+  if (fds == NULL)
+    return false;
+  set->fds = fds;
+  char **locators = (char **)realloc(set->locators, cap * sizeof(char *));
+  if (locators == NULL)
+    return false;
+  set->locators = locators;
+  z_clock_t *started =
+      (z_clock_t *)realloc(set->started, cap * sizeof(z_clock_t));
+  if (started == NULL)
+    return false;
+  set->started = started;
+  set->cap = cap;
+  return true;
+}
+
+static void probe_remove(struct ProbeSet *set, size_t k) {
+  probe_close(set->fds[k].fd);
+  free(set->locators[k]);
+  set->active--;
+  set->fds[k] = set->fds[set->active];
+  set->locators[k] = set->locators[set->active];
+  set->started[k] = set->started[set->active];
+}
+
+static void probe_set_free(struct ProbeSet *set) {
+  while (set->active > 0)
+    probe_remove(set, set->active - 1);
+  free(set->fds);
+  free(set->locators);
+  free(set->started);
+}
+
+// Resolve every locator of a batch first, then start all of its handshakes
+// back to back so no connect waits on another locator's lookup. A handshake
+// that completes at once sets *winner.
+static void probe_start(struct ProbeSet *set, const char *locators,
+                        size_t count, char **winner, uint64_t *rtt_us) {
+  struct addrinfo **infos =
+      (struct addrinfo **)calloc(count, sizeof(struct addrinfo *));
+  if (infos == NULL || !probe_reserve(set, set->active + count)) {
+    free(infos);
+    return;
+  }
+  const char *locator = locators;
+  for (size_t i = 0; i < count; i++, locator += strlen(locator) + 1)
+    infos[i] = probe_resolve(locator);
+
+  locator = locators;
+  for (size_t i = 0; i < count && *winner == NULL;
+       i++, locator += strlen(locator) + 1) {
+    struct addrinfo *info = infos[i];
+    if (info == NULL)
+      continue;
+    probe_socket_t s =
+        socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (s == PROBE_INVALID_SOCKET)
+      continue;
+    z_clock_t start = z_clock_now();
+    int rc = probe_set_nonblocking(s)
+                 ? connect(s, info->ai_addr, (socklen_t)info->ai_addrlen)
+                 : -1;
+    bool pending = rc != 0 && probe_in_progress();
+    if (rc == 0) {
+      *winner = strdup(locator);
+      *rtt_us = z_clock_elapsed_us(&start);
+    }
+    char *copy = pending ? strdup(locator) : NULL;
+    if (copy == NULL) {
+      probe_close(s);
+      continue;
+    }
+    set->fds[set->active].fd = s;
+    set->fds[set->active].events = POLLOUT;
+    set->fds[set->active].revents = 0;
+    set->locators[set->active] = copy;
+    set->started[set->active] = start;
+    set->active++;
+  }
+
+  for (size_t i = 0; i < count; i++)
+    if (infos[i] != NULL)
+      freeaddrinfo(infos[i]);
+  free(infos);
+}
+
+// Wait up to wait_ms for a handshake to complete and hand its locator over
+// in *winner. Probes that fail or outlive timeout_ms are dropped.
+static void probe_wait(struct ProbeSet *set, uint64_t wait_ms,
+                       uint64_t timeout_ms, char **winner, uint64_t *rtt_us) {
+  if (set->active == 0) {
+    z_sleep_ms(wait_ms);
+    return;
+  }
+  if (probe_poll(set->fds, (unsigned long)set->active, (int)wait_ms) < 0)
+    return;
+  for (size_t k = 0; k < set->active;) {
+    if (set->fds[k].revents != 0) {
+      int err = 0;
+      socklen_t err_len = sizeof(err);
+      if (getsockopt(set->fds[k].fd, SOL_SOCKET, SO_ERROR, (char *)&err,
+                     &err_len) == 0 &&
+          err == 0 && (set->fds[k].revents & POLLOUT)) {
+        *winner = set->locators[k];
+        *rtt_us = z_clock_elapsed_us(&set->started[k]);
+        set->locators[k] = NULL;
+        return;
+      }
+      // Refused or unreachable: drop it and keep waiting on the rest
+      probe_remove(set, k);
+    } else if (z_clock_elapsed_ms(&set->started[k]) >= timeout_ms) {
+      probe_remove(set, k);
+    } else {
+      k++;
+    }
+  }
+}
+
+static ZenohSession *scout_connect_open(const char *config_json,
+                                        const char *locator) {
+  size_t len = strlen(locator);
+  if (!scout_locator_json_safe(locator, len))
+    return NULL;
+
+  z_owned_config_t config;
+  if (config_json != NULL ? zc_config_from_str(&config, config_json) < 0
+                          : z_config_default(&config) < 0)
+    return NULL;
+
+  size_t n = len + 5;
+  char *endpoints = (char *)malloc(n);
+  if (endpoints == NULL) {
+    z_drop(z_move(config));
+    return NULL;
+  }
+  snprintf(endpoints, n, "[\"%s\"]", locator);
+  int rc = zc_config_insert_json5(z_loan_mut(config), Z_CONFIG_CONNECT_KEY,
+                                  endpoints);
+  free(endpoints);
+  if (rc < 0) {
+    z_drop(z_move(config));
+    return NULL;
+  }
+
+  z_owned_session_t s;
+  if (z_open(&s, z_move(config), NULL) < 0)
+    return NULL;
+  return session_new(&s);
+}
+
+static void *scout_connect_scout_main(void *arg) {
+  struct ScoutTask *task = (struct ScoutTask *)arg;
+  scout_task_run(task);
+  z_mutex_lock(z_loan_mut(task->mutex));
+  task->scouting_done = true;
+  z_mutex_unlock(z_loan_mut(task->mutex));
+  scout_task_release(task);
+  return NULL;
+}
+
+static void *scout_connect_main(void *arg) {
+  struct ScoutTask *task = (struct ScoutTask *)arg;
+  uint64_t probe_timeout_ms = task->probe_timeout_ms;
+
+  // Scouting runs on its own thread and keeps going after a winner is
+  // found; its reference keeps the task alive until it returns.
+  atomic_count_inc(&task->refs);
+  z_owned_task_t scout;
+  if (worker_start(&scout, scout_connect_scout_main, task) != 0) {
+    z_drop(z_move(task->config));
+    task->result = -1;
+    task->scouting_done = true;
+    atomic_count_dec(&task->refs);
+  } else {
+    z_task_detach(z_move(scout));
+  }
+
+#if defined(_WIN32)
+  WSADATA wsa;
+  bool wsa_ready = WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+#endif
+  struct ProbeSet probes;
+  memset(&probes, 0, sizeof(probes));
+  char *first = NULL; // Fallback when no probe answers
+  char *winner = NULL;
+  uint64_t rtt_us = UINT64_MAX;
+  int result = 0;
+  while (winner == NULL) {
+    z_mutex_lock(z_loan_mut(task->mutex));
+    char *fresh = task->fresh;
+    size_t fresh_count = task->fresh_count;
+    task->fresh = NULL;
+    task->fresh_len = 0;
+    task->fresh_count = 0;
+    bool done = task->scouting_done;
+    result = task->result;
+    z_mutex_unlock(z_loan_mut(task->mutex));
+
+    if (fresh != NULL) {
+      if (first == NULL)
+        first = strdup(fresh);
+#if defined(_WIN32)
+      if (wsa_ready)
+#endif
+        probe_start(&probes, fresh, fresh_count, &winner, &rtt_us);
+      free(fresh);
+      continue;
+    }
+    if (done && probes.active == 0)
+      break;
+    probe_wait(&probes, PROBE_TICK_MS, probe_timeout_ms, &winner, &rtt_us);
+  }
+  probe_set_free(&probes);
+#if defined(_WIN32)
+  if (wsa_ready)
+    WSACleanup();
+#endif
+
+  char *config_json = task->connect_config;
+  task->connect_config = NULL;
+  ZenohScoutConnectCallback callback = task->connect_callback;
+  void *context = task->context;
+  scout_task_release(task);
+
+  ZenohSession *session = NULL;
+  char *locator = winner;
+  if (locator != NULL) {
+    free(first);
+    result = 0;
+  } else {
+    locator = first;
+    rtt_us = UINT64_MAX;
+    if (result == 0 && locator == NULL)
+      result = -2;
+  }
+  if (result == 0) {
+    session = scout_connect_open(config_json, locator);
+    if (session == NULL)
+      result = -3;
+  }
+  free(config_json);
+
+  callback(session, result, locator, rtt_us, context);
+  return NULL;
+}
+
+FFI_PLUGIN_EXPORT int zenoh_scout_connect(const char *what,
+                                          const char *config_json,
+                                          uint64_t scout_timeout_ms,
+                                          uint64_t probe_timeout_ms,
+                                          ZenohScoutConnectCallback callback,
+                                          void *context) {
+  if (callback == NULL)
+    return -1;
+  runtime_mark_started();
+  struct ScoutTask *task = scout_task_new(what, config_json, scout_timeout_ms);
+  if (task == NULL)
+    return -1;
+  if (config_json != NULL &&
+      (task->connect_config = strdup(config_json)) == NULL) {
+    z_drop(z_move(task->config));
+    scout_task_release(task);
+    return -1;
+  }
+  task->probe_timeout_ms = probe_timeout_ms > 0 ? probe_timeout_ms : 1000;
+  task->connect_callback = callback;
+  task->context = context;
+
+  z_owned_task_t thread;
+  if (worker_start(&thread, scout_connect_main, task) != 0) {
+    z_drop(z_move(task->config));
+    scout_task_release(task);
+    return -1;
+  }
+  z_task_detach(z_move(thread));
+  return 0;
+}
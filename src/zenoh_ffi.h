@@ -16,6 +16,7 @@
 #endif
 
 #if _WIN32
+#include <winsock2.h> // must precede windows.h
 #include <windows.h>
 #else
 #include <pthread.h>
@@ -39,6 +40,21 @@ typedef struct ZenohPublisher ZenohPublisher;
 typedef struct ZenohSubscriber ZenohSubscriber;
 typedef struct ZenohQueryable ZenohQueryable;
 typedef struct ZenohLivelinessToken ZenohLivelinessToken;
+typedef struct ZenohShmProvider ZenohShmProvider;
+typedef struct ZenohShmBuffer ZenohShmBuffer;
+typedef struct ZenohQuerier ZenohQuerier;
+typedef struct ZenohQuery ZenohQuery;
+typedef struct ZenohStorage ZenohStorage;
+typedef struct ZenohLogStore ZenohLogStore;
+typedef struct ZenohTimeSeries ZenohTimeSeries;
+typedef struct ZenohQueryingSubscriber ZenohQueryingSubscriber;
+typedef struct ZenohAdvancedSubscriber ZenohAdvancedSubscriber;
+typedef struct ZenohReplyChannel ZenohReplyChannel;
+typedef struct ZenohRpcServer ZenohRpcServer;
+typedef struct ZenohRpcClient ZenohRpcClient;
+typedef struct ZenohRpcResponse ZenohRpcResponse;
+typedef struct ZenohSessionGroup ZenohSessionGroup;
+typedef struct ZenohLivelinessTracker ZenohLivelinessTracker;
 
 // ============================================================================
 // Enums - Priority and Congestion Control
@@ -65,6 +81,58 @@ typedef enum {
   ZENOH_SAMPLE_KIND_DELETE = 1
 } ZenohSampleKind;
 
+typedef enum {
+  ZENOH_REPLY_KIND_PUT = 0,
+  ZENOH_REPLY_KIND_DELETE = 1,
+  ZENOH_REPLY_KIND_ERROR = 2
+} ZenohReplyKind;
+
+// Status of an RPC call. Handlers may return their own codes from 16 up.
+typedef enum {
+  ZENOH_RPC_OK = 0,
+  ZENOH_RPC_ERROR = 1,       // Handler or transport error
+  ZENOH_RPC_NOT_FOUND = 2,   // No such method
+  ZENOH_RPC_TIMEOUT = 3,     // Deadline exceeded
+  ZENOH_RPC_UNAVAILABLE = 4  // No server replied
+} ZenohRpcStatus;
+
+// Buffering of a ZenohReplyChannel
+typedef enum {
+  ZENOH_REPLY_CHANNEL_FIFO = 0, // Blocks zenoh when full
+  ZENOH_REPLY_CHANNEL_RING = 1  // Drops the oldest reply when full
+} ZenohReplyChannelKind;
+
+// ============================================================================
+// Enums - Query Consolidation, Target and Locality
+// ============================================================================
+
+typedef enum {
+  ZENOH_CONSOLIDATION_AUTO = 0,
+  ZENOH_CONSOLIDATION_NONE = 1,
+  ZENOH_CONSOLIDATION_MONOTONIC = 2,
+  ZENOH_CONSOLIDATION_LATEST = 3
+} ZenohConsolidationMode;
+
+typedef enum {
+  ZENOH_QUERY_TARGET_BEST_MATCHING = 0,
+  ZENOH_QUERY_TARGET_ALL = 1,
+  ZENOH_QUERY_TARGET_ALL_COMPLETE = 2
+} ZenohQueryTarget;
+
+typedef enum {
+  ZENOH_LOCALITY_ANY = 0,
+  ZENOH_LOCALITY_SESSION_LOCAL = 1,
+  ZENOH_LOCALITY_REMOTE = 2
+} ZenohLocality;
+
+// Named starting points for zenoh_config_tune
+typedef enum {
+  ZENOH_TRANSPORT_PROFILE_DEFAULT = 0,            // zenoh's own defaults
+  ZENOH_TRANSPORT_PROFILE_LOW_LATENCY = 1,        // Low-latency transport and no batching
+  ZENOH_TRANSPORT_PROFILE_HIGH_THROUGHPUT = 2,    // Large batches and deep queues
+  ZENOH_TRANSPORT_PROFILE_CONSTRAINED_DEVICE = 3  // Small buffers and compression
+} ZenohTransportProfile;
+
 // ============================================================================
 // Encoding Types
 // ============================================================================
@@ -135,8 +203,246 @@ typedef struct {
   ZenohEncodingId encoding;
   const uint8_t *attachment;
   size_t attachment_len;
+  ZenohConsolidationMode consolidation;
+  ZenohQueryTarget target;
+  ZenohLocality allowed_destination;
+  uint32_t limit;        // Max data replies delivered (0 = unlimited)
+  const char *cursor;    // Only deliver keys sorting after this one
 } ZenohGetOptions;
 
+typedef struct {
+  uint64_t timeout_ms;  // Timeout in milliseconds (0 = zenoh default)
+  ZenohPriority priority;
+  ZenohCongestionControl congestion_control;
+  bool is_express;
+  ZenohConsolidationMode consolidation;
+  ZenohQueryTarget target;
+  ZenohLocality allowed_destination;
+} ZenohQuerierOptions;
+
+// ============================================================================
+// Subscriber Options
+// ============================================================================
+
+typedef struct {
+  const char *query_selector; // Initial query (NULL = the key expression)
+  ZenohQueryTarget query_target;
+  ZenohConsolidationMode query_consolidation;
+  uint64_t query_timeout_ms;
+  ZenohLocality allowed_origin;
+} ZenohQueryingSubscriberOptions;
+
+typedef struct {
+  bool history;                // Fetch the publishers' cached samples
+  bool detect_late_publishers; // Also fetch history of publishers seen later
+  size_t history_max_samples;  // Per key (0 = unlimited)
+  uint64_t history_max_age_ms; // 0 = unlimited
+  bool recovery;               // Retransmit samples detected as missed
+  uint64_t recovery_period_ms; // Last-sample queries (0 = use heartbeats)
+  uint64_t query_timeout_ms;   // History and recovery queries (0 = default)
+  bool subscriber_detection;   // Announce the subscriber through liveliness
+  ZenohLocality allowed_origin;
+} ZenohAdvancedSubscriberOptions;
+
+// ============================================================================
+// Storage Options
+// ============================================================================
+
+typedef struct {
+  size_t max_entries; // Keys kept, including deleted ones (0 = unlimited)
+  bool complete;      // Declare the queryable as complete for its key space
+} ZenohStorageOptions;
+
+typedef struct {
+  uint64_t entries;
+  uint64_t tombstones;   // Deleted keys remembered for last-writer-wins
+  uint64_t memory_bytes; // Approximate heap used by keys, values and index
+  uint64_t queries;
+  uint64_t rejected;     // Updates older than the stored value, or over capacity
+} ZenohStorageStats;
+
+typedef struct {
+  size_t segment_size;             // Bytes per segment file (0 = 64 MiB)
+  double compaction_ratio;         // Garbage share that triggers compaction
+  uint64_t compaction_interval_ms; // Background compaction period
+  bool sync_writes;                // msync every record before returning
+} ZenohLogStoreOptions;
+
+typedef struct {
+  uint64_t entries;
+  uint64_t tombstones;
+  uint64_t segments;
+  uint64_t disk_bytes;  // Size of all segment files
+  uint64_t live_bytes;  // Bytes of the records the index points to
+  uint64_t index_bytes; // Heap used by the in-memory index
+  uint64_t compactions; // Segments reclaimed since open
+} ZenohLogStoreStats;
+
+// How a time series turns sample payloads into values
+typedef enum {
+  ZENOH_TIMESERIES_FORMAT_AUTO = 0, // Payload is a text number, nothing else
+  ZENOH_TIMESERIES_FORMAT_TEXT = 1,
+  ZENOH_TIMESERIES_FORMAT_F64_LE = 2,
+  ZENOH_TIMESERIES_FORMAT_F32_LE = 3,
+  ZENOH_TIMESERIES_FORMAT_I64_LE = 4,
+  ZENOH_TIMESERIES_FORMAT_JSON_FIELD = 5, // Number under json_field
+} ZenohTimeSeriesFormat;
+
+// Native value extractor, called on zenoh threads. Returns false to drop the
+// sample.
+typedef bool (*ZenohTimeSeriesExtractor)(const uint8_t *data, size_t len,
+                                         double *value, void *context);
+
+typedef struct {
+  size_t capacity;   // Points kept per key (0 = 3600)
+  size_t max_series; // Keys tracked (0 = unlimited)
+  ZenohTimeSeriesFormat format;
+  const char *json_field;             // Copied, read by JSON_FIELD
+  ZenohTimeSeriesExtractor extractor; // Overrides format when set
+  void *extractor_context;
+  bool complete; // Declare the queryable as complete for its key space
+} ZenohTimeSeriesOptions;
+
+typedef struct {
+  uint64_t series;
+  uint64_t points;
+  uint64_t samples;
+  uint64_t rejected;     // Unparsable, out-of-order or over max_series
+  uint64_t queries;
+  uint64_t memory_bytes; // Ring and key allocations
+} ZenohTimeSeriesStats;
+
+// ============================================================================
+// Transport Tuning
+// ============================================================================
+
+// Transport settings applied on top of a profile. Flags are 1 (on), 0 (off)
+// or -1 (profile value); sizes of 0 and a time limit of -1 keep the profile
+// value.
+typedef struct {
+  ZenohTransportProfile profile;
+  int lowlatency;                 // Requires qos off
+  int qos;                        // Priority queues
+  int compression;
+  int shared_memory;              // Only honored by SHM-enabled builds
+  int batching;                   // Coalesce messages into batches
+  int64_t batching_time_limit_ms; // Longest a batch waits before it is sent
+  uint32_t batch_size;            // Bytes per batch, at most 65535
+  uint32_t rx_buffer_size;        // Receive buffer bytes per link
+  uint32_t queue_size;            // Batches per priority queue, 1 to 16
+  uint64_t wait_before_drop_us;   // Wait on a full queue before dropping
+} ZenohTransportTuning;
+
+// ============================================================================
+// Runtime Statistics
+// ============================================================================
+
+#define ZENOH_STATS_COPY_BUCKETS 16
+
+// Counters of a session, or of one publisher, subscriber or queryable. A
+// session snapshot sums its live entities, the ones already undeclared and
+// its own ad-hoc puts.
+typedef struct {
+  uint64_t puts;
+  uint64_t bytes_out;
+  uint64_t put_errors;
+  uint64_t samples_in;
+  uint64_t bytes_in;
+  uint64_t dropped_samples; // Received but not delivered to the callback
+  uint64_t queries_served;
+  // Time spent copying each sample for Dart, not Dart's own handling.
+  // Bucket i counts copies that took less than 2^i microseconds and the
+  // last bucket all slower ones.
+  uint64_t sample_copy_us[ZENOH_STATS_COPY_BUCKETS];
+  uint64_t publishers;  // Live entities (session snapshots only)
+  uint64_t subscribers;
+  uint64_t queryables;
+} ZenohSessionStats;
+
+// ============================================================================
+// Runtime and Threads
+// ============================================================================
+
+// Worker counts of zenoh's runtime pools, handed to zenoh through the
+// ZENOH_RUNTIME variable. 0 keeps zenoh's default.
+typedef struct {
+  uint32_t app_workers; // Application pool: API calls and timers
+  uint32_t acc_workers; // Acceptor pool: incoming connections
+  uint32_t tx_workers;  // Transmission pool
+  uint32_t rx_workers;  // Reception pool: runs subscriber and query callbacks
+  uint32_t max_blocking_threads; // Blocking threads of each pool
+} ZenohRuntimeConfig;
+
+typedef enum {
+  ZENOH_THREAD_DELIVERY = 0, // zenoh thread that ran a callback of this library
+  ZENOH_THREAD_WORKER = 1,   // Thread started by this library
+} ZenohThreadKind;
+
+// Applied by each thread of one kind to itself
+typedef struct {
+  uint64_t cpu_mask; // Bit i allows CPU i (0 leaves the affinity alone)
+  bool set_nice;
+  int32_t nice; // -20 (highest priority) to 19 (lowest)
+} ZenohThreadPolicy;
+
+typedef struct {
+  uint64_t thread_id;    // OS thread id (0 for the sum of exited workers)
+  ZenohThreadKind kind;
+  uint64_t cpu_time_us;  // User plus system time
+  uint64_t callbacks;    // Callbacks delivered on this thread
+  int32_t policy_result; // 0 or -1 when the OS refused the last policy
+} ZenohThreadStats;
+
+// ============================================================================
+// Session Group Stats
+// ============================================================================
+
+// Live entities of one session of a ZenohSessionGroup
+typedef struct {
+  uint64_t publishers;
+  uint64_t subscribers;
+} ZenohSessionGroupStats;
+
+// ============================================================================
+// RPC Options
+// ============================================================================
+
+typedef struct {
+  uint64_t attempt_timeout_ms; // Timeout of each attempt (0 = zenoh default)
+  ZenohPriority priority;
+  bool is_express;             // Send requests without batching
+  ZenohQueryTarget target;
+  ZenohLocality allowed_destination;
+} ZenohRpcClientOptions;
+
+// ============================================================================
+// Reply Items
+// ============================================================================
+
+// One reply of a zenoh_query_reply_batch call
+typedef struct {
+  const char *key;
+  const uint8_t *payload;
+  size_t payload_len;
+  ZenohEncodingId encoding;
+  const uint8_t *attachment;
+  size_t attachment_len;
+} ZenohReplyItem;
+
+// One reply received from a ZenohReplyChannel. The strings and buffers are
+// owned by the channel and stay valid until its next receive or close.
+typedef struct {
+  const char *key;         // NULL for error replies
+  const uint8_t *payload;
+  size_t payload_len;
+  int reply_kind;          // ZenohReplyKind
+  const char *encoding;
+  const uint8_t *attachment;
+  size_t attachment_len;
+  uint64_t timestamp;      // NTP64 or 0
+  const char *replier_id;  // NULL unless built with the unstable API
+} ZenohReplyRecord;
+
 // ============================================================================
 // Callback Types
 // ============================================================================
@@ -159,31 +465,157 @@ typedef void (*ZenohOnArgsCallback)(const char *value);
 typedef void (*ZenohGetCallback)(const char *key, const uint8_t *value,
                                  size_t len, const char *kind, void *context);
 
-// Extended query callback
+// Extended query callback. reply_kind is a ZenohReplyKind; error replies have
+// a NULL key and carry the error payload and encoding. timestamp is the raw
+// NTP64 time (0 if the reply has none). replier_id is the replier's zid in hex,
+// or NULL when unknown or built without the unstable API.
 typedef void (*ZenohGetCallbackEx)(const char *key, const uint8_t *value,
-                                   size_t len, int sample_kind,
+                                   size_t len, int reply_kind,
                                    const char *encoding,
                                    const uint8_t *attachment,
-                                   size_t attachment_len, void *context);
+                                   size_t attachment_len, uint64_t timestamp,
+                                   const char *replier_id, void *context);
+
+// Multi-selector query callback: a ZenohGetCallbackEx reply tagged with the
+// index of the selector it answers
+typedef void (*ZenohGetMultiCallback)(size_t selector_index, const char *key,
+                                      const uint8_t *value, size_t len,
+                                      int reply_kind, const char *encoding,
+                                      const uint8_t *attachment,
+                                      size_t attachment_len,
+                                      uint64_t timestamp,
+                                      const char *replier_id, void *context);
 
 // Query completion callback
 typedef void (*ZenohGetCompleteCallback)(void *context);
 
+// Paged query completion. next_cursor resumes after the last delivered key
+// (pass it as ZenohGetOptions.cursor), or is NULL when nothing is left.
+typedef void (*ZenohGetPageCallback)(const char *next_cursor, void *context);
+
+// Native RPC method handler, run on a zenoh thread. Writes its response with
+// zenoh_rpc_response_write and returns a ZenohRpcStatus or its own code.
+typedef int (*ZenohRpcHandler)(const uint8_t *request, size_t len,
+                               ZenohRpcResponse *response, void *context);
+
+// RPC request for a method without a native handler. query must be answered
+// with zenoh_rpc_respond, passing call_id back.
+typedef void (*ZenohRpcRequestCallback)(const char *method,
+                                        const uint8_t *request, size_t len,
+                                        uint64_t call_id, ZenohQuery *query,
+                                        void *context);
+
+// RPC call outcome, invoked exactly once per call. data is NULL unless a
+// server replied in time.
+typedef void (*ZenohRpcResponseCallback)(uint64_t call_id, int status,
+                                         const uint8_t *data, size_t len,
+                                         void *context);
+
+// Advanced subscriber miss callback. source_id is the zid of the publisher
+// whose samples were lost, count how many could not be recovered.
+typedef void (*ZenohSampleMissCallback)(const char *source_id, uint32_t count,
+                                        void *context);
+
+// Queryable callback. query is an owned, refcounted handle: replies may be
+// sent from any thread until zenoh_query_finalize drops the last reference,
+// which tells the querier that no more replies will follow.
 typedef void (*ZenohQueryCallback)(const char *key, const char *selector,
                                    const uint8_t *value, size_t len,
-                                   const char *kind, void *reply_context,
+                                   const char *kind, ZenohQuery *query,
                                    void *user_context);
 
+// Shared-memory aware subscriber callback. When shm_buffer is non-NULL, value
+// points into the mapped segment and stays valid until
+// zenoh_shm_buffer_free(shm_buffer); otherwise value is a heap copy.
+typedef void (*ZenohSubscriberShmCallback)(const char *key,
+                                           const uint8_t *value, size_t len,
+                                           ZenohShmBuffer *shm_buffer,
+                                           void *context);
+
+// Chunked transfer completion callback. data holds the whole reassembled
+// object as a heap buffer; release it with zenoh_free_string.
+typedef void (*ZenohChunkedCallback)(const char *key, uint8_t *data, size_t len,
+                                     uint64_t transfer_id, void *context);
+
+// Chunked transfer progress callback, called once per accepted chunk
+typedef void (*ZenohChunkProgressCallback)(uint64_t transfer_id,
+                                           uint32_t received, uint32_t total,
+                                           void *context);
+
+// Completion of zenoh_publisher_put_chunked_async: result is the number of
+// chunks sent or < 0
+typedef void (*ZenohChunkedPutCallback)(uint64_t transfer_id, int result,
+                                        void *context);
+
+// Matching status callback: matching is true while at least one entity
+// matches the declaring querier
+typedef void (*ZenohMatchingCallback)(bool matching, void *context);
+
+// Storage change callback, called after an update has been applied
+typedef void (*ZenohStorageChangeCallback)(const char *key, int sample_kind,
+                                           void *context);
+
+// Asynchronous open result, called on the worker thread. session is NULL
+// unless result is 0. elapsed_us is the time spent in z_open.
+typedef void (*ZenohSessionOpenCallback)(ZenohSession *session, int result,
+                                         uint64_t elapsed_us, void *context);
+
+// Asynchronous close result. The session handle is already freed.
+typedef void (*ZenohSessionCloseCallback)(int result, uint64_t elapsed_us,
+                                          void *context);
+
+// Asynchronous session group open result, called on the worker thread. group
+// is NULL unless result is 0.
+typedef void (*ZenohSessionGroupOpenCallback)(ZenohSessionGroup *group,
+                                              int result, uint64_t elapsed_us,
+                                              void *context);
+
 // Liveliness callback
 typedef void (*ZenohLivelinessCallback)(const char *key, int is_alive,
                                         void *context);
 
+// Liveliness tracker delta from version - 1 to version. keys holds
+// joined_count and then left_count NUL-terminated keys back to back, len
+// bytes in all; release it with zenoh_free_string.
+typedef void (*ZenohLivelinessDeltaCallback)(uint64_t version, char *keys,
+                                             size_t len, size_t joined_count,
+                                             size_t left_count, void *context);
+
+// Scouting result. Each distinct zid is reported as a packed record: whatami
+// (1 byte) then zid (16 bytes) then the locator count (u32 LE) and the
+// locators as NUL-terminated strings. A zid is reported again only when it
+// brings new locators. A final call with record NULL carries the outcome.
+// Release records with zenoh_free_string.
+typedef void (*ZenohScoutCallback)(uint8_t *record, size_t len, int result,
+                                   void *context);
+
+// Scout-and-connect result. locator is the endpoint connected to (release
+// with zenoh_free_string) and rtt_us its probe handshake time or UINT64_MAX
+// if no probe answered. session is NULL unless result is 0.
+typedef void (*ZenohScoutConnectCallback)(ZenohSession *session, int result,
+                                          char *locator, uint64_t rtt_us,
+                                          void *context);
+
 // ============================================================================
 // Library Management
 // ============================================================================
 
 FFI_PLUGIN_EXPORT int zenoh_init_logger(void);
 
+// Size zenoh's runtime pools. The runtime reads its configuration once, so
+// this must run before the first session is opened; it fails with -2 after.
+FFI_PLUGIN_EXPORT int zenoh_runtime_configure(const ZenohRuntimeConfig *config);
+// Affinity and niceness for threads of kind. Delivery threads apply it before
+// their next callback and library threads when they start; threads that
+// also call put or get themselves are left alone. NULL stops applying a
+// policy, though threads keep what they already applied.
+FFI_PLUGIN_EXPORT int zenoh_set_thread_policy(ZenohThreadKind kind,
+                                              const ZenohThreadPolicy *policy);
+// Fill one entry per live tracked thread plus one for exited workers, up to
+// max. Returns the number written.
+FFI_PLUGIN_EXPORT size_t zenoh_thread_stats(ZenohThreadStats *stats,
+                                            size_t max);
+
 // ============================================================================
 // Session Management
 // ============================================================================
@@ -195,6 +627,94 @@ FFI_PLUGIN_EXPORT ZenohSession *zenoh_open_session_with_config(
 FFI_PLUGIN_EXPORT void zenoh_close_session(ZenohSession *session);
 FFI_PLUGIN_EXPORT const char *zenoh_session_info(ZenohSession *session);
 
+FFI_PLUGIN_EXPORT void
+zenoh_transport_tuning_default(ZenohTransportTuning *tuning);
+// Apply tuning to config_json (NULL for the default config) through
+// zc_config_insert_json5. Returns the complete resulting config as JSON for
+// zenoh_open_session_with_config, or NULL when a value is rejected. When
+// applied is not NULL it receives a JSON object of every key written and the
+// value zenoh stored, or on rejection the rejected key (NULL when the config
+// itself failed to parse). Free both with zenoh_free_string.
+FFI_PLUGIN_EXPORT char *zenoh_config_tune(const char *config_json,
+                                          const ZenohTransportTuning *tuning,
+                                          char **applied);
+
+// Copy the session's counters. Counters are updated lock-free on the hot
+// path; a snapshot costs one pass over the session's live entities.
+FFI_PLUGIN_EXPORT int zenoh_session_stats_snapshot(ZenohSession *session,
+                                                   ZenohSessionStats *stats);
+// Counters of a single entity. Fails for entities that are not tracked.
+FFI_PLUGIN_EXPORT int zenoh_publisher_stats_snapshot(ZenohPublisher *publisher,
+                                                     ZenohSessionStats *stats);
+FFI_PLUGIN_EXPORT int
+zenoh_subscriber_stats_snapshot(ZenohSubscriber *subscriber,
+                                ZenohSessionStats *stats);
+FFI_PLUGIN_EXPORT int zenoh_queryable_stats_snapshot(ZenohQueryable *queryable,
+                                                     ZenohSessionStats *stats);
+
+// Open a session on a native worker thread. config_json may be NULL for the
+// default config. Returns 0 once the open is started; callback reports the
+// outcome exactly once.
+FFI_PLUGIN_EXPORT int
+zenoh_open_session_async(const char *config_json,
+                         ZenohSessionOpenCallback callback, void *context);
+
+// Close a session without blocking the caller. The session must not be used
+// after this returns 0.
+FFI_PLUGIN_EXPORT int
+zenoh_close_session_async(ZenohSession *session,
+                          ZenohSessionCloseCallback callback, void *context);
+
+// ============================================================================
+// Session Groups
+// ============================================================================
+
+// Open count sessions from the same config (NULL for the default), in
+// parallel. Fails unless every session opens. The members share zenoh's
+// process-wide runtime, so a group adds sessions (transports, links and
+// entity tables), not threads; size the runtime pools with
+// zenoh_runtime_configure. Blocks until every open has finished.
+FFI_PLUGIN_EXPORT ZenohSessionGroup *
+zenoh_session_group_open(size_t count, const char *config_json);
+// zenoh_session_group_open on a native worker thread. Returns 0 once the
+// open is started; callback reports the outcome exactly once.
+FFI_PLUGIN_EXPORT int
+zenoh_session_group_open_async(size_t count, const char *config_json,
+                               ZenohSessionGroupOpenCallback callback,
+                               void *context);
+FFI_PLUGIN_EXPORT size_t zenoh_session_group_size(ZenohSessionGroup *group);
+// Borrow a member session. It is closed with the group, never on its own.
+FFI_PLUGIN_EXPORT ZenohSession *
+zenoh_session_group_session(ZenohSessionGroup *group, size_t index);
+// Index of the session key hashes to
+FFI_PLUGIN_EXPORT int zenoh_session_group_route(ZenohSessionGroup *group,
+                                                const char *key);
+// Declare on the session picked by affinity (taken modulo the group size),
+// or by key hash when affinity is negative. opts may be NULL.
+FFI_PLUGIN_EXPORT ZenohPublisher *zenoh_session_group_declare_publisher(
+    ZenohSessionGroup *group, const char *key, int affinity,
+    ZenohPublisherOptions *opts);
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_session_group_declare_subscriber(
+    ZenohSessionGroup *group, const char *key, int affinity,
+    ZenohSubscriberCallback callback, void *context);
+// Fill one entry per session, up to max, with its live publishers and
+// subscribers however they were declared. Returns the number written.
+FFI_PLUGIN_EXPORT size_t zenoh_session_group_stats(
+    ZenohSessionGroup *group, ZenohSessionGroupStats *stats, size_t max);
+// Sum of the member sessions' statistics
+FFI_PLUGIN_EXPORT int
+zenoh_session_group_stats_snapshot(ZenohSessionGroup *group,
+                                   ZenohSessionStats *stats);
+// Close every session in parallel, returning once all are closed. Entities
+// declared through the group must be undeclared first.
+FFI_PLUGIN_EXPORT void zenoh_session_group_close(ZenohSessionGroup *group);
+// zenoh_session_group_close on a native worker thread. The group must not be
+// used after this returns 0.
+FFI_PLUGIN_EXPORT int
+zenoh_session_group_close_async(ZenohSessionGroup *group,
+                                ZenohSessionCloseCallback callback,
+                                void *context);
+
 // ============================================================================
 // Publisher
 // ============================================================================
@@ -212,6 +732,19 @@ FFI_PLUGIN_EXPORT int zenoh_publisher_put_with_options(ZenohPublisher *publisher
 FFI_PLUGIN_EXPORT int zenoh_publisher_delete(ZenohPublisher *publisher);
 FFI_PLUGIN_EXPORT void zenoh_undeclare_publisher(ZenohPublisher *publisher);
 
+// Declare count publishers in one call. keys holds count NUL-terminated key
+// expressions back to back. opts holds opts_count entries: none for the
+// defaults, one shared by every key, or one per key. The publishers live in
+// one contiguous block freed with the last of them. publishers[i] is NULL
+// where key i failed; returns the number declared.
+FFI_PLUGIN_EXPORT size_t zenoh_declare_publishers_bulk(
+    ZenohSession *session, const char *keys, size_t count,
+    const ZenohPublisherOptions *opts, size_t opts_count,
+    ZenohPublisher **publishers);
+// Undeclare each non-NULL publisher, whether or not declared in bulk
+FFI_PLUGIN_EXPORT void zenoh_undeclare_publishers_bulk(
+    ZenohPublisher **publishers, size_t count);
+
 // ============================================================================
 // Subscriber
 // ============================================================================
@@ -224,6 +757,105 @@ FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_ex(
     void *context);
 FFI_PLUGIN_EXPORT void zenoh_undeclare_subscriber(ZenohSubscriber *subscriber);
 
+// Declare count subscribers sharing callback, with keys packed as for
+// zenoh_declare_publishers_bulk. Subscriber i gets contexts[i] (NULL when
+// contexts is NULL). Takes no options: like zenoh_declare_subscriber, every
+// subscriber uses the zenoh defaults.
+FFI_PLUGIN_EXPORT size_t zenoh_declare_subscribers_bulk(
+    ZenohSession *session, const char *keys, size_t count,
+    ZenohSubscriberCallback callback, void *const *contexts,
+    ZenohSubscriber **subscribers);
+FFI_PLUGIN_EXPORT void zenoh_undeclare_subscribers_bulk(
+    ZenohSubscriber **subscribers, size_t count);
+
+// ============================================================================
+// Querying and Advanced Subscribers
+// ============================================================================
+
+// Subscribes to key_expr and queries it. Samples are held back until the
+// query completes, then replies and held samples are delivered in timestamp
+// order without duplicates, on_ready is called, and live delivery resumes.
+// Returns NULL when the query cannot be sent. Held samples that do not fit
+// in memory count as dropped in the subscriber's stats.
+FFI_PLUGIN_EXPORT ZenohQueryingSubscriber *zenoh_declare_querying_subscriber(
+    ZenohSession *session, const char *key_expr,
+    ZenohQueryingSubscriberOptions *options,
+    ZenohSubscriberCallbackEx callback, ZenohGetCompleteCallback on_ready,
+    void *context);
+FFI_PLUGIN_EXPORT void
+zenoh_undeclare_querying_subscriber(ZenohQueryingSubscriber *subscriber);
+FFI_PLUGIN_EXPORT int
+zenoh_querying_subscriber_stats_snapshot(ZenohQueryingSubscriber *subscriber,
+                                         ZenohSessionStats *stats);
+
+// Advanced subscribers need zenoh-c built with its unstable API
+FFI_PLUGIN_EXPORT bool zenoh_advanced_subscriber_is_available(void);
+// Subscriber with history and lost-sample recovery from advanced publishers.
+// on_miss may be NULL. Returns NULL when unavailable.
+FFI_PLUGIN_EXPORT ZenohAdvancedSubscriber *zenoh_declare_advanced_subscriber(
+    ZenohSession *session, const char *key_expr,
+    ZenohAdvancedSubscriberOptions *options,
+    ZenohSubscriberCallbackEx callback, ZenohSampleMissCallback on_miss,
+    void *context);
+FFI_PLUGIN_EXPORT void
+zenoh_undeclare_advanced_subscriber(ZenohAdvancedSubscriber *subscriber);
+
+// ============================================================================
+// Shared Memory
+// ============================================================================
+
+// Returns false when zenoh-c was built without shared-memory support; all
+// other SHM functions then return NULL / -1.
+FFI_PLUGIN_EXPORT bool zenoh_shm_is_available(void);
+FFI_PLUGIN_EXPORT ZenohShmProvider *zenoh_shm_provider_create(size_t size);
+FFI_PLUGIN_EXPORT void zenoh_shm_provider_destroy(ZenohShmProvider *provider);
+FFI_PLUGIN_EXPORT ZenohShmBuffer *zenoh_shm_alloc(ZenohShmProvider *provider,
+                                                  size_t len);
+FFI_PLUGIN_EXPORT uint8_t *zenoh_shm_buffer_data(ZenohShmBuffer *buffer);
+FFI_PLUGIN_EXPORT size_t zenoh_shm_buffer_len(ZenohShmBuffer *buffer);
+FFI_PLUGIN_EXPORT void zenoh_shm_buffer_free(ZenohShmBuffer *buffer);
+// Publishes the buffer without copying. Takes ownership of buffer.
+FFI_PLUGIN_EXPORT int zenoh_publisher_put_shm(ZenohPublisher *publisher,
+                                              ZenohShmBuffer *buffer);
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_subscriber_shm(
+    ZenohSession *session, const char *key,
+    ZenohSubscriberShmCallback callback, void *context);
+
+// ============================================================================
+// Chunked Transfer
+// ============================================================================
+
+// Splits data into chunks of chunk_size bytes (0 = 64 KiB), each prefixed
+// with a header carrying the transfer id, index, count and CRC-32, and
+// publishes them back to back. Chunks borrow slices of data rather than
+// copying it: with release set, ownership of data passes to the call and
+// release(data) runs once zenoh has dropped the last chunk (also on
+// failure); with release NULL, data is copied once. Returns the number of
+// chunks sent or < 0.
+FFI_PLUGIN_EXPORT int
+zenoh_publisher_put_chunked(ZenohPublisher *publisher, const uint8_t *data,
+                            size_t len, size_t chunk_size,
+                            void (*release)(void *data),
+                            uint64_t *transfer_id);
+// Same as zenoh_publisher_put_chunked, but the chunks are published on a
+// native worker thread and callback reports the outcome, so the caller is
+// free to prepare the next object meanwhile. Returns < 0 if the put could
+// not be started; callback is not called then.
+FFI_PLUGIN_EXPORT int zenoh_publisher_put_chunked_async(
+    ZenohPublisher *publisher, const uint8_t *data, size_t len,
+    size_t chunk_size, void (*release)(void *data),
+    ZenohChunkedPutCallback callback, void *context);
+// Reassembles chunked transfers into a preallocated buffer and only delivers
+// complete objects. Plain (non-chunked) samples are delivered as-is with
+// transfer id 0. Objects larger than max_object_size (0 = 256 MiB) or split
+// into more than 2^20 chunks are rejected, as are new transfers once the
+// in-flight ones hold 512 MiB (or one maximum-size object, if larger).
+// Transfers idle for timeout_ms (0 = 30 s) are discarded.
+FFI_PLUGIN_EXPORT ZenohSubscriber *zenoh_declare_chunked_subscriber(
+    ZenohSession *session, const char *key, ZenohChunkedCallback callback,
+    ZenohChunkProgressCallback progress_callback, size_t max_object_size,
+    uint64_t timeout_ms, void *context);
+
 // ============================================================================
 // Queryable
 // ============================================================================
@@ -232,11 +864,30 @@ FFI_PLUGIN_EXPORT ZenohQueryable *
 zenoh_declare_queryable(ZenohSession *session, const char *key_expr,
                         ZenohQueryCallback callback, void *context);
 FFI_PLUGIN_EXPORT void zenoh_undeclare_queryable(ZenohQueryable *queryable);
-FFI_PLUGIN_EXPORT void zenoh_query_reply(void *reply_context, const char *key,
-                                         const uint8_t *data, size_t len);
-FFI_PLUGIN_EXPORT void zenoh_query_reply_with_options(
-    void *reply_context, const char *key, const uint8_t *data, size_t len,
+FFI_PLUGIN_EXPORT int zenoh_query_reply(ZenohQuery *query, const char *key,
+                                        const uint8_t *data, size_t len);
+FFI_PLUGIN_EXPORT int zenoh_query_reply_with_options(
+    ZenohQuery *query, const char *key, const uint8_t *data, size_t len,
     ZenohEncodingId encoding, const uint8_t *attachment, size_t attachment_len);
+// Sends n replies in one call. Returns the number sent, or the error code of
+// the first reply that failed.
+FFI_PLUGIN_EXPORT int zenoh_query_reply_batch(ZenohQuery *query,
+                                              const ZenohReplyItem *items,
+                                              size_t n);
+FFI_PLUGIN_EXPORT int zenoh_query_reply_err(ZenohQuery *query,
+                                            const uint8_t *payload, size_t len,
+                                            ZenohEncodingId encoding);
+FFI_PLUGIN_EXPORT int zenoh_query_reply_del(ZenohQuery *query,
+                                            const char *key);
+// Value of selector parameter name (parameters are separated by ';' or '&'),
+// as a heap string to release with zenoh_free_string. Returns "" for a
+// parameter without a value and NULL if it is absent.
+FFI_PLUGIN_EXPORT const char *zenoh_query_param_get(ZenohQuery *query,
+                                                    const char *name);
+// Adds a reference, e.g. before handing the query to another thread
+FFI_PLUGIN_EXPORT ZenohQuery *zenoh_query_retain(ZenohQuery *query);
+// Drops a reference; the last one finalizes the reply stream
+FFI_PLUGIN_EXPORT void zenoh_query_finalize(ZenohQuery *query);
 
 // ============================================================================
 // Ad-hoc Operations
@@ -254,14 +905,207 @@ FFI_PLUGIN_EXPORT int zenoh_delete(ZenohSession *session, const char *key);
 // Query (Get)
 // ============================================================================
 
-FFI_PLUGIN_EXPORT void zenoh_get_async(ZenohSession *session,
-                                       const char *selector,
-                                       ZenohGetCallback callback,
-                                       void *context);
-FFI_PLUGIN_EXPORT void zenoh_get_async_with_options(
+// The zenoh_get_async* calls return < 0 if the query could not be issued
+// (bad selector, out of memory); no callback is called then. Otherwise
+// completion is always reported, even if zenoh fails to send the query.
+FFI_PLUGIN_EXPORT int zenoh_get_async(ZenohSession *session,
+                                      const char *selector,
+                                      ZenohGetCallback callback,
+                                      void *context);
+FFI_PLUGIN_EXPORT int zenoh_get_async_with_options(
     ZenohSession *session, const char *selector, ZenohGetCallback callback,
     ZenohGetCompleteCallback complete_callback, void *context,
     ZenohGetOptions *options);
+// Like zenoh_get_async_with_options, but delivers error replies and the full
+// reply metadata
+FFI_PLUGIN_EXPORT int zenoh_get_async_ex(
+    ZenohSession *session, const char *selector, ZenohGetCallbackEx callback,
+    ZenohGetCompleteCallback complete_callback, void *context,
+    ZenohGetOptions *options);
+// Like zenoh_get_async_ex, reporting the cursor of the next page on
+// completion. options->limit and options->cursor are sent to storages as the
+// `_limit` and `_cursor` parameters and enforced again on the replies. With a
+// limit the page is held until the query is done and then delivered in key
+// order: it is the smallest keys after the cursor, whatever order replies
+// arrive in, and replies past it are dropped once a smaller page is full.
+FFI_PLUGIN_EXPORT int zenoh_get_async_paged(
+    ZenohSession *session, const char *selector, ZenohGetCallbackEx callback,
+    ZenohGetPageCallback page_callback, void *context,
+    ZenohGetOptions *options);
+// Queries every selector with the same options and one shared deadline
+// (options->timeout_ms from the call). Replies carry the index of their
+// selector. complete_callback fires exactly once: when all queries are done,
+// or as soon as quorum data replies have been delivered (0 = wait for all).
+// Later replies are discarded.
+FFI_PLUGIN_EXPORT void zenoh_get_multi(
+    ZenohSession *session, const char *const *selectors, size_t count,
+    ZenohGetOptions *options, size_t quorum, ZenohGetMultiCallback callback,
+    ZenohGetCompleteCallback complete_callback, void *context);
+
+// ============================================================================
+// Reply Channel
+// ============================================================================
+
+// Queries selector into a bounded channel of capacity replies (0 = 256) that
+// the caller drains at its own pace. A FIFO channel holds back zenoh when
+// full: the zenoh thread delivering a reply blocks until the channel is
+// drained or closed. A ring channel drops the oldest reply instead. Returns
+// NULL on failure.
+FFI_PLUGIN_EXPORT ZenohReplyChannel *
+zenoh_get_channel(ZenohSession *session, const char *selector,
+                  ZenohGetOptions *options, ZenohReplyChannelKind kind,
+                  size_t capacity);
+// Moves up to max (at most 64) queued replies into out without blocking.
+// Returns the number received, or -1 once all replies have been received.
+FFI_PLUGIN_EXPORT int zenoh_reply_try_recv_batch(ZenohReplyChannel *channel,
+                                                 ZenohReplyRecord *out,
+                                                 size_t max);
+// Drops pending replies and releases the channel, unblocking a FIFO sender.
+// Its signature lets it serve as a Dart NativeFinalizer.
+FFI_PLUGIN_EXPORT void zenoh_reply_channel_close(ZenohReplyChannel *channel);
+
+// ============================================================================
+// Querier
+// ============================================================================
+
+// Declares the key expression and query options once, so repeated queries on
+// the same key skip re-parsing and re-resolution.
+FFI_PLUGIN_EXPORT ZenohQuerier *
+zenoh_declare_querier(ZenohSession *session, const char *key,
+                      ZenohQuerierOptions *options);
+FFI_PLUGIN_EXPORT int zenoh_querier_get(
+    ZenohQuerier *querier, const char *parameters, const uint8_t *payload,
+    size_t payload_len, ZenohEncodingId encoding, const uint8_t *attachment,
+    size_t attachment_len, ZenohGetCallback callback,
+    ZenohGetCompleteCallback complete_callback, void *context);
+// Returns 1 if queryables currently match the querier, 0 if not, < 0 on error
+FFI_PLUGIN_EXPORT int zenoh_querier_get_matching_status(ZenohQuerier *querier);
+// Installs (or replaces) the querier's matching-status listener
+FFI_PLUGIN_EXPORT int zenoh_querier_declare_matching_listener(
+    ZenohQuerier *querier, ZenohMatchingCallback callback, void *context);
+FFI_PLUGIN_EXPORT void zenoh_undeclare_querier(ZenohQuerier *querier);
+
+// ============================================================================
+// RPC
+// ============================================================================
+
+// Declares a queryable on service_key that dispatches calls to the registered
+// methods. callback receives calls to methods without a native handler.
+FFI_PLUGIN_EXPORT ZenohRpcServer *
+zenoh_declare_rpc_server(ZenohSession *session, const char *service_key,
+                         ZenohRpcRequestCallback callback, void *context);
+// Registers or replaces method. A NULL handler forwards it to the server
+// callback.
+FFI_PLUGIN_EXPORT int zenoh_rpc_server_register(ZenohRpcServer *server,
+                                                const char *method,
+                                                ZenohRpcHandler handler,
+                                                void *context);
+FFI_PLUGIN_EXPORT int zenoh_rpc_server_unregister(ZenohRpcServer *server,
+                                                  const char *method);
+FFI_PLUGIN_EXPORT void zenoh_undeclare_rpc_server(ZenohRpcServer *server);
+// Appends to a native handler's response
+FFI_PLUGIN_EXPORT int zenoh_rpc_response_write(ZenohRpcResponse *response,
+                                               const uint8_t *data,
+                                               size_t len);
+// Answers a forwarded call and releases query
+FFI_PLUGIN_EXPORT int zenoh_rpc_respond(ZenohQuery *query, uint64_t call_id,
+                                        int status, const uint8_t *data,
+                                        size_t len);
+
+// Declares a querier on service_key. Calls share it and may be pipelined.
+FFI_PLUGIN_EXPORT ZenohRpcClient *
+zenoh_rpc_client_new(ZenohSession *session, const char *service_key,
+                     ZenohRpcClientOptions *options);
+// Starts a call and returns its id (0 on failure). Attempts that get no reply
+// are retried up to retries times (at most 64) while deadline_ms (0 = none)
+// has not passed; no attempt waits past the deadline. A request zenoh
+// refuses outright is not retried. callback reports the outcome.
+FFI_PLUGIN_EXPORT uint64_t zenoh_rpc_call(ZenohRpcClient *client,
+                                          const char *method,
+                                          const uint8_t *request, size_t len,
+                                          uint64_t deadline_ms,
+                                          uint32_t retries,
+                                          ZenohRpcResponseCallback callback,
+                                          void *context);
+// In-flight calls still complete, without further retries
+FFI_PLUGIN_EXPORT void zenoh_rpc_client_close(ZenohRpcClient *client);
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+// Subscribes to key_expr, keeps the latest value of every key (last writer
+// wins on sample timestamps) and answers queries on key_expr natively.
+// Queries may restrict replies with a `_time=[start..end]` parameter.
+// on_change may be NULL.
+FFI_PLUGIN_EXPORT ZenohStorage *zenoh_declare_memory_storage(
+    ZenohSession *session, const char *key_expr, ZenohStorageOptions *options,
+    ZenohStorageChangeCallback on_change, void *context);
+// Same as zenoh_declare_memory_storage, persisting to an open log store. The
+// storage holds its own reference to store.
+FFI_PLUGIN_EXPORT ZenohStorage *zenoh_declare_log_storage(
+    ZenohSession *session, const char *key_expr, ZenohLogStore *store,
+    ZenohStorageOptions *options, ZenohStorageChangeCallback on_change,
+    void *context);
+// Copies the value of key into a heap buffer (release it with
+// zenoh_free_string). Returns 1 if found, 0 if not, < 0 on error.
+FFI_PLUGIN_EXPORT int zenoh_storage_get(ZenohStorage *storage, const char *key,
+                                        uint8_t **data, size_t *len);
+FFI_PLUGIN_EXPORT int zenoh_storage_stats(ZenohStorage *storage,
+                                          ZenohStorageStats *stats);
+FFI_PLUGIN_EXPORT void zenoh_undeclare_storage(ZenohStorage *storage);
+
+// ============================================================================
+// Log Store
+// ============================================================================
+
+// Opens (creating if needed) a log-structured store in directory path.
+// Segments are memory-mapped and the key index is rebuilt from the last
+// index snapshot plus the records written after it.
+FFI_PLUGIN_EXPORT ZenohLogStore *zenoh_log_store_open(
+    const char *path, ZenohLogStoreOptions *options);
+// Writes the index snapshot and releases the handle. Storages declared on
+// the store keep it open until they are undeclared.
+FFI_PLUGIN_EXPORT void zenoh_log_store_close(ZenohLogStore *store);
+FFI_PLUGIN_EXPORT int zenoh_log_store_put(ZenohLogStore *store,
+                                          const char *key, const uint8_t *data,
+                                          size_t len, ZenohEncodingId encoding);
+FFI_PLUGIN_EXPORT int zenoh_log_store_delete(ZenohLogStore *store,
+                                             const char *key);
+// Copies the value of key into a heap buffer (release it with
+// zenoh_free_string). Returns 1 if found, 0 if not, < 0 on error.
+FFI_PLUGIN_EXPORT int zenoh_log_store_get(ZenohLogStore *store,
+                                          const char *key, uint8_t **data,
+                                          size_t *len);
+FFI_PLUGIN_EXPORT int zenoh_log_store_stats(ZenohLogStore *store,
+                                            ZenohLogStoreStats *stats);
+// Rewrites every sealed segment now; puts keep running meanwhile. Returns
+// the number reclaimed.
+FFI_PLUGIN_EXPORT int zenoh_log_store_compact(ZenohLogStore *store);
+// Syncs segments to disk and writes the index snapshot
+FFI_PLUGIN_EXPORT int zenoh_log_store_flush(ZenohLogStore *store);
+
+// ============================================================================
+// Time Series
+// ============================================================================
+
+// Subscribes to key_expr and keeps a ring of (time, value) points per key.
+// Queries select points with `_time=[start..end]` and may downsample with
+// `step=1s&agg=min|max|avg|last`. Each reply carries one key's points as
+// packed little-endian (u64 NTP64 time, f64 value) pairs.
+FFI_PLUGIN_EXPORT ZenohTimeSeries *
+zenoh_declare_timeseries(ZenohSession *session, const char *key_expr,
+                         ZenohTimeSeriesOptions *options);
+// Packs the points of key selected by parameters (same syntax as queries)
+// into a heap buffer (release it with zenoh_free_string). Returns the number
+// of points or < 0 on error.
+FFI_PLUGIN_EXPORT int zenoh_timeseries_read(ZenohTimeSeries *ts,
+                                            const char *key,
+                                            const char *parameters,
+                                            uint8_t **data, size_t *len);
+FFI_PLUGIN_EXPORT int zenoh_timeseries_stats(ZenohTimeSeries *ts,
+                                             ZenohTimeSeriesStats *stats);
+FFI_PLUGIN_EXPORT void zenoh_undeclare_timeseries(ZenohTimeSeries *ts);
 
 // ============================================================================
 // Liveliness
@@ -281,6 +1125,26 @@ FFI_PLUGIN_EXPORT void zenoh_liveliness_get(ZenohSession *session,
                                             ZenohLivelinessCallback callback,
                                             void *context, uint64_t timeout_ms);
 
+// Track the alive tokens under key_expr natively. Changes are coalesced and
+// reported through callback at most once per interval_ms (0 = 100 ms), on a
+// library thread; the first delta carries the tokens already alive.
+FFI_PLUGIN_EXPORT ZenohLivelinessTracker *
+zenoh_liveliness_tracker_open(ZenohSession *session, const char *key_expr,
+                              uint64_t interval_ms,
+                              ZenohLivelinessDeltaCallback callback,
+                              void *context);
+// The alive set as of the last delta, packed like the delta keys. version
+// is the delta it reflects, so later deltas apply on top of it. Free the
+// result with zenoh_free_string.
+FFI_PLUGIN_EXPORT char *zenoh_liveliness_snapshot(ZenohLivelinessTracker *tracker,
+                                                  uint64_t *version,
+                                                  size_t *count, size_t *len);
+FFI_PLUGIN_EXPORT size_t
+zenoh_liveliness_tracker_count(ZenohLivelinessTracker *tracker);
+// Stop tracking. No delta is delivered after this returns.
+FFI_PLUGIN_EXPORT void
+zenoh_liveliness_tracker_close(ZenohLivelinessTracker *tracker);
+
 // ============================================================================
 // Scouting
 // ============================================================================
@@ -288,6 +1152,28 @@ FFI_PLUGIN_EXPORT void zenoh_liveliness_get(ZenohSession *session,
 FFI_PLUGIN_EXPORT void zenoh_scout(const char *what, const char *config,
                                    void (*callback)(const char *info));
 
+// Scout on a library thread for timeout_ms (0 = 1000) with config_json (NULL
+// for the default config). what is "router", "peer" or "peer|router".
+// Returns 0 once started.
+FFI_PLUGIN_EXPORT int zenoh_scout_ex(const char *what, const char *config_json,
+                                     uint64_t timeout_ms,
+                                     ZenohScoutCallback callback,
+                                     void *context);
+
+// Scout like zenoh_scout_ex, probing every TCP-based locator as its hello
+// arrives, for up to probe_timeout_ms (0 = 1000) each, and open a session
+// with config_json connected to the first to answer without waiting out
+// the scout. Falls back to the first locator found when none answers.
+// Locators containing quotes, backslashes or control characters are
+// skipped. Result is -1 if scouting failed, -2 if nothing was found and
+// -3 if the open failed.
+FFI_PLUGIN_EXPORT int zenoh_scout_connect(const char *what,
+                                          const char *config_json,
+                                          uint64_t scout_timeout_ms,
+                                          uint64_t probe_timeout_ms,
+                                          ZenohScoutConnectCallback callback,
+                                          void *context);
+
 // ============================================================================
 // Helpers
 // ============================================================================
@@ -299,6 +1185,20 @@ FFI_PLUGIN_EXPORT void zenoh_publisher_options_default(
     ZenohPublisherOptions *options);
 FFI_PLUGIN_EXPORT void zenoh_put_options_default(ZenohPutOptions *options);
 FFI_PLUGIN_EXPORT void zenoh_get_options_default(ZenohGetOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_querier_options_default(
+    ZenohQuerierOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_storage_options_default(
+    ZenohStorageOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_log_store_options_default(
+    ZenohLogStoreOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_timeseries_options_default(
+    ZenohTimeSeriesOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_querying_subscriber_options_default(
+    ZenohQueryingSubscriberOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_rpc_client_options_default(
+    ZenohRpcClientOptions *options);
+FFI_PLUGIN_EXPORT void zenoh_advanced_subscriber_options_default(
+    ZenohAdvancedSubscriberOptions *options);
 
 // Encoding helpers
 FFI_PLUGIN_EXPORT const char *zenoh_encoding_to_string(ZenohEncodingId encoding);
@@ -1,6 +1,7 @@
 import 'dart:typed_data';
 import 'dart:convert';
 import 'package:test/test.dart';
+import 'package:zenoh_ffi/src/packed_keys.dart';
 import 'package:zenoh_ffi/zenoh_ffi.dart';
 
 void main() {
@@ -436,4 +437,384 @@ void main() {
       expect(exception.errorCode, isNull);
     });
   });
+
+  group('Query enums', () {
+    test('values match the native enums', () {
+      expect(ZenohConsolidationMode.auto.value, equals(0));
+      expect(ZenohConsolidationMode.latest.value, equals(3));
+      expect(ZenohQueryTarget.bestMatching.value, equals(0));
+      expect(ZenohQueryTarget.allComplete.value, equals(2));
+      expect(ZenohLocality.any.value, equals(0));
+      expect(ZenohLocality.remote.value, equals(2));
+    });
+
+    test('ZenohGetOptions defaults to auto consolidation', () {
+      const options = ZenohGetOptions();
+
+      expect(options.consolidation, equals(ZenohConsolidationMode.auto));
+      expect(options.target, equals(ZenohQueryTarget.bestMatching));
+      expect(options.allowedDestination, equals(ZenohLocality.any));
+    });
+  });
+
+  group('ZenohTimePoint', () {
+    // 32.32 fixed point seconds since the Unix epoch
+    int ntp64(int seconds, int fraction) => (seconds << 32) | fraction;
+
+    Uint8List points(List<(int, double)> entries, {int trailing = 0}) {
+      final data = ByteData(entries.length * 16 + trailing);
+      for (var i = 0; i < entries.length; i++) {
+        data.setUint64(i * 16, entries[i].$1, Endian.little);
+        data.setFloat64(i * 16 + 8, entries[i].$2, Endian.little);
+      }
+      return data.buffer.asUint8List();
+    }
+
+    test('decode converts NTP64 times', () {
+      final decoded = ZenohTimePoint.decode(points([
+        (ntp64(1700000000, 0), 1.5),
+        (ntp64(1700000001, 0x80000000), -2.0),
+      ]));
+
+      expect(decoded, hasLength(2));
+      expect(decoded[0].time.microsecondsSinceEpoch,
+          equals(1700000000 * 1000000));
+      expect(decoded[0].value, equals(1.5));
+      expect(decoded[1].time.microsecondsSinceEpoch,
+          equals(1700000001 * 1000000 + 500000));
+      expect(decoded[1].value, equals(-2.0));
+    });
+
+    test('decode rounds sub-microsecond fractions down', () {
+      final decoded =
+          ZenohTimePoint.decode(points([(ntp64(10, 0xFFFFFFFF), 0.0)]));
+
+      expect(decoded.single.time.microsecondsSinceEpoch,
+          equals(10 * 1000000 + 999999));
+    });
+
+    test('decode skips zero times and trailing bytes', () {
+      final decoded = ZenohTimePoint.decode(points([
+        (0, 1.0),
+        (ntp64(20, 0), 2.0),
+      ], trailing: 7));
+
+      expect(decoded, hasLength(1));
+      expect(decoded.single.value, equals(2.0));
+    });
+
+    test('decode of an empty payload is empty', () {
+      expect(ZenohTimePoint.decode(Uint8List(0)), isEmpty);
+    });
+
+    test('ZenohTimeSeriesFormat matches the native enum', () {
+      expect(ZenohTimeSeriesFormat.auto.value, equals(0));
+      expect(ZenohTimeSeriesFormat.float64.value, equals(2));
+      expect(ZenohTimeSeriesFormat.int64.value, equals(4));
+      expect(ZenohTimeSeriesFormat.jsonField.value, equals(5));
+    });
+  });
+
+  group('ZenohReplyChannelKind', () {
+    test('values match the native enum', () {
+      expect(ZenohReplyChannelKind.fifo.value, equals(0));
+      expect(ZenohReplyChannelKind.ring.value, equals(1));
+    });
+  });
+
+  group('ZenohRpcStatus', () {
+    test('fromValue maps the native statuses', () {
+      expect(ZenohRpcStatus.fromValue(0), equals(ZenohRpcStatus.ok));
+      expect(ZenohRpcStatus.fromValue(2), equals(ZenohRpcStatus.notFound));
+      expect(ZenohRpcStatus.fromValue(3), equals(ZenohRpcStatus.timeout));
+      expect(ZenohRpcStatus.fromValue(4), equals(ZenohRpcStatus.unavailable));
+    });
+
+    test('fromValue returns null for handler codes', () {
+      expect(ZenohRpcStatus.fromValue(16), isNull);
+    });
+  });
+
+  group('ZenohPage', () {
+    test('hasMore follows the cursor', () {
+      final reply =
+          ZenohReply(key: 'k/00', payload: Uint8List.fromList([1]));
+
+      expect(ZenohPage([reply], 'k/00').hasMore, isTrue);
+      expect(ZenohPage([reply], null).hasMore, isFalse);
+      expect(ZenohPage([], null).replies, isEmpty);
+    });
+
+    test('ZenohGetOptions carries limit and cursor', () {
+      const defaults = ZenohGetOptions();
+      const page = ZenohGetOptions(limit: 10, cursor: 'k/09');
+
+      expect(defaults.limit, equals(0));
+      expect(defaults.cursor, isNull);
+      expect(page.limit, equals(10));
+      expect(page.cursor, equals('k/09'));
+    });
+  });
+
+  group('ZenohTransportTuning', () {
+    test('ZenohTransportProfile matches the native enum', () {
+      expect(ZenohTransportProfile.defaults.value, equals(0));
+      expect(ZenohTransportProfile.lowLatency.value, equals(1));
+      expect(ZenohTransportProfile.highThroughput.value, equals(2));
+      expect(ZenohTransportProfile.constrainedDevice.value, equals(3));
+    });
+
+    test('defaults to the default profile with no overrides', () {
+      const tuning = ZenohTransportTuning();
+
+      expect(tuning.profile, equals(ZenohTransportProfile.defaults));
+      expect(tuning.lowLatency, isNull);
+      expect(tuning.batchSize, isNull);
+      expect(ZenohTransportTuning.lowLatencyProfile.profile,
+          equals(ZenohTransportProfile.lowLatency));
+    });
+
+    test('a builder without tuning has no transport keys', () {
+      expect(ZenohConfigBuilder().mode('peer').transportKeys, isEmpty);
+    });
+
+    test('out-of-range overrides are rejected before zenoh sees them', () {
+      expect(
+          () => ZenohConfigBuilder()
+              .transport(const ZenohTransportTuning(batchSize: 65536))
+              .build(),
+          throwsArgumentError);
+      expect(
+          () => ZenohConfigBuilder()
+              .transport(const ZenohTransportTuning(queueSize: 17))
+              .build(),
+          throwsArgumentError);
+      expect(
+          () => ZenohConfigBuilder()
+              .transport(const ZenohTransportTuning(rxBufferSize: -1))
+              .build(),
+          throwsArgumentError);
+    });
+  });
+
+  group('ZenohThreadPolicy', () {
+    test('ZenohThreadKind matches the native enum', () {
+      expect(ZenohThreadKind.delivery.value, equals(0));
+      expect(ZenohThreadKind.worker.value, equals(1));
+    });
+
+    test('defaults leave affinity and niceness alone', () {
+      const policy = ZenohThreadPolicy();
+
+      expect(policy.cpus, isEmpty);
+      expect(policy.nice, isNull);
+    });
+  });
+
+  group('Packed keys', () {
+    test('packKeys writes NUL-terminated UTF-8 keys back to back', () {
+      final packed = packKeys(['a/b', 'ü', '']);
+
+      expect(packed, equals([0x61, 0x2f, 0x62, 0, 0xc3, 0xbc, 0, 0]));
+    });
+
+    test('unpackKeys splits what packKeys wrote', () {
+      final keys = ['sensors/1', 'robots/ü/arm', 'x'];
+
+      expect(unpackKeys(packKeys(keys)), equals(keys));
+    });
+
+    test('unpackKeys splits NUL-terminated UTF-8 keys', () {
+      final packed =
+          Uint8List.fromList([0x61, 0x2f, 0x62, 0, 0xc3, 0xbc, 0, 0]);
+
+      expect(unpackKeys(packed), equals(['a/b', 'ü', '']));
+      expect(unpackKeys(Uint8List(0)), isEmpty);
+    });
+
+    test('unpackKeys ignores an unterminated tail', () {
+      expect(unpackKeys(Uint8List.fromList([0x61, 0, 0x62])), equals(['a']));
+    });
+  });
+
+  group('ZenohHello', () {
+    Uint8List record(int whatami, List<String> locators, {int? count}) {
+      final bytes = BytesBuilder()
+        ..addByte(whatami)
+        ..add(List.generate(16, (i) => i * 16 + i));
+      final header = ByteData(4)
+        ..setUint32(0, count ?? locators.length, Endian.little);
+      bytes.add(header.buffer.asUint8List());
+      for (final locator in locators) {
+        bytes
+          ..add(utf8.encode(locator))
+          ..addByte(0);
+      }
+      return bytes.toBytes();
+    }
+
+    test('decode reads role, zid and locators', () {
+      final hello = ZenohHello.decode(
+          record(1, ['tcp/10.0.0.2:7447', 'udp/[fe80::1]:7447']));
+
+      expect(hello.whatami, equals(ZenohWhatAmI.router));
+      expect(hello.zid, equals('00112233-4455-6677-8899-aabbccddeeff'));
+      expect(hello.locators,
+          equals(['tcp/10.0.0.2:7447', 'udp/[fe80::1]:7447']));
+    });
+
+    test('decode stops at the locator count', () {
+      final hello =
+          ZenohHello.decode(record(2, ['tcp/a:1', 'tcp/b:2'], count: 1));
+
+      expect(hello.whatami, equals(ZenohWhatAmI.peer));
+      expect(hello.locators, equals(['tcp/a:1']));
+    });
+
+    test('decode accepts a node without locators', () {
+      final hello = ZenohHello.decode(record(4, []));
+
+      expect(hello.whatami, equals(ZenohWhatAmI.client));
+      expect(hello.locators, isEmpty);
+    });
+
+    test('ZenohWhatAmI.fromValue maps zenoh roles', () {
+      expect(ZenohWhatAmI.fromValue(1), equals(ZenohWhatAmI.router));
+      expect(ZenohWhatAmI.fromValue(2), equals(ZenohWhatAmI.peer));
+      expect(ZenohWhatAmI.fromValue(4), equals(ZenohWhatAmI.client));
+      expect(ZenohWhatAmI.fromValue(3), equals(ZenohWhatAmI.peer));
+    });
+  });
+
+  group('ZenohSerializer', () {
+    test('ZenohSerialType values and sizes are stable', () {
+      expect(ZenohSerialType.int8.value, equals(0));
+      expect(ZenohSerialType.uint16.value, equals(3));
+      expect(ZenohSerialType.int32.value, equals(4));
+      expect(ZenohSerialType.uint64.value, equals(7));
+      expect(ZenohSerialType.float32.value, equals(8));
+      expect(ZenohSerialType.float64.value, equals(9));
+      expect(ZenohSerialType.boolean.value, equals(10));
+      expect(ZenohSerialType.int16.size, equals(2));
+      expect(ZenohSerialType.float32.size, equals(4));
+      expect(ZenohSerialType.uint64.size, equals(8));
+      expect(ZenohSerialType.boolean.size, equals(1));
+    });
+
+    test('float64List round trips with a sequence length prefix', () {
+      final values = Float64List.fromList([1.5, -2.25, 1e300]);
+      final payload = ZenohSerializer.float64List(values);
+
+      expect(payload.length, equals(1 + 3 * 8));
+      expect(payload[0], equals(3));
+      expect(ByteData.sublistView(payload).getFloat64(1, Endian.little),
+          equals(1.5));
+      expect(ZenohSerializer.toFloat64List(payload), equals(values));
+    });
+
+    test('float32List and int32List round trip', () {
+      final floats = Float32List.fromList([0.5, -1.0, 3.25]);
+      final ints = Int32List.fromList([0, -1, 0x7fffffff, -0x80000000]);
+
+      expect(
+          ZenohSerializer.toFloat32List(ZenohSerializer.float32List(floats)),
+          equals(floats));
+      expect(ZenohSerializer.toInt32List(ZenohSerializer.int32List(ints)),
+          equals(ints));
+    });
+
+    test('lengths from 128 take a multi-byte varint', () {
+      final values = Int32List(200);
+      final payload = ZenohSerializer.int32List(values);
+
+      expect(payload.sublist(0, 2), equals([0xC8, 0x01]));
+      expect(payload.length, equals(2 + 200 * 4));
+      expect(ZenohSerializer.toInt32List(payload), hasLength(200));
+    });
+
+    test('empty arrays round trip', () {
+      final payload = ZenohSerializer.float64List(Float64List(0));
+
+      expect(payload, equals([0]));
+      expect(ZenohSerializer.toFloat64List(payload), isEmpty);
+    });
+
+    test('views into a larger buffer serialize only their values', () {
+      final backing = Float64List.fromList([9.0, 1.0, 2.0, 9.0]);
+      final view = Float64List.sublistView(backing, 1, 3);
+
+      expect(
+          ZenohSerializer.toFloat64List(ZenohSerializer.float64List(view)),
+          equals([1.0, 2.0]));
+    });
+
+    // int32 id, bool flag, 3 bytes of padding, float64 value
+    const fields = [
+      ZenohSerialField(ZenohSerialType.int32, 0),
+      ZenohSerialField(ZenohSerialType.boolean, 4),
+      ZenohSerialField(ZenohSerialType.float64, 8),
+    ];
+
+    test('records are written without padding and read back', () {
+      final data = ByteData(32);
+      data.setInt32(0, 7, Endian.host);
+      data.setUint8(4, 5); // Any non-zero byte is true
+      data.setUint8(5, 0xAA); // Padding is not serialized
+      data.setFloat64(8, 0.25, Endian.host);
+      data.setInt32(16, -3, Endian.host);
+      data.setFloat64(24, -8.0, Endian.host);
+
+      final payload = ZenohSerializer.records(fields, data, 16);
+      expect(payload.length, equals(1 + 2 * 13));
+      expect(payload[0], equals(2));
+      expect(payload[5], equals(1));
+      expect(payload[5 + 13], equals(0));
+
+      final decoded = ZenohSerializer.toRecords(fields, payload, 16);
+      expect(decoded.lengthInBytes, equals(32));
+      expect(decoded.getInt32(0, Endian.host), equals(7));
+      expect(decoded.getUint8(4), equals(1));
+      expect(decoded.getUint8(5), equals(0));
+      expect(decoded.getFloat64(8, Endian.host), equals(0.25));
+      expect(decoded.getInt32(16, Endian.host), equals(-3));
+      expect(decoded.getUint8(20), equals(0));
+      expect(decoded.getFloat64(24, Endian.host), equals(-8.0));
+    });
+
+    test('records rejects a partial trailing record', () {
+      expect(() => ZenohSerializer.records(fields, ByteData(20), 16),
+          throwsArgumentError);
+    });
+
+    test('records rejects fields outside the stride', () {
+      expect(
+          () => ZenohSerializer.records(
+              const [ZenohSerialField(ZenohSerialType.float64, 12)],
+              ByteData(16),
+              16),
+          throwsArgumentError);
+      expect(() => ZenohSerializer.records(const [], ByteData(16), 16),
+          throwsArgumentError);
+      expect(() => ZenohSerializer.records(fields, ByteData(16), 0),
+          throwsArgumentError);
+    });
+
+    test('deserializing rejects malformed payloads', () {
+      // Length says 2 values but only one follows
+      final short = Uint8List.fromList([2, ...List.filled(8, 0)]);
+      // Unterminated varint
+      final unterminated = Uint8List.fromList([0x80]);
+      // A bool byte other than 0 or 1
+      final badBool = Uint8List.fromList([1, ...List.filled(13, 0)])..[5] = 2;
+
+      expect(() => ZenohSerializer.toFloat64List(short),
+          throwsA(isA<ZenohException>()));
+      expect(() => ZenohSerializer.toFloat64List(unterminated),
+          throwsA(isA<ZenohException>()));
+      expect(() => ZenohSerializer.toFloat64List(Uint8List(0)),
+          throwsA(isA<ZenohException>()));
+      expect(() => ZenohSerializer.toRecords(fields, badBool, 16),
+          throwsA(isA<ZenohException>()));
+    });
+  });
 }
@@ -0,0 +1,173 @@
+import 'dart:async';
+import 'dart:typed_data';
+import 'package:test/test.dart';
+import 'package:zenoh_ffi/zenoh_ffi.dart';
+
+// These tests talk to the native library through a local peer session and
+// are skipped when the plugin library has not been built for the host.
+void main() {
+  ZenohSession? session;
+
+  setUpAll(() async {
+    try {
+      session = await ZenohSession.openWithConfig(
+          ZenohConfigBuilder().mode('peer').multicastScouting(false));
+    } catch (_) {
+      session = null;
+    }
+  });
+
+  tearDownAll(() async {
+    await session?.close();
+  });
+
+  group('Chunked transfer', () {
+    // magic | transfer_id | total_len | chunk_size | index | count | crc32
+    Uint8List forgedChunk(int totalLen, int chunkSize, int count) {
+      final header = ByteData(36 + 1);
+      header.setUint32(0, 0x4b48435a, Endian.little);
+      header.setUint64(4, 0x1234567, Endian.little);
+      header.setUint64(12, totalLen, Endian.little);
+      header.setUint32(20, chunkSize, Endian.little);
+      header.setUint32(24, 0, Endian.little);
+      header.setUint32(28, count, Endian.little);
+      header.setUint32(32, 0, Endian.little);
+      return header.buffer.asUint8List();
+    }
+
+    test('rejects forged headers and still reassembles valid transfers',
+        () async {
+      if (session == null) {
+        markTestSkipped('native library not available');
+        return;
+      }
+      final s = session!;
+      const key = 'test/native/chunked';
+      final sub = await s.declareChunkedSubscriber(key, maxObjectSize: 0);
+      final pub = await s.declarePublisher(key,
+          options: const ZenohPublisherOptions(
+              congestionControl: ZenohCongestionControl.block));
+
+      // One bit per chunk for 2^32 - 1 chunks used to wrap to a 0-byte
+      // bitmap; 2^21 one-byte chunks exceed the chunk count bound.
+      await s.put(key, forgedChunk(0xFFFFFFFF, 1, 0xFFFFFFFF));
+      await s.put(key, forgedChunk(1 << 21, 1, 1 << 21));
+
+      final data = Uint8List.fromList(List.generate(5000, (i) => i & 0xff));
+      final received = sub.stream.first;
+      await pub.putChunked(data, chunkSize: 1024);
+
+      final sample = await received.timeout(const Duration(seconds: 5));
+      expect(sample.payload, equals(data));
+
+      await pub.undeclare();
+      await sub.undeclare();
+    });
+
+    test('drops late chunks of a completed transfer', () async {
+      if (session == null) {
+        markTestSkipped('native library not available');
+        return;
+      }
+      final s = session!;
+      const key = 'test/native/chunked/late';
+      final sub = await s.declareChunkedSubscriber(key);
+
+      // A complete one-chunk transfer of the single byte 0x2a
+      final chunk = ByteData(36 + 1);
+      chunk.setUint32(0, 0x4b48435a, Endian.little);
+      chunk.setUint64(4, 0x7654321, Endian.little);
+      chunk.setUint64(12, 1, Endian.little);
+      chunk.setUint32(20, 1, Endian.little);
+      chunk.setUint32(24, 0, Endian.little);
+      chunk.setUint32(28, 1, Endian.little);
+      chunk.setUint32(32, 0x09b9265b, Endian.little); // CRC-32 of 0x2a
+      chunk.setUint8(36, 0x2a);
+      final bytes = chunk.buffer.asUint8List();
+
+      final received = sub.stream.take(2).toList();
+      await s.put(key, bytes);
+      await s.put(key, bytes);
+      await s.put(key, Uint8List.fromList([1, 2, 3]));
+
+      final samples = await received.timeout(const Duration(seconds: 5));
+      expect(samples[0].payload, equals([0x2a]));
+      expect(samples[1].payload, equals([1, 2, 3]));
+
+      await sub.undeclare();
+    });
+  });
+
+  group('Paged queries', () {
+    test('pages through more keys than one page holds', () async {
+      if (session == null) {
+        markTestSkipped('native library not available');
+        return;
+      }
+      final s = session!;
+      final keys = List.generate(
+          25, (i) => 'test/native/page/k${i.toString().padLeft(2, '0')}');
+      // Ignores _limit and _cursor and answers in reverse key order, so the
+      // page has to be chosen and ordered natively
+      final queryable = await s.declareQueryable('test/native/page/**', (q) {
+        for (final key in keys.reversed) {
+          q.replyString(key, key);
+        }
+      });
+
+      final seen = <String>[];
+      String? cursor;
+      var pages = 0;
+      do {
+        final page =
+            await s.getPage('test/native/page/**', limit: 10, cursor: cursor);
+        final pageKeys = page.replies.map((r) => r.key).toList();
+        expect(pageKeys, equals([...pageKeys]..sort()));
+        seen.addAll(pageKeys);
+        cursor = page.nextCursor;
+        pages++;
+      } while (cursor != null && pages < 10);
+
+      expect(pages, equals(3));
+      expect(seen, equals(keys));
+
+      await queryable.undeclare();
+    });
+  });
+
+  group('Transport tuning', () {
+    test('profiles write their transport keys', () {
+      if (session == null) {
+        markTestSkipped('native library not available');
+        return;
+      }
+      final keys = ZenohConfigBuilder()
+          .mode('peer')
+          .transport(ZenohTransportTuning.lowLatencyProfile)
+          .transportKeys;
+
+      expect(keys['transport/unicast/lowlatency'], isTrue);
+      expect(keys['transport/unicast/qos/enabled'], isFalse);
+      expect(keys['transport/unicast/compression/enabled'], isFalse);
+      expect(keys['transport/link/tx/queue/batching/enabled'], isFalse);
+    });
+
+    test('overrides replace the profile values', () {
+      if (session == null) {
+        markTestSkipped('native library not available');
+        return;
+      }
+      final keys = ZenohConfigBuilder()
+          .mode('peer')
+          .transport(const ZenohTransportTuning(
+              profile: ZenohTransportProfile.highThroughput,
+              batchSize: 4096,
+              queueSize: 2))
+          .transportKeys;
+
+      expect(keys['transport/link/tx/batch_size'], equals(4096));
+      expect(keys['transport/link/tx/queue/size']['data'], equals(2));
+      expect(keys['transport/link/tx/queue/batching/enabled'], isTrue);
+    });
+  });
+}